@@ -5,7 +5,19 @@ import 'package:flutter/foundation.dart';
 import 'package:path/path.dart' as p;
 import 'package:path_provider/path_provider.dart';
 import 'package:sqflite/sqflite.dart' as sqflite;
+import '../models/history_cursor.dart';
+import '../models/history_search_hit.dart';
 import '../models/transcription.dart';
+import 'history_fts.dart';
+import 'history_rollup.dart';
+import 'history_stat_dao.dart';
+import 'history_stat_entity.dart';
+import 'latency_bucket_dao.dart';
+import 'latency_bucket_entity.dart';
+import 'llm_cache_dao.dart';
+import 'llm_cache_entity.dart';
+import 'memory_record_dao.dart';
+import 'memory_record_entity.dart';
 import 'setting_dao.dart';
 import 'setting_entity.dart';
 import 'transcription_dao.dart';
@@ -14,15 +26,48 @@ import 'transcription_entity.dart';
 part 'app_database.g.dart';
 
 /// 统一的 SQLite 数据库，使用 Floor ORM 管理历史记录和所有配置数据。
-@Database(version: 8, entities: [SettingEntity, TranscriptionEntity])
+@Database(
+  version: 14,
+  entities: [
+    SettingEntity,
+    TranscriptionEntity,
+    MemoryRecordEntity,
+    HistoryDailyStatEntity,
+    HistoryModelUsageEntity,
+    LatencyBucketEntity,
+    LlmCacheEntity,
+  ],
+)
 abstract class AppDatabase extends FloorDatabase {
   SettingDao get settingDao;
   TranscriptionDao get transcriptionDao;
+  MemoryRecordDao get memoryRecordDao;
+  HistoryStatDao get historyStatDao;
+  LatencyBucketDao get latencyBucketDao;
+  LlmCacheDao get llmCacheDao;
 
   // ==================== 单例管理 ====================
 
   static AppDatabase? _instance;
   static bool _useInMemory = false;
+  static bool _historyFtsReady = false;
+
+  /// 全文索引不在 Floor 的实体模型内，每次打开时确保其存在；
+  /// 汇总表的触发器在建库时创建，升级时由迁移创建。
+  ///
+  /// 历史记录以 INSERT OR REPLACE 写入，需开启 recursive_triggers，
+  /// 被替换的旧行才会触发删除触发器、从全文索引与汇总表中移除。
+  static final Callback _callback = Callback(
+    onConfigure: (database) async {
+      await database.execute('PRAGMA recursive_triggers = ON');
+    },
+    onCreate: (database, version) async {
+      await HistoryRollup.createTriggers(database);
+    },
+    onOpen: (database) async {
+      _historyFtsReady = await HistoryFts.ensure(database);
+    },
+  );
 
   static Future<String> _resolveDatabaseNameOrPath() async {
     if (kIsWeb) return 'voicetype.db';
@@ -46,12 +91,14 @@ abstract class AppDatabase extends FloorDatabase {
       _instance = await $FloorAppDatabase
           .inMemoryDatabaseBuilder()
           .addMigrations(_migrations)
+          .addCallback(_callback)
           .build();
     } else {
       final dbPath = await _resolveDatabaseNameOrPath();
       _instance = await $FloorAppDatabase
           .databaseBuilder(dbPath)
           .addMigrations(_migrations)
+          .addCallback(_callback)
           .build();
     }
     return _instance!;
@@ -67,6 +114,9 @@ abstract class AppDatabase extends FloorDatabase {
     return _instance!;
   }
 
+  /// 已初始化时返回实例，否则返回 null，不触发初始化。
+  static AppDatabase? get instanceIfOpen => _instance;
+
   /// 仅限测试使用：重置为内存数据库，避免文件锁冲突。
   @visibleForTesting
   static Future<void> resetForTest() async {
@@ -100,6 +150,93 @@ abstract class AppDatabase extends FloorDatabase {
     return {for (final e in entities) e.key: e.value};
   }
 
+  // ==================== 统计计数器便捷方法 ====================
+
+  /// 读取一组计数器，缺失或无法解析的按 0 处理。
+  Future<Map<String, int>> getCounters(List<String> keys) async {
+    final counters = <String, int>{for (final key in keys) key: 0};
+    if (keys.isEmpty) return counters;
+    for (final entity in await settingDao.findByKeys(keys)) {
+      counters[entity.key] = int.tryParse(entity.value) ?? 0;
+    }
+    return counters;
+  }
+
+  /// 在一个事务内按增量累加计数器。
+  ///
+  /// 计数器以十进制字符串存于 settings 表；累加在 SQL 中完成
+  /// （`value = value + ?`），不依赖调用方先读出旧值。
+  Future<void> incrementCounters(Map<String, int> deltas) async {
+    if (deltas.isEmpty) return;
+    final batch = database.batch();
+    deltas.forEach((key, delta) {
+      batch.rawInsert(
+        'INSERT INTO settings (`key`, value) VALUES (?, ?) '
+        'ON CONFLICT (`key`) DO UPDATE SET '
+        'value = CAST(CAST(value AS INTEGER) + ? AS TEXT)',
+        [key, '$delta', delta],
+      );
+    });
+    await batch.commit(noResult: true);
+  }
+
+  // ==================== 阶段耗时直方图便捷方法 ====================
+
+  /// 在一个事务内把各桶的增量样本数累加到直方图表。
+  ///
+  /// [deltas] 的 `count` 字段是增量而不是新值。
+  Future<void> addLatencyBuckets(List<LatencyBucketEntity> deltas) async {
+    if (deltas.isEmpty) return;
+    final batch = database.batch();
+    for (final delta in deltas) {
+      batch.rawInsert(
+        'INSERT INTO latency_buckets (day, stage, bucket, count) '
+        'VALUES (?, ?, ?, ?) '
+        'ON CONFLICT (day, stage, bucket) DO UPDATE SET count = count + ?',
+        [delta.day, delta.stage, delta.bucket, delta.count, delta.count],
+      );
+    }
+    await batch.commit(noResult: true);
+  }
+
+  /// 读取 [day]（含）之后各天的直方图桶。
+  Future<List<LatencyBucketEntity>> getLatencyBucketsSince(String day) {
+    return latencyBucketDao.findSince(day);
+  }
+
+  /// 删除 [day] 之前的直方图桶。
+  Future<void> pruneLatencyBuckets(String day) {
+    return latencyBucketDao.deleteBefore(day);
+  }
+
+  // ==================== LLM 结果缓存便捷方法 ====================
+
+  /// 按最近使用时间保留至多 [maxEntries] 条、合计不超过 [maxBytes] 字节的
+  /// 缓存，其余删除；返回删除的条数。
+  Future<int> pruneLlmCache({
+    required int maxEntries,
+    required int maxBytes,
+  }) async {
+    final rows = await database.rawQuery(
+      'SELECT `key`, size FROM llm_result_cache ORDER BY last_used_at DESC',
+    );
+    final evicted = <String>[];
+    var bytes = 0;
+    for (var i = 0; i < rows.length; i++) {
+      bytes += rows[i]['size'] as int;
+      if (i >= maxEntries || bytes > maxBytes) {
+        evicted.add(rows[i]['key'] as String);
+      }
+    }
+    for (var i = 0; i < evicted.length; i += _maxInListBatch) {
+      final end = i + _maxInListBatch < evicted.length
+          ? i + _maxInListBatch
+          : evicted.length;
+      await llmCacheDao.deleteByKeys(evicted.sublist(i, end));
+    }
+    return evicted.length;
+  }
+
   // ==================== 历史记录便捷方法 ====================
 
   Future<List<Transcription>> getAllHistory() async {
@@ -107,6 +244,80 @@ abstract class AppDatabase extends FloorDatabase {
     return entities.map((e) => e.toModel()).toList();
   }
 
+  /// 按 `(created_at, id)` 降序读取一页历史记录；[before] 为空时返回首页。
+  Future<List<Transcription>> getHistoryPage({
+    required int limit,
+    HistoryCursor? before,
+  }) async {
+    final entities = before == null
+        ? await transcriptionDao.getLatest(limit)
+        : await transcriptionDao.getPageBefore(
+            before.createdAt,
+            before.id,
+            limit,
+          );
+    return entities.map((e) => e.toModel()).toList();
+  }
+
+  /// 逐页遍历全部历史记录，任一时刻只持有一页。
+  Stream<List<Transcription>> historyPages({int pageSize = 500}) async* {
+    HistoryCursor? cursor;
+    while (true) {
+      final page = await getHistoryPage(limit: pageSize, before: cursor);
+      if (page.isEmpty) return;
+      yield page;
+      if (page.length < pageSize) return;
+      cursor = HistoryCursor.after(page.last);
+    }
+  }
+
+  /// 全文检索历史记录，返回带高亮片段的命中结果（最新在前）。
+  ///
+  /// [query] 按空白切分为多个检索词；可传入上一页最后一条的 [before] 翻页。
+  Future<List<HistorySearchHit>> searchHistory(
+    String query, {
+    int limit = 20,
+    HistoryCursor? before,
+    bool matchAny = false,
+  }) {
+    return HistoryFts.search(
+      database,
+      query: query,
+      limit: limit,
+      before: before,
+      matchAny: matchAny,
+      ftsReady: _historyFtsReady,
+    );
+  }
+
+  /// 按日期升序读取每日汇总。
+  Future<List<HistoryDailyStatEntity>> getDailyHistoryStats() {
+    return historyStatDao.getDailyStats();
+  }
+
+  Future<List<HistoryModelUsageEntity>> getHistoryModelUsage() {
+    return historyStatDao.getModelUsage();
+  }
+
+  Future<int> countHistory() async {
+    return (await transcriptionDao.countAll()) ?? 0;
+  }
+
+  /// 返回 [ids] 中仍存在于历史记录表的 id。
+  Future<Set<String>> filterExistingHistoryIds(Iterable<String> ids) async {
+    final all = ids.toList();
+    final existing = <String>{};
+    for (var i = 0; i < all.length; i += _maxInListBatch) {
+      final end = i + _maxInListBatch < all.length
+          ? i + _maxInListBatch
+          : all.length;
+      existing.addAll(
+        await transcriptionDao.findExistingIds(all.sublist(i, end)),
+      );
+    }
+    return existing;
+  }
+
   Future<void> insertHistory(Transcription item) async {
     await transcriptionDao.insertItem(TranscriptionEntity.fromModel(item));
   }
@@ -119,6 +330,37 @@ abstract class AppDatabase extends FloorDatabase {
     await transcriptionDao.deleteAll();
   }
 
+  // ==================== 词典/记忆/实体记录便捷方法 ====================
+
+  /// `IN (...)` 列表单批参数个数，低于 SQLite 默认上限 999。
+  static const int _maxInListBatch = 500;
+
+  /// 按列表顺序读取一个集合的全部记录。
+  Future<List<MemoryRecordEntity>> getMemoryRecords(String collection) {
+    return memoryRecordDao.findByCollection(collection);
+  }
+
+  Future<int> countMemoryRecords(String collection) async {
+    return (await memoryRecordDao.countByCollection(collection)) ?? 0;
+  }
+
+  /// 写入变更行、删除移除的行；删除按批拆分以避开参数上限。
+  Future<void> applyMemoryRecordChanges(
+    String collection, {
+    List<MemoryRecordEntity> upserts = const [],
+    List<String> deletedIds = const [],
+  }) async {
+    if (upserts.isEmpty && deletedIds.isEmpty) return;
+    await memoryRecordDao.applyChanges(collection, upserts, deletedIds);
+  }
+
+  Future<void> replaceMemoryRecords(
+    String collection,
+    List<MemoryRecordEntity> records,
+  ) {
+    return memoryRecordDao.replaceCollection(collection, records);
+  }
+
   // ==================== 数据库迁移 ====================
 
   static final _migrations = [
@@ -171,5 +413,80 @@ abstract class AppDatabase extends FloorDatabase {
         );
       }
     }),
+    Migration(8, 9, (database) async {
+      // 旧版 settings 中的 JSON 数据在首次加载时由 MemoryRecordStore 迁移。
+      await database.execute(
+        'CREATE TABLE IF NOT EXISTS `memory_records` '
+        '(`collection` TEXT NOT NULL, `id` TEXT NOT NULL, '
+        '`normalized_key` TEXT NOT NULL, `enabled` INTEGER NOT NULL, '
+        '`updated_at` INTEGER NOT NULL, `seq` INTEGER NOT NULL, '
+        '`payload` TEXT NOT NULL, PRIMARY KEY (`collection`, `id`))',
+      );
+      await database.execute(
+        'CREATE INDEX IF NOT EXISTS `index_memory_records_collection_normalized_key` '
+        'ON `memory_records` (`collection`, `normalized_key`)',
+      );
+      await database.execute(
+        'CREATE INDEX IF NOT EXISTS `index_memory_records_collection_enabled` '
+        'ON `memory_records` (`collection`, `enabled`)',
+      );
+      await database.execute(
+        'CREATE INDEX IF NOT EXISTS `index_memory_records_collection_updated_at` '
+        'ON `memory_records` (`collection`, `updated_at`)',
+      );
+    }),
+    Migration(9, 10, (database) async {
+      await database.execute(
+        'CREATE INDEX IF NOT EXISTS `index_transcriptions_created_at_id` '
+        'ON `transcriptions` (`created_at`, `id`)',
+      );
+    }),
+    Migration(10, 11, (database) async {
+      await database.execute(
+        'CREATE TABLE IF NOT EXISTS `history_daily_stats` '
+        '(`day` TEXT NOT NULL, `count` INTEGER NOT NULL, '
+        '`duration_ms` INTEGER NOT NULL, `char_count` INTEGER NOT NULL, '
+        '`llm_input_tokens` INTEGER NOT NULL, '
+        '`llm_output_tokens` INTEGER NOT NULL, PRIMARY KEY (`day`))',
+      );
+      await database.execute(
+        'CREATE TABLE IF NOT EXISTS `history_model_usage` '
+        '(`provider` TEXT NOT NULL, `model` TEXT NOT NULL, '
+        '`count` INTEGER NOT NULL, `duration_ms` INTEGER NOT NULL, '
+        '`char_count` INTEGER NOT NULL, `llm_input_tokens` INTEGER NOT NULL, '
+        '`llm_output_tokens` INTEGER NOT NULL, '
+        'PRIMARY KEY (`provider`, `model`))',
+      );
+      await HistoryRollup.createTriggers(database);
+      await HistoryRollup.backfill(database);
+    }),
+    Migration(11, 12, (database) async {
+      await database.execute(
+        'CREATE TABLE IF NOT EXISTS `latency_buckets` '
+        '(`day` TEXT NOT NULL, `stage` TEXT NOT NULL, '
+        '`bucket` INTEGER NOT NULL, `count` INTEGER NOT NULL, '
+        'PRIMARY KEY (`day`, `stage`, `bucket`))',
+      );
+    }),
+    Migration(12, 13, (database) async {
+      await database.execute(
+        'CREATE TABLE IF NOT EXISTS `llm_result_cache` '
+        '(`key` TEXT NOT NULL, `text` TEXT NOT NULL, '
+        '`unchanged` INTEGER NOT NULL, `prompt_tokens` INTEGER NOT NULL, '
+        '`completion_tokens` INTEGER NOT NULL, `size` INTEGER NOT NULL, '
+        '`created_at` INTEGER NOT NULL, `last_used_at` INTEGER NOT NULL, '
+        'PRIMARY KEY (`key`))',
+      );
+      await database.execute(
+        'CREATE INDEX IF NOT EXISTS `index_llm_result_cache_last_used_at` '
+        'ON `llm_result_cache` (`last_used_at`)',
+      );
+    }),
+    Migration(13, 14, (database) async {
+      await database.execute(
+        'CREATE INDEX IF NOT EXISTS `index_memory_records_collection_seq` '
+        'ON `memory_records` (`collection`, `seq`)',
+      );
+    }),
   ];
 }
@@ -72,13 +72,21 @@ class _$AppDatabase extends AppDatabase {
 
   TranscriptionDao? _transcriptionDaoInstance;
 
+  MemoryRecordDao? _memoryRecordDaoInstance;
+
+  HistoryStatDao? _historyStatDaoInstance;
+
+  LatencyBucketDao? _latencyBucketDaoInstance;
+
+  LlmCacheDao? _llmCacheDaoInstance;
+
   Future<sqflite.Database> open(
     String path,
     List<Migration> migrations, [
     Callback? callback,
   ]) async {
     final databaseOptions = sqflite.OpenDatabaseOptions(
-      version: 8,
+      version: 14,
       onConfigure: (database) async {
         await database.execute('PRAGMA foreign_keys = ON');
         await callback?.onConfigure?.call(database);
@@ -103,6 +111,39 @@ class _$AppDatabase extends AppDatabase {
         await database.execute(
           'CREATE TABLE IF NOT EXISTS `transcriptions` (`id` TEXT NOT NULL, `text` TEXT NOT NULL, `raw_text` TEXT, `created_at` TEXT NOT NULL, `duration_ms` INTEGER NOT NULL, `llm_processing_duration_ms` INTEGER, `llm_input_tokens` INTEGER, `llm_output_tokens` INTEGER, `provider` TEXT NOT NULL, `model` TEXT NOT NULL, `provider_config` TEXT NOT NULL, PRIMARY KEY (`id`))',
         );
+        await database.execute(
+          'CREATE TABLE IF NOT EXISTS `memory_records` (`collection` TEXT NOT NULL, `id` TEXT NOT NULL, `normalized_key` TEXT NOT NULL, `enabled` INTEGER NOT NULL, `updated_at` INTEGER NOT NULL, `seq` INTEGER NOT NULL, `payload` TEXT NOT NULL, PRIMARY KEY (`collection`, `id`))',
+        );
+        await database.execute(
+          'CREATE TABLE IF NOT EXISTS `history_daily_stats` (`day` TEXT NOT NULL, `count` INTEGER NOT NULL, `duration_ms` INTEGER NOT NULL, `char_count` INTEGER NOT NULL, `llm_input_tokens` INTEGER NOT NULL, `llm_output_tokens` INTEGER NOT NULL, PRIMARY KEY (`day`))',
+        );
+        await database.execute(
+          'CREATE TABLE IF NOT EXISTS `history_model_usage` (`provider` TEXT NOT NULL, `model` TEXT NOT NULL, `count` INTEGER NOT NULL, `duration_ms` INTEGER NOT NULL, `char_count` INTEGER NOT NULL, `llm_input_tokens` INTEGER NOT NULL, `llm_output_tokens` INTEGER NOT NULL, PRIMARY KEY (`provider`, `model`))',
+        );
+        await database.execute(
+          'CREATE TABLE IF NOT EXISTS `latency_buckets` (`day` TEXT NOT NULL, `stage` TEXT NOT NULL, `bucket` INTEGER NOT NULL, `count` INTEGER NOT NULL, PRIMARY KEY (`day`, `stage`, `bucket`))',
+        );
+        await database.execute(
+          'CREATE TABLE IF NOT EXISTS `llm_result_cache` (`key` TEXT NOT NULL, `text` TEXT NOT NULL, `unchanged` INTEGER NOT NULL, `prompt_tokens` INTEGER NOT NULL, `completion_tokens` INTEGER NOT NULL, `size` INTEGER NOT NULL, `created_at` INTEGER NOT NULL, `last_used_at` INTEGER NOT NULL, PRIMARY KEY (`key`))',
+        );
+        await database.execute(
+          'CREATE INDEX `index_transcriptions_created_at_id` ON `transcriptions` (`created_at`, `id`)',
+        );
+        await database.execute(
+          'CREATE INDEX `index_memory_records_collection_normalized_key` ON `memory_records` (`collection`, `normalized_key`)',
+        );
+        await database.execute(
+          'CREATE INDEX `index_memory_records_collection_enabled` ON `memory_records` (`collection`, `enabled`)',
+        );
+        await database.execute(
+          'CREATE INDEX `index_memory_records_collection_updated_at` ON `memory_records` (`collection`, `updated_at`)',
+        );
+        await database.execute(
+          'CREATE INDEX `index_memory_records_collection_seq` ON `memory_records` (`collection`, `seq`)',
+        );
+        await database.execute(
+          'CREATE INDEX `index_llm_result_cache_last_used_at` ON `llm_result_cache` (`last_used_at`)',
+        );
 
         await callback?.onCreate?.call(database, version);
       },
@@ -122,6 +163,35 @@ class _$AppDatabase extends AppDatabase {
       changeListener,
     );
   }
+
+  @override
+  MemoryRecordDao get memoryRecordDao {
+    return _memoryRecordDaoInstance ??= _$MemoryRecordDao(
+      database,
+      changeListener,
+    );
+  }
+
+  @override
+  HistoryStatDao get historyStatDao {
+    return _historyStatDaoInstance ??= _$HistoryStatDao(
+      database,
+      changeListener,
+    );
+  }
+
+  @override
+  LatencyBucketDao get latencyBucketDao {
+    return _latencyBucketDaoInstance ??= _$LatencyBucketDao(
+      database,
+      changeListener,
+    );
+  }
+
+  @override
+  LlmCacheDao get llmCacheDao {
+    return _llmCacheDaoInstance ??= _$LlmCacheDao(database, changeListener);
+  }
 }
 
 class _$SettingDao extends SettingDao {
@@ -163,6 +233,23 @@ class _$SettingDao extends SettingDao {
     );
   }
 
+  @override
+  Future<List<SettingEntity>> findByKeys(List<String> keys) async {
+    const offset = 1;
+    final _sqliteVariablesForKeys = Iterable<String>.generate(
+      keys.length,
+      (i) => '?${i + offset}',
+    ).join(',');
+    return _queryAdapter.queryList(
+      'SELECT * FROM settings WHERE `key` IN (' +
+          _sqliteVariablesForKeys +
+          ')',
+      mapper: (Map<String, Object?> row) =>
+          SettingEntity(row['key'] as String, row['value'] as String),
+      arguments: [...keys],
+    );
+  }
+
   @override
   Future<void> deleteByKey(String key) async {
     await _queryAdapter.queryNoReturn(
@@ -230,6 +317,76 @@ class _$TranscriptionDao extends TranscriptionDao {
     );
   }
 
+  @override
+  Future<List<TranscriptionEntity>> getLatest(int limit) async {
+    return _queryAdapter.queryList(
+      'SELECT * FROM transcriptions ORDER BY created_at DESC, id DESC LIMIT ?1',
+      mapper: (Map<String, Object?> row) => TranscriptionEntity(
+        id: row['id'] as String,
+        text: row['text'] as String,
+        rawText: row['raw_text'] as String?,
+        createdAt: row['created_at'] as String,
+        durationMs: row['duration_ms'] as int,
+        llmProcessingDurationMs: row['llm_processing_duration_ms'] as int?,
+        llmInputTokens: row['llm_input_tokens'] as int?,
+        llmOutputTokens: row['llm_output_tokens'] as int?,
+        provider: row['provider'] as String,
+        model: row['model'] as String,
+        providerConfig: row['provider_config'] as String,
+      ),
+      arguments: [limit],
+    );
+  }
+
+  @override
+  Future<List<TranscriptionEntity>> getPageBefore(
+    String createdAt,
+    String id,
+    int limit,
+  ) async {
+    return _queryAdapter.queryList(
+      'SELECT * FROM transcriptions WHERE created_at < ?1 OR (created_at = ?1 AND id < ?2) ORDER BY created_at DESC, id DESC LIMIT ?3',
+      mapper: (Map<String, Object?> row) => TranscriptionEntity(
+        id: row['id'] as String,
+        text: row['text'] as String,
+        rawText: row['raw_text'] as String?,
+        createdAt: row['created_at'] as String,
+        durationMs: row['duration_ms'] as int,
+        llmProcessingDurationMs: row['llm_processing_duration_ms'] as int?,
+        llmInputTokens: row['llm_input_tokens'] as int?,
+        llmOutputTokens: row['llm_output_tokens'] as int?,
+        provider: row['provider'] as String,
+        model: row['model'] as String,
+        providerConfig: row['provider_config'] as String,
+      ),
+      arguments: [createdAt, id, limit],
+    );
+  }
+
+  @override
+  Future<int?> countAll() async {
+    return _queryAdapter.query(
+      'SELECT COUNT(*) FROM transcriptions',
+      mapper: (Map<String, Object?> row) => row.values.first as int,
+    );
+  }
+
+  @override
+  Future<List<String>> findExistingIds(List<String> ids) async {
+    const offset = 1;
+    final _sqliteVariablesForIds = Iterable<String>.generate(
+      ids.length,
+      (i) => '?${i + offset}',
+    ).join(',');
+    return _queryAdapter.queryList(
+      'SELECT id FROM transcriptions WHERE id IN (' +
+          _sqliteVariablesForIds +
+          ')',
+      mapper: (Map<String, Object?> row) => row.values.first as String,
+      arguments: [...ids],
+    );
+  }
+
   @override
   Future<void> deleteById(String id) async {
     await _queryAdapter.queryNoReturn(
@@ -251,3 +408,287 @@ class _$TranscriptionDao extends TranscriptionDao {
     );
   }
 }
+
+class _$MemoryRecordDao extends MemoryRecordDao {
+  _$MemoryRecordDao(this.database, this.changeListener)
+    : _queryAdapter = QueryAdapter(database),
+      _memoryRecordEntityInsertionAdapter = InsertionAdapter(
+        database,
+        'memory_records',
+        (MemoryRecordEntity item) => <String, Object?>{
+          'collection': item.collection,
+          'id': item.id,
+          'normalized_key': item.normalizedKey,
+          'enabled': item.enabled ? 1 : 0,
+          'updated_at': item.updatedAt,
+          'seq': item.seq,
+          'payload': item.payload,
+        },
+      );
+
+  final sqflite.DatabaseExecutor database;
+
+  final StreamController<String> changeListener;
+
+  final QueryAdapter _queryAdapter;
+
+  final InsertionAdapter<MemoryRecordEntity>
+  _memoryRecordEntityInsertionAdapter;
+
+  @override
+  Future<List<MemoryRecordEntity>> findByCollection(String collection) async {
+    return _queryAdapter.queryList(
+      'SELECT * FROM memory_records WHERE collection = ?1 ORDER BY seq ASC',
+      mapper: (Map<String, Object?> row) => MemoryRecordEntity(
+        collection: row['collection'] as String,
+        id: row['id'] as String,
+        normalizedKey: row['normalized_key'] as String,
+        enabled: (row['enabled'] as int) != 0,
+        updatedAt: row['updated_at'] as int,
+        seq: row['seq'] as int,
+        payload: row['payload'] as String,
+      ),
+      arguments: [collection],
+    );
+  }
+
+  @override
+  Future<int?> countByCollection(String collection) async {
+    return _queryAdapter.query(
+      'SELECT COUNT(*) FROM memory_records WHERE collection = ?1',
+      mapper: (Map<String, Object?> row) => row.values.first as int,
+      arguments: [collection],
+    );
+  }
+
+  @override
+  Future<void> deleteByIds(String collection, List<String> ids) async {
+    const offset = 2;
+    final _sqliteVariablesForIds = Iterable<String>.generate(
+      ids.length,
+      (i) => '?${i + offset}',
+    ).join(',');
+    await _queryAdapter.queryNoReturn(
+      'DELETE FROM memory_records WHERE collection = ?1 AND id IN (' +
+          _sqliteVariablesForIds +
+          ')',
+      arguments: [collection, ...ids],
+    );
+  }
+
+  @override
+  Future<void> deleteCollection(String collection) async {
+    await _queryAdapter.queryNoReturn(
+      'DELETE FROM memory_records WHERE collection = ?1',
+      arguments: [collection],
+    );
+  }
+
+  @override
+  Future<void> upsertRecords(List<MemoryRecordEntity> records) async {
+    await _memoryRecordEntityInsertionAdapter.insertList(
+      records,
+      OnConflictStrategy.replace,
+    );
+  }
+
+  @override
+  Future<void> applyChanges(
+    String collection,
+    List<MemoryRecordEntity> upserts,
+    List<String> deletedIds,
+  ) async {
+    if (database is sqflite.Transaction) {
+      await super.applyChanges(collection, upserts, deletedIds);
+    } else {
+      await (database as sqflite.Database).transaction<void>((
+        transaction,
+      ) async {
+        final transactionDatabase = _$AppDatabase(changeListener)
+          ..database = transaction;
+        await transactionDatabase.memoryRecordDao.applyChanges(
+          collection,
+          upserts,
+          deletedIds,
+        );
+      });
+    }
+  }
+
+  @override
+  Future<void> replaceCollection(
+    String collection,
+    List<MemoryRecordEntity> records,
+  ) async {
+    if (database is sqflite.Transaction) {
+      await super.replaceCollection(collection, records);
+    } else {
+      await (database as sqflite.Database).transaction<void>((
+        transaction,
+      ) async {
+        final transactionDatabase = _$AppDatabase(changeListener)
+          ..database = transaction;
+        await transactionDatabase.memoryRecordDao.replaceCollection(
+          collection,
+          records,
+        );
+      });
+    }
+  }
+}
+
+class _$HistoryStatDao extends HistoryStatDao {
+  _$HistoryStatDao(this.database, this.changeListener)
+    : _queryAdapter = QueryAdapter(database);
+
+  final sqflite.DatabaseExecutor database;
+
+  final StreamController<String> changeListener;
+
+  final QueryAdapter _queryAdapter;
+
+  @override
+  Future<List<HistoryDailyStatEntity>> getDailyStats() async {
+    return _queryAdapter.queryList(
+      'SELECT * FROM history_daily_stats ORDER BY day ASC',
+      mapper: (Map<String, Object?> row) => HistoryDailyStatEntity(
+        day: row['day'] as String,
+        count: row['count'] as int,
+        durationMs: row['duration_ms'] as int,
+        charCount: row['char_count'] as int,
+        llmInputTokens: row['llm_input_tokens'] as int,
+        llmOutputTokens: row['llm_output_tokens'] as int,
+      ),
+    );
+  }
+
+  @override
+  Future<List<HistoryModelUsageEntity>> getModelUsage() async {
+    return _queryAdapter.queryList(
+      'SELECT * FROM history_model_usage',
+      mapper: (Map<String, Object?> row) => HistoryModelUsageEntity(
+        provider: row['provider'] as String,
+        model: row['model'] as String,
+        count: row['count'] as int,
+        durationMs: row['duration_ms'] as int,
+        charCount: row['char_count'] as int,
+        llmInputTokens: row['llm_input_tokens'] as int,
+        llmOutputTokens: row['llm_output_tokens'] as int,
+      ),
+    );
+  }
+}
+
+class _$LatencyBucketDao extends LatencyBucketDao {
+  _$LatencyBucketDao(this.database, this.changeListener)
+    : _queryAdapter = QueryAdapter(database);
+
+  final sqflite.DatabaseExecutor database;
+
+  final StreamController<String> changeListener;
+
+  final QueryAdapter _queryAdapter;
+
+  @override
+  Future<List<LatencyBucketEntity>> findSince(String day) async {
+    return _queryAdapter.queryList(
+      'SELECT * FROM latency_buckets WHERE day >= ?1',
+      mapper: (Map<String, Object?> row) => LatencyBucketEntity(
+        day: row['day'] as String,
+        stage: row['stage'] as String,
+        bucket: row['bucket'] as int,
+        count: row['count'] as int,
+      ),
+      arguments: [day],
+    );
+  }
+
+  @override
+  Future<void> deleteBefore(String day) async {
+    await _queryAdapter.queryNoReturn(
+      'DELETE FROM latency_buckets WHERE day < ?1',
+      arguments: [day],
+    );
+  }
+}
+
+class _$LlmCacheDao extends LlmCacheDao {
+  _$LlmCacheDao(this.database, this.changeListener)
+    : _queryAdapter = QueryAdapter(database),
+      _llmCacheEntityInsertionAdapter = InsertionAdapter(
+        database,
+        'llm_result_cache',
+        (LlmCacheEntity item) => <String, Object?>{
+          'key': item.key,
+          'text': item.text,
+          'unchanged': item.unchanged ? 1 : 0,
+          'prompt_tokens': item.promptTokens,
+          'completion_tokens': item.completionTokens,
+          'size': item.size,
+          'created_at': item.createdAt,
+          'last_used_at': item.lastUsedAt,
+        },
+      );
+
+  final sqflite.DatabaseExecutor database;
+
+  final StreamController<String> changeListener;
+
+  final QueryAdapter _queryAdapter;
+
+  final InsertionAdapter<LlmCacheEntity> _llmCacheEntityInsertionAdapter;
+
+  @override
+  Future<LlmCacheEntity?> findByKey(String key) async {
+    return _queryAdapter.query(
+      'SELECT * FROM llm_result_cache WHERE `key` = ?1',
+      mapper: (Map<String, Object?> row) => LlmCacheEntity(
+        key: row['key'] as String,
+        text: row['text'] as String,
+        unchanged: (row['unchanged'] as int) != 0,
+        promptTokens: row['prompt_tokens'] as int,
+        completionTokens: row['completion_tokens'] as int,
+        size: row['size'] as int,
+        createdAt: row['created_at'] as int,
+        lastUsedAt: row['last_used_at'] as int,
+      ),
+      arguments: [key],
+    );
+  }
+
+  @override
+  Future<void> touch(String key, int usedAt) async {
+    await _queryAdapter.queryNoReturn(
+      'UPDATE llm_result_cache SET last_used_at = ?2 WHERE `key` = ?1',
+      arguments: [key, usedAt],
+    );
+  }
+
+  @override
+  Future<void> deleteByKeys(List<String> keys) async {
+    const offset = 1;
+    final _sqliteVariablesForKeys = Iterable<String>.generate(
+      keys.length,
+      (i) => '?${i + offset}',
+    ).join(',');
+    await _queryAdapter.queryNoReturn(
+      'DELETE FROM llm_result_cache WHERE `key` IN (' +
+          _sqliteVariablesForKeys +
+          ')',
+      arguments: [...keys],
+    );
+  }
+
+  @override
+  Future<void> deleteAll() async {
+    await _queryAdapter.queryNoReturn('DELETE FROM llm_result_cache');
+  }
+
+  @override
+  Future<void> upsertEntry(LlmCacheEntity entry) async {
+    await _llmCacheEntityInsertionAdapter.insert(
+      entry,
+      OnConflictStrategy.replace,
+    );
+  }
+}
@@ -0,0 +1,202 @@
+import 'package:sqflite/sqflite.dart' as sqflite;
+import '../models/history_cursor.dart';
+import '../models/history_search_hit.dart';
+import 'transcription_entity.dart';
+
+/// 转录历史的 FTS5 全文索引。
+///
+/// `transcriptions_fts` 以 `transcriptions` 为外部内容表，通过触发器随插入、
+/// 更新与删除同步。分词器使用 trigram，可直接检索无空格分隔的中日韩文本；
+/// trigram 无法索引少于 3 个字符的词，这类词改用 LIKE 过滤。
+///
+/// 系统 SQLite 未编译 FTS5 或版本过旧（不支持 trigram）时建表失败，
+/// 检索整体退化为 LIKE 扫描，结果一致但速度较慢。
+class HistoryFts {
+  HistoryFts._();
+
+  static const String table = 'transcriptions_fts';
+
+  /// trigram 分词器可索引的最短词长。
+  static const int minIndexedTermLength = 3;
+
+  static const int _snippetTokens = 24;
+  static const String _ellipsis = '…';
+
+  /// 创建全文索引与同步触发器；首次创建时从现有记录重建索引。
+  ///
+  /// 返回索引是否可用。
+  static Future<bool> ensure(sqflite.Database db) async {
+    try {
+      final existing = await db.rawQuery(
+        "SELECT name FROM sqlite_master WHERE type = 'table' AND name = ?",
+        [table],
+      );
+      await db.execute(
+        'CREATE VIRTUAL TABLE IF NOT EXISTS `$table` USING fts5('
+        'text, raw_text, '
+        "content = 'transcriptions', tokenize = 'trigram')",
+      );
+      await db.execute(
+        'CREATE TRIGGER IF NOT EXISTS `${table}_ai` '
+        'AFTER INSERT ON `transcriptions` BEGIN '
+        'INSERT INTO `$table` (rowid, text, raw_text) '
+        'VALUES (new.rowid, new.text, new.raw_text); '
+        'END',
+      );
+      await db.execute(
+        'CREATE TRIGGER IF NOT EXISTS `${table}_ad` '
+        'AFTER DELETE ON `transcriptions` BEGIN '
+        'INSERT INTO `$table` (`$table`, rowid, text, raw_text) '
+        "VALUES ('delete', old.rowid, old.text, old.raw_text); "
+        'END',
+      );
+      await db.execute(
+        'CREATE TRIGGER IF NOT EXISTS `${table}_au` '
+        'AFTER UPDATE ON `transcriptions` BEGIN '
+        'INSERT INTO `$table` (`$table`, rowid, text, raw_text) '
+        "VALUES ('delete', old.rowid, old.text, old.raw_text); "
+        'INSERT INTO `$table` (rowid, text, raw_text) '
+        'VALUES (new.rowid, new.text, new.raw_text); '
+        'END',
+      );
+      if (existing.isEmpty) {
+        await db.execute("INSERT INTO `$table` (`$table`) VALUES ('rebuild')");
+      }
+      return true;
+    } catch (_) {
+      return false;
+    }
+  }
+
+  /// 按空白切分的检索词查询历史记录，结果按 `(created_at, id)` 降序，
+  /// 可用 [before] 继续翻页。
+  ///
+  /// 默认要求命中全部检索词；[matchAny] 为 true 时命中任一即可。
+  static Future<List<HistorySearchHit>> search(
+    sqflite.DatabaseExecutor db, {
+    required String query,
+    required int limit,
+    required bool ftsReady,
+    HistoryCursor? before,
+    bool matchAny = false,
+  }) async {
+    final terms = splitTerms(query);
+    if (terms.isEmpty || limit <= 0) return const [];
+
+    final indexed = ftsReady
+        ? terms.where((t) => t.length >= minIndexedTermLength).toList()
+        : const <String>[];
+    // 任一匹配模式下，只要有可索引的词就不再用短词扩大结果集。
+    final filtered = indexed.isEmpty
+        ? terms
+        : matchAny
+        ? const <String>[]
+        : terms.where((t) => t.length < minIndexedTermLength).toList();
+
+    final where = <String>[];
+    final args = <Object?>[];
+    String sql;
+    if (indexed.isNotEmpty) {
+      sql =
+          'SELECT t.*, snippet(`$table`, -1, ?, ?, ?, $_snippetTokens) '
+          'AS snippet FROM `$table` '
+          'JOIN transcriptions t ON t.rowid = `$table`.rowid';
+      args.addAll([
+        HistorySearchHit.highlightStart,
+        HistorySearchHit.highlightEnd,
+        _ellipsis,
+      ]);
+      where.add('`$table` MATCH ?');
+      args.add(
+        indexed.map(_quotePhrase).join(matchAny ? ' OR ' : ' AND '),
+      );
+    } else {
+      sql = 'SELECT t.* FROM transcriptions t';
+    }
+
+    if (filtered.isNotEmpty) {
+      final likes = <String>[];
+      for (final term in filtered) {
+        likes.add(
+          "(t.text LIKE ? ESCAPE '\\' OR t.raw_text LIKE ? ESCAPE '\\')",
+        );
+        final pattern = '%${_escapeLike(term)}%';
+        args
+          ..add(pattern)
+          ..add(pattern);
+      }
+      where.add('(${likes.join(matchAny ? ' OR ' : ' AND ')})');
+    }
+    if (before != null) {
+      where.add('(t.created_at < ? OR (t.created_at = ? AND t.id < ?))');
+      args.addAll([before.createdAt, before.createdAt, before.id]);
+    }
+    sql +=
+        ' WHERE ${where.join(' AND ')} '
+        'ORDER BY t.created_at DESC, t.id DESC LIMIT ?';
+    args.add(limit);
+
+    final rows = await db.rawQuery(sql, args);
+    return [
+      for (final row in rows)
+        _toHit(row, indexed.isNotEmpty ? null : terms),
+    ];
+  }
+
+  /// 按空白切分并去重检索词。
+  static List<String> splitTerms(String query) {
+    final seen = <String>{};
+    final terms = <String>[];
+    for (final part in query.trim().split(RegExp(r'\s+'))) {
+      if (part.isEmpty) continue;
+      if (seen.add(part.toLowerCase())) terms.add(part);
+    }
+    return terms;
+  }
+
+  static HistorySearchHit _toHit(
+    Map<String, Object?> row,
+    List<String>? likeTerms,
+  ) {
+    final item = TranscriptionEntity.fromRow(row).toModel();
+    final snippet = likeTerms == null
+        ? (row['snippet'] as String? ?? '')
+        : _likeSnippet(item.text, item.rawText, likeTerms);
+    return HistorySearchHit(item: item, snippet: snippet);
+  }
+
+  /// LIKE 检索没有 FTS 的 snippet()，在 Dart 侧截取首个命中位置附近的片段。
+  static String _likeSnippet(String text, String? rawText, List<String> terms) {
+    for (final source in [text, rawText ?? '']) {
+      final lower = source.toLowerCase();
+      for (final term in terms) {
+        final start = lower.indexOf(term.toLowerCase());
+        if (start < 0) continue;
+        final end = start + term.length;
+        const context = _snippetTokens ~/ 2;
+        final from = start - context < 0 ? 0 : start - context;
+        final to = end + context > source.length
+            ? source.length
+            : end + context;
+        return '${from > 0 ? _ellipsis : ''}'
+            '${source.substring(from, start)}'
+            '${HistorySearchHit.highlightStart}'
+            '${source.substring(start, end)}'
+            '${HistorySearchHit.highlightEnd}'
+            '${source.substring(end, to)}'
+            '${to < source.length ? _ellipsis : ''}';
+      }
+    }
+    return text.length > _snippetTokens
+        ? '${text.substring(0, _snippetTokens)}$_ellipsis'
+        : text;
+  }
+
+  static String _quotePhrase(String term) =>
+      '"${term.replaceAll('"', '""')}"';
+
+  static String _escapeLike(String term) => term
+      .replaceAll('\\', '\\\\')
+      .replaceAll('%', '\\%')
+      .replaceAll('_', '\\_');
+}
@@ -0,0 +1,97 @@
+import 'package:sqflite/sqflite.dart' as sqflite;
+
+/// 维护 `history_daily_stats` 与 `history_model_usage` 汇总表的触发器。
+///
+/// 汇总随 `transcriptions` 的每次写入在同一语句事务内更新；
+/// INSERT OR REPLACE 依赖 recursive_triggers 先触发旧行的删除触发器。
+/// 字符数使用 SQLite 的 `length()`，按 Unicode 码点计数。
+class HistoryRollup {
+  HistoryRollup._();
+
+  /// 日期键取 `created_at` 的前 10 个字符（本地日期）。
+  static String _dayOf(String row) => 'substr($row.created_at, 1, 10)';
+
+  static const List<String> _sumColumns = [
+    'duration_ms',
+    'char_count',
+    'llm_input_tokens',
+    'llm_output_tokens',
+  ];
+
+  /// 与 [_sumColumns] 一一对应的取值表达式。
+  static List<String> _values(String row) => [
+    '$row.duration_ms',
+    'length($row.text)',
+    'coalesce($row.llm_input_tokens, 0)',
+    'coalesce($row.llm_output_tokens, 0)',
+  ];
+
+  static String _addSql(String row) {
+    final day = _dayOf(row);
+    final updates = [
+      'count = count + 1',
+      for (final c in _sumColumns) '$c = $c + excluded.$c',
+    ].join(', ');
+    final columns = _sumColumns.join(', ');
+    final values = _values(row).join(', ');
+    return 'INSERT INTO history_daily_stats (day, count, $columns) '
+        'VALUES ($day, 1, $values) '
+        'ON CONFLICT (day) DO UPDATE SET $updates; '
+        'INSERT INTO history_model_usage (provider, model, count, $columns) '
+        'VALUES ($row.provider, $row.model, 1, $values) '
+        'ON CONFLICT (provider, model) DO UPDATE SET $updates;';
+  }
+
+  static String _subtractSql(String row) {
+    final day = _dayOf(row);
+    final values = _values(row);
+    final updates = [
+      'count = count - 1',
+      for (var i = 0; i < _sumColumns.length; i++)
+        '${_sumColumns[i]} = ${_sumColumns[i]} - ${values[i]}',
+    ].join(', ');
+    final modelWhere = 'provider = $row.provider AND model = $row.model';
+    return 'UPDATE history_daily_stats SET $updates WHERE day = $day; '
+        'DELETE FROM history_daily_stats WHERE day = $day AND count <= 0; '
+        'UPDATE history_model_usage SET $updates WHERE $modelWhere; '
+        'DELETE FROM history_model_usage WHERE $modelWhere AND count <= 0;';
+  }
+
+  /// 创建同步触发器（幂等）。
+  static Future<void> createTriggers(sqflite.DatabaseExecutor db) async {
+    await db.execute(
+      'CREATE TRIGGER IF NOT EXISTS `history_rollup_ai` '
+      'AFTER INSERT ON `transcriptions` BEGIN ${_addSql('new')} END',
+    );
+    await db.execute(
+      'CREATE TRIGGER IF NOT EXISTS `history_rollup_ad` '
+      'AFTER DELETE ON `transcriptions` BEGIN ${_subtractSql('old')} END',
+    );
+    await db.execute(
+      'CREATE TRIGGER IF NOT EXISTS `history_rollup_au` '
+      'AFTER UPDATE OF text, created_at, duration_ms, llm_input_tokens, '
+      'llm_output_tokens, provider, model ON `transcriptions` BEGIN '
+      '${_subtractSql('old')} ${_addSql('new')} END',
+    );
+  }
+
+  /// 由现有记录重建汇总表，用于升级迁移。
+  static Future<void> backfill(sqflite.DatabaseExecutor db) async {
+    final columns = _sumColumns.join(', ');
+    final sums = _values(
+      'transcriptions',
+    ).map((value) => 'SUM($value)').join(', ');
+    await db.execute('DELETE FROM history_daily_stats');
+    await db.execute('DELETE FROM history_model_usage');
+    await db.execute(
+      'INSERT INTO history_daily_stats (day, count, $columns) '
+      "SELECT ${_dayOf('transcriptions')}, COUNT(*), $sums "
+      'FROM transcriptions GROUP BY 1',
+    );
+    await db.execute(
+      'INSERT INTO history_model_usage (provider, model, count, $columns) '
+      'SELECT provider, model, COUNT(*), $sums '
+      'FROM transcriptions GROUP BY provider, model',
+    );
+  }
+}
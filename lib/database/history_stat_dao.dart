@@ -0,0 +1,12 @@
+import 'package:floor/floor.dart';
+import 'history_stat_entity.dart';
+
+/// 转录汇总统计表的 DAO，只读；数据由触发器维护。
+@dao
+abstract class HistoryStatDao {
+  @Query('SELECT * FROM history_daily_stats ORDER BY day ASC')
+  Future<List<HistoryDailyStatEntity>> getDailyStats();
+
+  @Query('SELECT * FROM history_model_usage')
+  Future<List<HistoryModelUsageEntity>> getModelUsage();
+}
@@ -0,0 +1,66 @@
+import 'package:floor/floor.dart';
+
+/// 按天汇总的转录统计，对应 `history_daily_stats` 表。
+///
+/// 由 `transcriptions` 上的触发器在插入、更新与删除时增量维护。
+@Entity(tableName: 'history_daily_stats')
+class HistoryDailyStatEntity {
+  /// 本地日期，格式 `yyyy-MM-dd`（即 `created_at` 的前 10 个字符）。
+  @primaryKey
+  final String day;
+
+  final int count;
+
+  @ColumnInfo(name: 'duration_ms')
+  final int durationMs;
+
+  @ColumnInfo(name: 'char_count')
+  final int charCount;
+
+  @ColumnInfo(name: 'llm_input_tokens')
+  final int llmInputTokens;
+
+  @ColumnInfo(name: 'llm_output_tokens')
+  final int llmOutputTokens;
+
+  HistoryDailyStatEntity({
+    required this.day,
+    required this.count,
+    required this.durationMs,
+    required this.charCount,
+    required this.llmInputTokens,
+    required this.llmOutputTokens,
+  });
+}
+
+/// 按服务商与模型汇总的转录统计，对应 `history_model_usage` 表。
+@Entity(tableName: 'history_model_usage', primaryKeys: ['provider', 'model'])
+class HistoryModelUsageEntity {
+  final String provider;
+
+  final String model;
+
+  final int count;
+
+  @ColumnInfo(name: 'duration_ms')
+  final int durationMs;
+
+  @ColumnInfo(name: 'char_count')
+  final int charCount;
+
+  @ColumnInfo(name: 'llm_input_tokens')
+  final int llmInputTokens;
+
+  @ColumnInfo(name: 'llm_output_tokens')
+  final int llmOutputTokens;
+
+  HistoryModelUsageEntity({
+    required this.provider,
+    required this.model,
+    required this.count,
+    required this.durationMs,
+    required this.charCount,
+    required this.llmInputTokens,
+    required this.llmOutputTokens,
+  });
+}
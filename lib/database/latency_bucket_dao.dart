@@ -0,0 +1,12 @@
+import 'package:floor/floor.dart';
+import 'latency_bucket_entity.dart';
+
+/// 阶段耗时直方图的 DAO；写入在 `AppDatabase` 中以 SQL 累加完成。
+@dao
+abstract class LatencyBucketDao {
+  @Query('SELECT * FROM latency_buckets WHERE day >= :day')
+  Future<List<LatencyBucketEntity>> findSince(String day);
+
+  @Query('DELETE FROM latency_buckets WHERE day < :day')
+  Future<void> deleteBefore(String day);
+}
@@ -0,0 +1,24 @@
+import 'package:floor/floor.dart';
+
+/// 流水线各阶段耗时直方图的一个桶，对应 `latency_buckets` 表。
+///
+/// 每行是某天某阶段落在 [bucket] 内的样本数；桶的边界由
+/// `LatencyHistogram` 定义，只存非空桶。
+@Entity(tableName: 'latency_buckets', primaryKeys: ['day', 'stage', 'bucket'])
+class LatencyBucketEntity {
+  /// 本地日期，格式 `yyyy-MM-dd`。
+  final String day;
+
+  final String stage;
+
+  final int bucket;
+
+  final int count;
+
+  LatencyBucketEntity({
+    required this.day,
+    required this.stage,
+    required this.bucket,
+    required this.count,
+  });
+}
@@ -0,0 +1,23 @@
+import 'package:floor/floor.dart';
+import 'llm_cache_entity.dart';
+
+/// LLM 结果缓存表的 DAO；淘汰在 `AppDatabase` 中按 LRU 顺序完成。
+@dao
+abstract class LlmCacheDao {
+  @Query('SELECT * FROM llm_result_cache WHERE `key` = :key')
+  Future<LlmCacheEntity?> findByKey(String key);
+
+  @Insert(onConflict: OnConflictStrategy.replace)
+  Future<void> upsertEntry(LlmCacheEntity entry);
+
+  @Query(
+    'UPDATE llm_result_cache SET last_used_at = :usedAt WHERE `key` = :key',
+  )
+  Future<void> touch(String key, int usedAt);
+
+  @Query('DELETE FROM llm_result_cache WHERE `key` IN (:keys)')
+  Future<void> deleteByKeys(List<String> keys);
+
+  @Query('DELETE FROM llm_result_cache')
+  Future<void> deleteAll();
+}
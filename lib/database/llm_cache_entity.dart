@@ -0,0 +1,48 @@
+import 'package:floor/floor.dart';
+
+/// 一条 LLM 结果缓存，对应 `llm_result_cache` 表。
+///
+/// [key] 是请求内容的 SHA-256（见 `LlmResultCache.keyFor`）。[unchanged]
+/// 为 true 时表示模型原样返回了输入（负缓存），[text] 留空。
+@Entity(
+  tableName: 'llm_result_cache',
+  indices: [
+    Index(value: ['last_used_at']),
+  ],
+)
+class LlmCacheEntity {
+  @primaryKey
+  final String key;
+
+  final String text;
+
+  final bool unchanged;
+
+  /// 原请求消耗的 token，命中时计为节省量。
+  @ColumnInfo(name: 'prompt_tokens')
+  final int promptTokens;
+
+  @ColumnInfo(name: 'completion_tokens')
+  final int completionTokens;
+
+  /// 行占用的字节数（按 UTF-8 估算），用于容量上限。
+  final int size;
+
+  /// 写入与最近命中时间（毫秒时间戳），按后者做 LRU 淘汰。
+  @ColumnInfo(name: 'created_at')
+  final int createdAt;
+
+  @ColumnInfo(name: 'last_used_at')
+  final int lastUsedAt;
+
+  LlmCacheEntity({
+    required this.key,
+    required this.text,
+    required this.unchanged,
+    required this.promptTokens,
+    required this.completionTokens,
+    required this.size,
+    required this.createdAt,
+    required this.lastUsedAt,
+  });
+}
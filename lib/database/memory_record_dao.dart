@@ -0,0 +1,60 @@
+import 'package:floor/floor.dart';
+import 'memory_record_entity.dart';
+
+/// 词典、记忆与实体记录表的 DAO（数据访问对象）。
+@dao
+abstract class MemoryRecordDao {
+  /// 单条 DELETE 语句 `IN` 列表的上限，超出时在同一事务内分批删除。
+  static const int maxDeleteBatch = 500;
+
+  @Query(
+    'SELECT * FROM memory_records WHERE collection = :collection '
+    'ORDER BY seq ASC',
+  )
+  Future<List<MemoryRecordEntity>> findByCollection(String collection);
+
+  @Query('SELECT COUNT(*) FROM memory_records WHERE collection = :collection')
+  Future<int?> countByCollection(String collection);
+
+  @Insert(onConflict: OnConflictStrategy.replace)
+  Future<void> upsertRecords(List<MemoryRecordEntity> records);
+
+  @Query(
+    'DELETE FROM memory_records WHERE collection = :collection '
+    'AND id IN (:ids)',
+  )
+  Future<void> deleteByIds(String collection, List<String> ids);
+
+  @Query('DELETE FROM memory_records WHERE collection = :collection')
+  Future<void> deleteCollection(String collection);
+
+  /// 在同一事务内写入变更行并删除移除的行。
+  @transaction
+  Future<void> applyChanges(
+    String collection,
+    List<MemoryRecordEntity> upserts,
+    List<String> deletedIds,
+  ) async {
+    for (var i = 0; i < deletedIds.length; i += maxDeleteBatch) {
+      final end = i + maxDeleteBatch < deletedIds.length
+          ? i + maxDeleteBatch
+          : deletedIds.length;
+      await deleteByIds(collection, deletedIds.sublist(i, end));
+    }
+    if (upserts.isNotEmpty) {
+      await upsertRecords(upserts);
+    }
+  }
+
+  /// 以 [records] 整体替换一个集合（用于旧版数据迁移）。
+  @transaction
+  Future<void> replaceCollection(
+    String collection,
+    List<MemoryRecordEntity> records,
+  ) async {
+    await deleteCollection(collection);
+    if (records.isNotEmpty) {
+      await upsertRecords(records);
+    }
+  }
+}
@@ -0,0 +1,45 @@
+import 'package:floor/floor.dart';
+
+/// 词典、记忆与实体数据的行级记录，对应 `memory_records` 表。
+///
+/// 每种数据以 [collection] 区分，一条模型对象对应一行；[payload] 保存该对象的
+/// JSON，常用过滤字段单独成列并建立索引。
+@Entity(
+  tableName: 'memory_records',
+  primaryKeys: ['collection', 'id'],
+  indices: [
+    Index(value: ['collection', 'normalized_key']),
+    Index(value: ['collection', 'enabled']),
+    Index(value: ['collection', 'updated_at']),
+    Index(value: ['collection', 'seq']),
+  ],
+)
+class MemoryRecordEntity {
+  final String collection;
+
+  final String id;
+
+  @ColumnInfo(name: 'normalized_key')
+  final String normalizedKey;
+
+  final bool enabled;
+
+  /// 最近更新时间（毫秒时间戳）。
+  @ColumnInfo(name: 'updated_at')
+  final int updatedAt;
+
+  /// 列表内顺序，加载时按升序还原。
+  final int seq;
+
+  final String payload;
+
+  MemoryRecordEntity({
+    required this.collection,
+    required this.id,
+    required this.normalizedKey,
+    required this.enabled,
+    required this.updatedAt,
+    required this.seq,
+    required this.payload,
+  });
+}
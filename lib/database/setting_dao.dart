@@ -10,6 +10,9 @@ abstract class SettingDao {
   @Query('SELECT * FROM settings')
   Future<List<SettingEntity>> getAll();
 
+  @Query('SELECT * FROM settings WHERE `key` IN (:keys)')
+  Future<List<SettingEntity>> findByKeys(List<String> keys);
+
   @Insert(onConflict: OnConflictStrategy.replace)
   Future<void> insertSetting(SettingEntity setting);
 
@@ -7,6 +7,31 @@ abstract class TranscriptionDao {
   @Query('SELECT * FROM transcriptions ORDER BY created_at DESC')
   Future<List<TranscriptionEntity>> getAll();
 
+  /// 最新的 [limit] 条记录（分页首页）。
+  @Query(
+    'SELECT * FROM transcriptions ORDER BY created_at DESC, id DESC '
+    'LIMIT :limit',
+  )
+  Future<List<TranscriptionEntity>> getLatest(int limit);
+
+  /// 排在 `(createdAt, id)` 之后的 [limit] 条记录（键集分页）。
+  @Query(
+    'SELECT * FROM transcriptions WHERE created_at < :createdAt '
+    'OR (created_at = :createdAt AND id < :id) '
+    'ORDER BY created_at DESC, id DESC LIMIT :limit',
+  )
+  Future<List<TranscriptionEntity>> getPageBefore(
+    String createdAt,
+    String id,
+    int limit,
+  );
+
+  @Query('SELECT COUNT(*) FROM transcriptions')
+  Future<int?> countAll();
+
+  @Query('SELECT id FROM transcriptions WHERE id IN (:ids)')
+  Future<List<String>> findExistingIds(List<String> ids);
+
   @Insert(onConflict: OnConflictStrategy.replace)
   Future<void> insertItem(TranscriptionEntity item);
 
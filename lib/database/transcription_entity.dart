@@ -2,7 +2,12 @@ import 'package:floor/floor.dart';
 import '../models/transcription.dart';
 
 /// 转录历史记录实体，对应 `transcriptions` 表。
-@Entity(tableName: 'transcriptions')
+@Entity(
+  tableName: 'transcriptions',
+  indices: [
+    Index(value: ['created_at', 'id']),
+  ],
+)
 class TranscriptionEntity {
   @primaryKey
   final String id;
@@ -48,12 +53,29 @@ class TranscriptionEntity {
     required this.providerConfig,
   });
 
+  /// 从原始查询结果行创建，供 DAO 之外的手写 SQL 使用。
+  factory TranscriptionEntity.fromRow(Map<String, Object?> row) =>
+      TranscriptionEntity(
+        id: row['id'] as String,
+        text: row['text'] as String,
+        rawText: row['raw_text'] as String?,
+        createdAt: row['created_at'] as String,
+        durationMs: row['duration_ms'] as int,
+        llmProcessingDurationMs: row['llm_processing_duration_ms'] as int?,
+        llmInputTokens: row['llm_input_tokens'] as int?,
+        llmOutputTokens: row['llm_output_tokens'] as int?,
+        provider: row['provider'] as String,
+        model: row['model'] as String,
+        providerConfig: row['provider_config'] as String,
+      );
+
   /// 转换为领域模型。
   Transcription toModel() => Transcription(
     id: id,
     text: text,
     rawText: rawText,
     createdAt: DateTime.parse(createdAt),
+    storedCreatedAt: createdAt,
     duration: Duration(milliseconds: durationMs),
     llmProcessingDuration: llmProcessingDurationMs == null
         ? null
@@ -70,7 +92,7 @@ class TranscriptionEntity {
     id: t.id,
     text: t.text,
     rawText: t.rawText,
-    createdAt: t.createdAt.toIso8601String(),
+    createdAt: t.storedCreatedAt ?? t.createdAt.toIso8601String(),
     durationMs: t.duration.inMilliseconds,
     llmProcessingDurationMs: t.llmProcessingDuration?.inMilliseconds,
     llmInputTokens: t.llmInputTokens,
@@ -1268,6 +1268,84 @@ abstract class AppLocalizations {
   /// **'All requests connect directly without any proxy.'**
   String get noProxySubtitle;
 
+  /// No description provided for @providerRoutingEnabled.
+  ///
+  /// In en, this message translates to:
+  /// **'Choose Service Automatically'**
+  String get providerRoutingEnabled;
+
+  /// No description provided for @providerRoutingDescription.
+  ///
+  /// In en, this message translates to:
+  /// **'Pick the fastest available service among the added models, in model list order. Services that keep failing are paused, and the local model is used when every cloud service is unavailable.'**
+  String get providerRoutingDescription;
+
+  /// No description provided for @requestHedgingEnabled.
+  ///
+  /// In en, this message translates to:
+  /// **'Request Hedging'**
+  String get requestHedgingEnabled;
+
+  /// No description provided for @requestHedgingDescription.
+  ///
+  /// In en, this message translates to:
+  /// **'When cloud recognition or correction has not returned after its recent p90 latency, send a second request and use whichever returns first. Extra requests stay under about 10%.'**
+  String get requestHedgingDescription;
+
+  /// No description provided for @sttHedgeBackup.
+  ///
+  /// In en, this message translates to:
+  /// **'Speech Recognition Backup'**
+  String get sttHedgeBackup;
+
+  /// No description provided for @aiHedgeBackup.
+  ///
+  /// In en, this message translates to:
+  /// **'Text Model Backup'**
+  String get aiHedgeBackup;
+
+  /// No description provided for @hedgeBackupSameService.
+  ///
+  /// In en, this message translates to:
+  /// **'Same service'**
+  String get hedgeBackupSameService;
+
+  /// No description provided for @latencyBudgetTitle.
+  ///
+  /// In en, this message translates to:
+  /// **'Output Latency Budget'**
+  String get latencyBudgetTitle;
+
+  /// No description provided for @latencyBudgetDescription.
+  ///
+  /// In en, this message translates to:
+  /// **'Text must be typed within this time after the hotkey is released. Corrections and enhancements that recent latency says cannot finish in time are skipped, and the locally corrected text is typed instead.'**
+  String get latencyBudgetDescription;
+
+  /// No description provided for @latencyBudgetUnlimited.
+  ///
+  /// In en, this message translates to:
+  /// **'No limit'**
+  String get latencyBudgetUnlimited;
+
+  /// No description provided for @latencyBudgetSeconds.
+  ///
+  /// In en, this message translates to:
+  /// **'{value} s'**
+  String latencyBudgetSeconds(String value);
+
+  /// No description provided for @lateCorrectionEnabled.
+  ///
+  /// In en, this message translates to:
+  /// **'Finish Corrections After Output'**
+  String get lateCorrectionEnabled;
+
+  /// No description provided for @lateCorrectionDescription.
+  ///
+  /// In en, this message translates to:
+  /// **'Skipped corrections and enhancements finish in the background and update the history.'**
+  String get lateCorrectionDescription;
+
   /// No description provided for @inputMonitoringRequired.
   ///
   /// In en, this message translates to:
@@ -1664,6 +1742,24 @@ abstract class AppLocalizations {
   /// **'Candidate Selection Rate'**
   String get correctionSelectedRate;
 
+  /// No description provided for @correctionLocalRewrites.
+  ///
+  /// In en, this message translates to:
+  /// **'Local Rewrites'**
+  String get correctionLocalRewrites;
+
+  /// No description provided for @correctionLlmAvoidedRate.
+  ///
+  /// In en, this message translates to:
+  /// **'LLM Avoided Rate'**
+  String get correctionLlmAvoidedRate;
+
+  /// No description provided for @correctionShadowMismatchRate.
+  ///
+  /// In en, this message translates to:
+  /// **'Shadow Check Mismatch Rate'**
+  String get correctionShadowMismatchRate;
+
   /// No description provided for @correctionChangesTitle.
   ///
   /// In en, this message translates to:
@@ -1730,6 +1826,180 @@ abstract class AppLocalizations {
   /// **'All Tokens Summary'**
   String get allTokenUsage;
 
+  /// No description provided for @llmCacheHits.
+  ///
+  /// In en, this message translates to:
+  /// **'Cache hits'**
+  String get llmCacheHits;
+
+  /// No description provided for @llmCacheHitSummary.
+  ///
+  /// In en, this message translates to:
+  /// **'{rate}, saved {saved}'**
+  String llmCacheHitSummary(String rate, String saved);
+
+  /// No description provided for @promptPrefixCache.
+  ///
+  /// In en, this message translates to:
+  /// **'Prefix cache'**
+  String get promptPrefixCache;
+
+  /// No description provided for @pipelineLatencyTitle.
+  ///
+  /// In en, this message translates to:
+  /// **'Pipeline latency (last {days} days)'**
+  String pipelineLatencyTitle(int days);
+
+  /// No description provided for @exportTrace.
+  ///
+  /// In en, this message translates to:
+  /// **'Export trace'**
+  String get exportTrace;
+
+  /// No description provided for @traceExported.
+  ///
+  /// In en, this message translates to:
+  /// **'Exported to {path}'**
+  String traceExported(String path);
+
+  /// No description provided for @traceExportFailed.
+  ///
+  /// In en, this message translates to:
+  /// **'Export failed'**
+  String get traceExportFailed;
+
+  /// No description provided for @latencyStage.
+  ///
+  /// In en, this message translates to:
+  /// **'Stage'**
+  String get latencyStage;
+
+  /// No description provided for @latencyCount.
+  ///
+  /// In en, this message translates to:
+  /// **'Count'**
+  String get latencyCount;
+
+  /// No description provided for @latencyModel.
+  ///
+  /// In en, this message translates to:
+  /// **'Model'**
+  String get latencyModel;
+
+  /// No description provided for @firstTokenP50.
+  ///
+  /// In en, this message translates to:
+  /// **'TTFT P50'**
+  String get firstTokenP50;
+
+  /// No description provided for @firstTokenP90.
+  ///
+  /// In en, this message translates to:
+  /// **'TTFT P90'**
+  String get firstTokenP90;
+
+  /// No description provided for @outputSpeed.
+  ///
+  /// In en, this message translates to:
+  /// **'Output speed'**
+  String get outputSpeed;
+
+  /// No description provided for @modelStreamLatencyTitle.
+  ///
+  /// In en, this message translates to:
+  /// **'Streaming output by model (all time)'**
+  String get modelStreamLatencyTitle;
+
+  /// No description provided for @pipelineStageHotkey.
+  ///
+  /// In en, this message translates to:
+  /// **'Hotkey response'**
+  String get pipelineStageHotkey;
+
+  /// No description provided for @pipelineStageRecorderStop.
+  ///
+  /// In en, this message translates to:
+  /// **'Stop recording'**
+  String get pipelineStageRecorderStop;
+
+  /// No description provided for @pipelineStageSegmentWait.
+  ///
+  /// In en, this message translates to:
+  /// **'Segment wait'**
+  String get pipelineStageSegmentWait;
+
+  /// No description provided for @pipelineStageStt.
+  ///
+  /// In en, this message translates to:
+  /// **'Speech recognition'**
+  String get pipelineStageStt;
+
+  /// No description provided for @pipelineStageCorrectionLocal.
+  ///
+  /// In en, this message translates to:
+  /// **'Correction (local)'**
+  String get pipelineStageCorrectionLocal;
+
+  /// No description provided for @pipelineStageCorrectionLlm.
+  ///
+  /// In en, this message translates to:
+  /// **'Correction (LLM)'**
+  String get pipelineStageCorrectionLlm;
+
+  /// No description provided for @pipelineStageRetroCorrection.
+  ///
+  /// In en, this message translates to:
+  /// **'Final retro pass'**
+  String get pipelineStageRetroCorrection;
+
+  /// No description provided for @pipelineStageEnhanceFirstToken.
+  ///
+  /// In en, this message translates to:
+  /// **'Enhance first token'**
+  String get pipelineStageEnhanceFirstToken;
+
+  /// No description provided for @pipelineStageEnhance.
+  ///
+  /// In en, this message translates to:
+  /// **'Enhance done'**
+  String get pipelineStageEnhance;
+
+  /// No description provided for @pipelineStageInsertText.
+  ///
+  /// In en, this message translates to:
+  /// **'Insert text'**
+  String get pipelineStageInsertText;
+
+  /// No description provided for @pipelineStageEndToEnd.
+  ///
+  /// In en, this message translates to:
+  /// **'End to end'**
+  String get pipelineStageEndToEnd;
+
+  /// No description provided for @pipelineStageStartupFirstFrame.
+  ///
+  /// In en, this message translates to:
+  /// **'Startup to first frame'**
+  String get pipelineStageStartupFirstFrame;
+
+  /// No description provided for @pipelineStageStartupSettings.
+  ///
+  /// In en, this message translates to:
+  /// **'Startup to core settings'**
+  String get pipelineStageStartupSettings;
+
+  /// No description provided for @pipelineStageStartupHotkeyReady.
+  ///
+  /// In en, this message translates to:
+  /// **'Startup to hotkey ready'**
+  String get pipelineStageStartupHotkeyReady;
+
+  /// No description provided for @pipelineStageStartupSettingsLoaded.
+  ///
+  /// In en, this message translates to:
+  /// **'Startup to data loaded'**
+  String get pipelineStageStartupSettingsLoaded;
+
   /// No description provided for @retroTokenUsage.
   ///
   /// In en, this message translates to:
@@ -2366,6 +2636,18 @@ abstract class AppLocalizations {
   /// **'Run one more paragraph-level correction when recording stops for better term consistency'**
   String get retrospectiveCorrectionDescription;
 
+  /// No description provided for @localCorrectionFastPathEnabled.
+  ///
+  /// In en, this message translates to:
+  /// **'Local Fast Path'**
+  String get localCorrectionFastPathEnabled;
+
+  /// No description provided for @localCorrectionFastPathDescription.
+  ///
+  /// In en, this message translates to:
+  /// **'Apply high-confidence dictionary and memory replacements locally and only call the LLM for ambiguous hits'**
+  String get localCorrectionFastPathDescription;
+
   /// No description provided for @textProcessing.
   ///
   /// In en, this message translates to:
@@ -632,6 +632,51 @@ class AppLocalizationsEn extends AppLocalizations {
   String get noProxySubtitle =>
       'All requests connect directly without any proxy.';
 
+  @override
+  String get providerRoutingEnabled => 'Choose Service Automatically';
+
+  @override
+  String get providerRoutingDescription =>
+      'Pick the fastest available service among the added models, in model list order. Services that keep failing are paused, and the local model is used when every cloud service is unavailable.';
+
+  @override
+  String get requestHedgingEnabled => 'Request Hedging';
+
+  @override
+  String get requestHedgingDescription =>
+      'When cloud recognition or correction has not returned after its recent p90 latency, send a second request and use whichever returns first. Extra requests stay under about 10%.';
+
+  @override
+  String get sttHedgeBackup => 'Speech Recognition Backup';
+
+  @override
+  String get aiHedgeBackup => 'Text Model Backup';
+
+  @override
+  String get hedgeBackupSameService => 'Same service';
+
+  @override
+  String get latencyBudgetTitle => 'Output Latency Budget';
+
+  @override
+  String get latencyBudgetDescription =>
+      'Text must be typed within this time after the hotkey is released. Corrections and enhancements that recent latency says cannot finish in time are skipped, and the locally corrected text is typed instead.';
+
+  @override
+  String get latencyBudgetUnlimited => 'No limit';
+
+  @override
+  String latencyBudgetSeconds(String value) {
+    return '$value s';
+  }
+
+  @override
+  String get lateCorrectionEnabled => 'Finish Corrections After Output';
+
+  @override
+  String get lateCorrectionDescription =>
+      'Skipped corrections and enhancements finish in the background and update the history.';
+
   @override
   String get inputMonitoringRequired => 'Input Monitoring Required';
 
@@ -847,6 +892,15 @@ class AppLocalizationsEn extends AppLocalizations {
   @override
   String get correctionSelectedRate => 'Candidate Selection Rate';
 
+  @override
+  String get correctionLocalRewrites => 'Local Rewrites';
+
+  @override
+  String get correctionLlmAvoidedRate => 'LLM Avoided Rate';
+
+  @override
+  String get correctionShadowMismatchRate => 'Shadow Check Mismatch Rate';
+
   @override
   String get correctionChangesTitle => 'Correction Details (Latest 20)';
 
@@ -882,6 +936,99 @@ class AppLocalizationsEn extends AppLocalizations {
   @override
   String get allTokenUsage => 'All Tokens Summary';
 
+  @override
+  String get llmCacheHits => 'Cache hits';
+
+  @override
+  String llmCacheHitSummary(String rate, String saved) {
+    return '$rate, saved $saved';
+  }
+
+  @override
+  String get promptPrefixCache => 'Prefix cache';
+
+  @override
+  String pipelineLatencyTitle(int days) {
+    return 'Pipeline latency (last $days days)';
+  }
+
+  @override
+  String get exportTrace => 'Export trace';
+
+  @override
+  String traceExported(String path) {
+    return 'Exported to $path';
+  }
+
+  @override
+  String get traceExportFailed => 'Export failed';
+
+  @override
+  String get latencyStage => 'Stage';
+
+  @override
+  String get latencyCount => 'Count';
+
+  @override
+  String get latencyModel => 'Model';
+
+  @override
+  String get firstTokenP50 => 'TTFT P50';
+
+  @override
+  String get firstTokenP90 => 'TTFT P90';
+
+  @override
+  String get outputSpeed => 'Output speed';
+
+  @override
+  String get modelStreamLatencyTitle => 'Streaming output by model (all time)';
+
+  @override
+  String get pipelineStageHotkey => 'Hotkey response';
+
+  @override
+  String get pipelineStageRecorderStop => 'Stop recording';
+
+  @override
+  String get pipelineStageSegmentWait => 'Segment wait';
+
+  @override
+  String get pipelineStageStt => 'Speech recognition';
+
+  @override
+  String get pipelineStageCorrectionLocal => 'Correction (local)';
+
+  @override
+  String get pipelineStageCorrectionLlm => 'Correction (LLM)';
+
+  @override
+  String get pipelineStageRetroCorrection => 'Final retro pass';
+
+  @override
+  String get pipelineStageEnhanceFirstToken => 'Enhance first token';
+
+  @override
+  String get pipelineStageEnhance => 'Enhance done';
+
+  @override
+  String get pipelineStageInsertText => 'Insert text';
+
+  @override
+  String get pipelineStageEndToEnd => 'End to end';
+
+  @override
+  String get pipelineStageStartupFirstFrame => 'Startup to first frame';
+
+  @override
+  String get pipelineStageStartupSettings => 'Startup to core settings';
+
+  @override
+  String get pipelineStageStartupHotkeyReady => 'Startup to hotkey ready';
+
+  @override
+  String get pipelineStageStartupSettingsLoaded => 'Startup to data loaded';
+
   @override
   String get retroTokenUsage => 'Retrospective Tokens';
 
@@ -1232,6 +1379,13 @@ class AppLocalizationsEn extends AppLocalizations {
   String get retrospectiveCorrectionDescription =>
       'Run one more paragraph-level correction when recording stops for better term consistency';
 
+  @override
+  String get localCorrectionFastPathEnabled => 'Local Fast Path';
+
+  @override
+  String get localCorrectionFastPathDescription =>
+      'Apply high-confidence dictionary and memory replacements locally and only call the LLM for ambiguous hits';
+
   @override
   String get textProcessing => 'Text Processing';
 
@@ -604,6 +604,50 @@ class AppLocalizationsZh extends AppLocalizations {
   @override
   String get noProxySubtitle => '所有请求直连，不走任何代理。';
 
+  @override
+  String get providerRoutingEnabled => '自动选择服务';
+
+  @override
+  String get providerRoutingDescription =>
+      '按模型列表顺序，在已添加的模型中选择近期最快且可用的一个；连续失败的服务暂停使用，云端全部不可用时改用本地模型。';
+
+  @override
+  String get requestHedgingEnabled => '请求对冲';
+
+  @override
+  String get requestHedgingDescription =>
+      '云端识别或纠错超过近期 p90 耗时仍未返回时，再发一路请求，采用先返回的结果。额外请求约占 10% 以内。';
+
+  @override
+  String get sttHedgeBackup => '语音识别备用服务';
+
+  @override
+  String get aiHedgeBackup => '文本模型备用服务';
+
+  @override
+  String get hedgeBackupSameService => '同一服务';
+
+  @override
+  String get latencyBudgetTitle => '上屏延迟预算';
+
+  @override
+  String get latencyBudgetDescription =>
+      '松开按键后须在此时间内上屏。按近期耗时预计来不及的纠错与增强会被跳过，改为上屏本地纠错后的文本。';
+
+  @override
+  String get latencyBudgetUnlimited => '不限';
+
+  @override
+  String latencyBudgetSeconds(String value) {
+    return '$value 秒';
+  }
+
+  @override
+  String get lateCorrectionEnabled => '上屏后补做纠错';
+
+  @override
+  String get lateCorrectionDescription => '被跳过的纠错与增强在后台完成后更新到历史记录。';
+
   @override
   String get inputMonitoringRequired => '需要输入监控权限';
 
@@ -816,6 +860,15 @@ class AppLocalizationsZh extends AppLocalizations {
   @override
   String get correctionSelectedRate => '候选入选率';
 
+  @override
+  String get correctionLocalRewrites => '本地直出';
+
+  @override
+  String get correctionLlmAvoidedRate => 'LLM 节省率';
+
+  @override
+  String get correctionShadowMismatchRate => '抽检偏差率';
+
   @override
   String get correctionChangesTitle => '纠错明细（最近 20 条）';
 
@@ -849,6 +902,99 @@ class AppLocalizationsZh extends AppLocalizations {
   @override
   String get allTokenUsage => '全部 Token 汇总';
 
+  @override
+  String get llmCacheHits => '缓存命中';
+
+  @override
+  String llmCacheHitSummary(String rate, String saved) {
+    return '$rate，节省 $saved';
+  }
+
+  @override
+  String get promptPrefixCache => '前缀缓存';
+
+  @override
+  String pipelineLatencyTitle(int days) {
+    return '流水线耗时（近 $days 天）';
+  }
+
+  @override
+  String get exportTrace => '导出 Trace';
+
+  @override
+  String traceExported(String path) {
+    return '已导出到 $path';
+  }
+
+  @override
+  String get traceExportFailed => '导出失败';
+
+  @override
+  String get latencyStage => '阶段';
+
+  @override
+  String get latencyCount => '次数';
+
+  @override
+  String get latencyModel => '模型';
+
+  @override
+  String get firstTokenP50 => '首字 P50';
+
+  @override
+  String get firstTokenP90 => '首字 P90';
+
+  @override
+  String get outputSpeed => '输出速度';
+
+  @override
+  String get modelStreamLatencyTitle => '各模型流式输出（累计）';
+
+  @override
+  String get pipelineStageHotkey => '快捷键响应';
+
+  @override
+  String get pipelineStageRecorderStop => '停止录音';
+
+  @override
+  String get pipelineStageSegmentWait => '等待分段';
+
+  @override
+  String get pipelineStageStt => '语音识别';
+
+  @override
+  String get pipelineStageCorrectionLocal => '纠错（本地）';
+
+  @override
+  String get pipelineStageCorrectionLlm => '纠错（LLM）';
+
+  @override
+  String get pipelineStageRetroCorrection => '终态回溯';
+
+  @override
+  String get pipelineStageEnhanceFirstToken => '增强首字';
+
+  @override
+  String get pipelineStageEnhance => '增强完成';
+
+  @override
+  String get pipelineStageInsertText => '写入文本';
+
+  @override
+  String get pipelineStageEndToEnd => '端到端';
+
+  @override
+  String get pipelineStageStartupFirstFrame => '启动到首帧';
+
+  @override
+  String get pipelineStageStartupSettings => '启动到核心设置';
+
+  @override
+  String get pipelineStageStartupHotkeyReady => '启动到快捷键就绪';
+
+  @override
+  String get pipelineStageStartupSettingsLoaded => '启动到数据加载完成';
+
   @override
   String get retroTokenUsage => '终态回溯 Token 用量';
 
@@ -1181,6 +1327,13 @@ class AppLocalizationsZh extends AppLocalizations {
   @override
   String get retrospectiveCorrectionDescription => '停止录音后对整段文本再纠错一次，提升术语一致性';
 
+  @override
+  String get localCorrectionFastPathEnabled => '本地快速纠错';
+
+  @override
+  String get localCorrectionFastPathDescription =>
+      '高置信度的词典与记忆替换直接在本地完成，仅在命中有歧义时调用 LLM';
+
   @override
   String get textProcessing => '文本处理';
 
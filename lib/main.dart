@@ -3,8 +3,13 @@ import 'package:flutter/material.dart';
 import 'package:sqflite_common_ffi/sqflite_ffi.dart';
 import 'app.dart';
 import 'database/app_database.dart';
+import 'services/llm_stream_stats_service.dart';
 import 'services/local_asr_worker_main.dart';
+import 'services/log_service.dart';
 import 'services/overlay_service.dart';
+import 'services/pipeline_tracer.dart';
+import 'services/recording_archiver.dart';
+import 'services/stat_counters.dart';
 
 void main(List<String> args) async {
   if (args.contains('--asr-worker')) {
@@ -12,6 +17,7 @@ void main(List<String> args) async {
     return;
   }
 
+  PipelineTracer.instance.beginStartup();
   WidgetsFlutterBinding.ensureInitialized();
   if (Platform.isMacOS || Platform.isLinux || Platform.isWindows) {
     sqfliteFfiInit();
@@ -27,5 +33,33 @@ void main(List<String> args) async {
     }
   }
 
+  // 退出或隐藏窗口时落盘尚未写入的统计计数、模型流式统计、阶段耗时与日志。
+  AppLifecycleListener(
+    onHide: () {
+      StatCounters.instance.flush();
+      LlmStreamStatsService.instance.flush();
+      PipelineTracer.instance.flush();
+      LogService.flush();
+    },
+    onExitRequested: () async {
+      await _flushBeforeExit();
+      return AppExitResponse.exit;
+    },
+  );
+  // Windows 托盘「退出」直接销毁窗口，不经过 onExitRequested。
+  OverlayService.onPrepareExit = _flushBeforeExit;
+
   runApp(const VoiceTypeApp());
+  WidgetsBinding.instance.waitUntilFirstFrameRasterized.then((_) {
+    PipelineTracer.instance.markStartup(PipelineStage.startupFirstFrame);
+  });
+  // 启动稍后归档上次运行遗留的录音并执行保留策略。
+  RecordingArchiver.instance.schedule(const Duration(minutes: 2));
+}
+
+Future<void> _flushBeforeExit() async {
+  await StatCounters.instance.flush();
+  await LlmStreamStatsService.instance.flush();
+  await PipelineTracer.instance.flush();
+  await LogService.close();
 }
@@ -23,6 +23,44 @@ class TrendDataPoint {
   });
 }
 
+/// 流水线单个阶段在统计窗口内的耗时分布（毫秒）。
+class StageLatency {
+  final String stage;
+  final int count;
+  final double p50Ms;
+  final double p90Ms;
+  final double p99Ms;
+
+  const StageLatency({
+    required this.stage,
+    required this.count,
+    required this.p50Ms,
+    required this.p90Ms,
+    required this.p99Ms,
+  });
+}
+
+/// 单个模型累计的流式输出表现。
+class ModelStreamLatency {
+  final String model;
+  final int count;
+
+  /// 首字延迟（毫秒）。
+  final double firstTokenP50Ms;
+  final double firstTokenP90Ms;
+
+  /// 首字之后的平均输出速度（token/秒），尚无样本时为 0。
+  final double tokensPerSecond;
+
+  const ModelStreamLatency({
+    required this.model,
+    required this.count,
+    required this.firstTokenP50Ms,
+    required this.firstTokenP90Ms,
+    required this.tokensPerSecond,
+  });
+}
+
 /// 仪表盘统计汇总数据。
 class DashboardStats {
   // ── 核心汇总 ──
@@ -77,6 +115,11 @@ class DashboardStats {
   final int correctionSelected;
   final int correctionReferenceChars;
 
+  // ── 纠错本地快速路径 ──
+  final int correctionLocalRewrites;
+  final int correctionShadowChecks;
+  final int correctionShadowMismatches;
+
   // ── 终态回溯 ──
   final int retroCalls;
   final int retroLlmCalls;
@@ -96,6 +139,20 @@ class DashboardStats {
   final int memoryPromptInjectionCount;
   final int memoryCorrectionHitCount;
 
+  // ── 流水线阶段耗时（近 7 天） ──
+  final List<StageLatency> stageLatencies;
+
+  // ── 各模型流式输出（累计） ──
+  final List<ModelStreamLatency> modelStreamLatencies;
+
+  // ── LLM 结果缓存 ──
+  final int llmCacheHits;
+  final int llmCacheLookups;
+  final int llmCacheSavedTokens;
+
+  /// AI 增强输入 token 中命中服务端前缀缓存的部分。
+  final int enhanceCachedPromptTokens;
+
   const DashboardStats({
     required this.totalCount,
     required this.totalDurationMs,
@@ -129,6 +186,9 @@ class DashboardStats {
     this.correctionMatches = 0,
     this.correctionSelected = 0,
     this.correctionReferenceChars = 0,
+    this.correctionLocalRewrites = 0,
+    this.correctionShadowChecks = 0,
+    this.correctionShadowMismatches = 0,
     this.retroCalls = 0,
     this.retroLlmCalls = 0,
     this.retroPromptTokens = 0,
@@ -144,6 +204,12 @@ class DashboardStats {
     this.memoryEventsCount = 0,
     this.memoryPromptInjectionCount = 0,
     this.memoryCorrectionHitCount = 0,
+    this.stageLatencies = const [],
+    this.modelStreamLatencies = const [],
+    this.llmCacheHits = 0,
+    this.llmCacheLookups = 0,
+    this.llmCacheSavedTokens = 0,
+    this.enhanceCachedPromptTokens = 0,
   });
 
   /// 空状态。
@@ -205,9 +271,27 @@ class DashboardStats {
 
   int get retroTotalTokens => retroPromptTokens + retroCompletionTokens;
 
+  double get llmCacheHitRate =>
+      llmCacheLookups > 0 ? llmCacheHits / llmCacheLookups : 0;
+
+  double get enhancePrefixCacheRate => enhancePromptTokens > 0
+      ? enhanceCachedPromptTokens / enhancePromptTokens
+      : 0;
+
   double get correctionLlmInvokeRate =>
       correctionCalls > 0 ? correctionLlmCalls / correctionCalls : 0;
 
+  /// 本来需要 LLM 的纠错中，由本地快速路径完成的比例。
+  double get correctionLlmAvoidedRate {
+    final wouldCall = correctionLlmCalls + correctionLocalRewrites;
+    return wouldCall > 0 ? correctionLocalRewrites / wouldCall : 0;
+  }
+
+  /// 本地直出抽检中与 LLM 结果不一致的比例。
+  double get correctionShadowMismatchRate => correctionShadowChecks > 0
+      ? correctionShadowMismatches / correctionShadowChecks
+      : 0;
+
   double get correctionSelectedRate =>
       correctionMatches > 0 ? correctionSelected / correctionMatches : 0;
 
@@ -0,0 +1,16 @@
+import 'transcription.dart';
+
+/// 历史记录分页游标：按 `(created_at, id)` 降序定位上一页的最后一条记录。
+class HistoryCursor {
+  /// 与数据库中 `created_at` 列一致的 ISO 8601 字符串。
+  final String createdAt;
+  final String id;
+
+  const HistoryCursor({required this.createdAt, required this.id});
+
+  /// 以 [item] 作为上一页末尾构造游标；优先使用其存储的原始时间字符串。
+  factory HistoryCursor.after(Transcription item) => HistoryCursor(
+    createdAt: item.storedCreatedAt ?? item.createdAt.toIso8601String(),
+    id: item.id,
+  );
+}
@@ -0,0 +1,15 @@
+import 'transcription.dart';
+
+/// 历史记录全文检索的一条命中结果。
+class HistorySearchHit {
+  /// 片段中高亮区间的起止标记（STX / ETX 控制字符，不会出现在正常文本中）。
+  static const String highlightStart = '\u0002';
+  static const String highlightEnd = '\u0003';
+
+  final Transcription item;
+
+  /// 命中位置附近的文本片段，匹配内容以 [highlightStart]/[highlightEnd] 包围。
+  final String snippet;
+
+  const HistorySearchHit({required this.item, required this.snippet});
+}
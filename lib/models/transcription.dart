@@ -3,6 +3,10 @@ class Transcription {
   final String text;
   final String? rawText;
   final DateTime createdAt;
+
+  /// 从数据库读出时 `created_at` 列的原始字符串；写回与分页游标都用它，
+  /// 避免 [createdAt] 重新序列化后与存储值不一致。
+  final String? storedCreatedAt;
   final Duration duration;
   final Duration? llmProcessingDuration;
   final int? llmInputTokens;
@@ -16,6 +20,7 @@ class Transcription {
     required this.text,
     this.rawText,
     required this.createdAt,
+    this.storedCreatedAt,
     required this.duration,
     this.llmProcessingDuration,
     this.llmInputTokens,
@@ -50,7 +55,7 @@ class Transcription {
     'id': id,
     'text': text,
     'raw_text': rawText,
-    'created_at': createdAt.toIso8601String(),
+    'created_at': storedCreatedAt ?? createdAt.toIso8601String(),
     'duration_ms': duration.inMilliseconds,
     'llm_processing_duration_ms': llmProcessingDuration?.inMilliseconds,
     'llm_input_tokens': llmInputTokens,
@@ -81,6 +86,7 @@ class Transcription {
     text: row['text'] as String,
     rawText: row['raw_text'] as String?,
     createdAt: DateTime.parse(row['created_at'] as String),
+    storedCreatedAt: row['created_at'] as String,
     duration: Duration(milliseconds: row['duration_ms'] as int),
     llmProcessingDuration: row['llm_processing_duration_ms'] == null
         ? null
@@ -8,6 +8,7 @@ import '../models/dictionary_entry.dart';
 import '../models/entity_alias.dart';
 import '../models/entity_memory.dart';
 import '../models/entity_relation.dart';
+import '../models/history_cursor.dart';
 import '../models/memory_item.dart';
 import '../models/stt_request_context.dart';
 import '../models/term_context_entry.dart';
@@ -17,29 +18,45 @@ import '../models/provider_config.dart';
 import '../services/audio_recorder.dart';
 import '../services/ai_enhance_service.dart';
 import '../services/history_db.dart';
+import '../services/latency_budget.dart';
 import '../services/stt_service.dart';
 import '../services/overlay_service.dart';
 import '../services/log_service.dart';
+import '../services/network_client_service.dart';
+import '../services/pipeline_tracer.dart';
+import '../services/recording_archiver.dart';
+import '../services/segment_pipeline.dart';
 import '../services/token_stats_service.dart';
 import '../services/vad_service.dart';
 import '../services/correction_service.dart';
+import '../services/local_correction_plan.dart';
+import '../services/local_rewrite_gate.dart';
 import '../services/correction_context.dart';
 import '../services/pinyin_matcher.dart';
 import '../services/session_glossary.dart';
 import '../services/correction_stats_service.dart';
 import '../services/context_recall_service.dart';
 import '../services/session_entity_state.dart';
-import '../services/term_prompt_builder.dart';
+import '../services/term_prompt_context_cache.dart';
+import '../services/text_compute_pool.dart';
 
 enum RecordingState { idle, recording, transcribing }
 
 class RecordingProvider extends ChangeNotifier {
   static const Duration _segmentDuration = Duration(seconds: 10);
   static const String _overlayOwner = 'dictation';
+  static const String _budgetStageEnhance = 'enhance';
   static const String _editedHistoryIdsKey = 'edited_history_ids_v1';
   static const String _historyContextOverridesKey =
       'history_context_overrides_v1';
 
+  /// 常驻内存的最新历史记录条数；更早的记录由历史页按需分页加载。
+  static const int _historyWindowSize = 200;
+  static const int _historyPageSize = 100;
+
+  /// 全文检索召回的候选数；结果还需过滤掉未用作上下文的记录。
+  static const int _relatedHistorySearchLimit = 50;
+
   final AudioRecorderService _recorder = AudioRecorderService();
   final HistoryDb _historyDb = HistoryDb.instance;
 
@@ -54,19 +71,26 @@ class RecordingProvider extends ChangeNotifier {
   Timer? _segmentTimer;
   StreamSubscription<double>? _amplitudeSub;
   final List<Transcription> _history = [];
+  int _historyWindowLimit = _historyWindowSize;
+  int _historyTotalCount = 0;
+  bool _hasMoreHistory = false;
+  bool _loadingMoreHistory = false;
   final Set<String> _editedHistoryIds = {};
   final Map<String, bool> _historyContextOverrides = {};
   Completer<void>? _stopCompleter;
-  Completer<void>? _segmentDrainCompleter;
   VadService? _vadService;
   StreamSubscription<void>? _vadSub;
-  final List<String> _segmentQueue = [];
+  // 分段处理流水线：STT → 本地匹配 → LLM 纠错 → 按序追加，每次会话新建
+  StagedPipeline<_SegmentJob>? _segmentPipeline;
   final StringBuffer _rawTextBuffer = StringBuffer();
   final StringBuffer _realtimeTextBuffer = StringBuffer();
-  bool _segmentWorkerRunning = false;
   bool _segmentSwitching = false;
   bool _sessionStopping = false;
   int _sessionId = 0;
+  PipelineTrace? _sessionTrace;
+  // 各会话的归档令牌与已入队的分段文件；上一会话的转写可能与下一会话
+  // 的录音重叠，因此按会话分开保存，转写完成后交给归档
+  final Map<int, _SessionArchive> _sessionArchives = {};
   SttProviderConfig? _activeSttConfig;
   // VAD auto-stop callback — set by the screen that owns the provider
   void Function()? onVadTriggered;
@@ -79,13 +103,18 @@ class RecordingProvider extends ChangeNotifier {
   static const ContextRecallService _contextRecallService =
       ContextRecallService();
   bool _retrospectiveCorrectionEnabled = false;
+  // 松开按键到上屏的延迟预算，为 null 时不限时
+  Duration? _latencySlo;
+  bool _lateCorrectionEnabled = false;
+  LatencyBudget? _sessionBudget;
   List<DictionaryEntry> _dictionaryEntries = const [];
   List<TermContextEntry> _termContextEntries = const [];
   List<EntityMemory> _entityMemories = const [];
   List<EntityAlias> _entityAliases = const [];
   List<EntityRelation> _entityRelations = const [];
   List<MemoryItem> _memoryItems = const [];
-  final TermPromptBuilder _termPromptBuilder = const TermPromptBuilder();
+  final TermPromptContextCache _promptContextCache = TermPromptContextCache();
+  String _memorySnapshotVersion = 'empty';
   Future<void> Function(Map<String, TermPin> strongEntries, String sourceRef)?
   onSessionGlossaryFlush;
   Future<void> Function(SttRequestContext context)? onSttPromptTrace;
@@ -117,6 +146,7 @@ class RecordingProvider extends ChangeNotifier {
     List<MemoryItem> memoryItems = const [],
     int maxReferenceEntries = 15,
     double minCandidateScore = 0.30,
+    bool localFastPath = true,
   }) {
     _dictionaryEntries = List<DictionaryEntry>.from(dictionaryEntries);
     _termContextEntries = List<TermContextEntry>.from(termContextEntries);
@@ -124,6 +154,7 @@ class RecordingProvider extends ChangeNotifier {
     _entityAliases = List<EntityAlias>.from(entityAliases);
     _entityRelations = List<EntityRelation>.from(entityRelations);
     _memoryItems = List<MemoryItem>.from(memoryItems);
+    _memorySnapshotVersion = _computeMemorySnapshotVersion(_memoryItems);
     _correctionService = CorrectionService(
       matcher: matcher,
       context: _correctionContext,
@@ -138,6 +169,12 @@ class RecordingProvider extends ChangeNotifier {
       memoryItems: _memoryItems,
       sessionEntityState: _sessionEntityState,
       onMemoryCorrectionHit: onMemoryCorrectionHit,
+      computePool: TextComputePool.instance,
+      localRewriteGate: localFastPath ? const LocalRewriteGate() : null,
+    );
+    // 词典版本变化后提前下发快照，失败时纠错会退回当前 isolate。
+    unawaited(
+      TextComputePool.instance.prepare(matcher).catchError((Object _) {}),
     );
   }
 
@@ -150,6 +187,7 @@ class RecordingProvider extends ChangeNotifier {
     _entityAliases = const [];
     _entityRelations = const [];
     _memoryItems = const [];
+    _memorySnapshotVersion = 'empty';
   }
 
   /// 设置终态回溯纠错开关。
@@ -157,6 +195,15 @@ class RecordingProvider extends ChangeNotifier {
     _retrospectiveCorrectionEnabled = value;
   }
 
+  /// 设置松开按键到上屏的延迟预算，下次录音起生效；为 null 时不限时。
+  ///
+  /// 预计来不及的 LLM 纠错与增强会被跳过或放弃等待，改用本地结果；
+  /// [lateCorrection] 为 true 时上屏后在后台补做，结果写回历史记录。
+  void setLatencyBudget(Duration? slo, {bool lateCorrection = false}) {
+    _latencySlo = slo;
+    _lateCorrectionEnabled = lateCorrection;
+  }
+
   /// 手动覆盖会话术语映射（由词典页编辑触发）。
   void applySessionGlossaryOverride(String original, String corrected) {
     _sessionGlossary.override(original, corrected);
@@ -174,6 +221,10 @@ class RecordingProvider extends ChangeNotifier {
     );
   }
 
+  /// 当前会话 STT 提示上下文各片段的缓存命中统计。
+  Map<String, PromptCacheStats> get promptContextCacheStats =>
+      _promptContextCache.stats;
+
   Future<void> _flushGlossaryStats() async {
     try {
       await CorrectionStatsService.instance.flushGlossaryStats(
@@ -190,7 +241,13 @@ class RecordingProvider extends ChangeNotifier {
   String get transcribedText => _transcribedText;
   String get error => _error;
   Duration get recordingDuration => _recordingDuration;
+  /// 已加载到内存的历史记录（最新在前），不一定是全部记录。
   List<Transcription> get history => List.unmodifiable(_history);
+  int get historyTotalCount => _historyTotalCount > _history.length
+      ? _historyTotalCount
+      : _history.length;
+  bool get hasMoreHistory => _hasMoreHistory;
+  bool get loadingMoreHistory => _loadingMoreHistory;
   List<Transcription> get contextHistory => List.unmodifiable(
     _history.where((item) => isHistoryUsedForContext(item.id)).toList(),
   );
@@ -228,15 +285,24 @@ class RecordingProvider extends ChangeNotifier {
     return '$m:$s';
   }
 
-  Future<void> startRecording(SttProviderConfig config) async {
+  /// 开始录音。[aiEnhanceConfig] 为本次会话将使用的增强配置，
+  /// 仅用于提前预热其端点连接。
+  Future<void> startRecording(
+    SttProviderConfig config, {
+    AiEnhanceConfig? aiEnhanceConfig,
+  }) async {
     if (_busy) return;
     _busy = true;
     try {
-      await _startRecordingInternal(config).timeout(
+      await _startRecordingInternal(
+        config,
+        aiEnhanceConfig: aiEnhanceConfig,
+      ).timeout(
         const Duration(seconds: 15),
         onTimeout: () {
           LogService.error('RECORDING', 'startRecording timed out after 15s');
           _state = RecordingState.idle;
+          _endSessionArchive(_sessionId);
           unawaited(OverlayService.hideOverlay(owner: _overlayOwner));
           notifyListeners();
         },
@@ -244,6 +310,7 @@ class RecordingProvider extends ChangeNotifier {
     } catch (e) {
       _error = '录音启动失败: $e';
       _state = RecordingState.idle;
+      _endSessionArchive(_sessionId);
       unawaited(OverlayService.hideOverlay(owner: _overlayOwner));
       notifyListeners();
     } finally {
@@ -251,7 +318,10 @@ class RecordingProvider extends ChangeNotifier {
     }
   }
 
-  Future<void> _startRecordingInternal(SttProviderConfig config) async {
+  Future<void> _startRecordingInternal(
+    SttProviderConfig config, {
+    AiEnhanceConfig? aiEnhanceConfig,
+  }) async {
     // 等待上一次 stop 操作完成，避免竞态
     if (_stopCompleter != null && !_stopCompleter!.isCompleted) {
       await LogService.info('RECORDING', 'waiting for stopCompleter');
@@ -262,22 +332,38 @@ class RecordingProvider extends ChangeNotifier {
     }
     _error = '';
     _activeSttConfig = config;
+    // 录音期间预热 STT、纠错与增强端点的连接，停止后的请求免去握手。
+    unawaited(
+      NetworkClientService.preconnect([
+        config.baseUrl,
+        if (_correctionService != null) _correctionService!.aiConfig.baseUrl,
+        if (aiEnhanceConfig != null) aiEnhanceConfig.baseUrl,
+      ]),
+    );
     _sessionId += 1;
+    _sessionTrace = PipelineTracer.instance.begin();
+    _sessionArchives[_sessionId] = _SessionArchive(
+      RecordingArchiver.instance.beginSession(),
+    );
     _sessionStopping = false;
     _segmentSwitching = false;
     _segmentTimer?.cancel();
     _segmentTimer = null;
-    _segmentQueue.clear();
-    _segmentDrainCompleter = null;
+    _segmentPipeline = _createSegmentPipeline();
     _rawTextBuffer.clear();
     _realtimeTextBuffer.clear();
     _transcribedText = '';
     _amplitudeSub?.cancel();
     _amplitudeSub = null;
     _correctionContext.reset();
+    // 上一会话的预算可能仍被其后台转写持有，由该任务结束时释放。
+    final slo = _latencySlo;
+    _sessionBudget = slo == null ? null : LatencyBudget(slo);
     unawaited(_flushGlossaryStats());
+    _logPromptCacheStats();
     _sessionGlossary.reset();
     _sessionEntityState.reset();
+    _promptContextCache.reset();
 
     // 无论当前状态如何，都先 reset recorder，确保干净状态
     await LogService.info('RECORDING', 'resetting recorder');
@@ -419,63 +505,136 @@ class RecordingProvider extends ChangeNotifier {
     }
   }
 
+  /// 结束会话 [sessionId] 的归档；[commit] 时把其分段交给归档。
+  void _endSessionArchive(int sessionId, {bool commit = false}) {
+    final archive = _sessionArchives.remove(sessionId);
+    if (archive == null) return;
+    RecordingArchiver.instance.endSession(
+      archive.token,
+      commit ? archive.segmentPaths : const [],
+    );
+  }
+
   void _enqueueSegmentPath(String path, int sessionId) {
-    _segmentQueue.add(path);
-    _segmentDrainCompleter ??= Completer<void>();
-    if (!_segmentWorkerRunning) {
-      unawaited(_runSegmentWorker(sessionId));
+    _sessionArchives[sessionId]?.segmentPaths.add(path);
+    final pipeline = _segmentPipeline ??= _createSegmentPipeline();
+    pipeline.add(
+      _SegmentJob(
+        path: path,
+        sessionId: sessionId,
+        trace: sessionId == _sessionId ? _sessionTrace : null,
+      ),
+    );
+  }
+
+  /// 各阶段独立并发：后一段的 STT 与本地匹配可与前一段的 LLM 纠错重叠。
+  /// LLM 纠错依赖上下文窗口，按分段顺序执行；纠错积压时把已就绪的连续
+  /// 分段合并成一个请求。结果按入队顺序追加。
+  StagedPipeline<_SegmentJob> _createSegmentPipeline() {
+    return StagedPipeline<_SegmentJob>(
+      [
+        PipelineStep('stt', _transcribeSegment, concurrency: 2),
+        PipelineStep('local_match', _planSegmentCorrection, concurrency: 2),
+        PipelineStep(
+          'llm_correction',
+          _correctSegment,
+          ordered: true,
+          runBatch: _correctSegmentBatch,
+          maxBatch: 4,
+        ),
+      ],
+      onOutput: (job) {
+        if (job.sessionId == _sessionId) _appendRealtimeText(job.text);
+      },
+      onError: (job, step, error, _) {
+        LogService.error('SEGMENT', 'segment $step failed: $error');
+      },
+    );
+  }
+
+  Future<void> _transcribeSegment(_SegmentJob job) async {
+    final config = _activeSttConfig;
+    // 已开始新会话时丢弃旧会话尚未转写的分段。
+    if (config == null || job.sessionId != _sessionId) return;
+    final sttContext = _buildSttRequestContext(
+      scene: 'dictation',
+      currentText: _realtimeTextBuffer.toString(),
+    );
+    if (sttContext != null) {
+      unawaited(_recordPromptTrace(sttContext));
     }
+    final sttStartUs = PipelineTracer.nowUs();
+    job.text = await SttService(
+      config,
+    ).transcribe(job.path, context: sttContext);
+    job.trace?.record(PipelineStage.stt, sttStartUs);
   }
 
-  Future<void> _runSegmentWorker(int sessionId) async {
-    if (_segmentWorkerRunning) return;
-    _segmentWorkerRunning = true;
+  Future<void> _planSegmentCorrection(_SegmentJob job) async {
+    final correctionService = _correctionService;
+    if (correctionService == null || !job.needsCorrection(_sessionId)) return;
     try {
-      while (_segmentQueue.isNotEmpty) {
-        final path = _segmentQueue.removeAt(0);
-        final config = _activeSttConfig;
-        if (config == null) {
-          continue;
-        }
-        try {
-          final sttContext = _buildSttRequestContext(
-            scene: 'dictation',
-            currentText: _realtimeTextBuffer.toString(),
-          );
-          if (sttContext != null) {
-            unawaited(_recordPromptTrace(sttContext));
-          }
-          var text = await SttService(
-            config,
-          ).transcribe(path, context: sttContext);
-          // 纠错：若已配置 CorrectionService，对 STT 结果做拼音匹配 + LLM 纠错
-          if (sessionId == _sessionId &&
-              _correctionService != null &&
-              text.trim().isNotEmpty) {
-            try {
-              final result = await _correctionService!.correct(text);
-              text = result.text;
-            } catch (e) {
-              await LogService.error('SEGMENT', 'correction failed: $e');
-              // 纠错失败不影响主流程
-            }
-          }
-          if (sessionId == _sessionId) {
-            _appendRealtimeText(text);
-          }
-        } catch (e) {
-          await LogService.error('SEGMENT', 'segment transcribe failed: $e');
-        }
+      job.plan = await correctionService.planLocal(job.text);
+    } catch (e) {
+      // 纠错阶段会重新计算
+      await LogService.warn('SEGMENT', 'local match failed: $e');
+    }
+  }
+
+  Future<void> _correctSegment(_SegmentJob job) async {
+    final correctionService = _correctionService;
+    if (correctionService == null || !job.needsCorrection(_sessionId)) return;
+    // 纠错：对 STT 结果做拼音匹配 + LLM 纠错
+    final correctionStartUs = PipelineTracer.nowUs();
+    try {
+      final result = await correctionService.correct(
+        job.text,
+        plan: job.plan,
+        budget: _sessionBudget,
+      );
+      job.text = result.text;
+      job.trace?.record(
+        result.llmInvoked
+            ? PipelineStage.correctionLlm
+            : PipelineStage.correctionLocal,
+        correctionStartUs,
+      );
+    } catch (e) {
+      await LogService.error('SEGMENT', 'correction failed: $e');
+      // 纠错失败不影响主流程
+    }
+  }
+
+  Future<void> _correctSegmentBatch(List<_SegmentJob> jobs) async {
+    final correctionService = _correctionService;
+    if (correctionService == null) return;
+    final batch = jobs
+        .where((job) => job.needsCorrection(_sessionId))
+        .toList();
+    if (batch.length < 2) {
+      for (final job in batch) {
+        await _correctSegment(job);
       }
-    } finally {
-      _segmentWorkerRunning = false;
-      if (_segmentQueue.isEmpty) {
-        if (_segmentDrainCompleter != null &&
-            !_segmentDrainCompleter!.isCompleted) {
-          _segmentDrainCompleter!.complete();
-        }
-        _segmentDrainCompleter = null;
+      return;
+    }
+    final correctionStartUs = PipelineTracer.nowUs();
+    try {
+      final results = await correctionService.correctBatch(
+        [for (final job in batch) job.text],
+        plans: [for (final job in batch) job.plan],
+        budget: _sessionBudget,
+      );
+      for (var i = 0; i < batch.length; i++) {
+        batch[i].text = results[i].text;
+        batch[i].trace?.record(
+          results[i].llmInvoked
+              ? PipelineStage.correctionLlm
+              : PipelineStage.correctionLocal,
+          correctionStartUs,
+        );
       }
+    } catch (e) {
+      await LogService.error('SEGMENT', 'batch correction failed: $e');
     }
   }
 
@@ -483,7 +642,7 @@ class RecordingProvider extends ChangeNotifier {
     required String scene,
     required String currentText,
   }) {
-    final bundle = _termPromptBuilder.build(
+    final bundle = _promptContextCache.build(
       scene: scene,
       currentText: currentText,
       history: _history,
@@ -505,7 +664,7 @@ class RecordingProvider extends ChangeNotifier {
       promptTraceId: const Uuid().v4(),
       includedMemoryItemIds: bundle.includedMemoryItemIds,
       includedWeakMemoryItemIds: bundle.includedWeakMemoryItemIds,
-      memorySnapshotVersion: _memorySnapshotVersion(),
+      memorySnapshotVersion: _memorySnapshotVersion,
     );
   }
 
@@ -521,14 +680,25 @@ class RecordingProvider extends ChangeNotifier {
     } catch (_) {}
   }
 
-  String _memorySnapshotVersion() {
-    if (_memoryItems.isEmpty) return 'empty';
+  /// 记忆快照版本：记忆列表按会话复制，仅在重新配置时计算一次。
+  static String _computeMemorySnapshotVersion(List<MemoryItem> items) {
+    if (items.isEmpty) return 'empty';
     var latest = 0;
-    for (final item in _memoryItems) {
+    for (final item in items) {
       final updated = item.updatedAt.millisecondsSinceEpoch;
       if (updated > latest) latest = updated;
     }
-    return '${_memoryItems.length}:$latest';
+    return '${items.length}:$latest';
+  }
+
+  void _logPromptCacheStats() {
+    if (_promptContextCache.bundleStats.lookups == 0) return;
+    unawaited(
+      LogService.info(
+        'STT',
+        'prompt context cache ${_promptContextCache.describeStats()}',
+      ),
+    );
   }
 
   void _appendRealtimeText(String text) {
@@ -548,15 +718,22 @@ class RecordingProvider extends ChangeNotifier {
     notifyListeners();
   }
 
-  Future<void> _waitForSegmentDrain() async {
-    if (_segmentQueue.isEmpty && !_segmentWorkerRunning) {
-      return;
-    }
-    _segmentDrainCompleter ??= Completer<void>();
-    await _segmentDrainCompleter!.future.timeout(
-      const Duration(seconds: 60),
-      onTimeout: () {},
-    );
+  /// 等待已入队的分段处理完毕；超过 60 秒仍未完成时返回 false。
+  Future<bool> _waitForSegmentDrain() async {
+    final pipeline = _segmentPipeline;
+    if (pipeline == null || pipeline.pending == 0) return true;
+    return pipeline.drained
+        .then((_) => true)
+        .timeout(const Duration(seconds: 60), onTimeout: () => false);
+  }
+
+  /// 各阶段的占用情况，用于定位分段处理的瓶颈。
+  Map<String, Object?> _segmentOccupancy() {
+    final pipeline = _segmentPipeline;
+    if (pipeline == null) return const {};
+    final occupancy = pipeline.occupancy;
+    LogService.info('SEGMENT', 'pipeline occupancy ${occupancy.join(', ')}');
+    return {for (final stage in occupancy) stage.name: stage.toString()};
   }
 
   /// Start VAD monitoring. Call after startRecording().
@@ -593,10 +770,17 @@ class RecordingProvider extends ChangeNotifier {
     bool historyContextEnhancementEnabled = false,
     int minRecordingSeconds = 3,
     bool useStreaming = false,
+    int? triggeredAtUs,
   }) async {
     if (_busy) return;
     _busy = true;
     _activeSttConfig ??= config;
+    final trace = _sessionTrace;
+    final stopStartUs = PipelineTracer.nowUs();
+    if (triggeredAtUs != null) {
+      trace?.record(PipelineStage.hotkey, triggeredAtUs, endUs: stopStartUs);
+    }
+    final budget = _sessionBudget?..arm(triggeredAtUs ?? stopStartUs);
     stopVad();
     try {
       _durationTimer?.cancel();
@@ -614,6 +798,8 @@ class RecordingProvider extends ChangeNotifier {
       if (duration.inSeconds < minRecordingSeconds) {
         _sessionStopping = true;
         _state = RecordingState.idle;
+        budget?.dispose();
+        _endSessionArchive(_sessionId);
         unawaited(OverlayService.hideOverlay(owner: _overlayOwner));
         _stopCompleter = Completer<void>();
         _recorder.stop().then((_) => _recorder.reset()).whenComplete(() {
@@ -642,11 +828,16 @@ class RecordingProvider extends ChangeNotifier {
           aiEnhanceConfig: aiEnhanceConfig,
           historyContextEnhancementEnabled: historyContextEnhancementEnabled,
           useStreaming: useStreaming,
+          trace: trace,
+          originUs: triggeredAtUs ?? stopStartUs,
+          budget: budget,
         ),
       );
     } catch (e) {
       _error = '停止录音失败: $e';
       _state = RecordingState.idle;
+      budget?.dispose();
+      _endSessionArchive(_sessionId);
       unawaited(OverlayService.hideOverlay(owner: _overlayOwner));
       _amplitudeSub?.cancel();
       _amplitudeSub = null;
@@ -666,8 +857,13 @@ class RecordingProvider extends ChangeNotifier {
     required AiEnhanceConfig? aiEnhanceConfig,
     required bool historyContextEnhancementEnabled,
     bool useStreaming = false,
+    PipelineTrace? trace,
+    int? originUs,
+    LatencyBudget? budget,
   }) async {
     final sw = Stopwatch()..start();
+    // 下一次录音可能在本任务结束前开始，会话相关的状态按此 id 取用。
+    final sessionId = _sessionId;
     try {
       _sessionStopping = true;
       while (_segmentSwitching) {
@@ -675,6 +871,7 @@ class RecordingProvider extends ChangeNotifier {
       }
 
       await LogService.info('TRANSCRIBE', 'step1: stopping recorder...');
+      final recorderStopStartUs = PipelineTracer.nowUs();
       final stopFuture = _recorder.stop();
       final fallbackPath = _recorder.currentPath;
 
@@ -714,21 +911,41 @@ class RecordingProvider extends ChangeNotifier {
         );
       }
 
+      trace?.record(
+        PipelineStage.recorderStop,
+        recorderStopStartUs,
+        args: {'path': path != null},
+      );
+
       // recorder 已停止，允许下一次录音
       if (_stopCompleter != null && !_stopCompleter!.isCompleted) {
         _stopCompleter!.complete();
       }
 
+      final segmentWaitStartUs = PipelineTracer.nowUs();
       if (path == null) {
         await LogService.info(
           'TRANSCRIBE',
           'final segment path unavailable, continue with queued segments',
         );
       } else {
-        _enqueueSegmentPath(path, _sessionId);
+        _enqueueSegmentPath(path, sessionId);
       }
 
-      await _waitForSegmentDrain();
+      final drained = await _waitForSegmentDrain();
+      trace?.record(
+        PipelineStage.segmentWait,
+        segmentWaitStartUs,
+        args: _segmentOccupancy(),
+      );
+      // 仍有分段未转写完时不提交归档，保留原始录音。
+      if (!drained) {
+        await LogService.warn(
+          'TRANSCRIBE',
+          'segment drain timed out, keeping original recordings',
+        );
+      }
+      _endSessionArchive(sessionId, commit: drained);
 
       var rawText = _rawTextBuffer.toString().trim();
       await LogService.info(
@@ -756,8 +973,15 @@ class RecordingProvider extends ChangeNotifier {
             'TRANSCRIBE',
             'retrospective correction start...',
           );
+          final retroStartUs = PipelineTracer.nowUs();
           final retroResult = await _correctionService!.correctParagraph(
             rawText,
+            budget: budget,
+          );
+          trace?.record(
+            PipelineStage.retroCorrection,
+            retroStartUs,
+            args: {'llm': retroResult.llmInvoked},
           );
           if (retroResult.text.trim().isNotEmpty) {
             rawText = retroResult.text;
@@ -784,7 +1008,7 @@ class RecordingProvider extends ChangeNotifier {
         }
       }
 
-      _finalizeTranscriptionFromRawText(
+      await _finalizeTranscriptionFromRawText(
         rawText,
         config,
         duration,
@@ -792,6 +1016,9 @@ class RecordingProvider extends ChangeNotifier {
         aiEnhanceConfig: aiEnhanceConfig,
         historyContextEnhancementEnabled: historyContextEnhancementEnabled,
         useStreaming: useStreaming,
+        trace: trace,
+        originUs: originUs,
+        budget: budget,
       );
     } catch (e) {
       _error = '停止录音失败: $e';
@@ -803,8 +1030,11 @@ class RecordingProvider extends ChangeNotifier {
         _stopCompleter!.complete();
       }
       await _recorder.reset();
+      _endSessionArchive(sessionId);
       unawaited(OverlayService.hideOverlay(owner: _overlayOwner));
       notifyListeners();
+    } finally {
+      budget?.dispose();
     }
   }
 
@@ -824,7 +1054,7 @@ class RecordingProvider extends ChangeNotifier {
     return null;
   }
 
-  void _finalizeTranscriptionFromRawText(
+  Future<void> _finalizeTranscriptionFromRawText(
     String rawText,
     SttProviderConfig config,
     Duration duration, {
@@ -832,6 +1062,9 @@ class RecordingProvider extends ChangeNotifier {
     required AiEnhanceConfig? aiEnhanceConfig,
     required bool historyContextEnhancementEnabled,
     bool useStreaming = false,
+    PipelineTrace? trace,
+    int? originUs,
+    LatencyBudget? budget,
   }) async {
     final sw = Stopwatch()..start();
     try {
@@ -843,8 +1076,17 @@ class RecordingProvider extends ChangeNotifier {
       Duration? llmProcessingDuration;
       int? llmInputTokens;
       int? llmOutputTokens;
-
-      if (aiEnhanceEnabled && aiEnhanceConfig != null) {
+      // 上下文每次都不同，放进 user message，保持 system prompt 稳定
+      // 以命中服务端前缀缓存。
+      var enhanceContext = '';
+
+      if (aiEnhanceEnabled &&
+          aiEnhanceConfig != null &&
+          (budget == null ||
+              budget.allows(
+                AiEnhanceService.routeKeyOf(aiEnhanceConfig),
+                stage: _budgetStageEnhance,
+              ))) {
         try {
           await LogService.info('TRANSCRIBE', 'ai enhance start...');
           unawaited(
@@ -854,33 +1096,47 @@ class RecordingProvider extends ChangeNotifier {
               owner: _overlayOwner,
             ),
           );
-          var effectiveEnhanceConfig = aiEnhanceConfig;
           if (historyContextEnhancementEnabled) {
             final contextHints = _contextRecallService.recall(
               currentText: rawText,
               history: contextHistory,
+              relatedHistory: await _searchRelatedHistory(rawText),
             );
             if (contextHints.hasContent) {
-              effectiveEnhanceConfig = aiEnhanceConfig.copyWith(
-                prompt: aiEnhanceConfig.prompt + contextHints.toPromptSuffix(),
-              );
+              enhanceContext = contextHints.toPromptSuffix();
               await LogService.info(
                 'TRANSCRIBE',
                 'history context injected: refs=${contextHints.referenceTexts.length} topic=${contextHints.recentTopic ?? '-'} style=${contextHints.recentStyle ?? '-'}',
               );
             }
           }
-          final enhancer = AiEnhanceService(effectiveEnhanceConfig);
+          final enhancer = AiEnhanceService(aiEnhanceConfig);
           final estimatedInputTokens = AiEnhanceService.estimateTokenCount(
-            enhancer.buildInputForTokenEstimate(rawText),
+            enhancer.buildInputForTokenEstimate(
+              rawText,
+              context: enhanceContext,
+            ),
           );
           final llmSw = Stopwatch()..start();
+          final enhanceStartUs = PipelineTracer.nowUs();
 
           if (useStreaming) {
             // Streaming mode: show text in real-time on overlay
             final buffer = StringBuffer();
-            try {
-              await for (final chunk in enhancer.enhanceStream(rawText)) {
+            var abandoned = false;
+            Future<bool> consume() async {
+              final stream = enhancer.enhanceStream(
+                rawText,
+                context: enhanceContext,
+              );
+              await for (final chunk in stream) {
+                if (abandoned) break;
+                if (buffer.isEmpty && chunk.isNotEmpty) {
+                  trace?.record(
+                    PipelineStage.enhanceFirstToken,
+                    enhanceStartUs,
+                  );
+                }
                 buffer.write(chunk);
                 unawaited(
                   OverlayService.updateOverlayText(
@@ -889,40 +1145,63 @@ class RecordingProvider extends ChangeNotifier {
                   ),
                 );
               }
-              finalText = buffer.toString().trim();
-              if (finalText.isEmpty) finalText = rawText;
+              return true;
+            }
+
+            try {
+              final completed = await _withinBudget(consume(), budget);
+              if (completed == null) {
+                abandoned = true;
+                finalText = rawText;
+              } else {
+                finalText = buffer.toString().trim();
+                if (finalText.isEmpty) finalText = rawText;
+              }
             } catch (e) {
               await LogService.error(
                 'TRANSCRIBE',
                 'streaming enhance failed: $e, falling back to batch',
               );
               // Fallback to batch mode
-              final enhanceResult = await enhancer.enhance(rawText);
-              finalText = enhanceResult.text;
-              if (enhanceResult.totalTokens > 0) {
+              final enhanceResult = await _withinBudget(
+                enhancer.enhance(rawText, context: enhanceContext),
+                budget,
+              );
+              finalText = enhanceResult?.text ?? rawText;
+              if (enhanceResult != null && enhanceResult.totalTokens > 0) {
                 try {
                   await TokenStatsService.instance.addTokens(
                     promptTokens: enhanceResult.promptTokens,
                     completionTokens: enhanceResult.completionTokens,
+                    cachedPromptTokens: enhanceResult.cachedPromptTokens,
                   );
                 } catch (_) {}
               }
             }
           } else {
             // Batch mode (original)
-            final enhanceResult = await enhancer.enhance(rawText);
-            finalText = enhanceResult.text;
+            final enhanceResult = await _withinBudget(
+              enhancer.enhance(rawText, context: enhanceContext),
+              budget,
+            );
+            finalText = enhanceResult?.text ?? rawText;
             // 累计 token 用量
-            if (enhanceResult.totalTokens > 0) {
+            if (enhanceResult != null && enhanceResult.totalTokens > 0) {
               try {
                 await TokenStatsService.instance.addTokens(
                   promptTokens: enhanceResult.promptTokens,
                   completionTokens: enhanceResult.completionTokens,
+                  cachedPromptTokens: enhanceResult.cachedPromptTokens,
                 );
               } catch (_) {}
             }
           }
           llmSw.stop();
+          trace?.record(
+            PipelineStage.enhance,
+            enhanceStartUs,
+            args: {'streaming': useStreaming},
+          );
           llmProcessingDuration = llmSw.elapsed;
           llmInputTokens = estimatedInputTokens;
           llmOutputTokens = AiEnhanceService.estimateTokenCount(finalText);
@@ -954,6 +1233,8 @@ class RecordingProvider extends ChangeNotifier {
           providerConfigJson: json.encode(safeConfig.toJson()),
         );
         _history.insert(0, item);
+        _historyTotalCount++;
+        _trimHistoryWindow();
         try {
           await _historyDb.insert(item);
         } catch (e) {
@@ -965,7 +1246,16 @@ class RecordingProvider extends ChangeNotifier {
         }
         try {
           await LogService.info('TRANSCRIBE', 'inserting text...');
+          final insertStartUs = PipelineTracer.nowUs();
           await OverlayService.insertText(finalText);
+          trace?.record(PipelineStage.insertText, insertStartUs);
+          if (originUs != null) {
+            trace?.record(
+              PipelineStage.endToEnd,
+              originUs,
+              args: {'chars': finalText.length},
+            );
+          }
           await LogService.info(
             'TRANSCRIBE',
             'insertText done: ${sw.elapsedMilliseconds}ms',
@@ -973,6 +1263,17 @@ class RecordingProvider extends ChangeNotifier {
         } catch (e) {
           await LogService.error('TRANSCRIBE', 'insertText failed: $e');
         }
+        if (budget != null && budget.degraded && _lateCorrectionEnabled) {
+          unawaited(
+            _applyLateCorrection(
+              item,
+              rawText: rawText,
+              degradedStages: budget.degradedStages,
+              aiEnhanceConfig: aiEnhanceEnabled ? aiEnhanceConfig : null,
+              enhanceContext: enhanceContext,
+            ),
+          );
+        }
         unawaited(OverlayService.hideOverlay(owner: _overlayOwner));
         await LogService.info(
           'TRANSCRIBE',
@@ -999,6 +1300,82 @@ class RecordingProvider extends ChangeNotifier {
     }
   }
 
+  /// 在 [budget] 内等待增强请求 [work]；没有预算时一直等待，预算用尽时
+  /// 返回 null。
+  static Future<T?> _withinBudget<T>(Future<T> work, LatencyBudget? budget) {
+    if (budget == null) return work;
+    return budget.guard(work, stage: _budgetStageEnhance);
+  }
+
+  /// 补做因延迟预算跳过的纠错与增强，结果写回历史记录 [item]。
+  ///
+  /// 文本已经上屏，这里只更新历史；用户在此期间手动修改过的记录不覆盖。
+  Future<void> _applyLateCorrection(
+    Transcription item, {
+    required String rawText,
+    required Set<String> degradedStages,
+    AiEnhanceConfig? aiEnhanceConfig,
+    String enhanceContext = '',
+  }) async {
+    try {
+      var text = rawText;
+      final correctionService = _correctionService;
+      if (correctionService != null &&
+          degradedStages.any((stage) => stage != _budgetStageEnhance)) {
+        final result = await correctionService.correctParagraph(rawText);
+        if (result.text.trim().isNotEmpty) text = result.text;
+      }
+      if (aiEnhanceConfig != null &&
+          (degradedStages.contains(_budgetStageEnhance) || text != rawText)) {
+        final result = await AiEnhanceService(
+          aiEnhanceConfig,
+        ).enhance(text, context: enhanceContext);
+        if (result.totalTokens > 0) {
+          await TokenStatsService.instance.addTokens(
+            promptTokens: result.promptTokens,
+            completionTokens: result.completionTokens,
+            cachedPromptTokens: result.cachedPromptTokens,
+          );
+        }
+        if (result.text.trim().isNotEmpty) text = result.text;
+      }
+      text = text.trim();
+
+      final index = _history.indexWhere((entry) => entry.id == item.id);
+      if (text.isEmpty ||
+          text == item.text ||
+          index < 0 ||
+          _history[index].text != item.text) {
+        return;
+      }
+      final current = _history[index];
+      final updated = Transcription(
+        id: current.id,
+        text: text,
+        rawText: current.rawText,
+        createdAt: current.createdAt,
+        storedCreatedAt: current.storedCreatedAt,
+        duration: current.duration,
+        llmProcessingDuration: current.llmProcessingDuration,
+        llmInputTokens: current.llmInputTokens,
+        llmOutputTokens: current.llmOutputTokens,
+        provider: current.provider,
+        model: current.model,
+        providerConfigJson: current.providerConfigJson,
+      );
+      _history[index] = updated;
+      await _historyDb.insert(updated);
+      await LogService.info(
+        'TRANSCRIBE',
+        'late correction applied: stages=${degradedStages.join(',')} '
+            '${item.text.length} → ${text.length} chars',
+      );
+      notifyListeners();
+    } catch (e) {
+      await LogService.warn('TRANSCRIBE', 'late correction failed: $e');
+    }
+  }
+
   void _showTranscribeFailedOverlay() {
     // 不 await overlay 调用，避免 MethodChannel 阻塞后续录音
     OverlayService.showOverlay(
@@ -1013,10 +1390,13 @@ class RecordingProvider extends ChangeNotifier {
 
   Future<void> _loadHistory() async {
     try {
-      final items = await _historyDb.getAll();
+      final items = await _historyDb.getPage(limit: _historyWindowSize);
       _history
         ..clear()
         ..addAll(items);
+      _historyWindowLimit = _historyWindowSize;
+      _historyTotalCount = await _historyDb.count();
+      _hasMoreHistory = _historyTotalCount > items.length;
       final raw = await AppDatabase.instance.getSetting(_editedHistoryIdsKey);
       _editedHistoryIds
         ..clear()
@@ -1027,15 +1407,78 @@ class RecordingProvider extends ChangeNotifier {
       _historyContextOverrides
         ..clear()
         ..addAll(_decodeHistoryContextOverrides(contextRaw));
-      _historyContextOverrides.removeWhere(
-        (id, _) => !_history.any((item) => item.id == id),
-      );
+      // 窗口之外的记录仍可能存在，需按数据库判断是否已被删除。
+      if (_historyContextOverrides.isNotEmpty) {
+        final existing = await _historyDb.filterExistingIds(
+          _historyContextOverrides.keys,
+        );
+        _historyContextOverrides.removeWhere(
+          (id, _) => !existing.contains(id),
+        );
+      }
       notifyListeners();
     } catch (e) {
       // ignore
     }
   }
 
+  /// 通过全文检索召回与 [text] 相关、且允许用作上下文的历史记录。
+  Future<List<Transcription>> _searchRelatedHistory(String text) async {
+    final terms = _contextRecallService.buildSearchTerms(text);
+    if (terms.isEmpty) return const [];
+    try {
+      final hits = await _historyDb.search(
+        terms.join(' '),
+        limit: _relatedHistorySearchLimit,
+        matchAny: true,
+      );
+      return [
+        for (final hit in hits)
+          if (isHistoryUsedForContext(hit.item.id)) hit.item,
+      ];
+    } catch (e) {
+      return const [];
+    }
+  }
+
+  /// 在已加载窗口之后追加一页更早的历史记录。
+  Future<void> loadMoreHistory() async {
+    if (_loadingMoreHistory || !_hasMoreHistory) return;
+    _loadingMoreHistory = true;
+    notifyListeners();
+    try {
+      final page = await _historyDb.getPage(
+        limit: _historyPageSize,
+        before: _history.isEmpty ? null : HistoryCursor.after(_history.last),
+      );
+      final loadedIds = {for (final item in _history) item.id};
+      _history.addAll(page.where((item) => !loadedIds.contains(item.id)));
+      if (_history.length > _historyWindowLimit) {
+        _historyWindowLimit = _history.length;
+      }
+      _hasMoreHistory = page.length == _historyPageSize;
+    } catch (e) {
+      // ignore
+    } finally {
+      _loadingMoreHistory = false;
+      notifyListeners();
+    }
+  }
+
+  /// 历史页关闭后将窗口收回到默认大小，释放按需加载的记录。
+  ///
+  /// 在页面 dispose 期间调用，因此不通知监听者。
+  void releaseHistoryPages() {
+    _historyWindowLimit = _historyWindowSize;
+    _trimHistoryWindow();
+  }
+
+  void _trimHistoryWindow() {
+    if (_history.length <= _historyWindowLimit) return;
+    _history.removeRange(_historyWindowLimit, _history.length);
+    _hasMoreHistory = true;
+  }
+
   Set<String> _decodeEditedHistoryIds(String? raw) {
     if (raw == null || raw.trim().isEmpty) return <String>{};
     try {
@@ -1086,6 +1529,7 @@ class RecordingProvider extends ChangeNotifier {
 
   void removeHistory(int index) {
     final item = _history.removeAt(index);
+    if (_historyTotalCount > 0) _historyTotalCount--;
     _editedHistoryIds.remove(item.id);
     _historyContextOverrides.remove(item.id);
     unawaited(_saveEditedHistoryIds());
@@ -1104,6 +1548,7 @@ class RecordingProvider extends ChangeNotifier {
       text: text.trim(),
       rawText: current.rawText,
       createdAt: current.createdAt,
+      storedCreatedAt: current.storedCreatedAt,
       duration: current.duration,
       llmProcessingDuration: current.llmProcessingDuration,
       llmInputTokens: current.llmInputTokens,
@@ -1138,6 +1583,9 @@ class RecordingProvider extends ChangeNotifier {
 
   void clearAllHistory() {
     _history.clear();
+    _historyWindowLimit = _historyWindowSize;
+    _historyTotalCount = 0;
+    _hasMoreHistory = false;
     _editedHistoryIds.clear();
     _historyContextOverrides.clear();
     unawaited(_saveEditedHistoryIds());
@@ -1157,3 +1605,25 @@ class RecordingProvider extends ChangeNotifier {
     super.dispose();
   }
 }
+
+/// 一次录音会话在 [RecordingArchiver] 中的令牌与已入队的分段文件。
+class _SessionArchive {
+  final int token;
+  final List<String> segmentPaths = [];
+
+  _SessionArchive(this.token);
+}
+
+/// 流水线中的一个分段。
+class _SegmentJob {
+  final String path;
+  final int sessionId;
+  final PipelineTrace? trace;
+  String text = '';
+  LocalCorrectionPlan? plan;
+
+  _SegmentJob({required this.path, required this.sessionId, this.trace});
+
+  bool needsCorrection(int currentSessionId) =>
+      sessionId == currentSessionId && text.trim().isNotEmpty;
+}
@@ -35,6 +35,10 @@ import '../services/entity_learning_service.dart';
 import '../services/learning_feedback_service.dart';
 import '../services/markdown_term_import_service.dart';
 import '../services/memory_evolution_engine.dart';
+import '../services/memory_record_store.dart';
+import '../services/pipeline_tracer.dart';
+import '../services/provider_router.dart';
+import '../services/request_hedger.dart';
 import '../services/session_glossary.dart';
 
 class DictionaryCsvImportResult {
@@ -76,24 +80,22 @@ class SettingsProvider extends ChangeNotifier {
   static const _promptTemplatesKey = 'prompt_templates';
   static const _activePromptTemplateIdKey = 'active_prompt_template_id';
   static const _sceneModeKey = 'scene_mode';
-  static const _dictionaryEntriesKey = 'dictionary_entries';
-  static const _dictationTermPendingCandidatesKey =
-      'dictation_term_pending_candidates_v1';
-  static const _termContextEntriesKey = 'term_context_entries_v1';
-  static const _entityMemoriesKey = 'entity_memories_v1';
-  static const _entityAliasesKey = 'entity_aliases_v1';
-  static const _entityRelationsKey = 'entity_relations_v1';
-  static const _entityEvidencesKey = 'entity_evidences_v1';
-  static const _adaptiveMemoryItemsKey = 'adaptive_memory_items_v1';
-  static const _memoryEventsKey = 'memory_events_v1';
   static const _importedReferenceTermsKey = 'imported_reference_terms_v1';
   static const _correctionEnabledKey = 'correction_enabled';
   static const _retrospectiveCorrectionEnabledKey =
       'retrospective_correction_enabled';
+  static const _localCorrectionFastPathEnabledKey =
+      'local_correction_fast_path_enabled';
   static const _historyContextEnhancementEnabledKey =
       'history_context_enhancement_enabled';
   static const _localModelIdleUnloadMinutesKey =
       'local_llm_idle_unload_minutes';
+  static const _requestHedgingEnabledKey = 'request_hedging_enabled';
+  static const _providerRoutingEnabledKey = 'provider_routing_enabled';
+  static const _sttHedgeBackupEntryIdKey = 'stt_hedge_backup_entry_id';
+  static const _aiHedgeBackupEntryIdKey = 'ai_hedge_backup_entry_id';
+  static const _latencyBudgetMsKey = 'latency_budget_ms';
+  static const _lateCorrectionEnabledKey = 'late_correction_enabled';
 
   List<SttProviderConfig> _sttPresets = List<SttProviderConfig>.from(
     SttProviderConfig.fallbackPresets,
@@ -154,12 +156,54 @@ class SettingsProvider extends ChangeNotifier {
   List<MemoryItem> _adaptiveMemoryItems = [];
   List<MemoryEvent> _memoryEvents = [];
 
+  // 行级持久化：每次保存只写入变更的记录。
+  final _dictionaryStore = MemoryRecordStore(
+    MemoryRecordCollections.dictionaryEntries,
+  );
+  final _pendingCandidateStore = MemoryRecordStore(
+    MemoryRecordCollections.pendingCandidates,
+  );
+  final _termContextStore = MemoryRecordStore(
+    MemoryRecordCollections.termContextEntries,
+  );
+  final _entityMemoryStore = MemoryRecordStore(
+    MemoryRecordCollections.entityMemories,
+  );
+  final _entityAliasStore = MemoryRecordStore(
+    MemoryRecordCollections.entityAliases,
+  );
+  final _entityRelationStore = MemoryRecordStore(
+    MemoryRecordCollections.entityRelations,
+  );
+  final _entityEvidenceStore = MemoryRecordStore(
+    MemoryRecordCollections.entityEvidences,
+  );
+  final _memoryItemStore = MemoryRecordStore(
+    MemoryRecordCollections.memoryItems,
+  );
+  final _memoryEventStore = MemoryRecordStore(
+    MemoryRecordCollections.memoryEvents,
+  );
+
   // Correction settings
   bool _correctionEnabled = true;
   bool _retrospectiveCorrectionEnabled = false;
+  bool _localCorrectionFastPathEnabled = true;
   bool _historyContextEnhancementEnabled = true;
   String _correctionPrompt = '';
   int _localModelIdleUnloadMinutes = 3;
+
+  // Request hedging & routing
+  bool _requestHedgingEnabled = false;
+  bool _providerRoutingEnabled = false;
+  String? _sttHedgeBackupEntryId;
+  String? _aiHedgeBackupEntryId;
+
+  // 松开按键到上屏的延迟预算（毫秒），0 表示不限时
+  int _latencyBudgetMs = 0;
+  bool _lateCorrectionEnabled = true;
+
+  bool _coreSettingsLoaded = false;
   bool _loadCompleted = false;
   bool _onboardingCompleted = false;
   bool _shouldShowOnboardingOnLaunch = false;
@@ -263,14 +307,26 @@ class SettingsProvider extends ChangeNotifier {
   // Correction getters
   bool get correctionEnabled => _correctionEnabled;
   bool get retrospectiveCorrectionEnabled => _retrospectiveCorrectionEnabled;
+  bool get localCorrectionFastPathEnabled => _localCorrectionFastPathEnabled;
   bool get historyContextEnhancementEnabled =>
       _historyContextEnhancementEnabled;
   String get correctionPrompt => _correctionPrompt;
   int get localModelIdleUnloadMinutes => _localModelIdleUnloadMinutes;
+  bool get requestHedgingEnabled => _requestHedgingEnabled;
+  bool get providerRoutingEnabled => _providerRoutingEnabled;
+  String? get sttHedgeBackupEntryId => _sttHedgeBackupEntryId;
+  String? get aiHedgeBackupEntryId => _aiHedgeBackupEntryId;
+  int get latencyBudgetMs => _latencyBudgetMs;
+  Duration? get latencyBudget => _latencyBudgetMs > 0
+      ? Duration(milliseconds: _latencyBudgetMs)
+      : null;
+  bool get lateCorrectionEnabled => _lateCorrectionEnabled;
   PinyinMatcher get pinyinMatcher => _pinyinMatcher;
   int get correctionMaxReferenceEntries => _correctionMaxReferenceEntries;
   double get correctionMinCandidateScore => _correctionMinCandidateScore;
   bool get correctionEnableSingleCharFuzzy => _correctionEnableSingleCharFuzzy;
+  /// 快捷键、服务商等核心设置已加载（大集合可能仍在加载）。
+  bool get coreSettingsLoaded => _coreSettingsLoaded;
   bool get loadCompleted => _loadCompleted;
   bool get onboardingCompleted => _onboardingCompleted;
   bool get shouldShowOnboardingOnLaunch => _shouldShowOnboardingOnLaunch;
@@ -350,21 +406,24 @@ class SettingsProvider extends ChangeNotifier {
     return config.baseUrl.trim().isEmpty && config.apiKey.trim().isEmpty;
   }
 
+  /// 分两阶段加载：先用一次查询读出全部配置，应用快捷键、服务商等
+  /// 核心设置后立即通知界面（快捷键随之注册）；词典、记忆与实体等大集合
+  /// 随后加载（记录较多时在后台 isolate 中解码），完成后 [loadCompleted]。
   Future<void> load() async {
     final db = AppDatabase.instance;
 
+    final storedFuture = db.getAllSettings();
     await _loadPresetsFromAssets();
+    final stored = await storedFuture;
 
-    final onboardingCompletedStr = await db.getSetting(
-      onboardingCompletedStorageKey,
-    );
+    final onboardingCompletedStr = stored[onboardingCompletedStorageKey];
     if (onboardingCompletedStr != null) {
       _onboardingCompleted = onboardingCompletedStr == 'true';
     }
     _shouldShowOnboardingOnLaunch = !_onboardingCompleted;
 
     // 加载服务商配置
-    final configJson = await db.getSetting(_configKey);
+    final configJson = stored[_configKey];
     if (configJson != null) {
       final decoded = json.decode(configJson) as Map<String, dynamic>;
       _config = SttProviderConfig.fromJson(_cleanApiKeyInJson(decoded));
@@ -372,7 +431,7 @@ class SettingsProvider extends ChangeNotifier {
     }
 
     // 加载自定义服务商
-    final customJson = await db.getSetting('custom_providers');
+    final customJson = stored['custom_providers'];
     if (customJson != null) {
       _customProviders = (json.decode(customJson) as List)
           .map(
@@ -384,7 +443,7 @@ class SettingsProvider extends ChangeNotifier {
     }
 
     // 加载 API Keys
-    final keysJson = await db.getSetting('api_keys');
+    final keysJson = stored['api_keys'];
     if (keysJson != null) {
       final raw = Map<String, String>.from(json.decode(keysJson));
       for (final entry in raw.entries) {
@@ -397,7 +456,7 @@ class SettingsProvider extends ChangeNotifier {
     }
 
     // 加载快捷键
-    final hotkeyStr = await db.getSetting(_hotkeyKey);
+    final hotkeyStr = stored[_hotkeyKey];
     if (hotkeyStr != null) {
       _hotkey = LogicalKeyboardKey(int.parse(hotkeyStr));
     }
@@ -408,22 +467,22 @@ class SettingsProvider extends ChangeNotifier {
     }
 
     // 加载激活模式
-    final modeStr = await db.getSetting(_activationModeKey);
+    final modeStr = stored[_activationModeKey];
     if (modeStr != null) {
       _activationMode = ActivationMode.values[int.parse(modeStr)];
     }
 
-    final aiEnabledStr = await db.getSetting(_aiEnhanceEnabledKey);
+    final aiEnabledStr = stored[_aiEnhanceEnabledKey];
     if (aiEnabledStr != null) {
       _aiEnhanceEnabled = aiEnabledStr == 'true';
     }
 
-    final useCustomStr = await db.getSetting(_aiEnhanceUseCustomPromptKey);
+    final useCustomStr = stored[_aiEnhanceUseCustomPromptKey];
     if (useCustomStr != null) {
       _aiEnhanceUseCustomPrompt = useCustomStr == 'true';
     }
 
-    final minSecStr = await db.getSetting(_minRecordingSecondsKey);
+    final minSecStr = stored[_minRecordingSecondsKey];
     if (minSecStr != null) {
       _minRecordingSeconds = int.parse(minSecStr);
     }
@@ -435,7 +494,7 @@ class SettingsProvider extends ChangeNotifier {
       _aiEnhanceDefaultPrompt = prompt;
     } catch (_) {}
 
-    final aiEnhanceJson = await db.getSetting(_aiEnhanceConfigKey);
+    final aiEnhanceJson = stored[_aiEnhanceConfigKey];
     if (aiEnhanceJson != null) {
       final decoded = json.decode(aiEnhanceJson) as Map<String, dynamic>;
       _aiEnhanceConfig = AiEnhanceConfig.fromJson(_cleanApiKeyInJson(decoded));
@@ -445,7 +504,7 @@ class SettingsProvider extends ChangeNotifier {
       );
     }
 
-    final defaultModelsJson = await db.getSetting(_aiEnhanceDefaultModelsKey);
+    final defaultModelsJson = stored[_aiEnhanceDefaultModelsKey];
     if (defaultModelsJson != null) {
       _aiEnhanceDefaultModels.addAll(
         Map<String, String>.from(json.decode(defaultModelsJson)),
@@ -453,7 +512,7 @@ class SettingsProvider extends ChangeNotifier {
     }
 
     // 加载文本模型条目列表
-    final entriesJson = await db.getSetting(_aiModelEntriesKey);
+    final entriesJson = stored[_aiModelEntriesKey];
     if (entriesJson != null) {
       try {
         final list = json.decode(entriesJson) as List<dynamic>;
@@ -495,7 +554,7 @@ class SettingsProvider extends ChangeNotifier {
     }
 
     // 加载语音模型条目列表
-    final sttEntriesJson = await db.getSetting(_sttModelEntriesKey);
+    final sttEntriesJson = stored[_sttModelEntriesKey];
     if (sttEntriesJson != null) {
       try {
         final list = json.decode(sttEntriesJson) as List<dynamic>;
@@ -517,13 +576,13 @@ class SettingsProvider extends ChangeNotifier {
     }
 
     // 加载语言设置
-    final localeStr = await db.getSetting(_localeKey);
+    final localeStr = stored[_localeKey];
     if (localeStr != null) {
       _locale = Locale(localeStr);
     }
 
     // 加载主题模式
-    final themeModeStr = await db.getSetting(_themeModeKey);
+    final themeModeStr = stored[_themeModeKey];
     if (themeModeStr != null) {
       _themeMode = switch (themeModeStr) {
         'light' => ThemeMode.light,
@@ -532,34 +591,32 @@ class SettingsProvider extends ChangeNotifier {
       };
     }
 
-    final preferBuiltInMicrophoneStr = await db.getSetting(
-      _preferBuiltInMicrophoneKey,
-    );
+    final preferBuiltInMicrophoneStr = stored[_preferBuiltInMicrophoneKey];
     if (preferBuiltInMicrophoneStr != null) {
       _preferBuiltInMicrophone = preferBuiltInMicrophoneStr == 'true';
     }
     AudioRecorderService.setPreferBuiltInMicrophone(_preferBuiltInMicrophone);
 
-    final proxyModeStr = await db.getSetting(_networkProxyModeKey);
+    final proxyModeStr = stored[_networkProxyModeKey];
     _networkProxyMode = NetworkProxyModeX.fromStorage(proxyModeStr);
     NetworkClientService.setProxyMode(_networkProxyMode);
 
     // 加载 VAD 设置
-    final vadEnabledStr = await db.getSetting(_vadEnabledKey);
+    final vadEnabledStr = stored[_vadEnabledKey];
     if (vadEnabledStr != null) {
       _vadEnabled = vadEnabledStr == 'true';
     }
-    final vadThresholdStr = await db.getSetting(_vadSilenceThresholdKey);
+    final vadThresholdStr = stored[_vadSilenceThresholdKey];
     if (vadThresholdStr != null) {
       _vadSilenceThreshold = double.tryParse(vadThresholdStr) ?? 0.05;
     }
-    final vadDurationStr = await db.getSetting(_vadSilenceDurationKey);
+    final vadDurationStr = stored[_vadSilenceDurationKey];
     if (vadDurationStr != null) {
       _vadSilenceDurationSeconds = int.tryParse(vadDurationStr) ?? 3;
     }
 
     // 加载 Prompt 模板
-    final templatesJson = await db.getSetting(_promptTemplatesKey);
+    final templatesJson = stored[_promptTemplatesKey];
     if (templatesJson != null) {
       try {
         final list = json.decode(templatesJson) as List<dynamic>;
@@ -575,7 +632,7 @@ class SettingsProvider extends ChangeNotifier {
         .toList();
     _promptTemplates = [...builtins, ...customTemplates];
 
-    final activeTemplateIdRaw = await db.getSetting(_activePromptTemplateIdKey);
+    final activeTemplateIdRaw = stored[_activePromptTemplateIdKey];
     _activePromptTemplateId = _resolvedActivePromptTemplateId(
       activeTemplateIdRaw,
     );
@@ -587,57 +644,96 @@ class SettingsProvider extends ChangeNotifier {
     );
 
     // 加载场景模式
-    final sceneModeStr = await db.getSetting(_sceneModeKey);
+    final sceneModeStr = stored[_sceneModeKey];
     if (sceneModeStr != null) {
       _sceneMode = SceneMode.fromString(sceneModeStr);
     }
 
+    // 加载纠错设置
+    final correctionEnabledStr = stored[_correctionEnabledKey];
+    if (correctionEnabledStr != null) {
+      _correctionEnabled = correctionEnabledStr == 'true';
+    }
+
+    final retroStr = stored[_retrospectiveCorrectionEnabledKey];
+    if (retroStr != null) {
+      _retrospectiveCorrectionEnabled = retroStr == 'true';
+    }
+
+    final fastPathStr = stored[_localCorrectionFastPathEnabledKey];
+    if (fastPathStr != null) {
+      _localCorrectionFastPathEnabled = fastPathStr == 'true';
+    }
+
+    final historyContextStr = stored[_historyContextEnhancementEnabledKey];
+    if (historyContextStr != null) {
+      _historyContextEnhancementEnabled = historyContextStr == 'true';
+    }
+
+    final localModelIdleUnloadMinutesStr =
+        stored[_localModelIdleUnloadMinutesKey];
+    if (localModelIdleUnloadMinutesStr != null) {
+      _localModelIdleUnloadMinutes =
+          int.tryParse(localModelIdleUnloadMinutesStr)?.clamp(0, 30) ?? 3;
+    }
+
+    // 加载请求对冲与路由设置
+    _requestHedgingEnabled = stored[_requestHedgingEnabledKey] == 'true';
+    _providerRoutingEnabled = stored[_providerRoutingEnabledKey] == 'true';
+    _sttHedgeBackupEntryId = _nonEmpty(stored[_sttHedgeBackupEntryIdKey]);
+    _aiHedgeBackupEntryId = _nonEmpty(stored[_aiHedgeBackupEntryIdKey]);
+    _applyRequestPolicies();
+
+    // 加载延迟预算设置
+    _latencyBudgetMs =
+        int.tryParse(stored[_latencyBudgetMsKey] ?? '')?.clamp(0, 10000) ?? 0;
+    final lateCorrectionStr = stored[_lateCorrectionEnabledKey];
+    if (lateCorrectionStr != null) {
+      _lateCorrectionEnabled = lateCorrectionStr == 'true';
+    }
+
+    // 核心设置就绪：先通知界面注册快捷键，再加载大集合。
+    _coreSettingsLoaded = true;
+    notifyListeners();
+    PipelineTracer.instance.markStartup(PipelineStage.startupSettings);
+
     // 加载词典
-    final dictJson = await db.getSetting(_dictionaryEntriesKey);
-    if (dictJson != null) {
-      try {
-        final list = json.decode(dictJson) as List<dynamic>;
-        _dictionaryEntries = list
-            .whereType<Map<String, dynamic>>()
-            .map((e) => DictionaryEntry.fromJson(e))
-            .toList();
-      } catch (_) {}
+    final storedDictionaryEntries = await _dictionaryStore.load(
+      db,
+      settings: stored,
+    );
+    if (storedDictionaryEntries != null) {
+      _dictionaryEntries = storedDictionaryEntries;
     }
 
-    final pendingCandidatesJson = await db.getSetting(
-      _dictationTermPendingCandidatesKey,
+    final storedPendingCandidates = await _pendingCandidateStore.load(
+      db,
+      settings: stored,
     );
-    if (pendingCandidatesJson != null) {
-      try {
-        final list = json.decode(pendingCandidatesJson) as List<dynamic>;
-        _dictationTermPendingCandidates =
-            list
-                .whereType<Map<String, dynamic>>()
-                .map((e) => DictationTermPendingCandidate.fromJson(e))
-                .where(
-                  (candidate) =>
-                      candidate.original.isNotEmpty &&
-                      candidate.corrected.isNotEmpty,
-                )
-                .toList()
-              ..sort((a, b) => b.createdAt.compareTo(a.createdAt));
-      } catch (_) {}
+    if (storedPendingCandidates != null) {
+      _dictationTermPendingCandidates =
+          storedPendingCandidates
+              .where(
+                (candidate) =>
+                    candidate.original.isNotEmpty &&
+                    candidate.corrected.isNotEmpty,
+              )
+              .toList()
+            ..sort((a, b) => b.createdAt.compareTo(a.createdAt));
     }
 
-    final termContextEntriesJson = await db.getSetting(_termContextEntriesKey);
-    if (termContextEntriesJson != null) {
-      try {
-        final list = json.decode(termContextEntriesJson) as List<dynamic>;
-        _termContextEntries = list
-            .whereType<Map<String, dynamic>>()
-            .map((e) => TermContextEntry.fromJson(e))
-            .where((entry) => entry.promptTerm.isNotEmpty)
-            .toList(growable: false);
-      } catch (_) {}
+    final storedTermContextEntries = await _termContextStore.load(
+      db,
+      settings: stored,
+    );
+    if (storedTermContextEntries != null) {
+      _termContextEntries = storedTermContextEntries
+          .where((entry) => entry.promptTerm.isNotEmpty)
+          .toList(growable: false);
+      // 已有行级数据后不再回退到更早的导入格式。
+      await db.removeSetting(_importedReferenceTermsKey);
     } else {
-      final importedReferenceTermsJson = await db.getSetting(
-        _importedReferenceTermsKey,
-      );
+      final importedReferenceTermsJson = stored[_importedReferenceTermsKey];
       if (importedReferenceTermsJson != null) {
         try {
           final list = json.decode(importedReferenceTermsJson) as List<dynamic>;
@@ -662,115 +758,72 @@ class SettingsProvider extends ChangeNotifier {
       }
     }
 
-    final entityMemoriesJson = await db.getSetting(_entityMemoriesKey);
-    if (entityMemoriesJson != null) {
-      try {
-        final list = json.decode(entityMemoriesJson) as List<dynamic>;
-        _entityMemories = list
-            .whereType<Map<String, dynamic>>()
-            .map(EntityMemory.fromJson)
-            .where((item) => item.canonicalName.isNotEmpty)
-            .toList(growable: false);
-      } catch (_) {}
-    }
-
-    final entityAliasesJson = await db.getSetting(_entityAliasesKey);
-    if (entityAliasesJson != null) {
-      try {
-        final list = json.decode(entityAliasesJson) as List<dynamic>;
-        _entityAliases = list
-            .whereType<Map<String, dynamic>>()
-            .map(EntityAlias.fromJson)
-            .where(
-              (item) => item.entityId.isNotEmpty && item.aliasText.isNotEmpty,
-            )
-            .toList(growable: false);
-      } catch (_) {}
-    }
-
-    final entityRelationsJson = await db.getSetting(_entityRelationsKey);
-    if (entityRelationsJson != null) {
-      try {
-        final list = json.decode(entityRelationsJson) as List<dynamic>;
-        _entityRelations = list
-            .whereType<Map<String, dynamic>>()
-            .map(EntityRelation.fromJson)
-            .where(
-              (item) =>
-                  item.sourceEntityId.isNotEmpty &&
-                  item.targetEntityId.isNotEmpty &&
-                  item.relationType.isNotEmpty,
-            )
-            .toList(growable: false);
-      } catch (_) {}
-    }
-
-    final entityEvidencesJson = await db.getSetting(_entityEvidencesKey);
-    if (entityEvidencesJson != null) {
-      try {
-        final list = json.decode(entityEvidencesJson) as List<dynamic>;
-        _entityEvidences = list
-            .whereType<Map<String, dynamic>>()
-            .map(EntityEvidence.fromJson)
-            .where((item) => item.entityId.isNotEmpty)
-            .toList(growable: false);
-      } catch (_) {}
+    final storedEntityMemories = await _entityMemoryStore.load(
+      db,
+      settings: stored,
+    );
+    if (storedEntityMemories != null) {
+      _entityMemories = storedEntityMemories
+          .where((item) => item.canonicalName.isNotEmpty)
+          .toList(growable: false);
     }
 
-    final adaptiveMemoryItemsJson = await db.getSetting(
-      _adaptiveMemoryItemsKey,
+    final storedEntityAliases = await _entityAliasStore.load(
+      db,
+      settings: stored,
     );
-    if (adaptiveMemoryItemsJson != null) {
-      try {
-        final list = json.decode(adaptiveMemoryItemsJson) as List<dynamic>;
-        _adaptiveMemoryItems = list
-            .whereType<Map<String, dynamic>>()
-            .map(MemoryItem.fromJson)
-            .where((item) => item.displayText.isNotEmpty)
-            .toList(growable: false);
-      } catch (_) {}
+    if (storedEntityAliases != null) {
+      _entityAliases = storedEntityAliases
+          .where(
+            (item) => item.entityId.isNotEmpty && item.aliasText.isNotEmpty,
+          )
+          .toList(growable: false);
     }
 
-    final memoryEventsJson = await db.getSetting(_memoryEventsKey);
-    if (memoryEventsJson != null) {
-      try {
-        final list = json.decode(memoryEventsJson) as List<dynamic>;
-        _memoryEvents = list
-            .whereType<Map<String, dynamic>>()
-            .map(MemoryEvent.fromJson)
-            .where((event) => event.id.isNotEmpty)
-            .toList(growable: false);
-      } catch (_) {}
+    final storedEntityRelations = await _entityRelationStore.load(
+      db,
+      settings: stored,
+    );
+    if (storedEntityRelations != null) {
+      _entityRelations = storedEntityRelations
+          .where(
+            (item) =>
+                item.sourceEntityId.isNotEmpty &&
+                item.targetEntityId.isNotEmpty &&
+                item.relationType.isNotEmpty,
+          )
+          .toList(growable: false);
     }
 
-    // 构建拼音索引
-    _pinyinMatcher.buildIndex(_dictionaryEntries);
-
-    // 加载纠错设置
-    final correctionEnabledStr = await db.getSetting(_correctionEnabledKey);
-    if (correctionEnabledStr != null) {
-      _correctionEnabled = correctionEnabledStr == 'true';
+    final storedEntityEvidences = await _entityEvidenceStore.load(
+      db,
+      settings: stored,
+    );
+    if (storedEntityEvidences != null) {
+      _entityEvidences = storedEntityEvidences
+          .where((item) => item.entityId.isNotEmpty)
+          .toList(growable: false);
     }
 
-    final retroStr = await db.getSetting(_retrospectiveCorrectionEnabledKey);
-    if (retroStr != null) {
-      _retrospectiveCorrectionEnabled = retroStr == 'true';
+    final storedMemoryItems = await _memoryItemStore.load(db, settings: stored);
+    if (storedMemoryItems != null) {
+      _adaptiveMemoryItems = storedMemoryItems
+          .where((item) => item.displayText.isNotEmpty)
+          .toList(growable: false);
     }
 
-    final historyContextStr = await db.getSetting(
-      _historyContextEnhancementEnabledKey,
+    final storedMemoryEvents = await _memoryEventStore.load(
+      db,
+      settings: stored,
     );
-    if (historyContextStr != null) {
-      _historyContextEnhancementEnabled = historyContextStr == 'true';
+    if (storedMemoryEvents != null) {
+      _memoryEvents = storedMemoryEvents
+          .where((event) => event.id.isNotEmpty)
+          .toList(growable: false);
     }
 
-    final localModelIdleUnloadMinutesStr = await db.getSetting(
-      _localModelIdleUnloadMinutesKey,
-    );
-    if (localModelIdleUnloadMinutesStr != null) {
-      _localModelIdleUnloadMinutes =
-          int.tryParse(localModelIdleUnloadMinutesStr)?.clamp(0, 30) ?? 3;
-    }
+    // 构建拼音索引
+    _pinyinMatcher.buildIndex(_dictionaryEntries);
 
     // 加载纠错 prompt
     try {
@@ -782,13 +835,16 @@ class SettingsProvider extends ChangeNotifier {
     await LocalAsrProcessManager.instance.setIdleUnloadMinutes(
       _localModelIdleUnloadMinutes,
     );
-    await _cleanupRemovedSpeakerSettings();
+    await _cleanupRemovedSpeakerSettings(stored);
 
     _loadCompleted = true;
     notifyListeners();
+    PipelineTracer.instance.markStartup(PipelineStage.startupSettingsLoaded);
   }
 
-  Future<void> _cleanupRemovedSpeakerSettings() async {
+  Future<void> _cleanupRemovedSpeakerSettings(
+    Map<String, String> stored,
+  ) async {
     const keys = [
       'speaker_3d_enabled',
       'speaker_3d_model_path',
@@ -801,6 +857,7 @@ class SettingsProvider extends ChangeNotifier {
       'speaker_3d_download_source_mode',
     ];
     for (final key in keys) {
+      if (!stored.containsKey(key)) continue;
       await AppDatabase.instance.removeSetting(key);
     }
   }
@@ -1046,6 +1103,7 @@ class SettingsProvider extends ChangeNotifier {
       );
       _saveSetting(_aiEnhanceConfigKey, json.encode(_aiEnhanceConfig.toJson()));
     }
+    _applyRequestPolicies();
   }
 
   // ===== 语音模型条目管理 =====
@@ -1114,24 +1172,29 @@ class SettingsProvider extends ChangeNotifier {
         unawaited(_saveSttModelEntries());
       }
 
-      // 根据 vendorName + 模型文件名判断 provider type
-      SttProviderType type;
-      if (_isLocalSttVendorName(normalized.vendorName)) {
-        type = SttProviderType.senseVoice;
-      } else {
-        type = SttProviderType.cloud;
-      }
-      _config = _normalizeSttConfig(
-        _config.copyWith(
-          type: type,
-          name: normalized.vendorName,
-          baseUrl: normalized.baseUrl,
-          apiKey: normalized.apiKey,
-          model: normalized.model,
-        ),
-      );
+      _config = _sttConfigForEntry(normalized);
       _saveSetting(_configKey, json.encode(_config.toJson()));
     }
+    _applyRequestPolicies();
+  }
+
+  SttProviderConfig _sttConfigForEntry(SttModelEntry entry) {
+    // 根据 vendorName + 模型文件名判断 provider type
+    SttProviderType type;
+    if (_isLocalSttVendorName(entry.vendorName)) {
+      type = SttProviderType.senseVoice;
+    } else {
+      type = SttProviderType.cloud;
+    }
+    return _normalizeSttConfig(
+      _config.copyWith(
+        type: type,
+        name: entry.vendorName,
+        baseUrl: entry.baseUrl,
+        apiKey: entry.apiKey,
+        model: entry.model,
+      ),
+    );
   }
 
   bool _isLocalSttVendorName(String vendorName) {
@@ -1360,26 +1423,18 @@ class SettingsProvider extends ChangeNotifier {
   // ===== 词典管理 =====
 
   Future<void> _saveDictionaryEntries() async {
-    await _saveSetting(
-      _dictionaryEntriesKey,
-      json.encode(_dictionaryEntries.map((e) => e.toJson()).toList()),
-    );
+    await _dictionaryStore.save(AppDatabase.instance, _dictionaryEntries);
   }
 
   Future<void> _saveDictationTermPendingCandidates() async {
-    await _saveSetting(
-      _dictationTermPendingCandidatesKey,
-      json.encode(
-        _dictationTermPendingCandidates.map((e) => e.toJson()).toList(),
-      ),
+    await _pendingCandidateStore.save(
+      AppDatabase.instance,
+      _dictationTermPendingCandidates,
     );
   }
 
   Future<void> _saveTermContextEntries() async {
-    await _saveSetting(
-      _termContextEntriesKey,
-      json.encode(_termContextEntries.map((e) => e.toJson()).toList()),
-    );
+    await _termContextStore.save(AppDatabase.instance, _termContextEntries);
   }
 
   Future<void> _saveImportedReferenceTerms() async {
@@ -1390,45 +1445,27 @@ class SettingsProvider extends ChangeNotifier {
   }
 
   Future<void> _saveEntityMemories() async {
-    await _saveSetting(
-      _entityMemoriesKey,
-      json.encode(_entityMemories.map((e) => e.toJson()).toList()),
-    );
+    await _entityMemoryStore.save(AppDatabase.instance, _entityMemories);
   }
 
   Future<void> _saveEntityAliases() async {
-    await _saveSetting(
-      _entityAliasesKey,
-      json.encode(_entityAliases.map((e) => e.toJson()).toList()),
-    );
+    await _entityAliasStore.save(AppDatabase.instance, _entityAliases);
   }
 
   Future<void> _saveEntityRelations() async {
-    await _saveSetting(
-      _entityRelationsKey,
-      json.encode(_entityRelations.map((e) => e.toJson()).toList()),
-    );
+    await _entityRelationStore.save(AppDatabase.instance, _entityRelations);
   }
 
   Future<void> _saveEntityEvidences() async {
-    await _saveSetting(
-      _entityEvidencesKey,
-      json.encode(_entityEvidences.map((e) => e.toJson()).toList()),
-    );
+    await _entityEvidenceStore.save(AppDatabase.instance, _entityEvidences);
   }
 
   Future<void> _saveAdaptiveMemoryItems() async {
-    await _saveSetting(
-      _adaptiveMemoryItemsKey,
-      json.encode(_adaptiveMemoryItems.map((e) => e.toJson()).toList()),
-    );
+    await _memoryItemStore.save(AppDatabase.instance, _adaptiveMemoryItems);
   }
 
   Future<void> _saveMemoryEvents() async {
-    await _saveSetting(
-      _memoryEventsKey,
-      json.encode(_memoryEvents.map((e) => e.toJson()).toList()),
-    );
+    await _memoryEventStore.save(AppDatabase.instance, _memoryEvents);
   }
 
   /// 重建拼音索引（词典变更后调用）
@@ -3089,6 +3126,15 @@ class SettingsProvider extends ChangeNotifier {
     notifyListeners();
   }
 
+  Future<void> setLocalCorrectionFastPathEnabled(bool enabled) async {
+    _localCorrectionFastPathEnabled = enabled;
+    await _saveSetting(
+      _localCorrectionFastPathEnabledKey,
+      enabled.toString(),
+    );
+    notifyListeners();
+  }
+
   Future<void> setHistoryContextEnhancementEnabled(bool enabled) async {
     _historyContextEnhancementEnabled = enabled;
     await _saveSetting(
@@ -3110,6 +3156,94 @@ class SettingsProvider extends ChangeNotifier {
     notifyListeners();
   }
 
+  // ===== 请求对冲与路由设置 =====
+
+  Future<void> setProviderRoutingEnabled(bool enabled) async {
+    _providerRoutingEnabled = enabled;
+    _applyRequestPolicies();
+    await _saveSetting(_providerRoutingEnabledKey, enabled.toString());
+    notifyListeners();
+  }
+
+  Future<void> setRequestHedgingEnabled(bool enabled) async {
+    _requestHedgingEnabled = enabled;
+    _applyRequestPolicies();
+    await _saveSetting(_requestHedgingEnabledKey, enabled.toString());
+    notifyListeners();
+  }
+
+  /// 设置语音识别的对冲备用条目，为 null 时副本发往当前服务。
+  Future<void> setSttHedgeBackupEntryId(String? id) async {
+    _sttHedgeBackupEntryId = id;
+    _applyRequestPolicies();
+    await _saveSetting(_sttHedgeBackupEntryIdKey, id ?? '');
+    notifyListeners();
+  }
+
+  /// 设置文本模型的对冲备用条目，为 null 时副本发往当前服务。
+  Future<void> setAiHedgeBackupEntryId(String? id) async {
+    _aiHedgeBackupEntryId = id;
+    _applyRequestPolicies();
+    await _saveSetting(_aiHedgeBackupEntryIdKey, id ?? '');
+    notifyListeners();
+  }
+
+  /// 设置松开按键到上屏的延迟预算（毫秒），0 表示不限时。
+  Future<void> setLatencyBudgetMs(int milliseconds) async {
+    _latencyBudgetMs = milliseconds.clamp(0, 10000);
+    await _saveSetting(_latencyBudgetMsKey, _latencyBudgetMs.toString());
+    notifyListeners();
+  }
+
+  Future<void> setLateCorrectionEnabled(bool enabled) async {
+    _lateCorrectionEnabled = enabled;
+    await _saveSetting(_lateCorrectionEnabledKey, enabled.toString());
+    notifyListeners();
+  }
+
+  /// 把对冲与路由设置同步到 [RequestHedger] / [ProviderRouter]。
+  ///
+  /// 对冲备用条目已删除或正是当前启用的条目时不设备用服务；路由的
+  /// 备选按条目列表顺序排列，即用户的偏好顺序。
+  void _applyRequestPolicies() {
+    final hedger = RequestHedger.instance..enabled = _requestHedgingEnabled;
+
+    final sttBackup = _sttModelEntries
+        .where((e) => e.id == _sttHedgeBackupEntryId && !e.enabled)
+        .firstOrNull;
+    hedger.sttBackup = sttBackup == null
+        ? null
+        : _sttConfigForEntry(_normalizeSttModelEntry(sttBackup));
+
+    final aiBackup = _aiModelEntries
+        .where((e) => e.id == _aiHedgeBackupEntryId && !e.enabled)
+        .firstOrNull;
+    hedger.aiBackup = aiBackup == null ? null : _aiConfigForEntry(aiBackup);
+
+    ProviderRouter.instance
+      ..enabled = _providerRoutingEnabled
+      ..sttFallbacks = [
+        for (final entry in _sttModelEntries)
+          if (!entry.enabled)
+            _sttConfigForEntry(_normalizeSttModelEntry(entry)),
+      ]
+      ..aiFallbacks = [
+        for (final entry in _aiModelEntries)
+          if (!entry.enabled) _aiConfigForEntry(entry),
+      ];
+  }
+
+  AiEnhanceConfig _aiConfigForEntry(AiModelEntry entry) {
+    return _aiEnhanceConfig.copyWith(
+      baseUrl: entry.baseUrl,
+      apiKey: entry.apiKey,
+      model: entry.model,
+    );
+  }
+
+  static String? _nonEmpty(String? value) =>
+      value == null || value.isEmpty ? null : value;
+
   bool _containsChinese(String text) {
     return RegExp(r'[\u4e00-\u9fff]').hasMatch(text);
   }
@@ -11,6 +11,7 @@ import '../providers/settings_provider.dart';
 import '../services/log_service.dart';
 import '../services/audio_recorder.dart';
 import '../services/overlay_service.dart';
+import '../services/pipeline_tracer.dart';
 import 'pages/dictionary_page.dart';
 import 'pages/history_page.dart';
 import 'pages/dashboard_page.dart';
@@ -97,6 +98,7 @@ class _MainScreenState extends State<MainScreen> {
   bool _checkingHomePermissions = false;
   bool _homePermissionsChecked = false;
   LogicalKeyboardKey? _lastRegisteredHotkey;
+  bool _hotkeyRegistered = false;
   bool _fnTapToTalkPressCandidate = false;
   bool _onboardingDialogShown = false;
 
@@ -182,19 +184,34 @@ class _MainScreenState extends State<MainScreen> {
 
   void _registerCurrentHotkey(SettingsProvider settings) {
     // 只在热键实际变化时才重新注册，避免不必要的反复注册
-    if (settings.hotkey == _lastRegisteredHotkey) return;
-    _lastRegisteredHotkey = settings.hotkey;
+    if (settings.hotkey == _lastRegisteredHotkey) {
+      _markHotkeyReady(settings);
+      return;
+    }
+    final hotkey = settings.hotkey;
+    _lastRegisteredHotkey = hotkey;
+    _hotkeyRegistered = false;
 
-    final keyCode = _platformKeyCodeFor(settings.hotkey);
+    final keyCode = _platformKeyCodeFor(hotkey);
     if (keyCode == null) return;
 
     LogService.info('HOTKEY', 'registering hotkey keyCode=$keyCode');
     OverlayService.registerHotkey(keyCode: keyCode).then((ok) {
       LogService.info('HOTKEY', 'registerHotkey result=$ok');
+      if (hotkey == _lastRegisteredHotkey) {
+        _hotkeyRegistered = ok;
+        _markHotkeyReady(settings);
+      }
       if (!mounted || ok) return;
     });
   }
 
+  /// 启动追踪：已加载设置中的快捷键注册成功即视为就绪。
+  void _markHotkeyReady(SettingsProvider settings) {
+    if (!_hotkeyRegistered || !settings.coreSettingsLoaded) return;
+    PipelineTracer.instance.markStartup(PipelineStage.startupHotkeyReady);
+  }
+
   void _maybeShowOnboarding(SettingsProvider settings) {
     if (!settings.loadCompleted ||
         !settings.shouldShowOnboardingOnLaunch ||
@@ -361,6 +378,7 @@ class _MainScreenState extends State<MainScreen> {
                 settings.historyContextEnhancementEnabled,
             minRecordingSeconds: settings.minRecordingSeconds,
             useStreaming: settings.aiEnhanceEnabled,
+            triggeredAtUs: OverlayService.lastGlobalKeyEventUs,
           );
         } else if (recording.state == RecordingState.idle) {
           if (!_hasValidSttModel(settings)) {
@@ -368,7 +386,12 @@ class _MainScreenState extends State<MainScreen> {
             return;
           }
           _configureCorrection(settings, recording);
-          recording.startRecording(settings.config);
+          recording.startRecording(
+            settings.config,
+            aiEnhanceConfig: settings.aiEnhanceEnabled
+                ? settings.effectiveAiEnhanceConfig
+                : null,
+          );
           _startVadIfEnabled(settings, recording);
         }
         // transcribing 状态下忽略
@@ -381,7 +404,12 @@ class _MainScreenState extends State<MainScreen> {
           return;
         }
         _configureCorrection(settings, recording);
-        recording.startRecording(settings.config);
+        recording.startRecording(
+          settings.config,
+          aiEnhanceConfig: settings.aiEnhanceEnabled
+              ? settings.effectiveAiEnhanceConfig
+              : null,
+        );
         _startVadIfEnabled(settings, recording);
       } else if (type == 'up' && recording.state == RecordingState.recording) {
         recording.stopAndTranscribe(
@@ -392,6 +420,7 @@ class _MainScreenState extends State<MainScreen> {
               settings.historyContextEnhancementEnabled,
           minRecordingSeconds: settings.minRecordingSeconds,
           useStreaming: settings.aiEnhanceEnabled,
+          triggeredAtUs: OverlayService.lastGlobalKeyEventUs,
         );
       }
     }
@@ -415,6 +444,7 @@ class _MainScreenState extends State<MainScreen> {
         memoryItems: settings.adaptiveMemoryItems,
         maxReferenceEntries: settings.correctionMaxReferenceEntries,
         minCandidateScore: settings.correctionMinCandidateScore,
+        localFastPath: settings.localCorrectionFastPathEnabled,
       );
       recording.onSessionGlossaryFlush = (entries, sourceRef) {
         return settings.recordSessionGlossaryMemory(
@@ -435,6 +465,10 @@ class _MainScreenState extends State<MainScreen> {
     // 终态回溯开关同步
     recording.retrospectiveCorrectionEnabled =
         settings.retrospectiveCorrectionEnabled;
+    recording.setLatencyBudget(
+      settings.latencyBudget,
+      lateCorrection: settings.lateCorrectionEnabled,
+    );
   }
 
   void _startVadIfEnabled(
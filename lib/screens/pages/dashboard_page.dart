@@ -1,5 +1,7 @@
+import 'dart:io';
 import 'dart:math' as math;
 
+import 'package:file_picker/file_picker.dart';
 import 'package:fl_chart/fl_chart.dart';
 import 'package:flutter/material.dart';
 import 'package:intl/intl.dart';
@@ -7,6 +9,7 @@ import 'package:intl/intl.dart';
 import '../../l10n/app_localizations.dart';
 import '../../models/dashboard_stats.dart';
 import '../../services/dashboard_service.dart';
+import '../../services/pipeline_tracer.dart';
 import '../../widgets/modern_ui.dart';
 
 class DashboardPage extends StatefulWidget {
@@ -103,6 +106,8 @@ class _DashboardPageState extends State<DashboardPage> {
           const SizedBox(height: 12),
           _buildRetrospectiveSection(),
           const SizedBox(height: 12),
+          _buildLatencySection(),
+          const SizedBox(height: 12),
           _buildTrendSection(),
           const SizedBox(height: 12),
           _buildDistributionSection(),
@@ -901,6 +906,24 @@ class _DashboardPageState extends State<DashboardPage> {
                   value: _formatNumber(item.total),
                   cs: _cs,
                 ),
+              if (_stats.llmCacheLookups > 0)
+                _TokenLabel(
+                  color: _cs.outline,
+                  label: _l10n.llmCacheHits,
+                  value: _l10n.llmCacheHitSummary(
+                    '${(_stats.llmCacheHitRate * 100).toStringAsFixed(1)}%',
+                    _formatNumber(_stats.llmCacheSavedTokens),
+                  ),
+                  cs: _cs,
+                ),
+              if (_stats.enhanceCachedPromptTokens > 0)
+                _TokenLabel(
+                  color: _cs.outline,
+                  label: _l10n.promptPrefixCache,
+                  value:
+                      '${(_stats.enhancePrefixCacheRate * 100).toStringAsFixed(1)}%',
+                  cs: _cs,
+                ),
             ],
           ),
         ],
@@ -1067,6 +1090,21 @@ class _DashboardPageState extends State<DashboardPage> {
                 _l10n.correctionSelectedRate,
                 _formatPercent(_stats.correctionSelectedRate),
               ),
+              if (_stats.correctionLocalRewrites > 0) ...[
+                _buildEfficiencyItem(
+                  _l10n.correctionLocalRewrites,
+                  _formatNumber(_stats.correctionLocalRewrites),
+                ),
+                _buildEfficiencyItem(
+                  _l10n.correctionLlmAvoidedRate,
+                  _formatPercent(_stats.correctionLlmAvoidedRate),
+                ),
+              ],
+              if (_stats.correctionShadowChecks > 0)
+                _buildEfficiencyItem(
+                  _l10n.correctionShadowMismatchRate,
+                  _formatPercent(_stats.correctionShadowMismatchRate),
+                ),
             ],
           ),
         ],
@@ -1207,6 +1245,175 @@ class _DashboardPageState extends State<DashboardPage> {
     );
   }
 
+  // ─────────────── Pipeline Latency Section ───────────────
+
+  String _stageLabel(String stage) {
+    return switch (stage) {
+      PipelineStage.hotkey => _l10n.pipelineStageHotkey,
+      PipelineStage.recorderStop => _l10n.pipelineStageRecorderStop,
+      PipelineStage.segmentWait => _l10n.pipelineStageSegmentWait,
+      PipelineStage.stt => _l10n.pipelineStageStt,
+      PipelineStage.correctionLocal => _l10n.pipelineStageCorrectionLocal,
+      PipelineStage.correctionLlm => _l10n.pipelineStageCorrectionLlm,
+      PipelineStage.retroCorrection => _l10n.pipelineStageRetroCorrection,
+      PipelineStage.enhanceFirstToken => _l10n.pipelineStageEnhanceFirstToken,
+      PipelineStage.enhance => _l10n.pipelineStageEnhance,
+      PipelineStage.insertText => _l10n.pipelineStageInsertText,
+      PipelineStage.endToEnd => _l10n.pipelineStageEndToEnd,
+      PipelineStage.startupFirstFrame => _l10n.pipelineStageStartupFirstFrame,
+      PipelineStage.startupSettings => _l10n.pipelineStageStartupSettings,
+      PipelineStage.startupHotkeyReady =>
+        _l10n.pipelineStageStartupHotkeyReady,
+      PipelineStage.startupSettingsLoaded =>
+        _l10n.pipelineStageStartupSettingsLoaded,
+      _ => stage,
+    };
+  }
+
+  Widget _buildLatencySection() {
+    if (_stats.stageLatencies.isEmpty && _stats.modelStreamLatencies.isEmpty) {
+      return const SizedBox.shrink();
+    }
+
+    final headerStyle = TextStyle(fontSize: 11, color: _cs.onSurfaceVariant);
+    final valueStyle = TextStyle(
+      fontSize: 12,
+      fontWeight: FontWeight.w600,
+      color: _cs.onSurface,
+    );
+    TableRow row(List<String> cells, TextStyle style) {
+      return TableRow(
+        children: [
+          for (var i = 0; i < cells.length; i++)
+            Padding(
+              padding: const EdgeInsets.symmetric(vertical: 4),
+              child: Text(
+                cells[i],
+                textAlign: i == 0 ? TextAlign.left : TextAlign.right,
+                style: i == 0 ? style.copyWith(color: _cs.onSurface) : style,
+              ),
+            ),
+        ],
+      );
+    }
+
+    return _Card(
+      cs: _cs,
+      child: Column(
+        crossAxisAlignment: CrossAxisAlignment.start,
+        children: [
+          Row(
+            children: [
+              Expanded(
+                child: _buildSectionHeading(
+                  _l10n.pipelineLatencyTitle(
+                    DashboardService.latencyWindowDays,
+                  ),
+                  Icons.timer_outlined,
+                ),
+              ),
+              if (PipelineTracer.instance.hasTraces)
+                TextButton.icon(
+                  onPressed: _exportTrace,
+                  icon: const Icon(Icons.file_download_outlined, size: 16),
+                  label: Text(_l10n.exportTrace),
+                ),
+            ],
+          ),
+          if (_stats.stageLatencies.isNotEmpty) ...[
+            const SizedBox(height: 10),
+            Table(
+              columnWidths: const {0: FlexColumnWidth(2)},
+              children: [
+                row([
+                  _l10n.latencyStage,
+                  _l10n.latencyCount,
+                  'P50',
+                  'P90',
+                  'P99',
+                ], headerStyle),
+                for (final latency in _stats.stageLatencies)
+                  row([
+                    _stageLabel(latency.stage),
+                    _formatNumber(latency.count),
+                    _formatLatency(latency.p50Ms),
+                    _formatLatency(latency.p90Ms),
+                    _formatLatency(latency.p99Ms),
+                  ], valueStyle),
+              ],
+            ),
+          ],
+          if (_stats.modelStreamLatencies.isNotEmpty) ...[
+            const SizedBox(height: 14),
+            Text(_l10n.modelStreamLatencyTitle, style: headerStyle),
+            const SizedBox(height: 6),
+            Table(
+              columnWidths: const {0: FlexColumnWidth(2)},
+              children: [
+                row([
+                  _l10n.latencyModel,
+                  _l10n.latencyCount,
+                  _l10n.firstTokenP50,
+                  _l10n.firstTokenP90,
+                  _l10n.outputSpeed,
+                ], headerStyle),
+                for (final latency in _stats.modelStreamLatencies)
+                  row([
+                    latency.model,
+                    _formatNumber(latency.count),
+                    _formatLatency(latency.firstTokenP50Ms),
+                    _formatLatency(latency.firstTokenP90Ms),
+                    latency.tokensPerSecond > 0
+                        ? '${latency.tokensPerSecond.toStringAsFixed(1)} tok/s'
+                        : '-',
+                  ], valueStyle),
+              ],
+            ),
+          ],
+        ],
+      ),
+    );
+  }
+
+  String _formatLatency(double ms) {
+    if (ms >= 1000) return '${(ms / 1000).toStringAsFixed(2)}s';
+    if (ms >= 10) return '${ms.round()}ms';
+    return '${ms.toStringAsFixed(1)}ms';
+  }
+
+  Future<void> _exportTrace() async {
+    final messenger = ScaffoldMessenger.of(context);
+    final l10n = _l10n;
+    final cs = _cs;
+    try {
+      final stamp = DateFormat('yyyyMMdd_HHmmss').format(DateTime.now());
+      final savePath = await FilePicker.platform.saveFile(
+        dialogTitle: l10n.exportTrace,
+        fileName: 'voicetype_trace_$stamp.json',
+        type: FileType.custom,
+        allowedExtensions: const ['json'],
+      );
+      if (savePath == null || savePath.trim().isEmpty) return;
+
+      final targetPath = savePath.toLowerCase().endsWith('.json')
+          ? savePath
+          : '$savePath.json';
+      await File(
+        targetPath,
+      ).writeAsString(PipelineTracer.instance.exportChromeTrace());
+      messenger.showSnackBar(
+        SnackBar(content: Text(l10n.traceExported(targetPath))),
+      );
+    } catch (_) {
+      messenger.showSnackBar(
+        SnackBar(
+          content: Text(l10n.traceExportFailed),
+          backgroundColor: cs.error,
+        ),
+      );
+    }
+  }
+
   double _logTokenValue(int value) {
     if (value <= 0) return 0;
     return math.log(value + 1) / math.ln10;
@@ -125,6 +125,7 @@ class _GeneralPageState extends State<GeneralPage> {
   }
 
   Future<void> _loadLogInfo() async {
+    await LogService.flush();
     final logPath = await LogService.logFilePath;
     final logDirPath = await LogService.logDirectoryPath;
     final fileSize = await LogService.getLogFileSize();
@@ -741,6 +742,39 @@ class _GeneralPageState extends State<GeneralPage> {
               ),
             ],
           ),
+          const SizedBox(height: 12),
+          Row(
+            children: [
+              const SizedBox(width: 32),
+              Expanded(
+                child: Column(
+                  crossAxisAlignment: CrossAxisAlignment.start,
+                  children: [
+                    Text(
+                      l10n.localCorrectionFastPathEnabled,
+                      style: TextStyle(
+                        fontSize: 13,
+                        fontWeight: FontWeight.w500,
+                        color: _cs.onSurface,
+                      ),
+                    ),
+                    const SizedBox(height: 4),
+                    Text(
+                      l10n.localCorrectionFastPathDescription,
+                      style: TextStyle(fontSize: 12, color: _cs.outline),
+                    ),
+                  ],
+                ),
+              ),
+              const SizedBox(width: 12),
+              Switch(
+                value: settings.localCorrectionFastPathEnabled,
+                onChanged: settings.correctionEnabled
+                    ? (v) => settings.setLocalCorrectionFastPathEnabled(v)
+                    : null,
+              ),
+            ],
+          ),
         ],
       ),
     );
@@ -34,6 +34,13 @@ class _HistoryPageState extends State<HistoryPage> {
   /// 记录哪些 item id 的原始文本处于展开状态
   final Set<String> _expandedRawText = {};
   int _currentPage = 0;
+  RecordingProvider? _recording;
+
+  @override
+  void dispose() {
+    _recording?.releaseHistoryPages();
+    super.dispose();
+  }
 
   void _showFloatingSnackBar(String message, {Duration? duration}) {
     final text = message.trim();
@@ -57,16 +64,28 @@ class _HistoryPageState extends State<HistoryPage> {
   Widget build(BuildContext context) {
     final recording = context.watch<RecordingProvider>();
     final settings = context.watch<SettingsProvider>();
+    _recording = recording;
     final history = recording.history;
+    final historyCount = recording.historyTotalCount;
     final pendingCandidates = settings.dictationTermPendingCandidates;
-    final totalPages = _totalHistoryPages(history.length);
-    final currentPage = _clampedHistoryPage(history.length);
+    final totalPages = _totalHistoryPages(historyCount);
+    final currentPage = _clampedHistoryPage(historyCount);
     if (_currentPage != currentPage) {
       SchedulerBinding.instance.addPostFrameCallback((_) {
         if (!mounted) return;
         setState(() => _currentPage = currentPage);
       });
     }
+    // 当前页超出已加载窗口时按需拉取下一页。
+    final pageEnd = (currentPage + 1) * _historyPageSize;
+    if (pageEnd > history.length &&
+        recording.hasMoreHistory &&
+        !recording.loadingMoreHistory) {
+      SchedulerBinding.instance.addPostFrameCallback((_) {
+        if (!mounted) return;
+        recording.loadMoreHistory();
+      });
+    }
     final hasLearnableEditedHistory = history.any(
       (item) =>
           recording.isHistoryEdited(item.id) &&
@@ -87,7 +106,7 @@ class _HistoryPageState extends State<HistoryPage> {
             const SizedBox(height: 18),
           ],
           Expanded(
-            child: history.isEmpty
+            child: historyCount == 0
                 ? _buildEmpty(l10n)
                 : _buildList(
                     context,
@@ -101,7 +120,7 @@ class _HistoryPageState extends State<HistoryPage> {
           _buildArchiveHeader(
             recording: recording,
             settings: settings,
-            historyCount: history.length,
+            historyCount: historyCount,
             currentPage: currentPage,
             totalPages: totalPages,
             hasLearnableEditedHistory: hasLearnableEditedHistory,
@@ -440,6 +459,9 @@ class _HistoryPageState extends State<HistoryPage> {
         .skip(pageStart)
         .take(_historyPageSize)
         .toList(growable: false);
+    if (visibleHistory.isEmpty && recording.hasMoreHistory) {
+      return const Center(child: CircularProgressIndicator());
+    }
 
     return ListView.builder(
       padding: EdgeInsets.zero,
@@ -452,7 +474,7 @@ class _HistoryPageState extends State<HistoryPage> {
         return _buildArchiveCard(
           item: item,
           historyIndex: historyIndex,
-          totalCount: history.length,
+          totalCount: recording.historyTotalCount,
           recording: recording,
           l10n: l10n,
           wasEdited: wasEdited,
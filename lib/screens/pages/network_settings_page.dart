@@ -82,8 +82,188 @@ class NetworkSettingsPage extends StatelessWidget {
               ],
             ),
           ),
+          const SizedBox(height: 16),
+          _buildRequestPolicyCard(cs, settings, l10n),
         ],
       ),
     );
   }
+
+  Widget _buildRequestPolicyCard(
+    ColorScheme cs,
+    SettingsProvider settings,
+    AppLocalizations l10n,
+  ) {
+    final enabled = settings.requestHedgingEnabled;
+    final sttCandidates = settings.sttModelEntries
+        .where((e) => !e.enabled)
+        .toList();
+    final aiCandidates = settings.aiModelEntries
+        .where((e) => !e.enabled)
+        .toList();
+    final sttBackupId =
+        sttCandidates.any((e) => e.id == settings.sttHedgeBackupEntryId)
+        ? settings.sttHedgeBackupEntryId
+        : null;
+    final aiBackupId =
+        aiCandidates.any((e) => e.id == settings.aiHedgeBackupEntryId)
+        ? settings.aiHedgeBackupEntryId
+        : null;
+
+    Widget backupRow({
+      required String label,
+      required String? value,
+      required List<(String, String)> options,
+      required ValueChanged<String?> onChanged,
+    }) {
+      return Padding(
+        padding: const EdgeInsets.only(top: 8),
+        child: Row(
+          children: [
+            Expanded(
+              child: Text(
+                label,
+                style: TextStyle(fontSize: 14, color: cs.onSurface),
+              ),
+            ),
+            DropdownButton<String?>(
+              value: value,
+              onChanged: enabled ? onChanged : null,
+              items: [
+                DropdownMenuItem<String?>(
+                  value: null,
+                  child: Text(l10n.hedgeBackupSameService),
+                ),
+                for (final (id, name) in options)
+                  DropdownMenuItem<String?>(value: id, child: Text(name)),
+              ],
+            ),
+          ],
+        ),
+      );
+    }
+
+    return Container(
+      width: double.infinity,
+      padding: const EdgeInsets.all(20),
+      decoration: BoxDecoration(
+        color: cs.surface,
+        borderRadius: BorderRadius.circular(12),
+        border: Border.all(color: cs.outlineVariant),
+      ),
+      child: Column(
+        crossAxisAlignment: CrossAxisAlignment.start,
+        children: [
+          SwitchListTile.adaptive(
+            contentPadding: EdgeInsets.zero,
+            value: settings.providerRoutingEnabled,
+            title: Text(
+              l10n.providerRoutingEnabled,
+              style: TextStyle(
+                fontSize: 15,
+                fontWeight: FontWeight.w600,
+                color: cs.onSurface,
+              ),
+            ),
+            subtitle: Text(l10n.providerRoutingDescription),
+            onChanged: settings.setProviderRoutingEnabled,
+          ),
+          const Divider(height: 24),
+          SwitchListTile.adaptive(
+            contentPadding: EdgeInsets.zero,
+            value: enabled,
+            title: Text(
+              l10n.requestHedgingEnabled,
+              style: TextStyle(
+                fontSize: 15,
+                fontWeight: FontWeight.w600,
+                color: cs.onSurface,
+              ),
+            ),
+            subtitle: Text(l10n.requestHedgingDescription),
+            onChanged: settings.setRequestHedgingEnabled,
+          ),
+          backupRow(
+            label: l10n.sttHedgeBackup,
+            value: sttBackupId,
+            options: [
+              for (final e in sttCandidates)
+                (e.id, '${e.vendorName} · ${e.model}'),
+            ],
+            onChanged: settings.setSttHedgeBackupEntryId,
+          ),
+          backupRow(
+            label: l10n.aiHedgeBackup,
+            value: aiBackupId,
+            options: [
+              for (final e in aiCandidates)
+                (e.id, '${e.vendorName} · ${e.model}'),
+            ],
+            onChanged: settings.setAiHedgeBackupEntryId,
+          ),
+          const Divider(height: 24),
+          Row(
+            children: [
+              Expanded(
+                child: Column(
+                  crossAxisAlignment: CrossAxisAlignment.start,
+                  children: [
+                    Text(
+                      l10n.latencyBudgetTitle,
+                      style: TextStyle(
+                        fontSize: 15,
+                        fontWeight: FontWeight.w600,
+                        color: cs.onSurface,
+                      ),
+                    ),
+                    const SizedBox(height: 4),
+                    Text(
+                      l10n.latencyBudgetDescription,
+                      style: TextStyle(
+                        fontSize: 13,
+                        color: cs.onSurfaceVariant,
+                      ),
+                    ),
+                  ],
+                ),
+              ),
+              const SizedBox(width: 16),
+              DropdownButton<int>(
+                value: _latencyBudgetOptions.contains(settings.latencyBudgetMs)
+                    ? settings.latencyBudgetMs
+                    : 0,
+                onChanged: (value) {
+                  if (value != null) settings.setLatencyBudgetMs(value);
+                },
+                items: [
+                  for (final ms in _latencyBudgetOptions)
+                    DropdownMenuItem<int>(
+                      value: ms,
+                      child: Text(_formatLatencyBudget(l10n, ms)),
+                    ),
+                ],
+              ),
+            ],
+          ),
+          SwitchListTile.adaptive(
+            contentPadding: EdgeInsets.zero,
+            value: settings.lateCorrectionEnabled,
+            title: Text(l10n.lateCorrectionEnabled),
+            subtitle: Text(l10n.lateCorrectionDescription),
+            onChanged: settings.latencyBudgetMs > 0
+                ? settings.setLateCorrectionEnabled
+                : null,
+          ),
+        ],
+      ),
+    );
+  }
+
+  static const _latencyBudgetOptions = [0, 1000, 1500, 2000, 3000, 5000];
+
+  static String _formatLatencyBudget(AppLocalizations l10n, int ms) {
+    if (ms == 0) return l10n.latencyBudgetUnlimited;
+    final seconds = ms % 1000 == 0 ? '${ms ~/ 1000}' : '${ms / 1000}';
+    return l10n.latencyBudgetSeconds(seconds);
+  }
 }
@@ -850,7 +850,8 @@ class _PromptWorkshopPageState extends State<PromptWorkshopPage> {
 
       var outputText = outputBuffer.toString().trim();
       if (outputText.isEmpty) {
-        final result = await service.enhance(inputText);
+        // 调试提示词时每次都要真实请求。
+        final result = await service.enhance(inputText, useCache: false);
         outputText = result.text;
       }
       if (correctionEntries.isNotEmpty) {
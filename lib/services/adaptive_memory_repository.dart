@@ -4,11 +4,20 @@ import '../models/entity_alias.dart';
 import '../models/entity_memory.dart';
 import '../models/term_context_entry.dart';
 import '../models/memory_item.dart';
+import 'memory_item_index.dart';
 import 'session_glossary.dart';
 
 class AdaptiveMemoryRepository {
   const AdaptiveMemoryRepository();
 
+  /// 将记忆条目与旧版词典、待确认候选、上下文术语、实体及会话锚定合并，
+  /// 按召回优先级排序。
+  ///
+  /// 旧版数据到 [MemoryItem] 的投影按源对象实例缓存（模型均为不可变对象，
+  /// 修改时以 copyWith 产生新实例），因此未变化的条目保持同一 id。
+  /// 输入与上次合并逐项相同时直接复用上次快照；否则只对新增条目做二分插入，
+  /// 不再对全部结果重新排序。快照登记到 [MemoryItemIndex]，
+  /// 在其上连续记录纠错时按键查找的索引只构建一次。
   List<MemoryItem> mergeWithLegacy({
     required List<MemoryItem> memoryItems,
     required List<DictionaryEntry> dictionaryEntries,
@@ -18,6 +27,23 @@ class AdaptiveMemoryRepository {
     required List<EntityAlias> entityAliases,
     SessionGlossary? sessionGlossary,
   }) {
+    final pins =
+        sessionGlossary?.strongEntries.values.toList(growable: false) ??
+        const <TermPin>[];
+    final sources = <List<Object>>[
+      memoryItems,
+      dictionaryEntries,
+      pendingCandidates,
+      termContextEntries,
+      entityMemories,
+      entityAliases,
+      pins,
+    ];
+    final previous = _lastMerge;
+    if (previous != null && previous.matches(sources)) {
+      return previous.items;
+    }
+
     final merged = <String, MemoryItem>{
       for (final item in memoryItems) item.normalizedKey: item,
     };
@@ -27,15 +53,15 @@ class AdaptiveMemoryRepository {
     }
 
     for (final entry in dictionaryEntries.where((e) => e.enabled)) {
-      addIfAbsent(_fromDictionaryEntry(entry));
+      addIfAbsent(_project(entry, () => _fromDictionaryEntry(entry))!);
     }
 
     for (final candidate in pendingCandidates) {
-      addIfAbsent(_fromPendingCandidate(candidate));
+      addIfAbsent(_project(candidate, () => _fromPendingCandidate(candidate))!);
     }
 
     for (final entry in termContextEntries.where((e) => e.enabled)) {
-      final item = _fromTermContextEntry(entry);
+      final item = _project(entry, () => _fromTermContextEntry(entry));
       if (item != null) addIfAbsent(item);
     }
 
@@ -44,20 +70,90 @@ class AdaptiveMemoryRepository {
       aliasesByEntity.putIfAbsent(alias.entityId, () => []).add(alias);
     }
     for (final entity in entityMemories.where((e) => e.enabled)) {
-      addIfAbsent(_fromEntityMemory(entity, aliasesByEntity[entity.id] ?? []));
+      addIfAbsent(
+        _projectEntity(entity, aliasesByEntity[entity.id] ?? const []),
+      );
     }
 
-    if (sessionGlossary != null) {
-      for (final pin in sessionGlossary.strongEntries.values) {
-        addIfAbsent(_fromSessionPin(pin));
-      }
+    for (final pin in pins) {
+      addIfAbsent(_project(pin, () => _fromSessionPin(pin))!);
     }
 
-    final result = merged.values.toList(growable: false)
-      ..sort(_compareForRecall);
+    final result = List<MemoryItem>.unmodifiable(
+      previous == null
+          ? (merged.values.toList()..sort(_compareForRecall))
+          : _resort(previous.items, merged.values),
+    );
+    _lastMerge = _MergeSnapshot(sources, result);
+    MemoryItemIndex.register(result);
     return result;
   }
 
+  static const int _maxIncrementalInserts = 32;
+  static _MergeSnapshot? _lastMerge;
+
+  static final Expando<_Projection> _projectionBySource = Expando(
+    'MemoryItemProjection',
+  );
+
+  MemoryItem? _project(Object source, MemoryItem? Function() build) {
+    final cached = _projectionBySource[source];
+    if (cached != null) return cached.item;
+    final item = build();
+    _projectionBySource[source] = _Projection(item, const []);
+    return item;
+  }
+
+  MemoryItem _projectEntity(EntityMemory entity, List<EntityAlias> aliases) {
+    final cached = _projectionBySource[entity];
+    if (cached != null && _sameItems(cached.aliases, aliases)) {
+      return cached.item!;
+    }
+    final item = _fromEntityMemory(entity, aliases);
+    _projectionBySource[entity] = _Projection(
+      item,
+      List<EntityAlias>.of(aliases, growable: false),
+    );
+    return item;
+  }
+
+  /// 基于上次的有序结果增量得到新结果：保留仍存在的条目，二分插入新条目。
+  /// 新条目较多时退化为整体排序。
+  List<MemoryItem> _resort(
+    List<MemoryItem> previous,
+    Iterable<MemoryItem> current,
+  ) {
+    final previousSet = Set<MemoryItem>.identity()..addAll(previous);
+    final added = current.where((item) => !previousSet.contains(item)).toList();
+    if (added.length > _maxIncrementalInserts) {
+      return current.toList()..sort(_compareForRecall);
+    }
+    final currentSet = Set<MemoryItem>.identity()..addAll(current);
+    final result = previous.where(currentSet.contains).toList();
+    for (final item in added) {
+      var low = 0;
+      var high = result.length;
+      while (low < high) {
+        final mid = (low + high) >> 1;
+        if (_compareForRecall(result[mid], item) <= 0) {
+          low = mid + 1;
+        } else {
+          high = mid;
+        }
+      }
+      result.insert(low, item);
+    }
+    return result;
+  }
+
+  static bool _sameItems(List<Object> a, List<Object> b) {
+    if (a.length != b.length) return false;
+    for (var i = 0; i < a.length; i++) {
+      if (!identical(a[i], b[i])) return false;
+    }
+    return true;
+  }
+
   List<MemoryItem> recall({
     required List<MemoryItem> memoryItems,
     required String currentText,
@@ -267,6 +363,36 @@ class AdaptiveMemoryRepository {
   }
 }
 
+/// 上次合并的输入（逐项快照）与结果。
+class _MergeSnapshot {
+  final List<List<Object>> sources;
+  final List<MemoryItem> items;
+
+  _MergeSnapshot(List<List<Object>> sources, this.items)
+    : sources = [
+        for (final list in sources) List<Object>.of(list, growable: false),
+      ];
+
+  bool matches(List<List<Object>> current) {
+    for (var i = 0; i < sources.length; i++) {
+      if (!AdaptiveMemoryRepository._sameItems(sources[i], current[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+class _Projection {
+  /// 为 null 表示该源对象不产生记忆条目。
+  final MemoryItem? item;
+
+  /// 实体投影依赖的别名，其他来源为空。
+  final List<EntityAlias> aliases;
+
+  const _Projection(this.item, this.aliases);
+}
+
 class _ScoredMemoryItem {
   final MemoryItem item;
   final double score;
@@ -1,3 +1,5 @@
+import 'dart:async';
+
 import '../models/ai_enhance_config.dart';
 import 'ai_providers/ai_provider.dart';
 import 'ai_providers/openai_compatible_ai_provider.dart';
@@ -6,6 +8,11 @@ import 'ai_providers/zai_ai_provider.dart';
 import 'ai_providers/deepseek_ai_provider.dart';
 import 'ai_providers/aliyun_ai_provider.dart';
 import 'ai_providers/gemini_ai_provider.dart';
+import 'llm_result_cache.dart';
+import 'llm_stream_stats_service.dart';
+import 'provider_router.dart';
+import 'request_hedger.dart';
+import 'token_stats_service.dart';
 
 // Re-export types for backward compatibility
 export 'ai_providers/ai_provider.dart'
@@ -61,19 +68,140 @@ class AiEnhanceService {
     return OpenAiCompatibleAiProvider(config);
   }
 
+  /// [config] 的端点在健康度统计、对冲与路由中的标识。
+  static String routeKeyOf(AiEnhanceConfig config) =>
+      RequestHedger.keyFor('llm', config.baseUrl, config.model);
+
   /// 批量增强文本。
-  Future<AiEnhanceResult> enhance(String text, {Duration? timeout}) {
-    return _resolveProvider().enhance(text, timeout: timeout);
+  ///
+  /// 先查 [LlmResultCache]：端点、模型、system prompt 与 user message
+  /// 完全相同的请求直接返回缓存结果。结果记在实际产出它的端点名下，
+  /// 转移或对冲到备用服务时不会当作当前模型的结果。[unchangedText] 为
+  /// 「无改动」时应得到的文本（默认即 [text]），结果与它相同时只记负
+  /// 缓存；[useCache] 为 false 时既不读也不写缓存。
+  ///
+  /// 未命中时经 [ProviderRouter] 调用：开启路由时在当前端点与
+  /// [ProviderRouter.aiFallbacks] 中选择最快的健康端点，提示词保持不变。
+  ///
+  /// 每次都会变的提示信息（如最近输入上下文）经 [context] 放进 user
+  /// message，不要拼到 `config.prompt`，否则 system prompt 不再稳定，
+  /// 服务端的前缀缓存无法命中。
+  Future<AiEnhanceResult> enhance(
+    String text, {
+    Duration? timeout,
+    bool useCache = true,
+    String? unchangedText,
+    String context = '',
+  }) async {
+    final cache = LlmResultCache.instance;
+    final original = unchangedText ?? text;
+    final useCached = useCache && cache.enabled;
+    if (useCached) {
+      final cached = await cache.lookup(
+        _cacheKeyFor(text, context),
+        unchangedText: original,
+      );
+      if (cached != null) return cached;
+    }
+    final (result, producer) = await _enhanceRouted(text, timeout, context);
+    if (useCached) {
+      unawaited(
+        cache.store(
+          producer._cacheKeyFor(text, context),
+          result,
+          unchangedText: original,
+        ),
+      );
+    }
+    return result;
+  }
+
+  String _cacheKeyFor(String text, String context) {
+    final provider = _resolveProvider();
+    return LlmResultCache.keyFor(
+      baseUrl: config.baseUrl,
+      model: config.model,
+      prompt: provider.resolvePrompt(),
+      message: provider.buildEnhanceUserMessage(text, context: context),
+    );
+  }
+
+  /// 返回结果及实际产出它的服务。
+  Future<(AiEnhanceResult, AiEnhanceService)> _enhanceRouted(
+    String text,
+    Duration? timeout,
+    String context,
+  ) {
+    return ProviderRouter.instance.run(
+      _routeCandidates(),
+      (AiEnhanceConfig target) =>
+          AiEnhanceService(target)._enhanceHedged(text, timeout, context),
+    );
+  }
+
+  /// 当前端点在前、开启路由时再附上 [ProviderRouter.aiFallbacks] 的候选。
+  List<RouteCandidate<AiEnhanceConfig>> _routeCandidates() {
+    final router = ProviderRouter.instance;
+    final key = routeKeyOf(config);
+    return [
+      RouteCandidate(key, config),
+      if (router.enabled)
+        for (final fallback in router.aiFallbacks)
+          if (routeKeyOf(fallback) != key)
+            RouteCandidate(routeKeyOf(fallback), _withEndpointOf(fallback)),
+    ];
+  }
+
+  /// 沿用当前请求的提示词等设置，只换成 [endpoint] 的端点与模型。
+  AiEnhanceConfig _withEndpointOf(AiEnhanceConfig endpoint) {
+    return config.copyWith(
+      baseUrl: endpoint.baseUrl,
+      apiKey: endpoint.apiKey,
+      model: endpoint.model,
+    );
+  }
+
+  /// 经 [RequestHedger] 调用：迟迟未返回时对冲到同一端点或
+  /// [RequestHedger.aiBackup]。返回结果及实际产出它的服务。
+  Future<(AiEnhanceResult, AiEnhanceService)> _enhanceHedged(
+    String text,
+    Duration? timeout,
+    String context,
+  ) {
+    final provider = _resolveProvider();
+    final hedger = RequestHedger.instance;
+    final backup = hedger.aiBackup;
+    final hedgeService = backup == null
+        ? null
+        : AiEnhanceService(_withEndpointOf(backup));
+    return hedger.run(
+      key: routeKeyOf(config),
+      primary: (_) async => (
+        await provider.enhance(text, timeout: timeout, context: context),
+        this,
+      ),
+      hedge: hedgeService == null
+          ? null
+          : (_) async => (
+              await hedgeService._resolveProvider().enhance(
+                text,
+                timeout: timeout,
+                context: context,
+              ),
+              hedgeService,
+            ),
+      hedgeKey: backup == null ? null : routeKeyOf(backup),
+    );
   }
 
   /// 构建一次文本增强请求的完整输入文本，用于按统一口径估算历史 token。
   ///
   /// 统计口径：system prompt + 实际传给模型的 user message（其中包含 source 文本）。
-  String buildInputForTokenEstimate(String text) {
+  String buildInputForTokenEstimate(String text, {String context = ''}) {
     final provider = _resolveProvider();
     return [
       provider.resolvePrompt(),
-      provider.buildEnhanceUserMessage(text),
+      provider.buildEnhanceUserMessage(text, context: context),
     ].join('\n\n');
   }
 
@@ -113,9 +241,90 @@ class AiEnhanceService {
     return tokens;
   }
 
-  /// 流式增强文本（SSE）。
-  Stream<String> enhanceStream(String text, {Duration? timeout}) {
-    return _resolveProvider().enhanceStream(text, timeout: timeout);
+  /// 流式增强文本（SSE）。[context] 同 [enhance]。
+  ///
+  /// 开启路由时选择首字延迟最低的健康端点；已输出的文本无法撤回，
+  /// 因此流式请求不做失败转移。流结束后首字延迟与输出速度记入
+  /// [ProviderRouter] 与 [LlmStreamStatsService]，总耗时记入
+  /// [RequestHedger] 供延迟预算预测，服务端用量计入 [TokenStatsService]；
+  /// 失败计入失败率，调用方中途放弃（如超出延迟预算）按超时计，
+  /// 已等待的时间记为耗时。
+  Stream<String> enhanceStream(
+    String text, {
+    Duration? timeout,
+    String context = '',
+  }) async* {
+    final router = ProviderRouter.instance;
+    final candidates = _routeCandidates();
+    final target = candidates.length > 1
+        ? router.rank(candidates, byFirstToken: true).first
+        : candidates.first;
+    final output = StringBuffer();
+    final stopwatch = Stopwatch()..start();
+    AiStreamStats? stats;
+    var settled = false;
+    try {
+      final provider = AiEnhanceService(target.config)._resolveProvider();
+      final stream = provider.enhanceStream(
+        text,
+        timeout: timeout,
+        context: context,
+        onStats: (value) => stats = value,
+      );
+      await for (final delta in stream) {
+        output.write(delta);
+        yield delta;
+      }
+      settled = true;
+    } catch (_) {
+      settled = true;
+      router.recordFailure(target.key);
+      rethrow;
+    } finally {
+      if (!settled) {
+        RequestHedger.instance.recordLatency(target.key, stopwatch.elapsed);
+        router.recordFailure(target.key, timeout: true);
+      }
+    }
+    final completed = stats;
+    if (completed != null) {
+      _recordStream(target, completed, output.toString());
+    }
+  }
+
+  /// 服务端未返回用量时按输出文本估算 token 数来计算输出速度。
+  static void _recordStream(
+    RouteCandidate<AiEnhanceConfig> target,
+    AiStreamStats stats,
+    String output,
+  ) {
+    final completionTokens = stats.completionTokens > 0
+        ? stats.completionTokens
+        : estimateTokenCount(output);
+    RequestHedger.instance.recordLatency(target.key, stats.total);
+    ProviderRouter.instance.recordStream(
+      target.key,
+      firstToken: stats.firstToken,
+      total: stats.total,
+      tokensPerSecond: stats.tokensPerSecondFor(completionTokens),
+    );
+    unawaited(
+      LlmStreamStatsService.instance.record(
+        model: target.config.model,
+        firstToken: stats.firstToken,
+        decode: stats.decode,
+        completionTokens: completionTokens,
+      ),
+    );
+    if (stats.promptTokens + stats.completionTokens > 0) {
+      unawaited(
+        TokenStatsService.instance.addTokens(
+          promptTokens: stats.promptTokens,
+          completionTokens: stats.completionTokens,
+          cachedPromptTokens: stats.cachedPromptTokens,
+        ),
+      );
+    }
   }
 
   /// 检查文本模型服务是否可用（简单版本）。
@@ -1,4 +1,5 @@
 import '../../models/ai_enhance_config.dart';
+import 'sse_delta_parser.dart';
 
 /// AI 增强结果，包含增强后的文本和 token 用量。
 class AiEnhanceResult {
@@ -6,15 +7,55 @@ class AiEnhanceResult {
   final int promptTokens;
   final int completionTokens;
 
+  /// [promptTokens] 中命中服务端前缀缓存的部分（计费与首字延迟更低）。
+  final int cachedPromptTokens;
+
+  /// 结果来自 `LlmResultCache`，未发出请求。
+  final bool cached;
+
   const AiEnhanceResult({
     required this.text,
     this.promptTokens = 0,
     this.completionTokens = 0,
+    this.cachedPromptTokens = 0,
+    this.cached = false,
   });
 
   int get totalTokens => promptTokens + completionTokens;
 }
 
+/// 一次流式增强的时延、吞吐与用量。
+class AiStreamStats {
+  /// 从发出请求到收到第一段非空文本的耗时（TTFT）。
+  final Duration firstToken;
+
+  /// 从发出请求到流结束的耗时。
+  final Duration total;
+
+  /// 服务端在流末尾返回的用量；未返回时为 0。
+  final int promptTokens;
+  final int completionTokens;
+  final int cachedPromptTokens;
+
+  const AiStreamStats({
+    required this.firstToken,
+    required this.total,
+    this.promptTokens = 0,
+    this.completionTokens = 0,
+    this.cachedPromptTokens = 0,
+  });
+
+  /// 首字之后的输出耗时。
+  Duration get decode => total - firstToken;
+
+  /// 按 [completionTokens] 计算的输出速度（token/秒），无法计算时为 0。
+  double tokensPerSecondFor(int completionTokens) {
+    final micros = decode.inMicroseconds;
+    if (micros <= 0 || completionTokens <= 0) return 0;
+    return completionTokens * Duration.microsecondsPerSecond / micros;
+  }
+}
+
 /// AI 服务连接检查结果
 class AiConnectionCheckResult {
   final bool ok;
@@ -40,11 +81,22 @@ abstract class AiProvider {
 
   AiProvider(this.config);
 
-  /// 批量增强文本。
-  Future<AiEnhanceResult> enhance(String text, {Duration? timeout});
+  /// 批量增强文本。[context] 见 [buildEnhanceUserMessage]。
+  Future<AiEnhanceResult> enhance(
+    String text, {
+    Duration? timeout,
+    String context = '',
+  });
 
   /// 流式增强文本（SSE）。
-  Stream<String> enhanceStream(String text, {Duration? timeout});
+  ///
+  /// 流正常结束时以本次的 [AiStreamStats] 调用 [onStats]。
+  Stream<String> enhanceStream(
+    String text, {
+    Duration? timeout,
+    String context = '',
+    void Function(AiStreamStats stats)? onStats,
+  });
 
   /// 检查服务是否可用（详细版本）。
   Future<AiConnectionCheckResult> checkAvailabilityDetailed();
@@ -91,17 +143,70 @@ abstract class AiProvider {
   }
 
   /// 构建用于 AI 增强的 user message。
-  String buildEnhanceUserMessage(String text) {
+  ///
+  /// 服务端按请求前缀缓存，因此每次都变的内容只放在这里，排在固定的
+  /// system prompt 与说明文字之后：先是 [context]（如最近输入上下文），
+  /// 最后是待处理的 [text]。
+  String buildEnhanceUserMessage(String text, {String context = ''}) {
+    final contextSection = context.trim().isEmpty
+        ? ''
+        : '${context.trim()}\n\n';
     return '''
 请严格根据 system 提示词对以下文本做优化。
 仅输出优化后的文本本身，不要添加解释、前后缀或引号。
 
-<source>
+$contextSection<source>
 $text
 </source>
 ''';
   }
 
+  /// 读取 usage 中命中前缀缓存的输入 token 数。
+  ///
+  /// OpenAI、DashScope、智谱与 Gemini 兼容层使用
+  /// `prompt_tokens_details.cached_tokens`，DeepSeek 使用
+  /// `prompt_cache_hit_tokens`。
+  int parseCachedPromptTokens(Map<String, dynamic>? usage) {
+    if (usage == null) return 0;
+    final details = usage['prompt_tokens_details'];
+    if (details is Map<String, dynamic>) {
+      final cached = details['cached_tokens'];
+      if (cached is int) return cached;
+    }
+    final hit = usage['prompt_cache_hit_tokens'];
+    return hit is int ? hit : 0;
+  }
+
+  /// 将 SSE 响应体 [body] 解析为增量文本，供各 Provider 的
+  /// [enhanceStream] 共用。
+  ///
+  /// [clock] 在发出请求时开始计时；流结束时以首字延迟、总耗时与服务端
+  /// 返回的用量调用 [onStats]。
+  Stream<String> readSseDeltas(
+    Stream<List<int>> body,
+    Stopwatch clock, {
+    void Function(AiStreamStats stats)? onStats,
+  }) async* {
+    Duration? firstToken;
+    Map<String, dynamic>? usage;
+    await for (final delta in body.transform(const SseDeltaParser())) {
+      if (delta.usage != null) usage = delta.usage;
+      if (delta.content.isEmpty) continue;
+      firstToken ??= clock.elapsed;
+      yield delta.content;
+    }
+    final total = clock.elapsed;
+    onStats?.call(
+      AiStreamStats(
+        firstToken: firstToken ?? total,
+        total: total,
+        promptTokens: (usage?['prompt_tokens'] as int?) ?? 0,
+        completionTokens: (usage?['completion_tokens'] as int?) ?? 0,
+        cachedPromptTokens: parseCachedPromptTokens(usage),
+      ),
+    );
+  }
+
   /// 过滤通用/无意义的回复（如"谢谢"、"ok"）。
   String sanitizeEnhancedText(String text) {
     final cleaned = text.trim();
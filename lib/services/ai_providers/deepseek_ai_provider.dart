@@ -5,4 +5,7 @@ import 'openai_compatible_ai_provider.dart';
 /// 完全兼容 OpenAI `/chat/completions` 协议。
 class DeepSeekAiProvider extends OpenAiCompatibleAiProvider {
   DeepSeekAiProvider(super.config);
+
+  @override
+  bool get supportsStreamUsage => true;
 }
@@ -21,4 +21,7 @@ class GeminiAiProvider extends OpenAiCompatibleAiProvider {
 
   @override
   String get modelsUrl => '$_openAiBaseUrl/models';
+
+  @override
+  bool get supportsStreamUsage => true;
 }
@@ -5,4 +5,7 @@ import 'openai_compatible_ai_provider.dart';
 /// 使用原生 OpenAI `/chat/completions` 接口。
 class OpenAiAiProvider extends OpenAiCompatibleAiProvider {
   OpenAiAiProvider(super.config);
+
+  @override
+  bool get supportsStreamUsage => true;
 }
@@ -25,8 +25,17 @@ class OpenAiCompatibleAiProvider extends AiProvider {
   /// `/models` 端点 URL。子类可 override。
   String get modelsUrl => '${normalizeBaseUrl(config.baseUrl)}/models';
 
+  /// 流式请求是否携带 `stream_options.include_usage` 以在流末尾取得用量。
+  ///
+  /// 自定义端点未必接受该参数，默认不带；已知支持的厂商子类 override。
+  bool get supportsStreamUsage => false;
+
   @override
-  Future<AiEnhanceResult> enhance(String text, {Duration? timeout}) async {
+  Future<AiEnhanceResult> enhance(
+    String text, {
+    Duration? timeout,
+    String context = '',
+  }) async {
     if (text.trim().isEmpty) return AiEnhanceResult(text: text);
 
     await LogService.info(
@@ -48,7 +57,10 @@ class OpenAiCompatibleAiProvider extends AiProvider {
       'temperature': 0.2,
       'messages': [
         {'role': 'system', 'content': resolvedPrompt},
-        {'role': 'user', 'content': buildEnhanceUserMessage(text)},
+        {
+          'role': 'user',
+          'content': buildEnhanceUserMessage(text, context: context),
+        },
       ],
     };
     bodyMap.addAll(buildDefaultThinkingOptions(config.model));
@@ -78,14 +90,16 @@ class OpenAiCompatibleAiProvider extends AiProvider {
         final usage = jsonBody['usage'] as Map<String, dynamic>?;
         final promptTokens = (usage?['prompt_tokens'] as int?) ?? 0;
         final completionTokens = (usage?['completion_tokens'] as int?) ?? 0;
+        final cachedPromptTokens = parseCachedPromptTokens(usage);
         await LogService.info(
           'AI',
-          'enhance success textLength=${content.length} promptTokens=$promptTokens completionTokens=$completionTokens',
+          'enhance success textLength=${content.length} promptTokens=$promptTokens cachedTokens=$cachedPromptTokens completionTokens=$completionTokens',
         );
         return AiEnhanceResult(
           text: content,
           promptTokens: promptTokens,
           completionTokens: completionTokens,
+          cachedPromptTokens: cachedPromptTokens,
         );
       }
 
@@ -121,7 +135,12 @@ class OpenAiCompatibleAiProvider extends AiProvider {
   }
 
   @override
-  Stream<String> enhanceStream(String text, {Duration? timeout}) async* {
+  Stream<String> enhanceStream(
+    String text, {
+    Duration? timeout,
+    String context = '',
+    void Function(AiStreamStats stats)? onStats,
+  }) async* {
     if (text.trim().isEmpty) {
       yield text;
       return;
@@ -150,15 +169,19 @@ class OpenAiCompatibleAiProvider extends AiProvider {
       'model': config.model,
       'temperature': 0.2,
       'stream': true,
+      if (supportsStreamUsage) 'stream_options': {'include_usage': true},
       'messages': [
         {'role': 'system', 'content': resolvedPrompt},
-        {'role': 'user', 'content': buildEnhanceUserMessage(text)},
+        {
+          'role': 'user',
+          'content': buildEnhanceUserMessage(text, context: context),
+        },
       ],
     };
     bodyMap.addAll(buildDefaultThinkingOptions(config.model));
 
-    final httpClient = HttpClient();
-    httpClient.connectionTimeout = const Duration(seconds: 10);
+    final httpClient = NetworkClientService.httpClientFor(uri);
+    final clock = Stopwatch()..start();
     try {
       final request = await httpClient.postUrl(uri);
       request.headers.set('Content-Type', 'application/json; charset=utf-8');
@@ -181,42 +204,7 @@ class OpenAiCompatibleAiProvider extends AiProvider {
         throw AiEnhanceException('AI增强失败 (${response.statusCode})');
       }
 
-      // Parse SSE stream line-by-line to avoid losing events when network
-      // chunks split in the middle of a JSON payload.
-      await for (final rawLine
-          in response.transform(utf8.decoder).transform(const LineSplitter())) {
-        final line = rawLine.trim();
-        if (line.isEmpty) continue;
-        if (!line.startsWith('data:')) continue;
-
-        final jsonStr = line.substring(5).trim();
-        if (jsonStr.isEmpty || jsonStr == '[DONE]') continue;
-
-        try {
-          final jsonData = json.decode(jsonStr) as Map<String, dynamic>;
-          final choices = jsonData['choices'] as List<dynamic>?;
-          if (choices == null || choices.isEmpty) continue;
-
-          final delta = choices.first['delta'] as Map<String, dynamic>?;
-          if (delta == null) continue;
-
-          final content = delta['content'];
-          if (content is String && content.isNotEmpty) {
-            yield content;
-          } else if (content is List) {
-            for (final part in content) {
-              if (part is Map<String, dynamic>) {
-                final text = part['text'];
-                if (text is String && text.isNotEmpty) {
-                  yield text;
-                }
-              }
-            }
-          }
-        } catch (_) {
-          // Skip malformed SSE data lines.
-        }
-      }
+      yield* readSseDeltas(response, clock, onStats: onStats);
 
       await LogService.info('AI', 'streaming enhance complete');
     } on TimeoutException {
@@ -232,8 +220,6 @@ class OpenAiCompatibleAiProvider extends AiProvider {
       if (e is AiEnhanceException) rethrow;
       await LogService.error('AI', 'streaming enhance error: $e');
       throw AiEnhanceException('AI增强失败: $e');
-    } finally {
-      httpClient.close();
     }
   }
 
@@ -0,0 +1,279 @@
+import 'dart:async';
+import 'dart:convert';
+import 'dart:typed_data';
+
+/// SSE 流中一个 `data:` 事件携带的增量。
+class SseDelta {
+  /// `choices[0].delta.content` 的文本，没有时为空串。
+  final String content;
+
+  /// 服务端在流末尾返回的 token 用量，其他事件为 null。
+  final Map<String, dynamic>? usage;
+
+  const SseDelta({this.content = '', this.usage});
+}
+
+/// OpenAI 兼容 `/chat/completions` 流式响应的增量解析器。
+///
+/// 直接在字节上按 `\n` 切行，多字节 UTF-8 字符被网络分片截断时会留到
+/// 下一片拼齐，只有 `data:` 行才解码为字符串。每个事件先由
+/// [extractContent] 在原文上定位 `delta.content` 并就地反转义，不构建
+/// JSON 树；content 为数组、事件带 usage 或快速路径无法确定时才回退到
+/// 完整的 [json.decode]。无法解析的事件直接跳过。
+class SseDeltaParser extends StreamTransformerBase<List<int>, SseDelta> {
+  const SseDeltaParser();
+
+  static const int _lf = 0x0a;
+  static const int _cr = 0x0d;
+  static const List<int> _dataPrefix = [0x64, 0x61, 0x74, 0x61, 0x3a];
+
+  @override
+  Stream<SseDelta> bind(Stream<List<int>> stream) async* {
+    final pending = BytesBuilder(copy: false);
+    await for (final chunk in stream) {
+      var start = 0;
+      for (var i = 0; i < chunk.length; i++) {
+        if (chunk[i] != _lf) continue;
+        final List<int> line;
+        if (pending.isEmpty) {
+          line = chunk.sublist(start, i);
+        } else {
+          pending.add(chunk.sublist(start, i));
+          line = pending.takeBytes();
+        }
+        start = i + 1;
+        final delta = _parseLine(line);
+        if (delta != null) yield delta;
+      }
+      if (start < chunk.length) pending.add(chunk.sublist(start));
+    }
+    if (pending.isNotEmpty) {
+      final delta = _parseLine(pending.takeBytes());
+      if (delta != null) yield delta;
+    }
+  }
+
+  static SseDelta? _parseLine(List<int> line) {
+    var end = line.length;
+    if (end > 0 && line[end - 1] == _cr) end--;
+    if (end < _dataPrefix.length) return null;
+    for (var i = 0; i < _dataPrefix.length; i++) {
+      if (line[i] != _dataPrefix[i]) return null;
+    }
+    final payload = utf8.decode(
+      line.sublist(_dataPrefix.length, end),
+      allowMalformed: true,
+    );
+    return parseEvent(payload.trim());
+  }
+
+  /// 解析一个 `data:` 事件的负载；没有可发出的内容时返回 null。
+  static SseDelta? parseEvent(String payload) {
+    if (payload.isEmpty || payload == '[DONE]') return null;
+    if (!_hasUsage(payload)) {
+      final content = extractContent(payload);
+      if (content != null) {
+        return content.isEmpty ? null : SseDelta(content: content);
+      }
+    }
+    return _decodeFull(payload);
+  }
+
+  /// 不解析整个事件，直接读取 `delta` 对象顶层的 `content` 字符串。
+  ///
+  /// 没有 delta 或 content 时返回空串；content 不是字符串或 JSON 结构
+  /// 不符合预期时返回 null，由调用方回退到完整解析。
+  static String? extractContent(String payload) {
+    final scanner = _Scanner(payload);
+    final deltaAt = scanner.findKey('delta');
+    if (deltaAt < 0) return '';
+    scanner.pos = deltaAt;
+    if (scanner.skipLiteral('null')) return '';
+    if (!scanner.expect(0x7b)) return null;
+    while (true) {
+      scanner.skipWhitespace();
+      if (scanner.expect(0x7d)) return '';
+      if (scanner.peek != 0x22) return null;
+      final key = scanner.readString();
+      if (key == null) return null;
+      scanner.skipWhitespace();
+      if (!scanner.expect(0x3a)) return null;
+      scanner.skipWhitespace();
+      if (key == 'content') {
+        if (scanner.skipLiteral('null')) return '';
+        return scanner.peek == 0x22 ? scanner.readString() : null;
+      }
+      if (!scanner.skipValue()) return null;
+      scanner.skipWhitespace();
+      if (scanner.expect(0x2c)) continue;
+      return scanner.expect(0x7d) ? '' : null;
+    }
+  }
+
+  /// 事件中是否带有非空的 `usage` 对象（值为 null 的占位不算）。
+  static bool _hasUsage(String payload) {
+    final scanner = _Scanner(payload);
+    final at = scanner.findKey('usage');
+    return at >= 0 && at < payload.length && payload.codeUnitAt(at) == 0x7b;
+  }
+
+  static SseDelta? _decodeFull(String payload) {
+    try {
+      final data = json.decode(payload);
+      if (data is! Map<String, dynamic>) return null;
+      final usage = data['usage'];
+      final buffer = StringBuffer();
+      final choices = data['choices'];
+      if (choices is List && choices.isNotEmpty) {
+        final choice = choices.first;
+        final delta = choice is Map<String, dynamic> ? choice['delta'] : null;
+        final content = delta is Map<String, dynamic> ? delta['content'] : null;
+        if (content is String) {
+          buffer.write(content);
+        } else if (content is List) {
+          for (final part in content) {
+            if (part is Map<String, dynamic> && part['text'] is String) {
+              buffer.write(part['text'] as String);
+            }
+          }
+        }
+      }
+      if (buffer.isEmpty && usage is! Map<String, dynamic>) return null;
+      return SseDelta(
+        content: buffer.toString(),
+        usage: usage is Map<String, dynamic> ? usage : null,
+      );
+    } catch (_) {
+      return null;
+    }
+  }
+}
+
+/// 在 JSON 文本上按码元前进的最小扫描器，只支持 [SseDeltaParser] 所需的
+/// 操作；任何不符合预期的输入都以失败返回，而不是抛出异常。
+class _Scanner {
+  final String text;
+  int pos = 0;
+
+  _Scanner(this.text);
+
+  int get peek => pos < text.length ? text.codeUnitAt(pos) : -1;
+
+  bool expect(int unit) {
+    if (peek != unit) return false;
+    pos++;
+    return true;
+  }
+
+  void skipWhitespace() {
+    while (true) {
+      final unit = peek;
+      if (unit != 0x20 && unit != 0x09 && unit != 0x0a && unit != 0x0d) {
+        return;
+      }
+      pos++;
+    }
+  }
+
+  bool skipLiteral(String literal) {
+    if (!text.startsWith(literal, pos)) return false;
+    pos += literal.length;
+    return true;
+  }
+
+  /// 第一个作为对象键出现的 `"name"` 之后、值开始处的位置，未找到为 -1。
+  ///
+  /// 字符串值里的同名文本带有转义引号，或后面不跟冒号，不会被误认。
+  int findKey(String name) {
+    final token = '"$name"';
+    var from = 0;
+    while (true) {
+      final at = text.indexOf(token, from);
+      if (at < 0) return -1;
+      from = at + token.length;
+      if (at > 0 && text.codeUnitAt(at - 1) == 0x5c) continue;
+      pos = from;
+      skipWhitespace();
+      if (!expect(0x3a)) continue;
+      skipWhitespace();
+      return pos;
+    }
+  }
+
+  /// 读取从当前位置开始的 JSON 字符串并反转义；格式错误时返回 null。
+  String? readString() {
+    if (!expect(0x22)) return null;
+    final start = pos;
+    while (pos < text.length) {
+      final unit = text.codeUnitAt(pos);
+      if (unit == 0x22) return text.substring(start, pos++);
+      if (unit == 0x5c) break;
+      pos++;
+    }
+    final buffer = StringBuffer(text.substring(start, pos));
+    while (pos < text.length) {
+      final unit = text.codeUnitAt(pos++);
+      if (unit == 0x22) return buffer.toString();
+      if (unit != 0x5c) {
+        buffer.writeCharCode(unit);
+        continue;
+      }
+      if (pos >= text.length) return null;
+      final escaped = text.codeUnitAt(pos++);
+      switch (escaped) {
+        case 0x22 || 0x5c || 0x2f:
+          buffer.writeCharCode(escaped);
+        case 0x62:
+          buffer.writeCharCode(0x08);
+        case 0x66:
+          buffer.writeCharCode(0x0c);
+        case 0x6e:
+          buffer.writeCharCode(0x0a);
+        case 0x72:
+          buffer.writeCharCode(0x0d);
+        case 0x74:
+          buffer.writeCharCode(0x09);
+        case 0x75:
+          if (pos + 4 > text.length) return null;
+          final code = int.tryParse(text.substring(pos, pos + 4), radix: 16);
+          if (code == null) return null;
+          buffer.writeCharCode(code);
+          pos += 4;
+        default:
+          return null;
+      }
+    }
+    return null;
+  }
+
+  /// 跳过从当前位置开始的一个 JSON 值；结构不完整时返回 false。
+  bool skipValue() {
+    final unit = peek;
+    if (unit == 0x22) return readString() != null;
+    if (unit != 0x7b && unit != 0x5b) {
+      final start = pos;
+      while (pos < text.length) {
+        final c = text.codeUnitAt(pos);
+        if (c == 0x2c || c == 0x7d || c == 0x5d || c <= 0x20) break;
+        pos++;
+      }
+      return pos > start;
+    }
+    var depth = 0;
+    while (pos < text.length) {
+      final c = text.codeUnitAt(pos);
+      if (c == 0x22) {
+        if (readString() == null) return false;
+        continue;
+      }
+      pos++;
+      if (c == 0x7b || c == 0x5b) {
+        depth++;
+      } else if (c == 0x7d || c == 0x5d) {
+        depth--;
+        if (depth == 0) return true;
+      }
+    }
+    return false;
+  }
+}
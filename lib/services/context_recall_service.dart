@@ -4,21 +4,36 @@ import '../models/transcription.dart';
 class ContextRecallService {
   static const int defaultMaxCandidates = 10;
   static const int defaultMaxReferences = 3;
+  static const int defaultMaxSearchTerms = 6;
+
+  /// 全文检索的中文切片长度；trigram 索引要求检索词至少 3 个字符。
+  static const int _cjkSearchChunkLength = 4;
+  static const int _minSearchTermLength = 3;
+  static final RegExp _cjkOnlyPattern = RegExp(r'^[\u4e00-\u9fff]+$');
 
   const ContextRecallService();
 
   ContextHints recall({
     required String currentText,
     required List<Transcription> history,
+    List<Transcription> relatedHistory = const [],
     int maxCandidates = defaultMaxCandidates,
     int maxReferences = defaultMaxReferences,
   }) {
     final normalizedCurrentText = currentText.trim();
-    if (normalizedCurrentText.isEmpty || history.isEmpty) {
+    if (normalizedCurrentText.isEmpty ||
+        (history.isEmpty && relatedHistory.isEmpty)) {
       return const ContextHints();
     }
 
-    final recentHistory = history.take(maxCandidates).toList(growable: false);
+    // 最近的记录在前；全文检索召回的更早记录追加在后，
+    // 不获得新近度加分，但按一次关键词命中计分。
+    final recentHistory = history.take(maxCandidates).toList();
+    final recentCount = recentHistory.length;
+    final seenIds = {for (final item in recentHistory) item.id};
+    for (final item in relatedHistory) {
+      if (seenIds.add(item.id)) recentHistory.add(item);
+    }
     final currentKeywords = _extractKeywords(normalizedCurrentText);
     final currentStyle = _detectStyle(normalizedCurrentText);
 
@@ -31,12 +46,14 @@ class ContextRecallService {
       final sharedKeywordCount = keywords.intersection(currentKeywords).length;
       final style = _detectStyle(text);
 
-      var score = (maxCandidates - i) / maxCandidates;
+      var score = i < recentCount
+          ? (maxCandidates - i) / maxCandidates
+          : 2.0;
       score += sharedKeywordCount * 2.0;
       if (currentStyle == style && style != '通用') {
         score += 0.8;
       }
-      if (normalizedCurrentText.length <= 18 && i < 3) {
+      if (normalizedCurrentText.length <= 18 && i < 3 && i < recentCount) {
         score += 0.6;
       }
       if (score <= 1.0 && sharedKeywordCount == 0 && i >= 3) {
@@ -99,6 +116,34 @@ class ContextRecallService {
     );
   }
 
+  /// 由当前文本生成全文检索词，用于从更早的历史中召回相关记录。
+  ///
+  /// 连续中文按固定长度切片，避免整句作为一个短语几乎无法命中；
+  /// 短于 3 个字符的词无法走全文索引，直接舍弃。
+  List<String> buildSearchTerms(
+    String currentText, {
+    int maxTerms = defaultMaxSearchTerms,
+  }) {
+    final terms = <String>{};
+    for (final keyword in _extractKeywords(currentText.trim())) {
+      if (!_cjkOnlyPattern.hasMatch(keyword)) {
+        if (keyword.length >= _minSearchTermLength) terms.add(keyword);
+        continue;
+      }
+      var start = 0;
+      while (start + _minSearchTermLength <= keyword.length) {
+        final end = start + _cjkSearchChunkLength < keyword.length
+            ? start + _cjkSearchChunkLength
+            : keyword.length;
+        terms.add(keyword.substring(start, end));
+        start += _cjkSearchChunkLength;
+      }
+    }
+    final sorted = terms.toList()
+      ..sort((a, b) => b.length.compareTo(a.length));
+    return sorted.take(maxTerms).toList(growable: false);
+  }
+
   Set<String> _extractKeywords(String text) {
     final matches = RegExp(
       r'[A-Za-z][A-Za-z0-9\-_]{1,}|[0-9]+(?:\.[0-9]+)?|[\u4e00-\u9fff]{2,}',
@@ -1,15 +1,26 @@
 /// 纠错上下文管理器。
 ///
-/// 维护最近 N 段已纠错文本，用于辅助 LLM 判断同音字歧义。
+/// 维护最近 N 段已纠错文本，用于辅助 LLM 判断同音字歧义；同时维护
+/// 会话词表（#G），即本次会话中已出现过的 `错词->正词` 引用。
 /// 生命周期跟随录音会话，每次 startRecording 时重置。
 class CorrectionContext {
   /// 默认保留最近 5 段
   static const int defaultMaxSegments = 5;
 
+  /// 会话词表默认最多 48 条
+  static const int defaultMaxSessionReferences = 48;
+
   final int maxSegments;
+  final int maxSessionReferences;
   final List<String> _recentSegments = [];
 
-  CorrectionContext({this.maxSegments = defaultMaxSegments});
+  /// 错词 → 引用条目，保持首次加入的顺序。
+  final Map<String, String> _sessionReferences = {};
+
+  CorrectionContext({
+    this.maxSegments = defaultMaxSegments,
+    this.maxSessionReferences = defaultMaxSessionReferences,
+  });
 
   /// 添加一段已纠错文本到上下文窗口。
   void addSegment(String correctedText) {
@@ -38,8 +49,45 @@ class CorrectionContext {
   /// 当前上下文段数
   int get segmentCount => _recentSegments.length;
 
+  /// 把 `错词->正词|…` 格式的引用加入会话词表。
+  ///
+  /// 会话词表放在纠错 system prompt 末尾，只追加不重排，使同一会话内
+  /// 前后请求共享逐字节相同的前缀。同一错词的正词变化时原位替换；已满
+  /// 时不再加入，返回未能加入的条目（`|` 分隔），调用方应放进 #R。
+  String addSessionReferences(String reference) {
+    final overflow = <String>[];
+    for (final part in reference.split('|')) {
+      final entry = part.trim();
+      final arrow = entry.indexOf('->');
+      if (arrow <= 0) continue;
+      final source = entry.substring(0, arrow);
+      if (_sessionReferences.containsKey(source) ||
+          _sessionReferences.length < maxSessionReferences) {
+        _sessionReferences[source] = entry;
+      } else {
+        overflow.add(entry);
+      }
+    }
+    return overflow.join('|');
+  }
+
+  /// 会话词表字符串，用于纠错 prompt 的 #G 字段；为空时返回空字符串。
+  String getSessionReferenceString() => _sessionReferences.values.join('|');
+
+  /// 去掉 [reference] 中已在会话词表里的条目，余下的作为本段的 #R。
+  String withoutSessionReferences(String reference) {
+    if (_sessionReferences.isEmpty) return reference;
+    final known = _sessionReferences.values.toSet();
+    return reference
+        .split('|')
+        .map((part) => part.trim())
+        .where((part) => part.isNotEmpty && !known.contains(part))
+        .join('|');
+  }
+
   /// 重置上下文（新录音会话开始时调用）。
   void reset() {
     _recentSegments.clear();
+    _sessionReferences.clear();
   }
 }
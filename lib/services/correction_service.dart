@@ -1,3 +1,5 @@
+import 'dart:async';
+
 import '../models/ai_enhance_config.dart';
 import '../models/correction_change_log.dart';
 import '../models/dictionary_entry.dart';
@@ -10,11 +12,16 @@ import 'ai_enhance_service.dart';
 import 'correction_change_log_service.dart';
 import 'correction_context.dart';
 import 'entity_recall_service.dart';
+import 'latency_budget.dart';
+import 'local_correction_plan.dart';
+import 'local_rewrite_gate.dart';
 import 'log_service.dart';
 import 'pinyin_matcher.dart';
 import 'correction_stats_service.dart';
 import 'session_entity_state.dart';
 import 'session_glossary.dart';
+import 'text_compute_pool.dart';
+import 'term_replacement_engine.dart';
 import 'token_stats_service.dart';
 
 /// 纠错结果
@@ -22,7 +29,8 @@ class CorrectionResult {
   /// 纠错后的文本
   final String text;
 
-  /// 是否实际调用了 LLM（false 表示跳过纠错直接返回原文）
+  /// 是否实际调用了 LLM（false 表示跳过纠错直接返回原文，或命中了
+  /// LLM 结果缓存）
   final bool llmInvoked;
 
   /// LLM 消耗的 token 数量
@@ -47,9 +55,14 @@ typedef MemoryCorrectionHitRecorder =
 /// 核心流程：
 /// 1. 对 ASR 原始文本用 [PinyinMatcher] 检索匹配的词典条目
 /// 2. 若无匹配 → 跳过 LLM，Token 消耗 = 0
-/// 3. 若有匹配 → 构建 #R/#I/#C 符号化协议，调用 LLM 进行纠错
-/// 4. 更新 [CorrectionContext] 上下文窗口
+/// 3. 若命中都足够确定 → 由 [LocalRewriteGate] 在本地改写，跳过 LLM
+/// 4. 否则构建 #R/#I/#C 符号化协议，调用 LLM 进行纠错；会话内
+///    已出现过的引用放在 system prompt 末尾的 #G，作为稳定前缀
+/// 5. 更新 [CorrectionContext] 上下文窗口
 class CorrectionService {
+  static const String _budgetStageCorrection = 'correction';
+  static const String _budgetStageRetrospective = 'retrospective';
+
   final PinyinMatcher matcher;
   final CorrectionContext context;
   final AiEnhanceConfig aiConfig;
@@ -65,6 +78,15 @@ class CorrectionService {
   final EntityRecallService entityRecallService;
   final MemoryCorrectionHitRecorder? onMemoryCorrectionHit;
 
+  /// 本地匹配阶段的后台计算池；为 null 时在当前 isolate 计算。
+  final TextComputePool? computePool;
+
+  /// 本地快速路径闸门；为 null 时有命中即调用 LLM。
+  final LocalRewriteGate? localRewriteGate;
+
+  /// 本服务实例完成的本地直出次数，用于抽检采样。
+  int _localRewrites = 0;
+
   CorrectionService({
     required this.matcher,
     required this.context,
@@ -80,12 +102,21 @@ class CorrectionService {
     this.sessionEntityState,
     this.entityRecallService = const EntityRecallService(),
     this.onMemoryCorrectionHit,
+    this.computePool,
+    this.localRewriteGate,
   });
 
   /// 对 ASR 原始文本执行纠错。
   ///
-  /// 若词典中无匹配条目，直接返回原文不调用 LLM。
-  Future<CorrectionResult> correct(String rawSttText) async {
+  /// 若词典中无匹配条目，直接返回原文不调用 LLM。[plan] 为预先以
+  /// [planLocal] 算好的本地匹配结果，分段流水线借此把本地匹配与上一段的
+  /// LLM 纠错重叠执行。[budget] 判定来不及时不调用或不再等待 LLM，
+  /// 直接采用本地归一化结果。
+  Future<CorrectionResult> correct(
+    String rawSttText, {
+    LocalCorrectionPlan? plan,
+    LatencyBudget? budget,
+  }) async {
     if (rawSttText.trim().isEmpty) {
       return CorrectionResult(text: rawSttText);
     }
@@ -96,8 +127,9 @@ class CorrectionService {
     var fallbackText = rawSttText;
 
     try {
-      // 1. 拼音模糊匹配
-      final matchHits = matcher.findMatchHits(rawSttText);
+      // 1. 拼音模糊匹配与候选筛选
+      final localPlan = plan ?? await planLocal(rawSttText);
+      final matchHits = localPlan.matchHits;
       matchesCount = matchHits.length;
 
       final entityBundle = _buildEntityBundle(rawSttText);
@@ -126,7 +158,7 @@ class CorrectionService {
         'found ${matchHits.length} dictionary hit spans',
       );
 
-      final selectedHits = _selectHitsForReference(rawSttText, matchHits);
+      final selectedHits = localPlan.selectedHits;
       selectedCount = selectedHits.length;
       if (selectedHits.isEmpty &&
           !entityBundle.hasPromptData &&
@@ -145,9 +177,36 @@ class CorrectionService {
         return CorrectionResult(text: rawSttText);
       }
 
-      fallbackText = selectedHits.isEmpty
-          ? rawSttText
-          : _normalizeMatchedTermsFromHits(rawSttText, selectedHits);
+      final local = _decideLocal(
+        localPlan,
+        entityBundle: entityBundle,
+        memoryBundle: memoryReferenceBundle,
+      );
+      if (local != null && local.confident) {
+        return _commitLocalRewrite(
+          rawSttText,
+          local,
+          plan: localPlan,
+          entityBundle: entityBundle,
+          memoryBundle: memoryReferenceBundle,
+        );
+      }
+      if (local != null) {
+        await LogService.info(
+          'CORRECTION',
+          'local rewrite escalated to LLM: ${local.reason}',
+        );
+      }
+
+      fallbackText = localPlan.normalizedText;
+      if (budget != null &&
+          !budget.allows(_routeKey, stage: _budgetStageCorrection)) {
+        return _keepLocal(
+          fallbackText,
+          matchesCount: matchesCount,
+          selectedCount: selectedCount,
+        );
+      }
 
       // 2. 构建 #R 引用表
       final referenceStr = _buildReferenceStringFromHits(selectedHits);
@@ -163,30 +222,39 @@ class CorrectionService {
             'referenceChars=${combinedReferenceStr.length}',
       );
 
-      // 3. 构建完整 prompt 消息（追加 SessionGlossary 强锚定）
-      var finalReference = combinedReferenceStr;
-      if (sessionGlossary != null && sessionGlossary!.hasStrongEntries) {
-        final glossaryRef = sessionGlossary!.buildReferenceAppend();
-        if (glossaryRef.isNotEmpty) {
-          finalReference = _joinReferenceParts([
-            combinedReferenceStr,
-            glossaryRef,
-          ]);
-        }
-      }
+      // 3. 构建完整 prompt 消息：SessionGlossary 强锚定与会话内出现过的
+      // 引用在 system prompt 的 #G 中，#R 只放其余条目
+      final overflowPins = _pinSessionGlossary();
+      final correctionConfig = _correctionConfig();
       final userMessage = _buildUserMessage(
-        reference: finalReference,
+        reference: context.withoutSessionReferences(
+          _joinReferenceParts([combinedReferenceStr, overflowPins]),
+        ),
         input: rawSttText,
         contextStr: context.getContextString(),
         entitySection: entityBundle.correctionEntitySection,
         relationSection: entityBundle.correctionRelationSection,
       );
+      context.addSessionReferences(referenceStr);
 
       // 4. 调用 LLM
-      final correctionConfig = aiConfig.copyWith(prompt: correctionPrompt);
       final enhancer = AiEnhanceService(correctionConfig);
 
-      final result = await enhancer.enhance(userMessage);
+      final request = enhancer.enhance(
+        userMessage,
+        unchangedText: rawSttText,
+      );
+      final result = budget == null
+          ? await request
+          : await budget.guard(request, stage: _budgetStageCorrection);
+      if (result == null) {
+        return _keepLocal(
+          fallbackText,
+          matchesCount: matchesCount,
+          selectedCount: selectedCount,
+          referenceChars: referenceChars,
+        );
+      }
       var correctedText = result.text.trim();
 
       // 安全校验：若 LLM 返回空，退回原文
@@ -207,6 +275,7 @@ class CorrectionService {
           await TokenStatsService.instance.addTokens(
             promptTokens: result.promptTokens,
             completionTokens: result.completionTokens,
+            cachedPromptTokens: result.cachedPromptTokens,
           );
         } catch (_) {}
       }
@@ -215,25 +284,18 @@ class CorrectionService {
         matchesCount: matchesCount,
         selectedCount: selectedCount,
         referenceChars: referenceChars,
-        llmInvoked: true,
+        llmInvoked: !result.cached,
         promptTokens: result.promptTokens,
         completionTokens: result.completionTokens,
       );
 
-      // 6. 更新上下文
-      context.addSegment(correctedText);
-
-      // 7. 自动提取新的同音字映射到 SessionGlossary
-      if (sessionGlossary != null && correctedText != rawSttText) {
-        sessionGlossary!.extractAndPin(rawSttText, correctedText);
-      }
-      if (sessionEntityState != null) {
-        entityRecallService.activateMentions(
-          text: correctedText,
-          bundle: entityBundle,
-          sessionState: sessionEntityState!,
-        );
-      }
+      // 6. 更新上下文、会话词表与实体激活
+      await _commitCorrection(
+        rawText: rawSttText,
+        correctedText: correctedText,
+        selectedHits: selectedHits,
+        entityBundle: entityBundle,
+      );
 
       await LogService.info(
         'CORRECTION',
@@ -241,17 +303,6 @@ class CorrectionService {
             'tokens: ${result.totalTokens}',
       );
 
-      if (correctedText != rawSttText) {
-        try {
-          await CorrectionChangeLogService.instance.recordChange(
-            source: 'realtime',
-            inputText: rawSttText,
-            outputText: correctedText,
-            terms: _buildTermPairsFromHits(selectedHits),
-          );
-        } catch (_) {}
-      }
-
       await _recordMemoryHitsSafely(
         memoryReferenceBundle.itemIds,
         sourceRef: 'realtime',
@@ -259,7 +310,7 @@ class CorrectionService {
 
       return CorrectionResult(
         text: correctedText,
-        llmInvoked: true,
+        llmInvoked: !result.cached,
         promptTokens: result.promptTokens,
         completionTokens: result.completionTokens,
       );
@@ -277,22 +328,259 @@ class CorrectionService {
     }
   }
 
+  /// 一次请求纠错多个连续分段，结果与 [rawTexts] 一一对应。
+  ///
+  /// 分段队列积压时由流水线调用：需要 LLM 的分段合并为一个请求，共用
+  /// system prompt、#C 上下文窗口和去重合并后的 #R 引用表，#I 中以
+  /// `<sN>…</sN>` 逐段分隔。响应按标记拆回各段，段数、序号或长度对不上
+  /// 时退回逐段 [correct]。本地快速路径可以确定的分段不进入请求；需要
+  /// LLM 的分段不足两个时直接逐段处理。[budget] 同 [correct]。
+  Future<List<CorrectionResult>> correctBatch(
+    List<String> rawTexts, {
+    List<LocalCorrectionPlan?>? plans,
+    LatencyBudget? budget,
+  }) async {
+    final segments = <_BatchSegment>[];
+    try {
+      for (var i = 0; i < rawTexts.length; i++) {
+        final raw = rawTexts[i];
+        final plan = plans?[i] ?? await planLocal(raw);
+        final entityBundle = raw.trim().isEmpty
+            ? const EntityPromptBundle()
+            : _buildEntityBundle(raw);
+        final memoryBundle = _buildMemoryReferenceBundle(raw);
+        final local = _decideLocal(
+          plan,
+          entityBundle: entityBundle,
+          memoryBundle: memoryBundle,
+        );
+        segments.add(
+          _BatchSegment(
+            raw: raw,
+            plan: plan,
+            entityBundle: entityBundle,
+            memoryBundle: memoryBundle,
+            local: local != null && local.confident ? local : null,
+          ),
+        );
+      }
+    } catch (e) {
+      await LogService.warn('CORRECTION', 'batch planning failed: $e');
+      return [for (final raw in rawTexts) await correct(raw, budget: budget)];
+    }
+
+    Future<List<CorrectionResult>> oneByOne() async => [
+      for (final segment in segments)
+        await correct(segment.raw, plan: segment.plan, budget: budget),
+    ];
+
+    final batched = segments.where((s) => s.needsLlm).toList();
+    if (batched.length < 2) return oneByOne();
+    if (budget != null &&
+        !budget.allows(_routeKey, stage: _budgetStageCorrection)) {
+      return _finishBatch(segments, corrected: null, result: null);
+    }
+
+    final selectedHits = [for (final s in batched) ...s.plan.selectedHits];
+    final hitReference = _buildReferenceStringFromHits(selectedHits);
+    final reference = _unionReferences([
+      hitReference,
+      for (final s in batched) s.memoryBundle.reference,
+    ]);
+    final entityBundle = _buildEntityBundle(
+      batched.map((s) => s.raw).join('\n'),
+    );
+    final input = [
+      for (var i = 0; i < batched.length; i++)
+        '<s${i + 1}>${batched[i].raw}</s${i + 1}>',
+    ].join('\n');
+    final overflowPins = _pinSessionGlossary();
+    final correctionConfig = _correctionConfig();
+    final userMessage = _buildUserMessage(
+      reference: context.withoutSessionReferences(
+        _joinReferenceParts([reference, overflowPins]),
+      ),
+      input: input,
+      contextStr: context.getContextString(),
+      entitySection: entityBundle.correctionEntitySection,
+      relationSection: entityBundle.correctionRelationSection,
+    );
+    context.addSessionReferences(hitReference);
+
+    final AiEnhanceResult? result;
+    try {
+      final request = AiEnhanceService(correctionConfig).enhance(userMessage);
+      result = budget == null
+          ? await request
+          : await budget.guard(request, stage: _budgetStageCorrection);
+    } catch (e) {
+      await LogService.error('CORRECTION', 'batch correction failed: $e');
+      return _finishBatch(segments, corrected: null, result: null);
+    }
+    if (result == null) {
+      return _finishBatch(segments, corrected: null, result: null);
+    }
+
+    // 先计入批次请求的 token 与调用统计，响应无法拆分、逐段重试时不丢失。
+    if (result.totalTokens > 0) {
+      try {
+        await TokenStatsService.instance.addTokens(
+          promptTokens: result.promptTokens,
+          completionTokens: result.completionTokens,
+          cachedPromptTokens: result.cachedPromptTokens,
+        );
+      } catch (_) {}
+    }
+    await _recordStatsSafely(
+      matchesCount: batched.fold<int>(
+        0,
+        (n, s) => n + s.plan.matchHits.length,
+      ),
+      selectedCount: selectedHits.length,
+      referenceChars: reference.length,
+      llmInvoked: !result.cached,
+      promptTokens: result.promptTokens,
+      completionTokens: result.completionTokens,
+    );
+
+    final corrected = _splitBatchResponse(
+      result.text,
+      batched.map((s) => s.raw).toList(),
+    );
+    if (corrected == null) {
+      await LogService.warn(
+        'CORRECTION',
+        'batch response malformed, correcting ${batched.length} '
+            'segments one by one',
+      );
+      return oneByOne();
+    }
+    await LogService.info(
+      'CORRECTION',
+      'batched ${batched.length}/${segments.length} segments, '
+          'referenceChars=${reference.length} tokens: ${result.totalTokens}',
+    );
+    await _recordMemoryHitsSafely([
+      for (final s in batched) ...s.memoryBundle.itemIds,
+    ], sourceRef: 'realtime');
+    return _finishBatch(segments, corrected: corrected, result: result);
+  }
+
+  /// 按分段顺序写回上下文窗口并生成结果；[corrected] 为 null 表示请求
+  /// 失败，需要 LLM 的分段退回本地归一化文本。本地快速路径确定的分段
+  /// 按原顺序直出。批次 token 均摊到各段。
+  Future<List<CorrectionResult>> _finishBatch(
+    List<_BatchSegment> segments, {
+    required List<String>? corrected,
+    required AiEnhanceResult? result,
+  }) async {
+    final llmCount = segments.where((s) => s.needsLlm).length;
+    final results = <CorrectionResult>[];
+    var index = 0;
+    for (final segment in segments) {
+      final raw = segment.raw;
+      if (raw.trim().isEmpty) {
+        results.add(CorrectionResult(text: raw));
+        continue;
+      }
+      final local = segment.local;
+      if (local != null) {
+        results.add(
+          await _commitLocalRewrite(
+            raw,
+            local,
+            plan: segment.plan,
+            entityBundle: segment.entityBundle,
+            memoryBundle: segment.memoryBundle,
+          ),
+        );
+        continue;
+      }
+      if (!segment.needsLlm || corrected == null || result == null) {
+        await _recordStatsSafely(
+          matchesCount: segment.plan.matchHits.length,
+          selectedCount: segment.needsLlm
+              ? segment.plan.selectedHits.length
+              : 0,
+          referenceChars: 0,
+          llmInvoked: false,
+        );
+        final text = segment.needsLlm ? segment.plan.normalizedText : raw;
+        context.addSegment(text);
+        results.add(CorrectionResult(text: text));
+        continue;
+      }
+
+      final hits = segment.plan.selectedHits;
+      var text = corrected[index];
+      if (hits.isNotEmpty) {
+        text = _normalizeMatchedTermsFromHits(text, hits);
+      }
+      await _commitCorrection(
+        rawText: raw,
+        correctedText: text,
+        selectedHits: hits,
+        entityBundle: segment.entityBundle,
+      );
+      results.add(
+        CorrectionResult(
+          text: text,
+          llmInvoked: !result.cached,
+          promptTokens: _shareOf(result.promptTokens, index, llmCount),
+          completionTokens: _shareOf(result.completionTokens, index, llmCount),
+        ),
+      );
+      index++;
+    }
+    return results;
+  }
+
+  static final RegExp _batchSegmentPattern = RegExp(
+    r'<s(\d+)>([\s\S]*?)</s\1>',
+  );
+
+  /// 把批量响应拆回各段；段数或序号不符、某段为空或长度与原文相差过大
+  /// （多半是模型合并或串段）时返回 null。
+  List<String>? _splitBatchResponse(String response, List<String> raws) {
+    final matches = _batchSegmentPattern.allMatches(response).toList();
+    if (matches.length != raws.length) return null;
+    final texts = <String>[];
+    for (var i = 0; i < matches.length; i++) {
+      if (matches[i].group(1) != '${i + 1}') return null;
+      final text = matches[i].group(2)!.trim();
+      final rawLength = raws[i].trim().length;
+      if (text.isEmpty ||
+          text.length > rawLength * 2 + 16 ||
+          text.length * 2 < rawLength) {
+        return null;
+      }
+      texts.add(text);
+    }
+    return texts;
+  }
+
+  static int _shareOf(int total, int index, int count) =>
+      total ~/ count + (index < total % count ? 1 : 0);
+
   /// 终态回溯：对整段文本（已经过逐句纠错）再做一次全段复核。
   ///
   /// 与 [correct] 的区别：
   /// - 不更新 [CorrectionContext] 上下文窗口（避免重复污染）
   /// - 可传入自定义上下文（如前一段落文本）
   /// - 用于段落结束时的二次校验
+  /// - [budget] 判定来不及时保持原文
   Future<CorrectionResult> correctParagraph(
     String paragraphText, {
     String previousParagraph = '',
+    LatencyBudget? budget,
   }) async {
     if (paragraphText.trim().isEmpty) {
       return CorrectionResult(text: paragraphText);
     }
 
     try {
-      final matchHits = matcher.findMatchHits(paragraphText);
+      final plan = await planLocal(paragraphText);
+      final matchHits = plan.matchHits;
       final entityBundle = _buildEntityBundle(
         paragraphText,
         contextStr: previousParagraph,
@@ -311,7 +599,7 @@ class CorrectionService {
         return CorrectionResult(text: paragraphText);
       }
 
-      final selectedHits = _selectHitsForReference(paragraphText, matchHits);
+      final selectedHits = plan.selectedHits;
       if (selectedHits.isEmpty &&
           !entityBundle.hasPromptData &&
           memoryReferenceStr.isEmpty) {
@@ -323,9 +611,12 @@ class CorrectionService {
         return CorrectionResult(text: paragraphText);
       }
 
-      final fallbackText = selectedHits.isEmpty
-          ? paragraphText
-          : _normalizeMatchedTermsFromHits(paragraphText, selectedHits);
+      final fallbackText = plan.normalizedText;
+      if (budget != null &&
+          !budget.allows(_routeKey, stage: _budgetStageRetrospective)) {
+        await _recordRetroSafely(llmInvoked: false, textChanged: false);
+        return CorrectionResult(text: paragraphText);
+      }
 
       final referenceStr = _joinReferenceParts([
         _buildReferenceStringFromHits(selectedHits),
@@ -338,16 +629,25 @@ class CorrectionService {
           : context.getContextString();
 
       final userMessage = _buildUserMessage(
-        reference: referenceStr,
+        reference: context.withoutSessionReferences(referenceStr),
         input: paragraphText,
         contextStr: contextStr,
         entitySection: entityBundle.correctionEntitySection,
         relationSection: entityBundle.correctionRelationSection,
       );
 
-      final correctionConfig = aiConfig.copyWith(prompt: correctionPrompt);
-      final enhancer = AiEnhanceService(correctionConfig);
-      final result = await enhancer.enhance(userMessage);
+      final enhancer = AiEnhanceService(_correctionConfig());
+      final request = enhancer.enhance(
+        userMessage,
+        unchangedText: paragraphText,
+      );
+      final result = budget == null
+          ? await request
+          : await budget.guard(request, stage: _budgetStageRetrospective);
+      if (result == null) {
+        await _recordRetroSafely(llmInvoked: false, textChanged: false);
+        return CorrectionResult(text: paragraphText);
+      }
 
       var correctedText = result.text.trim();
       if (correctedText.isEmpty) {
@@ -366,6 +666,7 @@ class CorrectionService {
           await TokenStatsService.instance.addTokens(
             promptTokens: result.promptTokens,
             completionTokens: result.completionTokens,
+            cachedPromptTokens: result.cachedPromptTokens,
           );
         } catch (_) {}
       }
@@ -388,7 +689,7 @@ class CorrectionService {
       }
 
       await _recordRetroSafely(
-        llmInvoked: true,
+        llmInvoked: !result.cached,
         textChanged: correctedText != paragraphText,
         promptTokens: result.promptTokens,
         completionTokens: result.completionTokens,
@@ -401,7 +702,7 @@ class CorrectionService {
 
       return CorrectionResult(
         text: correctedText,
-        llmInvoked: true,
+        llmInvoked: !result.cached,
         promptTokens: result.promptTokens,
         completionTokens: result.completionTokens,
       );
@@ -501,10 +802,10 @@ class CorrectionService {
     });
 
     final refs = <String>{};
-    final itemIds = <String>[];
+    final items = <MemoryItem>[];
     for (final scoredItem in scored.take(maxReferenceEntries)) {
       final item = scoredItem.item;
-      itemIds.add(item.id);
+      items.add(item);
       refs.add('${item.original.trim()}->${item.canonical.trim()}');
       for (final alias in item.aliases) {
         final value = alias.trim();
@@ -512,7 +813,18 @@ class CorrectionService {
         refs.add('$value->${item.canonical.trim()}');
       }
     }
-    return _MemoryReferenceBundle(reference: refs.join('|'), itemIds: itemIds);
+    return _MemoryReferenceBundle(reference: refs.join('|'), items: items);
+  }
+
+  /// 合并多段的引用表，按条目去重。
+  String _unionReferences(List<String> parts) {
+    final entries = <String>{};
+    for (final part in parts) {
+      for (final entry in part.split('|')) {
+        if (entry.trim().isNotEmpty) entries.add(entry.trim());
+      }
+    }
+    return entries.join('|');
   }
 
   String _joinReferenceParts(List<String> parts) {
@@ -522,6 +834,174 @@ class CorrectionService {
         .join('|');
   }
 
+  String get _routeKey => AiEnhanceService.routeKeyOf(aiConfig);
+
+  /// 延迟预算不允许等待 LLM 时，直接采用本地归一化结果 [text]。
+  Future<CorrectionResult> _keepLocal(
+    String text, {
+    required int matchesCount,
+    required int selectedCount,
+    int referenceChars = 0,
+  }) async {
+    await _recordStatsSafely(
+      matchesCount: matchesCount,
+      selectedCount: selectedCount,
+      referenceChars: referenceChars,
+      llmInvoked: false,
+    );
+    context.addSegment(text);
+    return CorrectionResult(text: text);
+  }
+
+  /// 按 [localRewriteGate] 判定能否在本地完成纠错；未配置闸门或本来就
+  /// 不需要 LLM 时返回 null。
+  LocalRewriteDecision? _decideLocal(
+    LocalCorrectionPlan plan, {
+    required EntityPromptBundle entityBundle,
+    required _MemoryReferenceBundle memoryBundle,
+  }) {
+    final gate = localRewriteGate;
+    if (gate == null ||
+        (plan.selectedHits.isEmpty &&
+            !entityBundle.hasPromptData &&
+            memoryBundle.reference.isEmpty)) {
+      return null;
+    }
+    return gate.decide(
+      plan: plan,
+      memoryItems: memoryBundle.items,
+      strongPins: sessionGlossary?.strongEntries ?? const {},
+      hasEntityHints: entityBundle.hasPromptData,
+    );
+  }
+
+  /// 本地快速路径：直接输出 [decision] 的改写结果，不调用 LLM。
+  ///
+  /// 本地改写不提取进 SessionGlossary，避免判定结果自我强化；每
+  /// [LocalRewriteGate.shadowEvery] 次在后台用 LLM 抽检一次。
+  Future<CorrectionResult> _commitLocalRewrite(
+    String rawText,
+    LocalRewriteDecision decision, {
+    required LocalCorrectionPlan plan,
+    required EntityPromptBundle entityBundle,
+    required _MemoryReferenceBundle memoryBundle,
+  }) async {
+    final contextStr = context.getContextString();
+    await _recordStatsSafely(
+      matchesCount: plan.matchHits.length,
+      selectedCount: plan.selectedHits.length,
+      referenceChars: 0,
+      llmInvoked: false,
+      localRewrite: true,
+    );
+    await _commitCorrection(
+      rawText: rawText,
+      correctedText: decision.text,
+      selectedHits: decision.appliedHits,
+      entityBundle: entityBundle,
+      source: 'local',
+    );
+    await _recordMemoryHitsSafely(
+      decision.memoryItemIds,
+      sourceRef: 'realtime',
+    );
+    await LogService.info(
+      'CORRECTION',
+      'local rewrite: ${decision.rewriteCount} replacements, skipping LLM',
+    );
+
+    final every = localRewriteGate?.shadowEvery ?? 0;
+    if (every > 0 && _localRewrites++ % every == 0) {
+      unawaited(
+        _shadowCheck(
+          rawText,
+          decision.text,
+          plan: plan,
+          memoryBundle: memoryBundle,
+          contextStr: contextStr,
+        ),
+      );
+    }
+    return CorrectionResult(text: decision.text);
+  }
+
+  /// 抽检本地直出：用与 LLM 路径相同的 #R/#C/#I 请求一次纠错，与本地
+  /// 结果 [localText] 比对。不一致时计数并写入改动记录（来源
+  /// `local-shadow`，输入为本地结果、输出为 LLM 结果），不回写上下文。
+  Future<void> _shadowCheck(
+    String rawText,
+    String localText, {
+    required LocalCorrectionPlan plan,
+    required _MemoryReferenceBundle memoryBundle,
+    required String contextStr,
+  }) async {
+    try {
+      final reference = _joinReferenceParts([
+        _buildReferenceStringFromHits(plan.selectedHits),
+        memoryBundle.reference,
+      ]);
+      final result = await AiEnhanceService(_correctionConfig()).enhance(
+        _buildUserMessage(
+          reference: context.withoutSessionReferences(reference),
+          input: rawText,
+          contextStr: contextStr,
+        ),
+        unchangedText: rawText,
+      );
+      var llmText = result.text.trim();
+      if (llmText.isEmpty) return;
+      if (plan.selectedHits.isNotEmpty) {
+        llmText = _normalizeMatchedTermsFromHits(llmText, plan.selectedHits);
+      }
+      if (result.totalTokens > 0) {
+        await TokenStatsService.instance.addTokens(
+          promptTokens: result.promptTokens,
+          completionTokens: result.completionTokens,
+          cachedPromptTokens: result.cachedPromptTokens,
+        );
+      }
+      final mismatch = llmText != localText.trim();
+      await CorrectionStatsService.instance.recordShadowCheck(
+        mismatch: mismatch,
+      );
+      if (!mismatch) return;
+      await LogService.info(
+        'CORRECTION',
+        'local rewrite differs from LLM: ${localText.length} vs '
+            '${llmText.length} chars',
+      );
+      await CorrectionChangeLogService.instance.recordChange(
+        source: 'local-shadow',
+        inputText: localText,
+        outputText: llmText,
+        terms: _buildTermPairsFromHits(plan.selectedHits),
+      );
+    } catch (e) {
+      await LogService.warn('CORRECTION', 'local rewrite shadow failed: $e');
+    }
+  }
+
+  /// 纠错请求配置：system prompt 为纠错提示词加 #G 会话词表。
+  ///
+  /// #G 只追加，同一会话内前后请求的 system prompt 逐字节共享前缀，
+  /// 可命中服务端的前缀缓存；每次都变的 #R/#C/#I 都在 user message 中。
+  AiEnhanceConfig _correctionConfig() {
+    final glossary = context.getSessionReferenceString();
+    if (glossary.isEmpty) return aiConfig.copyWith(prompt: correctionPrompt);
+    return aiConfig.copyWith(prompt: '$correctionPrompt\n\n#G: $glossary');
+  }
+
+  /// 把 SessionGlossary 的强锚定条目并入会话词表，返回会话词表已满、
+  /// 需要放进本段 #R 的条目。
+  String _pinSessionGlossary() {
+    if (sessionGlossary == null || !sessionGlossary!.hasStrongEntries) {
+      return '';
+    }
+    return context.addSessionReferences(
+      sessionGlossary!.buildReferenceAppend(),
+    );
+  }
+
   /// 构建用于纠错的 user message（#R/#I/#C 符号化协议）。
   String _buildUserMessage({
     required String reference,
@@ -561,239 +1041,41 @@ class CorrectionService {
     );
   }
 
-  bool _containsChinese(String text) {
-    return RegExp(r'[\u4e00-\u9fff]').hasMatch(text);
-  }
-
-  bool _isChineseToLatinAlias(DictionaryEntry entry) {
-    final original = entry.original.trim();
-    final corrected = entry.corrected?.trim() ?? '';
-    return entry.type == DictionaryEntryType.correction &&
-        corrected.isNotEmpty &&
-        _containsChinese(original) &&
-        !_containsChinese(corrected);
-  }
-
-  String _targetTextForEntry(DictionaryEntry entry) {
-    if (entry.type != DictionaryEntryType.correction) {
-      return entry.original;
-    }
-    final corrected = entry.corrected?.trim() ?? '';
-    if (corrected.isEmpty) return entry.original;
-    if (_isChineseToLatinAlias(entry)) {
-      return entry.original;
-    }
-    return corrected;
-  }
-
-  String _normalizeMatchedTermsFromHits(
-    String text,
-    List<PinyinMatchHit> hits,
-  ) {
-    var output = text;
-    for (final hit in hits) {
-      final entry = hit.entry;
-      final alias = entry.corrected?.trim() ?? '';
-      final original = entry.original.trim();
-      final observed = hit.observedText.trim();
-
-      if (_isChineseToLatinAlias(entry)) {
-        final target = original;
-        if (alias.isEmpty || target.isEmpty) continue;
-
-        if (observed.isNotEmpty &&
-            observed != target &&
-            _containsChinese(observed)) {
-          output = output.replaceAll(observed, target);
-        }
-
-        output = output.replaceAll(
-          RegExp(RegExp.escape(alias), caseSensitive: false),
-          target,
-        );
+  bool _containsChinese(String text) =>
+      TermReplacementEngine.containsChinese(text);
 
-        final pinyin = PinyinMatcher.computePinyin(target);
-        if (pinyin.isNotEmpty) {
-          final syllables = pinyin
-              .split(RegExp(r'\s+'))
-              .where((s) => s.isNotEmpty)
-              .toList(growable: false);
-          if (syllables.isNotEmpty) {
-            final pattern = RegExp(
-              '\\b${syllables.map(RegExp.escape).join(r'[\\s_-]*')}\\b',
-              caseSensitive: false,
-            );
-            output = output.replaceAll(pattern, target);
-          }
-        }
-        continue;
-      }
+  bool _isChineseToLatinAlias(DictionaryEntry entry) =>
+      TermReplacementEngine.isChineseToLatinAlias(entry);
 
-      // Also normalize latin/romanized aliases back to canonical Chinese
-      // when the selected hit already proves they should collapse.
-      if (entry.type == DictionaryEntryType.correction &&
-          alias.isNotEmpty &&
-          _containsChinese(alias) &&
-          observed.isNotEmpty &&
-          !_containsChinese(observed)) {
-        output = output.replaceAll(
-          RegExp(RegExp.escape(observed), caseSensitive: false),
-          alias,
+  /// 拼音匹配、候选筛选与归一化。配置了 [computePool] 时在后台 isolate
+  /// 执行，池不可用时退回当前 isolate。不读写上下文窗口，可以提前计算。
+  Future<LocalCorrectionPlan> planLocal(String text) async {
+    final selector = ReferenceHitSelector(
+      maxReferenceEntries: maxReferenceEntries,
+      minCandidateScore: minCandidateScore,
+    );
+    final pool = computePool;
+    if (pool != null) {
+      try {
+        return await pool.planCorrection(matcher, text, selector);
+      } catch (e) {
+        await LogService.warn(
+          'CORRECTION',
+          'compute pool unavailable, matching inline: $e',
         );
-        if (original.isNotEmpty && !_containsChinese(original)) {
-          output = output.replaceAll(
-            RegExp(RegExp.escape(original), caseSensitive: false),
-            alias,
-          );
-        }
       }
     }
-    return output;
+    return LocalCorrectionPlan.compute(matcher, text, selector);
   }
 
-  List<PinyinMatchHit> _selectHitsForReference(
-    String rawText,
+  String _targetTextForEntry(DictionaryEntry entry) =>
+      ReferenceHitSelector.targetTextFor(entry);
+
+  String _normalizeMatchedTermsFromHits(
+    String text,
     List<PinyinMatchHit> hits,
   ) {
-    if (hits.isEmpty) return const [];
-    final ranked = hits
-        .map((hit) => _RankedHit(hit: hit, score: _scoreHit(rawText, hit)))
-        .where((r) => r.score >= minCandidateScore)
-        .toList();
-
-    if (ranked.isEmpty) return const [];
-
-    ranked.sort((a, b) {
-      final byScore = b.score.compareTo(a.score);
-      if (byScore != 0) return byScore;
-      final aLen = a.hit.observedText.length;
-      final bLen = b.hit.observedText.length;
-      final byLen = bLen.compareTo(aLen);
-      if (byLen != 0) return byLen;
-      return a.hit.entry.id.compareTo(b.hit.entry.id);
-    });
-
-    final result = <PinyinMatchHit>[];
-    final seen = <String>{};
-    for (final item in ranked) {
-      final key = _referenceDedupKey(item.hit);
-      if (!seen.add(key)) continue;
-      result.add(item.hit);
-      if (result.length >= maxReferenceEntries) break;
-    }
-    return result;
-  }
-
-  String _referenceDedupKey(PinyinMatchHit hit) {
-    final entry = hit.entry;
-    final target = _targetTextForEntry(entry);
-    final source = hit.observedText.trim().isNotEmpty
-        ? hit.observedText.trim()
-        : entry.original;
-    return '$source->$target';
-  }
-
-  double _scoreHit(String rawText, PinyinMatchHit hit) {
-    final source = rawText.trim();
-    if (source.isEmpty) return 0;
-
-    final entry = hit.entry;
-    final original = entry.original.trim();
-    final corrected = (entry.corrected ?? '').trim();
-    final observed = hit.observedText.trim();
-    if (original.isEmpty && corrected.isEmpty) return 0;
-
-    if (hit.matchType == PinyinMatchType.literal) {
-      return 1;
-    }
-
-    var bestCharSimilarity = 0.0;
-    if (observed.isNotEmpty && original.isNotEmpty) {
-      final s = _normalizedSimilarity(observed, original);
-      if (s > bestCharSimilarity) bestCharSimilarity = s;
-    }
-    if (observed.isNotEmpty && corrected.isNotEmpty) {
-      final s = _normalizedSimilarity(observed, corrected);
-      if (s > bestCharSimilarity) bestCharSimilarity = s;
-    }
-
-    var bestPinyinSimilarity = 0.0;
-    if (observed.isNotEmpty &&
-        original.isNotEmpty &&
-        _containsChinese(observed) &&
-        _containsChinese(original)) {
-      final observedPinyin = PinyinMatcher.computePinyin(observed);
-      final originalPinyin = PinyinMatcher.computePinyin(original);
-      final s = _normalizedSimilarity(observedPinyin, originalPinyin);
-      if (s > bestPinyinSimilarity) bestPinyinSimilarity = s;
-    }
-    if (observed.isNotEmpty &&
-        corrected.isNotEmpty &&
-        _containsChinese(observed) &&
-        _containsChinese(corrected)) {
-      final observedPinyin = PinyinMatcher.computePinyin(observed);
-      final correctedPinyin = PinyinMatcher.computePinyin(corrected);
-      final s = _normalizedSimilarity(observedPinyin, correctedPinyin);
-      if (s > bestPinyinSimilarity) bestPinyinSimilarity = s;
-    }
-    if (observed.isNotEmpty &&
-        entry.hasPinyinPattern &&
-        _containsChinese(observed)) {
-      final observedPinyin = PinyinMatcher.computePinyin(observed);
-      final s = _normalizedSimilarity(observedPinyin, entry.pinyinNormalized);
-      if (s > bestPinyinSimilarity) bestPinyinSimilarity = s;
-    }
-
-    final typeBonus = entry.type == DictionaryEntryType.correction ? 0.05 : 0.0;
-    final patternBonus = entry.hasPinyinPattern ? 0.18 : 0.0;
-    final matchTypeBonus = switch (hit.matchType) {
-      PinyinMatchType.pinyinExact => 0.12,
-      PinyinMatchType.pinyinFuzzy => 0.06,
-      PinyinMatchType.literal => 0.18,
-    };
-    final combined =
-        bestCharSimilarity * 0.55 +
-        bestPinyinSimilarity * 0.45 +
-        typeBonus +
-        patternBonus +
-        matchTypeBonus;
-    return combined > 1.0 ? 1.0 : combined;
-  }
-
-  double _normalizedSimilarity(String a, String b) {
-    if (a.isEmpty || b.isEmpty) return 0;
-    if (a == b) return 1;
-    final distance = _levenshtein(a, b);
-    final base = a.length > b.length ? a.length : b.length;
-    if (base == 0) return 0;
-    final sim = 1 - (distance / base);
-    return sim < 0 ? 0 : sim;
-  }
-
-  int _levenshtein(String a, String b) {
-    if (a == b) return 0;
-    if (a.isEmpty) return b.length;
-    if (b.isEmpty) return a.length;
-
-    var prev = List.generate(b.length + 1, (i) => i);
-    var curr = List.filled(b.length + 1, 0);
-
-    for (var i = 1; i <= a.length; i++) {
-      curr[0] = i;
-      for (var j = 1; j <= b.length; j++) {
-        final cost = a.codeUnitAt(i - 1) == b.codeUnitAt(j - 1) ? 0 : 1;
-        final deletion = prev[j] + 1;
-        final insertion = curr[j - 1] + 1;
-        final substitution = prev[j - 1] + cost;
-        var value = deletion < insertion ? deletion : insertion;
-        if (substitution < value) value = substitution;
-        curr[j] = value;
-      }
-      final tmp = prev;
-      prev = curr;
-      curr = tmp;
-    }
-    return prev[b.length];
+    return TermReplacementEngine.forMatcher(matcher).apply(text, hits);
   }
 
   List<CorrectionTermPair> _buildTermPairsFromHits(List<PinyinMatchHit> hits) {
@@ -817,11 +1099,47 @@ class CorrectionService {
     return pairs;
   }
 
+  /// 纠错后的收尾：更新上下文窗口，提取同音映射到 SessionGlossary，
+  /// 激活提及的实体并按 [source] 记录改动。本地改写（`local`）不提取
+  /// 同音映射。
+  Future<void> _commitCorrection({
+    required String rawText,
+    required String correctedText,
+    required List<PinyinMatchHit> selectedHits,
+    required EntityPromptBundle entityBundle,
+    String source = 'realtime',
+  }) async {
+    context.addSegment(correctedText);
+    if (sessionGlossary != null &&
+        source != 'local' &&
+        correctedText != rawText) {
+      sessionGlossary!.extractAndPin(rawText, correctedText);
+    }
+    if (sessionEntityState != null) {
+      entityRecallService.activateMentions(
+        text: correctedText,
+        bundle: entityBundle,
+        sessionState: sessionEntityState!,
+      );
+    }
+    if (correctedText != rawText) {
+      try {
+        await CorrectionChangeLogService.instance.recordChange(
+          source: source,
+          inputText: rawText,
+          outputText: correctedText,
+          terms: _buildTermPairsFromHits(selectedHits),
+        );
+      } catch (_) {}
+    }
+  }
+
   Future<void> _recordStatsSafely({
     required int matchesCount,
     required int selectedCount,
     required int referenceChars,
     required bool llmInvoked,
+    bool localRewrite = false,
     int promptTokens = 0,
     int completionTokens = 0,
   }) async {
@@ -831,6 +1149,7 @@ class CorrectionService {
         selectedCount: selectedCount,
         referenceChars: referenceChars,
         llmInvoked: llmInvoked,
+        localRewrite: localRewrite,
         promptTokens: promptTokens,
         completionTokens: completionTokens,
       );
@@ -864,13 +1183,6 @@ class CorrectionService {
   }
 }
 
-class _RankedHit {
-  final PinyinMatchHit hit;
-  final double score;
-
-  const _RankedHit({required this.hit, required this.score});
-}
-
 class _ScoredMemoryReference {
   final MemoryItem item;
   final double score;
@@ -880,7 +1192,35 @@ class _ScoredMemoryReference {
 
 class _MemoryReferenceBundle {
   final String reference;
-  final List<String> itemIds;
+  final List<MemoryItem> items;
+
+  const _MemoryReferenceBundle({this.reference = '', this.items = const []});
+
+  List<String> get itemIds => [for (final item in items) item.id];
+}
+
+/// 批量纠错中的一个分段及其本地匹配结果。
+class _BatchSegment {
+  final String raw;
+  final LocalCorrectionPlan plan;
+  final EntityPromptBundle entityBundle;
+  final _MemoryReferenceBundle memoryBundle;
+
+  /// 本地快速路径已能确定时的判定结果。
+  final LocalRewriteDecision? local;
+
+  const _BatchSegment({
+    required this.raw,
+    required this.plan,
+    required this.entityBundle,
+    required this.memoryBundle,
+    this.local,
+  });
 
-  const _MemoryReferenceBundle({this.reference = '', this.itemIds = const []});
+  bool get needsLlm =>
+      raw.trim().isNotEmpty &&
+      local == null &&
+      (plan.selectedHits.isNotEmpty ||
+          entityBundle.hasPromptData ||
+          memoryBundle.reference.isNotEmpty);
 }
@@ -1,4 +1,4 @@
-import '../database/app_database.dart';
+import 'stat_counters.dart';
 
 /// 持久化纠错召回与 Token 指标，用于后续参数调优。
 class CorrectionStatsService {
@@ -13,6 +13,12 @@ class CorrectionStatsService {
   static const _keyPromptTokensTotal = 'correction_prompt_tokens_total';
   static const _keyCompletionTokensTotal = 'correction_completion_tokens_total';
 
+  // ── 本地快速路径 ──
+  static const _keyLocalRewrites = 'correction_local_rewrites_total';
+  static const _keyShadowChecks = 'correction_local_shadow_checks_total';
+  static const _keyShadowMismatches =
+      'correction_local_shadow_mismatches_total';
+
   // ── 终态回溯 ──
   static const _keyRetroCalls = 'correction_retro_calls_total';
   static const _keyRetroLlmCalls = 'correction_retro_llm_calls_total';
@@ -28,42 +34,58 @@ class CorrectionStatsService {
   static const _keyGlossaryOverrides = 'glossary_overrides_total';
   static const _keyGlossaryInjections = 'glossary_injections_total';
 
+  static const _allKeys = [
+    _keyCallsTotal,
+    _keyLlmCallsTotal,
+    _keyMatchesTotal,
+    _keySelectedTotal,
+    _keyReferenceCharsTotal,
+    _keyPromptTokensTotal,
+    _keyCompletionTokensTotal,
+    _keyLocalRewrites,
+    _keyShadowChecks,
+    _keyShadowMismatches,
+    _keyRetroCalls,
+    _keyRetroLlmCalls,
+    _keyRetroPromptTokens,
+    _keyRetroCompletionTokens,
+    _keyRetroTextChanged,
+    _keyGlossaryPins,
+    _keyGlossaryStrongPromotions,
+    _keyGlossaryOverrides,
+    _keyGlossaryInjections,
+  ];
+
+  final _counters = StatCounters.instance;
+
+  /// 记录一次纠错调用；计数只在内存中累加，由 [StatCounters] 批量落盘。
+  ///
+  /// [localRewrite] 表示本地快速路径完成了纠错、省下了一次 LLM 调用。
   Future<void> recordCall({
     required int matchesCount,
     required int selectedCount,
     required int referenceChars,
     required bool llmInvoked,
+    bool localRewrite = false,
     int promptTokens = 0,
     int completionTokens = 0,
   }) async {
-    final db = await AppDatabase.getInstance();
-    final snapshot = await getSnapshot();
+    _counters
+      ..add(_keyCallsTotal, 1)
+      ..add(_keyLlmCallsTotal, llmInvoked ? 1 : 0)
+      ..add(_keyLocalRewrites, localRewrite ? 1 : 0)
+      ..add(_keyMatchesTotal, matchesCount)
+      ..add(_keySelectedTotal, selectedCount)
+      ..add(_keyReferenceCharsTotal, referenceChars)
+      ..add(_keyPromptTokensTotal, promptTokens)
+      ..add(_keyCompletionTokensTotal, completionTokens);
+  }
 
-    await db.setSetting(_keyCallsTotal, (snapshot.calls + 1).toString());
-    await db.setSetting(
-      _keyLlmCallsTotal,
-      (snapshot.llmCalls + (llmInvoked ? 1 : 0)).toString(),
-    );
-    await db.setSetting(
-      _keyMatchesTotal,
-      (snapshot.matches + matchesCount).toString(),
-    );
-    await db.setSetting(
-      _keySelectedTotal,
-      (snapshot.selected + selectedCount).toString(),
-    );
-    await db.setSetting(
-      _keyReferenceCharsTotal,
-      (snapshot.referenceChars + referenceChars).toString(),
-    );
-    await db.setSetting(
-      _keyPromptTokensTotal,
-      (snapshot.promptTokens + promptTokens).toString(),
-    );
-    await db.setSetting(
-      _keyCompletionTokensTotal,
-      (snapshot.completionTokens + completionTokens).toString(),
-    );
+  /// 记录一次本地直出的 LLM 抽检；[mismatch] 表示 LLM 结果与本地不同。
+  Future<void> recordShadowCheck({required bool mismatch}) async {
+    _counters
+      ..add(_keyShadowChecks, 1)
+      ..add(_keyShadowMismatches, mismatch ? 1 : 0);
   }
 
   /// 记录一次终态回溯调用。
@@ -73,25 +95,12 @@ class CorrectionStatsService {
     int promptTokens = 0,
     int completionTokens = 0,
   }) async {
-    final db = await AppDatabase.getInstance();
-    final snap = await getSnapshot();
-    await db.setSetting(_keyRetroCalls, (snap.retroCalls + 1).toString());
-    await db.setSetting(
-      _keyRetroLlmCalls,
-      (snap.retroLlmCalls + (llmInvoked ? 1 : 0)).toString(),
-    );
-    await db.setSetting(
-      _keyRetroPromptTokens,
-      (snap.retroPromptTokens + promptTokens).toString(),
-    );
-    await db.setSetting(
-      _keyRetroCompletionTokens,
-      (snap.retroCompletionTokens + completionTokens).toString(),
-    );
-    await db.setSetting(
-      _keyRetroTextChanged,
-      (snap.retroTextChanged + (textChanged ? 1 : 0)).toString(),
-    );
+    _counters
+      ..add(_keyRetroCalls, 1)
+      ..add(_keyRetroLlmCalls, llmInvoked ? 1 : 0)
+      ..add(_keyRetroPromptTokens, promptTokens)
+      ..add(_keyRetroCompletionTokens, completionTokens)
+      ..add(_keyRetroTextChanged, textChanged ? 1 : 0);
   }
 
   /// 累加 SessionGlossary 会话统计到持久化计数器。
@@ -101,88 +110,37 @@ class CorrectionStatsService {
     required int overrides,
     required int injections,
   }) async {
-    if (pins == 0 &&
-        strongPromotions == 0 &&
-        overrides == 0 &&
-        injections == 0) {
-      return;
-    }
-    final db = await AppDatabase.getInstance();
-    final snap = await getSnapshot();
-    await db.setSetting(
-      _keyGlossaryPins,
-      (snap.glossaryPins + pins).toString(),
-    );
-    await db.setSetting(
-      _keyGlossaryStrongPromotions,
-      (snap.glossaryStrongPromotions + strongPromotions).toString(),
-    );
-    await db.setSetting(
-      _keyGlossaryOverrides,
-      (snap.glossaryOverrides + overrides).toString(),
-    );
-    await db.setSetting(
-      _keyGlossaryInjections,
-      (snap.glossaryInjections + injections).toString(),
-    );
+    _counters
+      ..add(_keyGlossaryPins, pins)
+      ..add(_keyGlossaryStrongPromotions, strongPromotions)
+      ..add(_keyGlossaryOverrides, overrides)
+      ..add(_keyGlossaryInjections, injections);
   }
 
   Future<CorrectionStatsSnapshot> getSnapshot() async {
-    final db = await AppDatabase.getInstance();
-    final calls = int.tryParse(await db.getSetting(_keyCallsTotal) ?? '') ?? 0;
-    final llmCalls =
-        int.tryParse(await db.getSetting(_keyLlmCallsTotal) ?? '') ?? 0;
-    final matches =
-        int.tryParse(await db.getSetting(_keyMatchesTotal) ?? '') ?? 0;
-    final selected =
-        int.tryParse(await db.getSetting(_keySelectedTotal) ?? '') ?? 0;
-    final referenceChars =
-        int.tryParse(await db.getSetting(_keyReferenceCharsTotal) ?? '') ?? 0;
-    final promptTokens =
-        int.tryParse(await db.getSetting(_keyPromptTokensTotal) ?? '') ?? 0;
-    final completionTokens =
-        int.tryParse(await db.getSetting(_keyCompletionTokensTotal) ?? '') ?? 0;
-
-    // ── 终态回溯 ──
-    final retroCalls =
-        int.tryParse(await db.getSetting(_keyRetroCalls) ?? '') ?? 0;
-    final retroLlmCalls =
-        int.tryParse(await db.getSetting(_keyRetroLlmCalls) ?? '') ?? 0;
-    final retroPromptTokens =
-        int.tryParse(await db.getSetting(_keyRetroPromptTokens) ?? '') ?? 0;
-    final retroCompletionTokens =
-        int.tryParse(await db.getSetting(_keyRetroCompletionTokens) ?? '') ?? 0;
-    final retroTextChanged =
-        int.tryParse(await db.getSetting(_keyRetroTextChanged) ?? '') ?? 0;
-
-    // ── SessionGlossary ──
-    final glossaryPins =
-        int.tryParse(await db.getSetting(_keyGlossaryPins) ?? '') ?? 0;
-    final glossaryStrongPromotions =
-        int.tryParse(await db.getSetting(_keyGlossaryStrongPromotions) ?? '') ??
-        0;
-    final glossaryOverrides =
-        int.tryParse(await db.getSetting(_keyGlossaryOverrides) ?? '') ?? 0;
-    final glossaryInjections =
-        int.tryParse(await db.getSetting(_keyGlossaryInjections) ?? '') ?? 0;
+    final values = await _counters.read(_allKeys);
+    int value(String key) => values[key] ?? 0;
 
     return CorrectionStatsSnapshot(
-      calls: calls,
-      llmCalls: llmCalls,
-      matches: matches,
-      selected: selected,
-      referenceChars: referenceChars,
-      promptTokens: promptTokens,
-      completionTokens: completionTokens,
-      retroCalls: retroCalls,
-      retroLlmCalls: retroLlmCalls,
-      retroPromptTokens: retroPromptTokens,
-      retroCompletionTokens: retroCompletionTokens,
-      retroTextChanged: retroTextChanged,
-      glossaryPins: glossaryPins,
-      glossaryStrongPromotions: glossaryStrongPromotions,
-      glossaryOverrides: glossaryOverrides,
-      glossaryInjections: glossaryInjections,
+      calls: value(_keyCallsTotal),
+      llmCalls: value(_keyLlmCallsTotal),
+      matches: value(_keyMatchesTotal),
+      selected: value(_keySelectedTotal),
+      referenceChars: value(_keyReferenceCharsTotal),
+      promptTokens: value(_keyPromptTokensTotal),
+      completionTokens: value(_keyCompletionTokensTotal),
+      localRewrites: value(_keyLocalRewrites),
+      shadowChecks: value(_keyShadowChecks),
+      shadowMismatches: value(_keyShadowMismatches),
+      retroCalls: value(_keyRetroCalls),
+      retroLlmCalls: value(_keyRetroLlmCalls),
+      retroPromptTokens: value(_keyRetroPromptTokens),
+      retroCompletionTokens: value(_keyRetroCompletionTokens),
+      retroTextChanged: value(_keyRetroTextChanged),
+      glossaryPins: value(_keyGlossaryPins),
+      glossaryStrongPromotions: value(_keyGlossaryStrongPromotions),
+      glossaryOverrides: value(_keyGlossaryOverrides),
+      glossaryInjections: value(_keyGlossaryInjections),
     );
   }
 }
@@ -196,6 +154,11 @@ class CorrectionStatsSnapshot {
   final int promptTokens;
   final int completionTokens;
 
+  // ── 本地快速路径 ──
+  final int localRewrites;
+  final int shadowChecks;
+  final int shadowMismatches;
+
   // ── 终态回溯 ──
   final int retroCalls;
   final int retroLlmCalls;
@@ -217,6 +180,9 @@ class CorrectionStatsSnapshot {
     required this.referenceChars,
     required this.promptTokens,
     required this.completionTokens,
+    this.localRewrites = 0,
+    this.shadowChecks = 0,
+    this.shadowMismatches = 0,
     this.retroCalls = 0,
     this.retroLlmCalls = 0,
     this.retroPromptTokens = 0,
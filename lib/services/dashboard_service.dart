@@ -1,20 +1,18 @@
-import 'dart:convert';
-
 import '../database/app_database.dart';
 import '../models/dashboard_stats.dart';
-import '../models/memory_event.dart';
 import '../models/memory_item.dart';
 import 'correction_stats_service.dart';
+import 'llm_stream_stats_service.dart';
+import 'memory_record_store.dart';
+import 'pipeline_tracer.dart';
 import 'token_stats_service.dart';
 
 /// 仪表盘统计计算服务。
 ///
-/// 从数据库获取全部转录记录，在 Dart 层计算各维度统计指标。
+/// 读取按天与按模型的汇总表，在 Dart 层计算各维度统计指标。
 class DashboardService {
   DashboardService._();
   static final instance = DashboardService._();
-  static const _adaptiveMemoryItemsKey = 'adaptive_memory_items_v1';
-  static const _memoryEventsKey = 'memory_events_v1';
 
   final _db = AppDatabase.instance;
 
@@ -22,27 +20,6 @@ class DashboardService {
   Future<DashboardStats> computeStats({
     TrendGranularity granularity = TrendGranularity.day,
   }) async {
-    final all = await _db.getAllHistory();
-
-    // ── 核心汇总 ──
-    final totalCount = all.length;
-    int totalDurationMs = 0;
-    int totalCharCount = 0;
-    for (final t in all) {
-      totalDurationMs += t.duration.inMilliseconds;
-      totalCharCount += t.text.length;
-    }
-    final avgCharsPerSession = totalCount > 0
-        ? totalCharCount / totalCount
-        : 0.0;
-    final avgDurationMs = totalCount > 0 ? totalDurationMs / totalCount : 0.0;
-
-    // ── 效率 ──
-    final totalMinutes = totalDurationMs / 60000.0;
-    final avgCharsPerMinute = totalMinutes > 0
-        ? totalCharCount / totalMinutes
-        : 0.0;
-
     // ── 今日 / 本周 / 本月 ──
     final now = DateTime.now();
     final todayStart = DateTime(now.year, now.month, now.day);
@@ -56,52 +33,70 @@ class DashboardService {
     int weekCount = 0, weekDurationMs = 0, weekChars = 0;
     int monthCount = 0, monthDurationMs = 0, monthChars = 0;
 
-    // ── 分布 ──
-    final providerDist = <String, int>{};
-    final modelDist = <String, int>{};
+    // ── 核心汇总 ──
+    int totalCount = 0;
+    int totalDurationMs = 0;
+    int totalCharCount = 0;
 
     // ── 按天分组（用于活跃度和趋势计算） ──
+    // 每日汇总由触发器随历史记录写入维护，这里只读取汇总行。
     final dailyMap = <DateTime, _DailyAccumulator>{};
-
-    for (final t in all) {
-      final dayKey = DateTime(
-        t.createdAt.year,
-        t.createdAt.month,
-        t.createdAt.day,
-      );
+    for (final row in await _db.getDailyHistoryStats()) {
+      final parsed = DateTime.tryParse(row.day);
+      if (parsed == null) continue;
+      final dayKey = DateTime(parsed.year, parsed.month, parsed.day);
       final acc = dailyMap.putIfAbsent(dayKey, _DailyAccumulator.new);
-      acc.count++;
-      acc.durationMs += t.duration.inMilliseconds;
-      acc.charCount += t.text.length;
+      acc.count += row.count;
+      acc.durationMs += row.durationMs;
+      acc.charCount += row.charCount;
+
+      totalCount += row.count;
+      totalDurationMs += row.durationMs;
+      totalCharCount += row.charCount;
 
       // 今日 / 本周 / 本月
-      if (!t.createdAt.isBefore(todayStart)) {
-        todayCount++;
-        todayDurationMs += t.duration.inMilliseconds;
-        todayChars += t.text.length;
+      if (!dayKey.isBefore(todayStart)) {
+        todayCount += row.count;
+        todayDurationMs += row.durationMs;
+        todayChars += row.charCount;
       }
-      if (!t.createdAt.isBefore(weekStart)) {
-        weekCount++;
-        weekDurationMs += t.duration.inMilliseconds;
-        weekChars += t.text.length;
+      if (!dayKey.isBefore(weekStart)) {
+        weekCount += row.count;
+        weekDurationMs += row.durationMs;
+        weekChars += row.charCount;
       }
-      if (!t.createdAt.isBefore(monthStart)) {
-        monthCount++;
-        monthDurationMs += t.duration.inMilliseconds;
-        monthChars += t.text.length;
+      if (!dayKey.isBefore(monthStart)) {
+        monthCount += row.count;
+        monthDurationMs += row.durationMs;
+        monthChars += row.charCount;
       }
+    }
 
-      // 分布
-      final pKey = t.provider.isEmpty ? 'Unknown' : t.provider;
-      providerDist[pKey] = (providerDist[pKey] ?? 0) + 1;
-      final mKey = t.model.isEmpty ? 'Unknown' : t.model;
-      modelDist[mKey] = (modelDist[mKey] ?? 0) + 1;
+    // ── 分布 ──
+    final providerDist = <String, int>{};
+    final modelDist = <String, int>{};
+    for (final row in await _db.getHistoryModelUsage()) {
+      final pKey = row.provider.isEmpty ? 'Unknown' : row.provider;
+      providerDist[pKey] = (providerDist[pKey] ?? 0) + row.count;
+      final mKey = row.model.isEmpty ? 'Unknown' : row.model;
+      modelDist[mKey] = (modelDist[mKey] ?? 0) + row.count;
     }
 
+    final latest = await _db.getHistoryPage(limit: 1);
+    final lastTranscriptionAt = latest.isEmpty ? null : latest.first.createdAt;
+
+    final avgCharsPerSession = totalCount > 0
+        ? totalCharCount / totalCount
+        : 0.0;
+    final avgDurationMs = totalCount > 0 ? totalDurationMs / totalCount : 0.0;
+
+    // ── 效率 ──
+    final totalMinutes = totalDurationMs / 60000.0;
+    final avgCharsPerMinute = totalMinutes > 0
+        ? totalCharCount / totalMinutes
+        : 0.0;
+
     // ── 活跃度 ──
-    final lastTranscriptionAt = all.isEmpty
-        ? null
-        : all.first.createdAt; // getAll 按 DESC 排序
     final sortedDays = dailyMap.keys.toList()..sort();
 
     // 最活跃的一天
@@ -126,6 +121,7 @@ class DashboardService {
 
     // ── AI 增强 token 用量 ──
     final tokenStats = await TokenStatsService.instance.getTokens();
+    final cacheStats = await TokenStatsService.instance.getCacheStats();
 
     // ── 纠错 token 用量 ──
     final correctionStats = await CorrectionStatsService.instance.getSnapshot();
@@ -133,6 +129,12 @@ class DashboardService {
     // ── 学习记忆 ──
     final learningStats = await _computeLearningStats(weekStart: weekStart);
 
+    // ── 流水线阶段耗时 ──
+    final stageLatencies = await _computeStageLatencies(
+      since: todayStart.subtract(const Duration(days: latencyWindowDays - 1)),
+    );
+    final modelStreamLatencies = await _computeModelStreamLatencies();
+
     return DashboardStats(
       totalCount: totalCount,
       totalDurationMs: totalDurationMs,
@@ -166,6 +168,9 @@ class DashboardService {
       correctionMatches: correctionStats.matches,
       correctionSelected: correctionStats.selected,
       correctionReferenceChars: correctionStats.referenceChars,
+      correctionLocalRewrites: correctionStats.localRewrites,
+      correctionShadowChecks: correctionStats.shadowChecks,
+      correctionShadowMismatches: correctionStats.shadowMismatches,
       retroCalls: correctionStats.retroCalls,
       retroLlmCalls: correctionStats.retroLlmCalls,
       retroPromptTokens: correctionStats.retroPromptTokens,
@@ -181,17 +186,76 @@ class DashboardService {
       memoryEventsCount: learningStats.eventsCount,
       memoryPromptInjectionCount: learningStats.promptInjectionCount,
       memoryCorrectionHitCount: learningStats.correctionHitCount,
+      stageLatencies: stageLatencies,
+      modelStreamLatencies: modelStreamLatencies,
+      llmCacheHits: cacheStats.hits,
+      llmCacheLookups: cacheStats.lookups,
+      llmCacheSavedTokens: cacheStats.savedTokens,
+      enhanceCachedPromptTokens: tokenStats.cachedPromptTokens,
     );
   }
 
+  /// 阶段耗时统计的窗口天数（含今天）。
+  static const int latencyWindowDays = 7;
+
+  Future<List<StageLatency>> _computeStageLatencies({
+    required DateTime since,
+  }) async {
+    try {
+      final histograms = await PipelineTracer.instance.readHistograms(since);
+      final result = <StageLatency>[];
+      for (final stage in PipelineStage.all) {
+        final histogram = histograms[stage];
+        if (histogram == null || histogram.isEmpty) continue;
+        result.add(
+          StageLatency(
+            stage: stage,
+            count: histogram.totalCount,
+            p50Ms: histogram.percentile(0.5) / 1000,
+            p90Ms: histogram.percentile(0.9) / 1000,
+            p99Ms: histogram.percentile(0.99) / 1000,
+          ),
+        );
+      }
+      return result;
+    } catch (_) {
+      return const [];
+    }
+  }
+
+  /// 各模型的流式首字延迟与输出速度，按请求数从多到少排列。
+  Future<List<ModelStreamLatency>> _computeModelStreamLatencies() async {
+    try {
+      final records = await LlmStreamStatsService.instance.readAll();
+      final result = [
+        for (final entry in records.entries)
+          if (entry.value.requests > 0)
+            ModelStreamLatency(
+              model: entry.key,
+              count: entry.value.requests,
+              firstTokenP50Ms: entry.value.firstToken.percentile(0.5) / 1000,
+              firstTokenP90Ms: entry.value.firstToken.percentile(0.9) / 1000,
+              tokensPerSecond: entry.value.tokensPerSecond,
+            ),
+      ]..sort((a, b) => b.count.compareTo(a.count));
+      return result;
+    } catch (_) {
+      return const [];
+    }
+  }
+
   Future<_LearningStats> _computeLearningStats({
     required DateTime weekStart,
   }) async {
     try {
-      final memoryJson = await _db.getSetting(_adaptiveMemoryItemsKey);
-      final eventJson = await _db.getSetting(_memoryEventsKey);
-      final memoryItems = _decodeMemoryItems(memoryJson);
-      final memoryEvents = _decodeMemoryEvents(eventJson);
+      final memoryItems =
+          (await MemoryRecordCollections.memoryItems.readAll(_db))
+              .where((item) => item.displayText.isNotEmpty)
+              .toList(growable: false);
+      // 事件只需计数，不必逐条解码。
+      final eventsCount = await _db.countMemoryRecords(
+        MemoryRecordCollections.memoryEvents.name,
+      );
 
       var pending = 0;
       var weakActive = 0;
@@ -240,7 +304,7 @@ class DashboardService {
         suppressedCount: suppressed,
         highConfidenceCount: highConfidence,
         weekNewCount: weekNew,
-        eventsCount: memoryEvents.length,
+        eventsCount: eventsCount,
         promptInjectionCount: promptInjections,
         correctionHitCount: correctionHits,
       );
@@ -249,26 +313,6 @@ class DashboardService {
     }
   }
 
-  List<MemoryItem> _decodeMemoryItems(String? raw) {
-    if (raw == null || raw.trim().isEmpty) return const [];
-    final list = json.decode(raw) as List<dynamic>;
-    return list
-        .whereType<Map<String, dynamic>>()
-        .map(MemoryItem.fromJson)
-        .where((item) => item.displayText.isNotEmpty)
-        .toList(growable: false);
-  }
-
-  List<MemoryEvent> _decodeMemoryEvents(String? raw) {
-    if (raw == null || raw.trim().isEmpty) return const [];
-    final list = json.decode(raw) as List<dynamic>;
-    return list
-        .whereType<Map<String, dynamic>>()
-        .map(MemoryEvent.fromJson)
-        .where((event) => event.id.isNotEmpty)
-        .toList(growable: false);
-  }
-
   // ── 连续天数 ──
 
   int _computeStreak(List<DateTime> sortedDays, DateTime todayStart) {
@@ -0,0 +1,357 @@
+import 'dart:collection';
+
+import '../models/entity_alias.dart';
+import '../models/entity_memory.dart';
+import '../models/entity_relation.dart';
+
+/// 一段文本中出现的实体提及：标准名命中与别名命中。
+class EntityMentions {
+  final Set<String> canonicalEntityIds;
+  final Set<EntityAlias> aliases;
+
+  const EntityMentions({
+    this.canonicalEntityIds = const <String>{},
+    this.aliases = const <EntityAlias>{},
+  });
+
+  static const EntityMentions empty = EntityMentions();
+
+  bool get isEmpty => canonicalEntityIds.isEmpty && aliases.isEmpty;
+
+  bool hasCanonical(String entityId) => canonicalEntityIds.contains(entityId);
+
+  bool hasAlias(EntityAlias alias) => aliases.contains(alias);
+
+  Iterable<String> get entityIds sync* {
+    yield* canonicalEntityIds;
+    for (final alias in aliases) {
+      yield alias.entityId;
+    }
+  }
+
+  /// 与 [other] 是否包含相同的提及。
+  bool sameAs(EntityMentions other) {
+    if (identical(this, other)) return true;
+    return canonicalEntityIds.length == other.canonicalEntityIds.length &&
+        aliases.length == other.aliases.length &&
+        canonicalEntityIds.containsAll(other.canonicalEntityIds) &&
+        aliases.containsAll(other.aliases);
+  }
+
+  /// 合并 [other] 的提及；[other] 没有新增时返回自身。
+  EntityMentions union(EntityMentions other) {
+    if (other.isEmpty) return this;
+    if (isEmpty) return other;
+    if (canonicalEntityIds.containsAll(other.canonicalEntityIds) &&
+        aliases.containsAll(other.aliases)) {
+      return this;
+    }
+    return EntityMentions(
+      canonicalEntityIds: {...canonicalEntityIds, ...other.canonicalEntityIds},
+      aliases: Set<EntityAlias>.identity()
+        ..addAll(aliases)
+        ..addAll(other.aliases),
+    );
+  }
+}
+
+/// 实体召回索引。
+///
+/// 对全部已启用实体的标准名与别名建立一棵字典树，召回时对输入文本只做一次扫描，
+/// 不再逐实体、逐别名地 `contains`；同时维护实体 → 别名、实体 → 关系的邻接表。
+/// 历史与上下文文本的提及结果按文本缓存，跨分段复用。
+///
+/// 索引按实体/别名/关系列表实例缓存：设置层以写时复制方式替换列表，
+/// 因此列表不变即表示实体数据未变，无需重建。
+class EntityRecallIndex {
+  static const int _maxCachedTextMentions = 64;
+
+  final List<EntityMemory> memories;
+  final List<EntityAlias> aliases;
+  final List<EntityRelation> relations;
+
+  final Map<String, EntityMemory> _enabledById = {};
+  final Map<String, int> _memoryPosition = {};
+  final Map<String, List<EntityAlias>> _aliasesByEntity = {};
+  final Map<String, List<_IndexedRelation>> _relationsByEntity = {};
+  final Set<String> _manualEvidenceEntityIds = {};
+  final Map<String, int> _shortAliasCount = {};
+  final _MentionTrieNode _root = _MentionTrieNode();
+  int _maxPatternLength = 0;
+  final LinkedHashMap<String, EntityMentions> _textMentionCache =
+      LinkedHashMap<String, EntityMentions>();
+
+  EntityRecallIndex._(this.memories, this.aliases, this.relations) {
+    _build();
+  }
+
+  static final Expando<EntityRecallIndex> _indexByMemories = Expando(
+    'EntityRecallIndex',
+  );
+
+  /// 获取给定实体数据对应的索引，三个列表实例均未变化时复用缓存。
+  static EntityRecallIndex of({
+    required List<EntityMemory> memories,
+    required List<EntityAlias> aliases,
+    required List<EntityRelation> relations,
+  }) {
+    final cached = _indexByMemories[memories];
+    if (cached != null &&
+        identical(cached.aliases, aliases) &&
+        identical(cached.relations, relations)) {
+      return cached;
+    }
+    final index = EntityRecallIndex._(memories, aliases, relations);
+    _indexByMemories[memories] = index;
+    return index;
+  }
+
+  static final RegExp _shortLatinAlias = RegExp(r'^[A-Za-z0-9]+$');
+
+  void _build() {
+    for (var i = 0; i < memories.length; i++) {
+      final memory = memories[i];
+      if (!memory.enabled) continue;
+      _enabledById.putIfAbsent(memory.id, () => memory);
+      _memoryPosition.putIfAbsent(memory.id, () => i);
+      if (memory.canonicalName.isNotEmpty) {
+        _insert(memory.canonicalName, _MentionTarget.canonical(memory.id));
+      }
+    }
+
+    for (final alias in aliases) {
+      if (!_enabledById.containsKey(alias.entityId)) continue;
+      _aliasesByEntity.putIfAbsent(alias.entityId, () => []).add(alias);
+      if (alias.source == 'manual' ||
+          alias.source == 'history-edit' ||
+          alias.source == 'entity-memory') {
+        _manualEvidenceEntityIds.add(alias.entityId);
+      }
+      final value = alias.aliasText.trim();
+      if (value.isEmpty) continue;
+      if (value.runes.length <= 1 ||
+          (_shortLatinAlias.hasMatch(value) && value.length <= 2)) {
+        _shortAliasCount.update(
+          alias.entityId,
+          (count) => count + 1,
+          ifAbsent: () => 1,
+        );
+      }
+      _insert(value, _MentionTarget.alias(alias));
+    }
+
+    for (var i = 0; i < relations.length; i++) {
+      final relation = relations[i];
+      final indexed = _IndexedRelation(relation, i);
+      _relationsByEntity
+          .putIfAbsent(relation.sourceEntityId, () => [])
+          .add(indexed);
+      if (relation.targetEntityId != relation.sourceEntityId) {
+        _relationsByEntity
+            .putIfAbsent(relation.targetEntityId, () => [])
+            .add(indexed);
+      }
+    }
+  }
+
+  void _insert(String pattern, _MentionTarget target) {
+    var node = _root;
+    for (var i = 0; i < pattern.length; i++) {
+      node = node.children.putIfAbsent(
+        pattern.codeUnitAt(i),
+        _MentionTrieNode.new,
+      );
+    }
+    (node.targets ??= <_MentionTarget>[]).add(target);
+    if (pattern.length > _maxPatternLength) {
+      _maxPatternLength = pattern.length;
+    }
+  }
+
+  bool get isEmpty => _enabledById.isEmpty;
+
+  /// 单遍扫描 [text]，返回其中出现的全部标准名与别名（含重叠命中）。
+  ///
+  /// 只统计起点不早于 [from] 的命中。
+  EntityMentions scan(String text, {int from = 0}) {
+    if (text.isEmpty || _root.children.isEmpty) return EntityMentions.empty;
+    Set<String>? canonical;
+    Set<EntityAlias>? matchedAliases;
+    for (var i = from; i < text.length; i++) {
+      var node = _root.children[text.codeUnitAt(i)];
+      var j = i + 1;
+      while (node != null) {
+        final targets = node.targets;
+        if (targets != null) {
+          for (final target in targets) {
+            final alias = target.alias;
+            if (alias == null) {
+              (canonical ??= <String>{}).add(target.entityId);
+            } else {
+              (matchedAliases ??= Set<EntityAlias>.identity()).add(alias);
+            }
+          }
+        }
+        if (j >= text.length) break;
+        node = node.children[text.codeUnitAt(j)];
+        j++;
+      }
+    }
+    if (canonical == null && matchedAliases == null) {
+      return EntityMentions.empty;
+    }
+    return EntityMentions(
+      canonicalEntityIds: canonical ?? const <String>{},
+      aliases: matchedAliases ?? const <EntityAlias>{},
+    );
+  }
+
+  /// [text] 由长度为 [previousLength] 的已扫描前缀追加而来时，只扫描
+  /// 可能越过前缀末尾的命中并与前缀的结果 [previous] 合并，结果与
+  /// [scan] 整段文本一致。
+  EntityMentions scanAppended(
+    EntityMentions previous,
+    String text,
+    int previousLength,
+  ) {
+    final from = previousLength - _maxPatternLength + 1;
+    return previous.union(scan(text, from: from < 0 ? 0 : from));
+  }
+
+  /// 合并多段文本的提及结果；每段文本的扫描结果会被缓存。
+  EntityMentions mentionsIn(Iterable<String> texts) {
+    EntityMentions? single;
+    Set<String>? canonical;
+    Set<EntityAlias>? matchedAliases;
+    for (final text in texts) {
+      final mentions = _cachedMentions(text);
+      if (mentions.isEmpty) continue;
+      if (single == null && canonical == null) {
+        single = mentions;
+        continue;
+      }
+      if (canonical == null) {
+        canonical = {...single!.canonicalEntityIds};
+        matchedAliases = Set<EntityAlias>.identity()..addAll(single.aliases);
+      }
+      canonical.addAll(mentions.canonicalEntityIds);
+      matchedAliases!.addAll(mentions.aliases);
+    }
+    if (canonical != null) {
+      return EntityMentions(
+        canonicalEntityIds: canonical,
+        aliases: matchedAliases!,
+      );
+    }
+    return single ?? EntityMentions.empty;
+  }
+
+  EntityMentions _cachedMentions(String text) {
+    final cached = _textMentionCache.remove(text);
+    if (cached != null) {
+      _textMentionCache[text] = cached;
+      return cached;
+    }
+    final mentions = scan(text);
+    _textMentionCache[text] = mentions;
+    if (_textMentionCache.length > _maxCachedTextMentions) {
+      _textMentionCache.remove(_textMentionCache.keys.first);
+    }
+    return mentions;
+  }
+
+  /// 可能得分为正的已启用实体：被提及、会话中已激活或与已激活实体相关，
+  /// 按原实体列表顺序返回。
+  List<EntityMemory> candidates({
+    required List<EntityMentions> mentions,
+    required Iterable<String> activeEntityIds,
+  }) {
+    final ids = <String>{};
+    for (final item in mentions) {
+      ids.addAll(item.entityIds);
+    }
+    for (final id in activeEntityIds) {
+      ids.add(id);
+      final related = _relationsByEntity[id] ?? const <_IndexedRelation>[];
+      for (final indexed in related) {
+        ids.add(indexed.relation.sourceEntityId);
+        ids.add(indexed.relation.targetEntityId);
+      }
+    }
+    final result = <EntityMemory>[];
+    for (final id in ids) {
+      final memory = _enabledById[id];
+      if (memory != null) result.add(memory);
+    }
+    result.sort(
+      (a, b) => _memoryPosition[a.id]!.compareTo(_memoryPosition[b.id]!),
+    );
+    return result;
+  }
+
+  List<EntityAlias> aliasesOf(String entityId) =>
+      _aliasesByEntity[entityId] ?? const [];
+
+  /// 与实体相关的全部关系（作为 source 或 target）。
+  Iterable<EntityRelation> relationsOf(String entityId) {
+    final indexed = _relationsByEntity[entityId];
+    if (indexed == null) return const [];
+    return indexed.map((item) => item.relation);
+  }
+
+  bool hasManualEvidence(String entityId) =>
+      _manualEvidenceEntityIds.contains(entityId);
+
+  int shortAliasCount(String entityId) => _shortAliasCount[entityId] ?? 0;
+
+  /// 两端都在 [entityIds] 中的关系，保持原关系列表顺序。
+  List<EntityRelation> relationsAmong(
+    Set<String> entityIds, {
+    double minConfidence = 0,
+    int limit = 4,
+  }) {
+    final picked = <int, EntityRelation>{};
+    for (final id in entityIds) {
+      final related = _relationsByEntity[id] ?? const <_IndexedRelation>[];
+      for (final indexed in related) {
+        final relation = indexed.relation;
+        if (relation.confidence < minConfidence) continue;
+        if (!entityIds.contains(relation.sourceEntityId) ||
+            !entityIds.contains(relation.targetEntityId)) {
+          continue;
+        }
+        picked[indexed.position] = relation;
+      }
+    }
+    final positions = picked.keys.toList()..sort();
+    return positions
+        .take(limit)
+        .map((position) => picked[position]!)
+        .toList(growable: false);
+  }
+}
+
+class _MentionTrieNode {
+  final Map<int, _MentionTrieNode> children = {};
+  List<_MentionTarget>? targets;
+}
+
+class _MentionTarget {
+  final String entityId;
+
+  /// 为 null 表示标准名命中。
+  final EntityAlias? alias;
+
+  const _MentionTarget.canonical(this.entityId) : alias = null;
+
+  _MentionTarget.alias(EntityAlias value)
+    : entityId = value.entityId,
+      alias = value;
+}
+
+class _IndexedRelation {
+  final EntityRelation relation;
+  final int position;
+
+  const _IndexedRelation(this.relation, this.position);
+}
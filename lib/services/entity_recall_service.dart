@@ -3,6 +3,7 @@ import '../models/entity_memory.dart';
 import '../models/entity_prompt_bundle.dart';
 import '../models/entity_relation.dart';
 import 'entity_prompt_composer.dart';
+import 'entity_recall_index.dart';
 import 'session_entity_state.dart';
 
 class EntityRecallService {
@@ -17,6 +18,7 @@ class EntityRecallService {
     this.promptComposer = const EntityPromptComposer(),
   });
 
+  /// [currentMentions] 为调用方已扫描出的当前文本提及，省略时在此扫描。
   EntityPromptBundle buildForStt({
     required String currentText,
     required List<String> historyTexts,
@@ -26,9 +28,11 @@ class EntityRecallService {
     required List<EntityRelation> relations,
     required SessionEntityState sessionState,
     int maxEntities = defaultMaxSttEntities,
+    EntityMentions? currentMentions,
   }) {
     final recalled = _recall(
       currentText: currentText,
+      currentMentions: currentMentions,
       historyTexts: historyTexts,
       contextTexts: contextTexts,
       memories: memories,
@@ -122,6 +126,7 @@ class EntityRecallService {
 
   _RecallResult _recall({
     required String currentText,
+    EntityMentions? currentMentions,
     required List<String> historyTexts,
     required List<String> contextTexts,
     required List<EntityMemory> memories,
@@ -130,23 +135,34 @@ class EntityRecallService {
     required SessionEntityState sessionState,
     required int maxEntities,
   }) {
-    final aliasByEntity = <String, List<EntityAlias>>{};
-    for (final alias in aliases) {
-      aliasByEntity.putIfAbsent(alias.entityId, () => []).add(alias);
+    final index = EntityRecallIndex.of(
+      memories: memories,
+      aliases: aliases,
+      relations: relations,
+    );
+    if (index.isEmpty) {
+      return const _RecallResult(entities: [], relations: []);
     }
 
-    final relationIndex = _buildRelationIndex(relations);
+    currentMentions ??= index.scan(currentText.trim());
+    final historyMentions = index.mentionsIn(historyTexts);
+    final contextMentions = index.mentionsIn(contextTexts);
+    final activations = sessionState.activations;
+
     final scored = <RecalledEntity>[];
-    for (final memory in memories.where((e) => e.enabled)) {
-      final entityAliases = aliasByEntity[memory.id] ?? const [];
+    for (final memory in index.candidates(
+      mentions: [currentMentions, historyMentions, contextMentions],
+      activeEntityIds: activations.keys,
+    )) {
+      final entityAliases = index.aliasesOf(memory.id);
       final score = _scoreEntity(
         memory: memory,
         aliases: entityAliases,
-        relations: relationIndex[memory.id] ?? const [],
-        currentText: currentText,
-        historyTexts: historyTexts,
-        contextTexts: contextTexts,
-        sessionState: sessionState,
+        index: index,
+        current: currentMentions,
+        history: historyMentions,
+        context: contextMentions,
+        activations: activations,
       );
       if (score <= 0) continue;
       scored.add(
@@ -166,36 +182,22 @@ class EntityRecallService {
 
     final selected = _selectEntitiesWithRelationExpansion(
       scored: scored,
-      relations: relations,
+      index: index,
       maxEntities: maxEntities,
     );
     final selectedIds = selected.map((e) => e.memory.id).toSet();
-    final selectedRelations = relations
-        .where((relation) {
-          return selectedIds.contains(relation.sourceEntityId) &&
-              selectedIds.contains(relation.targetEntityId) &&
-              relation.confidence >= 0.5;
-        })
-        .take(4)
-        .toList(growable: false);
+    final selectedRelations = index.relationsAmong(
+      selectedIds,
+      minConfidence: 0.5,
+      limit: 4,
+    );
 
     return _RecallResult(entities: selected, relations: selectedRelations);
   }
 
-  Map<String, List<EntityRelation>> _buildRelationIndex(
-    List<EntityRelation> relations,
-  ) {
-    final index = <String, List<EntityRelation>>{};
-    for (final relation in relations) {
-      index.putIfAbsent(relation.sourceEntityId, () => []).add(relation);
-      index.putIfAbsent(relation.targetEntityId, () => []).add(relation);
-    }
-    return index;
-  }
-
   List<RecalledEntity> _selectEntitiesWithRelationExpansion({
     required List<RecalledEntity> scored,
-    required List<EntityRelation> relations,
+    required EntityRecallIndex index,
     required int maxEntities,
   }) {
     if (scored.isEmpty) return const [];
@@ -207,7 +209,7 @@ class EntityRecallService {
     for (final candidate in scored) {
       if (primaryIds.contains(candidate.memory.id)) continue;
       var relationBoost = 0.0;
-      for (final relation in relations) {
+      for (final relation in index.relationsOf(candidate.memory.id)) {
         final touchesPrimary =
             (primaryIds.contains(relation.sourceEntityId) &&
                 relation.targetEntityId == candidate.memory.id) ||
@@ -258,23 +260,23 @@ class EntityRecallService {
   double _scoreEntity({
     required EntityMemory memory,
     required List<EntityAlias> aliases,
-    required List<EntityRelation> relations,
-    required String currentText,
-    required List<String> historyTexts,
-    required List<String> contextTexts,
-    required SessionEntityState sessionState,
+    required EntityRecallIndex index,
+    required EntityMentions current,
+    required EntityMentions history,
+    required EntityMentions context,
+    required Map<String, SessionEntityActivation> activations,
   }) {
     var score = 0.0;
-    final current = currentText.trim();
-    final history = historyTexts.join('\n');
-    final context = contextTexts.join('\n');
-    final activation = sessionState.activations[memory.id];
+    final activation = activations[memory.id];
     if (activation != null) {
       score += 100 + activation.score;
     }
-    if (current.contains(memory.canonicalName)) score += 80;
-    if (history.contains(memory.canonicalName)) score += 35;
-    if (context.contains(memory.canonicalName)) score += 30;
+    final currentCanonicalHit = current.hasCanonical(memory.id);
+    final historyCanonicalHit = history.hasCanonical(memory.id);
+    final contextCanonicalHit = context.hasCanonical(memory.id);
+    if (currentCanonicalHit) score += 80;
+    if (historyCanonicalHit) score += 35;
+    if (contextCanonicalHit) score += 30;
     if (memory.confidence >= 0.9) {
       score += 15;
     } else {
@@ -282,11 +284,11 @@ class EntityRecallService {
     }
 
     for (final alias in aliases) {
-      final value = alias.aliasText.trim();
-      if (value.isEmpty) continue;
-      final currentHit = current.contains(value);
-      final historyHit = history.contains(value);
-      final contextHit = context.contains(value);
+      if (alias.aliasText.trim().isEmpty) continue;
+      final currentHit = current.hasAlias(alias);
+      final historyHit = history.hasAlias(alias);
+      final contextHit = context.hasAlias(alias);
+      if (!currentHit && !historyHit && !contextHit) continue;
       final typeBonus = switch (alias.aliasType) {
         EntityAliasType.fullName => 10.0,
         EntityAliasType.nickname => 8.0,
@@ -300,17 +302,14 @@ class EntityRecallService {
       if (currentHit) score += currentBase + typeBonus;
       if (historyHit) score += 35 + typeBonus * 0.4;
       if (contextHit) score += 30 + typeBonus * 0.3;
-      if (value.runes.length <= 1 ||
-          (RegExp(r'^[A-Za-z0-9]+$').hasMatch(value) && value.length <= 2)) {
-        score -= 12;
-      }
     }
+    score -= 12.0 * index.shortAliasCount(memory.id);
 
-    for (final relation in relations) {
+    for (final relation in index.relationsOf(memory.id)) {
       final relatedId = relation.sourceEntityId == memory.id
           ? relation.targetEntityId
           : relation.sourceEntityId;
-      if (sessionState.activations.containsKey(relatedId)) {
+      if (activations.containsKey(relatedId)) {
         score += 25 * relation.confidence;
       }
     }
@@ -318,19 +317,13 @@ class EntityRecallService {
     if (DateTime.now().difference(memory.updatedAt).inDays > 90) {
       score -= 15;
     }
-    final hasManualEvidence = aliases.any(
-      (alias) =>
-          alias.source == 'manual' ||
-          alias.source == 'history-edit' ||
-          alias.source == 'entity-memory',
-    );
-    if (!hasManualEvidence) {
+    if (!index.hasManualEvidence(memory.id)) {
       score -= 10;
     }
     if (activation == null &&
-        !current.contains(memory.canonicalName) &&
-        !history.contains(memory.canonicalName) &&
-        !context.contains(memory.canonicalName)) {
+        !currentCanonicalHit &&
+        !historyCanonicalHit &&
+        !contextCanonicalHit) {
       score -= 20;
     }
     return score;
@@ -0,0 +1,477 @@
+import 'dart:convert';
+import 'dart:typed_data';
+
+/// 编码结束后的流参数，用于回填 STREAMINFO。
+class FlacStreamInfo {
+  final int sampleRate;
+  final int channels;
+  final int bitsPerSample;
+  final int totalSamples;
+  final int minFrameSize;
+  final int maxFrameSize;
+
+  const FlacStreamInfo({
+    required this.sampleRate,
+    required this.channels,
+    required this.bitsPerSample,
+    this.totalSamples = 0,
+    this.minFrameSize = 0,
+    this.maxFrameSize = 0,
+  });
+}
+
+/// 流式 FLAC 编码器（无损），用于录音归档。
+///
+/// 固定块长 [blockSize]，每个声道独立编码：整块相同的样本（静音）写成
+/// CONSTANT 子帧，其余在 0~4 阶固定预测器中取残差最小者，残差按分区
+/// Rice 编码；压缩后反而更大时退回 VERBATIM。不计算 MD5（STREAMINFO
+/// 中填 0，按规范表示未知）。
+///
+/// 输入为交错的整型样本，编码好的帧通过 [onFrame] 依次输出；
+/// 文件头由 [buildHeader] 生成，长度与流参数无关，可先占位、结束后回填。
+class FlacEncoder {
+  static const int blockSize = 4096;
+  static const int _maxFixedOrder = 4;
+  static const int _maxPartitionOrder = 8;
+  static const int _maxRiceParameter = 14;
+
+  final int sampleRate;
+  final int channels;
+  final int bitsPerSample;
+  final void Function(Uint8List frame) onFrame;
+
+  final List<Int32List> _block;
+  int _fill = 0;
+  int _frameNumber = 0;
+  int _totalSamples = 0;
+  int _minFrameSize = 0;
+  int _maxFrameSize = 0;
+
+  FlacEncoder({
+    required this.sampleRate,
+    required this.channels,
+    required this.bitsPerSample,
+    required this.onFrame,
+  }) : _block = List.generate(channels, (_) => Int32List(blockSize)) {
+    if (channels < 1 || channels > 8) {
+      throw ArgumentError.value(channels, 'channels');
+    }
+    if (bitsPerSample < 4 || bitsPerSample > 24) {
+      throw ArgumentError.value(bitsPerSample, 'bitsPerSample');
+    }
+  }
+
+  /// 追加交错排列的样本（长度应为声道数的整数倍）。
+  void add(Int32List interleaved) {
+    for (var i = 0; i + channels <= interleaved.length; i += channels) {
+      for (var c = 0; c < channels; c++) {
+        _block[c][_fill] = interleaved[i + c];
+      }
+      if (++_fill == blockSize) _flushBlock();
+    }
+  }
+
+  /// 输出剩余样本并返回流参数。
+  FlacStreamInfo close() {
+    if (_fill > 0) _flushBlock();
+    return FlacStreamInfo(
+      sampleRate: sampleRate,
+      channels: channels,
+      bitsPerSample: bitsPerSample,
+      totalSamples: _totalSamples,
+      minFrameSize: _minFrameSize,
+      maxFrameSize: _maxFrameSize,
+    );
+  }
+
+  /// `fLaC` 标记 + STREAMINFO + VORBIS_COMMENT。
+  static Uint8List buildHeader(
+    FlacStreamInfo info, {
+    String vendor = 'voicetype',
+    List<String> comments = const [],
+  }) {
+    final out = BytesBuilder(copy: false)..add(ascii.encode('fLaC'));
+
+    final streamInfo = _BitWriter()
+      ..writeBits(blockSize, 16)
+      ..writeBits(blockSize, 16)
+      ..writeBits(info.minFrameSize, 24)
+      ..writeBits(info.maxFrameSize, 24)
+      ..writeBits(info.sampleRate, 20)
+      ..writeBits(info.channels - 1, 3)
+      ..writeBits(info.bitsPerSample - 1, 5)
+      ..writeBits(info.totalSamples >> 32, 4)
+      ..writeBits(info.totalSamples & 0xFFFFFFFF, 32);
+    for (var i = 0; i < 4; i++) {
+      streamInfo.writeBits(0, 32);
+    }
+    _addMetadataBlock(out, 0, streamInfo.takeBytes(), last: false);
+
+    final vorbis = BytesBuilder(copy: false);
+    final vendorBytes = utf8.encode(vendor);
+    vorbis
+      ..add(_uint32Le(vendorBytes.length))
+      ..add(vendorBytes)
+      ..add(_uint32Le(comments.length));
+    for (final comment in comments) {
+      final bytes = utf8.encode(comment);
+      vorbis
+        ..add(_uint32Le(bytes.length))
+        ..add(bytes);
+    }
+    _addMetadataBlock(out, 4, vorbis.takeBytes(), last: true);
+    return out.takeBytes();
+  }
+
+  /// 读取 VORBIS_COMMENT 中的注释（`KEY=value`）；不是 FLAC 时返回 null。
+  static List<String>? readComments(Uint8List bytes) {
+    if (bytes.length < 4 || ascii.decode(bytes.sublist(0, 4)) != 'fLaC') {
+      return null;
+    }
+    var offset = 4;
+    while (offset + 4 <= bytes.length) {
+      final header = bytes[offset];
+      final length =
+          (bytes[offset + 1] << 16) |
+          (bytes[offset + 2] << 8) |
+          bytes[offset + 3];
+      offset += 4;
+      if (offset + length > bytes.length) return null;
+      if (header & 0x7F == 4) {
+        final data = ByteData.sublistView(bytes, offset, offset + length);
+        var pos = 0;
+        pos += 4 + data.getUint32(pos, Endian.little);
+        final count = data.getUint32(pos, Endian.little);
+        pos += 4;
+        final comments = <String>[];
+        for (var i = 0; i < count; i++) {
+          final len = data.getUint32(pos, Endian.little);
+          pos += 4;
+          comments.add(
+            utf8.decode(bytes.sublist(offset + pos, offset + pos + len)),
+          );
+          pos += len;
+        }
+        return comments;
+      }
+      if (header & 0x80 != 0) break;
+      offset += length;
+    }
+    return const [];
+  }
+
+  void _flushBlock() {
+    final frame = _encodeFrame(_fill);
+    _frameNumber++;
+    _totalSamples += _fill;
+    _fill = 0;
+    if (_minFrameSize == 0 || frame.length < _minFrameSize) {
+      _minFrameSize = frame.length;
+    }
+    if (frame.length > _maxFrameSize) _maxFrameSize = frame.length;
+    onFrame(frame);
+  }
+
+  Uint8List _encodeFrame(int size) {
+    final w = _BitWriter();
+    final sizeCode = size == blockSize ? 12 : 7;
+    w
+      ..writeBits(0xFFF8, 16)
+      ..writeBits(sizeCode, 4)
+      ..writeBits(_sampleRateCode(sampleRate), 4)
+      ..writeBits(channels - 1, 4)
+      ..writeBits(_sampleSizeCode(bitsPerSample), 3)
+      ..writeBits(0, 1);
+    _writeUtf8Number(w, _frameNumber);
+    if (sizeCode == 7) w.writeBits(size - 1, 16);
+    w.writeBits(_crc8(w.bytes), 8);
+
+    for (final samples in _block) {
+      _writeSubframe(w, samples, size);
+    }
+    w.alignToByte();
+    w.writeBits(_crc16(w.bytes), 16);
+    return w.takeBytes();
+  }
+
+  void _writeSubframe(_BitWriter w, Int32List x, int n) {
+    final bps = bitsPerSample;
+    var constant = true;
+    for (var i = 1; i < n; i++) {
+      if (x[i] != x[0]) {
+        constant = false;
+        break;
+      }
+    }
+    if (constant) {
+      w
+        ..writeBits(0x00, 8)
+        ..writeSigned(x[0], bps);
+      return;
+    }
+
+    final order = n > _maxFixedOrder ? _bestFixedOrder(x, n) : -1;
+    if (order >= 0) {
+      final residual = _fixedResidual(x, n, order);
+      final plan = _RicePlan.best(residual, n, order, _maxRiceParameter);
+      if (order * bps + plan.bits < n * bps) {
+        w.writeBits(0x10 | (order << 1), 8);
+        for (var i = 0; i < order; i++) {
+          w.writeSigned(x[i], bps);
+        }
+        plan.write(w, residual);
+        return;
+      }
+    }
+
+    w.writeBits(0x02, 8);
+    for (var i = 0; i < n; i++) {
+      w.writeSigned(x[i], bps);
+    }
+  }
+
+  /// 按残差绝对值之和选择固定预测阶数。
+  static int _bestFixedOrder(Int32List x, int n) {
+    final sums = List<int>.filled(_maxFixedOrder + 1, 0);
+    for (var i = _maxFixedOrder; i < n; i++) {
+      final e0 = x[i];
+      final e1 = e0 - x[i - 1];
+      final e2 = e1 - (x[i - 1] - x[i - 2]);
+      final e3 = e2 - (x[i - 1] - 2 * x[i - 2] + x[i - 3]);
+      final e4 = e3 - (x[i - 1] - 3 * x[i - 2] + 3 * x[i - 3] - x[i - 4]);
+      sums[0] += e0.abs();
+      sums[1] += e1.abs();
+      sums[2] += e2.abs();
+      sums[3] += e3.abs();
+      sums[4] += e4.abs();
+    }
+    var best = 0;
+    for (var order = 1; order <= _maxFixedOrder; order++) {
+      if (sums[order] < sums[best]) best = order;
+    }
+    return best;
+  }
+
+  static Int32List _fixedResidual(Int32List x, int n, int order) {
+    final residual = Int32List(n - order);
+    for (var i = order; i < n; i++) {
+      residual[i - order] = switch (order) {
+        0 => x[i],
+        1 => x[i] - x[i - 1],
+        2 => x[i] - 2 * x[i - 1] + x[i - 2],
+        3 => x[i] - 3 * x[i - 1] + 3 * x[i - 2] - x[i - 3],
+        _ => x[i] - 4 * x[i - 1] + 6 * x[i - 2] - 4 * x[i - 3] + x[i - 4],
+      };
+    }
+    return residual;
+  }
+
+  static int _sampleRateCode(int rate) => switch (rate) {
+    88200 => 1,
+    176400 => 2,
+    192000 => 3,
+    8000 => 4,
+    16000 => 5,
+    22050 => 6,
+    24000 => 7,
+    32000 => 8,
+    44100 => 9,
+    48000 => 10,
+    96000 => 11,
+    _ => 0,
+  };
+
+  static int _sampleSizeCode(int bits) => switch (bits) {
+    8 => 1,
+    12 => 2,
+    16 => 4,
+    20 => 5,
+    24 => 6,
+    _ => 0,
+  };
+
+  static void _writeUtf8Number(_BitWriter w, int value) {
+    if (value < 0x80) {
+      w.writeBits(value, 8);
+      return;
+    }
+    var length = 2;
+    while (length < 7 && value >= 1 << (5 * length + 1)) {
+      length++;
+    }
+    final prefix = (0xFF << (8 - length)) & 0xFF;
+    w.writeBits(prefix | (value >> (6 * (length - 1))), 8);
+    for (var i = length - 2; i >= 0; i--) {
+      w.writeBits(0x80 | ((value >> (6 * i)) & 0x3F), 8);
+    }
+  }
+
+  static int _crc8(List<int> bytes) {
+    var crc = 0;
+    for (final byte in bytes) {
+      crc ^= byte;
+      for (var i = 0; i < 8; i++) {
+        crc = (crc & 0x80) != 0
+            ? ((crc << 1) ^ 0x07) & 0xFF
+            : (crc << 1) & 0xFF;
+      }
+    }
+    return crc;
+  }
+
+  static int _crc16(List<int> bytes) {
+    var crc = 0;
+    for (final byte in bytes) {
+      crc ^= byte << 8;
+      for (var i = 0; i < 8; i++) {
+        crc = (crc & 0x8000) != 0
+            ? ((crc << 1) ^ 0x8005) & 0xFFFF
+            : (crc << 1) & 0xFFFF;
+      }
+    }
+    return crc;
+  }
+
+  static void _addMetadataBlock(
+    BytesBuilder out,
+    int type,
+    Uint8List data, {
+    required bool last,
+  }) {
+    out
+      ..addByte((last ? 0x80 : 0) | type)
+      ..addByte((data.length >> 16) & 0xFF)
+      ..addByte((data.length >> 8) & 0xFF)
+      ..addByte(data.length & 0xFF)
+      ..add(data);
+  }
+
+  static Uint8List _uint32Le(int value) =>
+      Uint8List(4)..buffer.asByteData().setUint32(0, value, Endian.little);
+}
+
+/// 残差的 Rice 分区方案：分区阶数与每个分区的 Rice 参数。
+class _RicePlan {
+  final int predictorOrder;
+  final int partitionOrder;
+  final List<int> parameters;
+
+  /// 估算的编码位数（含残差头）。
+  final int bits;
+
+  const _RicePlan(
+    this.predictorOrder,
+    this.partitionOrder,
+    this.parameters,
+    this.bits,
+  );
+
+  /// 在所有合法分区阶数中选估算位数最少的方案。
+  static _RicePlan best(
+    Int32List residual,
+    int blockSize,
+    int predictorOrder,
+    int maxParameter,
+  ) {
+    final prefix = List<int>.filled(residual.length + 1, 0);
+    for (var i = 0; i < residual.length; i++) {
+      prefix[i + 1] = prefix[i] + _zigzag(residual[i]);
+    }
+
+    _RicePlan? best;
+    for (var order = 0; order <= FlacEncoder._maxPartitionOrder; order++) {
+      final partitions = 1 << order;
+      if (blockSize % partitions != 0) break;
+      final partitionSize = blockSize >> order;
+      if (partitionSize <= predictorOrder) break;
+
+      final parameters = <int>[];
+      var bits = 6;
+      for (var p = 0; p < partitions; p++) {
+        final start = p == 0 ? 0 : p * partitionSize - predictorOrder;
+        final end = (p + 1) * partitionSize - predictorOrder;
+        final count = end - start;
+        final sum = prefix[end] - prefix[start];
+        var bestK = 0;
+        var bestCost = count + sum;
+        for (var k = 1; k <= maxParameter; k++) {
+          final cost = count * (k + 1) + (sum >> k);
+          if (cost < bestCost) {
+            bestCost = cost;
+            bestK = k;
+          }
+        }
+        parameters.add(bestK);
+        bits += 4 + bestCost;
+      }
+      if (best == null || bits < best.bits) {
+        best = _RicePlan(predictorOrder, order, parameters, bits);
+      }
+    }
+    return best!;
+  }
+
+  void write(_BitWriter w, Int32List residual) {
+    w
+      ..writeBits(0, 2)
+      ..writeBits(partitionOrder, 4);
+    final partitions = 1 << partitionOrder;
+    final partitionSize = (residual.length + predictorOrder) >> partitionOrder;
+    var index = 0;
+    for (var p = 0; p < partitions; p++) {
+      final k = parameters[p];
+      w.writeBits(k, 4);
+      final count = p == 0 ? partitionSize - predictorOrder : partitionSize;
+      for (var i = 0; i < count; i++) {
+        final u = _zigzag(residual[index++]);
+        w
+          ..writeZeros(u >> k)
+          ..writeBits(1, 1);
+        if (k > 0) w.writeBits(u & ((1 << k) - 1), k);
+      }
+    }
+  }
+
+  static int _zigzag(int r) => r >= 0 ? r << 1 : ((-r) << 1) - 1;
+}
+
+/// 高位在前的位写入器。
+class _BitWriter {
+  final BytesBuilder _out = BytesBuilder();
+  int _acc = 0;
+  int _accBits = 0;
+
+  /// 已写出的完整字节。
+  List<int> get bytes => _out.toBytes();
+
+  void writeBits(int value, int count) {
+    if (count == 0) return;
+    _acc = (_acc << count) | (value & ((1 << count) - 1));
+    _accBits += count;
+    while (_accBits >= 8) {
+      _accBits -= 8;
+      _out.addByte((_acc >> _accBits) & 0xFF);
+    }
+    _acc &= (1 << _accBits) - 1;
+  }
+
+  void writeSigned(int value, int count) => writeBits(value, count);
+
+  void writeZeros(int count) {
+    var remaining = count;
+    while (remaining >= 32) {
+      writeBits(0, 32);
+      remaining -= 32;
+    }
+    writeBits(0, remaining);
+  }
+
+  void alignToByte() {
+    if (_accBits > 0) writeBits(0, 8 - _accBits);
+  }
+
+  Uint8List takeBytes() {
+    alignToByte();
+    return _out.takeBytes();
+  }
+}
@@ -1,3 +1,5 @@
+import '../models/history_cursor.dart';
+import '../models/history_search_hit.dart';
 import '../models/transcription.dart';
 import '../database/app_database.dart';
 
@@ -11,6 +13,28 @@ class HistoryDb {
 
   Future<List<Transcription>> getAll() => _db.getAllHistory();
 
+  Future<List<Transcription>> getPage({
+    required int limit,
+    HistoryCursor? before,
+  }) => _db.getHistoryPage(limit: limit, before: before);
+
+  Future<int> count() => _db.countHistory();
+
+  Future<List<HistorySearchHit>> search(
+    String query, {
+    int limit = 20,
+    HistoryCursor? before,
+    bool matchAny = false,
+  }) => _db.searchHistory(
+    query,
+    limit: limit,
+    before: before,
+    matchAny: matchAny,
+  );
+
+  Future<Set<String>> filterExistingIds(Iterable<String> ids) =>
+      _db.filterExistingHistoryIds(ids);
+
   Future<void> insert(Transcription item) => _db.insertHistory(item);
 
   Future<void> deleteById(String id) => _db.deleteHistoryById(id);
@@ -0,0 +1,122 @@
+import 'dart:async';
+
+import 'log_service.dart';
+import 'pipeline_tracer.dart';
+import 'request_hedger.dart';
+
+/// 一次语音输入从松开按键到文本上屏的延迟预算。
+///
+/// 录音开始时创建，松开按键时以按键时刻 [arm] 开始计时。此后 LLM 纠错
+/// 与增强在发请求前先按该服务近期耗时的 p90 判断能否在剩余预算内完成，
+/// 预计会超时的直接跳过；已在等待的请求在预算用尽时由 [guard] 放弃等待，
+/// 调用方改用本地结果。被放弃的请求本身继续完成，结果照常写入结果缓存
+/// 与耗时统计。
+///
+/// 尚无足够耗时样本的服务视为来得及，由 [guard] 兜底。
+class LatencyBudget {
+  /// 预算中留给上屏等收尾步骤的时间。
+  static const Duration defaultReserve = Duration(milliseconds: 150);
+
+  final Duration slo;
+  final Duration reserve;
+  final Duration? Function(String routeKey) _predict;
+  final int Function() _nowUs;
+
+  final Completer<void> _expired = Completer<void>();
+  final Set<String> _degradedStages = {};
+  int? _deadlineUs;
+  Timer? _timer;
+
+  LatencyBudget(
+    this.slo, {
+    this.reserve = defaultReserve,
+    Duration? Function(String routeKey)? predict,
+    int Function()? nowUs,
+  }) : _predict = predict ?? RequestHedger.instance.predict,
+       _nowUs = nowUs ?? PipelineTracer.nowUs;
+
+  bool get armed => _deadlineUs != null;
+
+  bool get isExpired => _expired.isCompleted;
+
+  /// 预算用尽时完成；开始计时前一直挂起。
+  Future<void> get expired => _expired.future;
+
+  /// 因预算而跳过或放弃等待的阶段。
+  Set<String> get degradedStages => Set.unmodifiable(_degradedStages);
+
+  bool get degraded => _degradedStages.isNotEmpty;
+
+  /// 以 [originUs]（[PipelineTracer.nowUs] 时基）为起点开始计时。
+  void arm(int originUs) {
+    if (armed) return;
+    final deadlineUs = originUs + slo.inMicroseconds - reserve.inMicroseconds;
+    _deadlineUs = deadlineUs;
+    final waitUs = deadlineUs - _nowUs();
+    _timer = Timer(Duration(microseconds: waitUs < 0 ? 0 : waitUs), _expire);
+  }
+
+  /// 剩余预算（不含 [reserve]）；开始计时前为 null。
+  Duration? get remaining {
+    final deadlineUs = _deadlineUs;
+    if (deadlineUs == null) return null;
+    final leftUs = deadlineUs - _nowUs();
+    return Duration(microseconds: leftUs < 0 ? 0 : leftUs);
+  }
+
+  /// 向 [routeKey] 对应的服务发起 [stage] 请求是否来得及；来不及时记入
+  /// [degradedStages]。
+  bool allows(String routeKey, {required String stage}) {
+    final left = remaining;
+    if (left == null) return true;
+    final predicted = _predict(routeKey);
+    if (left > Duration.zero && (predicted == null || predicted <= left)) {
+      return true;
+    }
+    _markDegraded(
+      stage,
+      'skip, predicted=${predicted?.inMilliseconds ?? '-'}ms '
+      'remaining=${left.inMilliseconds}ms',
+    );
+    return false;
+  }
+
+  /// 等待 [work]，预算先用尽时返回 null，并把 [stage] 记入
+  /// [degradedStages]。
+  Future<T?> guard<T>(Future<T> work, {required String stage}) {
+    final result = Completer<T?>();
+    work.then(
+      (value) {
+        if (!result.isCompleted) result.complete(value);
+      },
+      onError: (Object error, StackTrace stack) {
+        if (!result.isCompleted) result.completeError(error, stack);
+      },
+    );
+    expired.then((_) {
+      if (result.isCompleted) return;
+      _markDegraded(stage, 'abandoned at deadline');
+      result.complete(null);
+    });
+    return result.future;
+  }
+
+  void dispose() {
+    _timer?.cancel();
+    _timer = null;
+  }
+
+  void _expire() {
+    if (!_expired.isCompleted) _expired.complete();
+  }
+
+  void _markDegraded(String stage, String reason) {
+    _degradedStages.add(stage);
+    unawaited(
+      LogService.info(
+        'BUDGET',
+        '$stage $reason (slo=${slo.inMilliseconds}ms)',
+      ),
+    );
+  }
+}
@@ -0,0 +1,89 @@
+/// 固定分桶的耗时直方图（HDR 风格的对数-线性分桶），单位微秒。
+///
+/// 小于 [subBucketCount] 的值各占一个桶；更大的值按 2 的幂分段，
+/// 每段再等分为 [subBucketCount] 个桶，因此任意桶的相对宽度不超过
+/// 1/[subBucketCount]，分位数的相对误差约在 3% 以内。
+///
+/// 桶编号只由数值决定、与样本无关，不同天、不同进程的直方图
+/// 可以按桶直接相加；只保存非空桶。
+class LatencyHistogram {
+  static const int _subBucketBits = 4;
+  static const int subBucketCount = 1 << _subBucketBits;
+
+  final Map<int, int> _counts = {};
+  int _totalCount = 0;
+
+  LatencyHistogram();
+
+  /// 从 `桶编号 -> 样本数` 构建直方图。
+  LatencyHistogram.fromBuckets(Map<int, int> buckets) {
+    buckets.forEach(addToBucket);
+  }
+
+  int get totalCount => _totalCount;
+  bool get isEmpty => _totalCount == 0;
+
+  /// 非空桶的 `桶编号 -> 样本数`。
+  Map<int, int> get buckets => Map.unmodifiable(_counts);
+
+  /// 记录一个耗时样本（微秒），负值按 0 处理。
+  void record(int micros) => addToBucket(bucketOf(micros), 1);
+
+  void addToBucket(int bucket, int count) {
+    if (count <= 0) return;
+    _counts[bucket] = (_counts[bucket] ?? 0) + count;
+    _totalCount += count;
+  }
+
+  void merge(LatencyHistogram other) {
+    other._counts.forEach(addToBucket);
+  }
+
+  /// 第 [quantile]（0~1）分位的耗时（微秒），取所在桶的中点。
+  int percentile(double quantile) {
+    if (_totalCount == 0) return 0;
+    final rank = (quantile.clamp(0.0, 1.0) * _totalCount).ceil();
+    final target = rank < 1 ? 1 : rank;
+    final sorted = _counts.keys.toList()..sort();
+    var seen = 0;
+    for (final bucket in sorted) {
+      seen += _counts[bucket]!;
+      if (seen >= target) return midpointOf(bucket);
+    }
+    return midpointOf(sorted.last);
+  }
+
+  /// 最大样本所在桶的上界（微秒）。
+  int get maxMicros {
+    if (_totalCount == 0) return 0;
+    var maxBucket = 0;
+    for (final bucket in _counts.keys) {
+      if (bucket > maxBucket) maxBucket = bucket;
+    }
+    return upperBoundOf(maxBucket) - 1;
+  }
+
+  /// [micros] 所在的桶编号。
+  static int bucketOf(int micros) {
+    if (micros < subBucketCount) return micros < 0 ? 0 : micros;
+    final shift = micros.bitLength - 1 - _subBucketBits;
+    return (shift + 1) * subBucketCount + (micros >> shift) - subBucketCount;
+  }
+
+  /// 桶 [bucket] 的下界（含）。
+  static int lowerBoundOf(int bucket) {
+    if (bucket < subBucketCount) return bucket;
+    final shift = bucket ~/ subBucketCount - 1;
+    return (subBucketCount + bucket % subBucketCount) << shift;
+  }
+
+  /// 桶 [bucket] 的上界（不含）。
+  static int upperBoundOf(int bucket) {
+    if (bucket < subBucketCount) return bucket + 1;
+    final shift = bucket ~/ subBucketCount - 1;
+    return lowerBoundOf(bucket) + (1 << shift);
+  }
+
+  static int midpointOf(int bucket) =>
+      (lowerBoundOf(bucket) + upperBoundOf(bucket) - 1) ~/ 2;
+}
@@ -0,0 +1,151 @@
+import 'dart:async';
+import 'dart:convert';
+
+import 'package:crypto/crypto.dart';
+
+import '../database/app_database.dart';
+import '../database/llm_cache_entity.dart';
+import 'ai_providers/ai_provider.dart';
+import 'log_service.dart';
+import 'token_stats_service.dart';
+
+/// 按内容寻址的 LLM 结果缓存，持久化在 SQLite 的 `llm_result_cache` 表。
+///
+/// 键是（端点、模型、提示词模板、完整 user message）的 SHA-256，端点与
+/// 模型取实际产出结果的那一个（可能是故障转移或对冲的备用服务）。纠错请求的
+/// user message 已包含 #R 引用表、#C 上下文与 #I 原文，任何一项变化都会
+/// 得到新键；提示词模板以全文参与哈希，模板改动后旧条目自然失效。
+///
+/// 模型原样返回输入时只记录「无改动」（负缓存），不重复保存文本。
+/// 条目按最近命中时间做 LRU 淘汰，数量与字节数各有上限。数据库不可用
+/// 或尚未打开时所有查询视为未命中，不影响请求本身。
+class LlmResultCache {
+  static final instance = LlmResultCache();
+
+  /// 缓存条目格式版本，改变键的构成或条目语义时递增。
+  static const int schemaVersion = 2;
+
+  final int maxEntries;
+  final int maxBytes;
+
+  /// 每写入这么多条做一次淘汰。
+  final int pruneInterval;
+
+  bool enabled = true;
+
+  int _writesSincePrune = 0;
+  Future<void>? _pruning;
+
+  LlmResultCache({
+    this.maxEntries = 5000,
+    this.maxBytes = 8 * 1024 * 1024,
+    this.pruneInterval = 50,
+  });
+
+  static String keyFor({
+    required String baseUrl,
+    required String model,
+    required String prompt,
+    required String message,
+  }) {
+    final content = [
+      schemaVersion,
+      baseUrl.trim(),
+      model.trim(),
+      prompt,
+      message,
+    ].join('\u0000');
+    return sha256.convert(utf8.encode(content)).toString();
+  }
+
+  /// 查找缓存。命中时返回 token 计为 0、[AiEnhanceResult.cached] 为 true
+  /// 的结果；负缓存命中返回 [unchangedText]。
+  Future<AiEnhanceResult?> lookup(
+    String key, {
+    required String unchangedText,
+  }) async {
+    final db = AppDatabase.instanceIfOpen;
+    if (!enabled || db == null) return null;
+    LlmCacheEntity? entry;
+    try {
+      entry = await db.llmCacheDao.findByKey(key);
+      if (entry != null) {
+        final now = DateTime.now().millisecondsSinceEpoch;
+        await db.llmCacheDao.touch(key, now);
+      }
+    } catch (_) {
+      return null;
+    }
+    await TokenStatsService.instance.recordCacheLookup(
+      hit: entry != null,
+      savedPromptTokens: entry?.promptTokens ?? 0,
+      savedCompletionTokens: entry?.completionTokens ?? 0,
+    );
+    if (entry == null) return null;
+    return AiEnhanceResult(
+      text: entry.unchanged ? unchangedText : entry.text,
+      cached: true,
+    );
+  }
+
+  /// 写入一次成功请求的结果；空结果不缓存。
+  Future<void> store(
+    String key,
+    AiEnhanceResult result, {
+    required String unchangedText,
+  }) async {
+    final db = AppDatabase.instanceIfOpen;
+    if (!enabled || db == null || result.cached) return;
+    final text = result.text.trim();
+    if (text.isEmpty) return;
+    final unchanged = text == unchangedText.trim();
+    final now = DateTime.now().millisecondsSinceEpoch;
+    final entry = LlmCacheEntity(
+      key: key,
+      text: unchanged ? '' : result.text,
+      unchanged: unchanged,
+      promptTokens: result.promptTokens,
+      completionTokens: result.completionTokens,
+      size: key.length + (unchanged ? 0 : utf8.encode(result.text).length),
+      createdAt: now,
+      lastUsedAt: now,
+    );
+    try {
+      await db.llmCacheDao.upsertEntry(entry);
+    } catch (_) {
+      return;
+    }
+    if (++_writesSincePrune >= pruneInterval) {
+      _writesSincePrune = 0;
+      unawaited(prune());
+    }
+  }
+
+  /// 按 LRU 淘汰超出上限的条目。
+  Future<void> prune() {
+    return _pruning ??= _prune().whenComplete(() => _pruning = null);
+  }
+
+  Future<void> _prune() async {
+    final db = AppDatabase.instanceIfOpen;
+    if (db == null) return;
+    try {
+      final evicted = await db.pruneLlmCache(
+        maxEntries: maxEntries,
+        maxBytes: maxBytes,
+      );
+      if (evicted > 0) {
+        await LogService.info('LLM_CACHE', 'evicted $evicted entries');
+      }
+    } catch (e) {
+      await LogService.warn('LLM_CACHE', 'prune failed: $e');
+    }
+  }
+
+  /// 清空缓存。
+  Future<void> clear() async {
+    try {
+      await AppDatabase.instanceIfOpen?.llmCacheDao.deleteAll();
+    } catch (_) {}
+  }
+}
@@ -0,0 +1,142 @@
+import 'dart:async';
+import 'dart:convert';
+
+import '../database/app_database.dart';
+import 'latency_histogram.dart';
+
+/// 单个模型累计的流式输出统计。
+class ModelStreamRecord {
+  /// 首字延迟分布（微秒）。
+  final LatencyHistogram firstToken;
+
+  /// 有输出耗时的流式请求累计的输出 token 数与输出耗时（微秒）。
+  int completionTokens;
+  int decodeMicros;
+
+  ModelStreamRecord({
+    LatencyHistogram? firstToken,
+    this.completionTokens = 0,
+    this.decodeMicros = 0,
+  }) : firstToken = firstToken ?? LatencyHistogram();
+
+  int get requests => firstToken.totalCount;
+
+  /// 平均输出速度（token/秒），尚无样本时为 0。
+  double get tokensPerSecond => decodeMicros <= 0
+      ? 0
+      : completionTokens * Duration.microsecondsPerSecond / decodeMicros;
+
+  Map<String, dynamic> toJson() => {
+    'ttft': {
+      for (final entry in firstToken.buckets.entries)
+        '${entry.key}': entry.value,
+    },
+    'tokens': completionTokens,
+    'decodeUs': decodeMicros,
+  };
+
+  factory ModelStreamRecord.fromJson(Map<String, dynamic> json) {
+    final buckets = <int, int>{};
+    final raw = json['ttft'];
+    if (raw is Map) {
+      raw.forEach((key, value) {
+        final bucket = int.tryParse('$key');
+        if (bucket != null && value is int) buckets[bucket] = value;
+      });
+    }
+    return ModelStreamRecord(
+      firstToken: LatencyHistogram.fromBuckets(buckets),
+      completionTokens: (json['tokens'] as int?) ?? 0,
+      decodeMicros: (json['decodeUs'] as int?) ?? 0,
+    );
+  }
+}
+
+/// 按模型持久化流式增强的首字延迟与输出速度，供仪表盘对比模型。
+///
+/// 统计整体存为一条设置项；[record] 只更新内存，[flushDelay] 后或显式
+/// 调用 [flush] 时写入数据库。
+class LlmStreamStatsService {
+  LlmStreamStatsService._();
+  static final instance = LlmStreamStatsService._();
+
+  static const _key = 'llm_stream_stats';
+  static const Duration flushDelay = Duration(seconds: 5);
+
+  Future<Map<String, ModelStreamRecord>>? _loading;
+  bool _dirty = false;
+  Timer? _flushTimer;
+
+  /// 记录 [model] 的一次流式请求；[decode] 为首字之后的输出耗时。
+  Future<void> record({
+    required String model,
+    required Duration firstToken,
+    required Duration decode,
+    required int completionTokens,
+  }) async {
+    final name = model.trim();
+    if (name.isEmpty) return;
+    final models = await _load();
+    final record = models.putIfAbsent(name, ModelStreamRecord.new);
+    record.firstToken.record(firstToken.inMicroseconds);
+    if (decode > Duration.zero && completionTokens > 0) {
+      record
+        ..completionTokens += completionTokens
+        ..decodeMicros += decode.inMicroseconds;
+    }
+    _dirty = true;
+    _flushTimer ??= Timer(flushDelay, () {
+      _flushTimer = null;
+      unawaited(flush());
+    });
+  }
+
+  /// 将内存中的统计写入数据库；写入失败时留到下一轮。
+  Future<void> flush() async {
+    _flushTimer?.cancel();
+    _flushTimer = null;
+    if (!_dirty) return;
+    final models = await _load();
+    _dirty = false;
+    try {
+      final db = await AppDatabase.getInstance();
+      await db.setSetting(
+        _key,
+        jsonEncode({
+          for (final entry in models.entries) entry.key: entry.value.toJson(),
+        }),
+      );
+    } catch (_) {
+      _dirty = true;
+    }
+  }
+
+  /// 各模型的累计统计（`模型 -> 统计`）。
+  Future<Map<String, ModelStreamRecord>> readAll() async {
+    return Map.unmodifiable(await _load());
+  }
+
+  Future<Map<String, ModelStreamRecord>> _load() {
+    return _loading ??= () async {
+      final models = <String, ModelStreamRecord>{};
+      try {
+        final db = await AppDatabase.getInstance();
+        final raw = await db.getSetting(_key);
+        if (raw == null || raw.trim().isEmpty) return models;
+        final decoded = jsonDecode(raw);
+        if (decoded is! Map) return models;
+        decoded.forEach((model, value) {
+          if (value is Map) {
+            models['$model'] = ModelStreamRecord.fromJson(
+              value.cast<String, dynamic>(),
+            );
+          }
+        });
+      } catch (_) {
+        // 读取失败时不缓存空结果，以免落盘时覆盖已有统计。
+        _loading = null;
+      }
+      return models;
+    }();
+  }
+}
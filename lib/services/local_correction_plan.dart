@@ -0,0 +1,228 @@
+import '../models/dictionary_entry.dart';
+import 'pinyin_matcher.dart';
+import 'term_replacement_engine.dart';
+
+/// 纠错在调用 LLM 之前的本地阶段：拼音匹配、候选筛选与术语归一化。
+///
+/// 只依赖词典索引和输入文本，不读写会话状态，
+/// 因此既可在当前 isolate 计算，也可交给 [TextComputePool] 在后台执行。
+class LocalCorrectionPlan {
+  /// 拼音匹配的全部命中片段。
+  final List<PinyinMatchHit> matchHits;
+
+  /// 通过筛选、写入引用表的命中。
+  final List<PinyinMatchHit> selectedHits;
+
+  /// [selectedHits] 各自的候选分，下标一一对应。
+  final List<double> selectedScores;
+
+  /// 按 [selectedHits] 归一化后的输入；无选中命中时为原文。
+  final String normalizedText;
+
+  const LocalCorrectionPlan({
+    required this.matchHits,
+    required this.selectedHits,
+    this.selectedScores = const [],
+    required this.normalizedText,
+  });
+
+  static LocalCorrectionPlan compute(
+    PinyinMatcher matcher,
+    String text,
+    ReferenceHitSelector selector,
+  ) {
+    final matchHits = matcher.findMatchHits(text);
+    final scored = selector.selectScored(text, matchHits);
+    final selectedHits = [for (final item in scored) item.hit];
+    final engine = TermReplacementEngine.forMatcher(matcher);
+    return LocalCorrectionPlan(
+      matchHits: matchHits,
+      selectedHits: selectedHits,
+      selectedScores: [for (final item in scored) item.score],
+      normalizedText: engine.apply(text, selectedHits),
+    );
+  }
+}
+
+/// 纠错引用表的候选筛选。
+///
+/// 对每个命中按字形与拼音相似度打分并叠加条目类型加权，
+/// 丢弃低于 [minCandidateScore] 的候选，按「源 -> 目标」去重后
+/// 最多保留 [maxReferenceEntries] 条。
+class ReferenceHitSelector {
+  final int maxReferenceEntries;
+  final double minCandidateScore;
+
+  const ReferenceHitSelector({
+    this.maxReferenceEntries = 15,
+    this.minCandidateScore = 0.30,
+  });
+
+  /// 从 [hits] 中选出写入引用表的候选，按分数降序。
+  List<PinyinMatchHit> select(String rawText, List<PinyinMatchHit> hits) =>
+      [for (final item in selectScored(rawText, hits)) item.hit];
+
+  /// 同 [select]，同时带上每个候选的分数。
+  List<ScoredHit> selectScored(String rawText, List<PinyinMatchHit> hits) {
+    if (hits.isEmpty) return const [];
+    final ranked = hits
+        .map((hit) => ScoredHit(hit: hit, score: _scoreHit(rawText, hit)))
+        .where((r) => r.score >= minCandidateScore)
+        .toList();
+
+    if (ranked.isEmpty) return const [];
+
+    ranked.sort((a, b) {
+      final byScore = b.score.compareTo(a.score);
+      if (byScore != 0) return byScore;
+      final aLen = a.hit.observedText.length;
+      final bLen = b.hit.observedText.length;
+      final byLen = bLen.compareTo(aLen);
+      if (byLen != 0) return byLen;
+      return a.hit.entry.id.compareTo(b.hit.entry.id);
+    });
+
+    final result = <ScoredHit>[];
+    final seen = <String>{};
+    for (final item in ranked) {
+      final key = _referenceDedupKey(item.hit);
+      if (!seen.add(key)) continue;
+      result.add(item);
+      if (result.length >= maxReferenceEntries) break;
+    }
+    return result;
+  }
+
+  static String _referenceDedupKey(PinyinMatchHit hit) {
+    final entry = hit.entry;
+    final target = targetTextFor(entry);
+    final source = hit.observedText.trim().isNotEmpty
+        ? hit.observedText.trim()
+        : entry.original;
+    return '$source->$target';
+  }
+
+  double _scoreHit(String rawText, PinyinMatchHit hit) {
+    final source = rawText.trim();
+    if (source.isEmpty) return 0;
+
+    final entry = hit.entry;
+    final original = entry.original.trim();
+    final corrected = (entry.corrected ?? '').trim();
+    final observed = hit.observedText.trim();
+    if (original.isEmpty && corrected.isEmpty) return 0;
+
+    if (hit.matchType == PinyinMatchType.literal) {
+      return 1;
+    }
+
+    var bestCharSimilarity = 0.0;
+    if (observed.isNotEmpty && original.isNotEmpty) {
+      final s = _normalizedSimilarity(observed, original);
+      if (s > bestCharSimilarity) bestCharSimilarity = s;
+    }
+    if (observed.isNotEmpty && corrected.isNotEmpty) {
+      final s = _normalizedSimilarity(observed, corrected);
+      if (s > bestCharSimilarity) bestCharSimilarity = s;
+    }
+
+    var bestPinyinSimilarity = 0.0;
+    if (observed.isNotEmpty &&
+        original.isNotEmpty &&
+        TermReplacementEngine.containsChinese(observed) &&
+        TermReplacementEngine.containsChinese(original)) {
+      final observedPinyin = PinyinMatcher.computePinyin(observed);
+      final originalPinyin = PinyinMatcher.computePinyin(original);
+      final s = _normalizedSimilarity(observedPinyin, originalPinyin);
+      if (s > bestPinyinSimilarity) bestPinyinSimilarity = s;
+    }
+    if (observed.isNotEmpty &&
+        corrected.isNotEmpty &&
+        TermReplacementEngine.containsChinese(observed) &&
+        TermReplacementEngine.containsChinese(corrected)) {
+      final observedPinyin = PinyinMatcher.computePinyin(observed);
+      final correctedPinyin = PinyinMatcher.computePinyin(corrected);
+      final s = _normalizedSimilarity(observedPinyin, correctedPinyin);
+      if (s > bestPinyinSimilarity) bestPinyinSimilarity = s;
+    }
+    if (observed.isNotEmpty &&
+        entry.hasPinyinPattern &&
+        TermReplacementEngine.containsChinese(observed)) {
+      final observedPinyin = PinyinMatcher.computePinyin(observed);
+      final s = _normalizedSimilarity(observedPinyin, entry.pinyinNormalized);
+      if (s > bestPinyinSimilarity) bestPinyinSimilarity = s;
+    }
+
+    final typeBonus = entry.type == DictionaryEntryType.correction ? 0.05 : 0.0;
+    final patternBonus = entry.hasPinyinPattern ? 0.18 : 0.0;
+    final matchTypeBonus = switch (hit.matchType) {
+      PinyinMatchType.pinyinExact => 0.12,
+      PinyinMatchType.pinyinFuzzy => 0.06,
+      PinyinMatchType.literal => 0.18,
+    };
+    final combined =
+        bestCharSimilarity * 0.55 +
+        bestPinyinSimilarity * 0.45 +
+        typeBonus +
+        patternBonus +
+        matchTypeBonus;
+    return combined > 1.0 ? 1.0 : combined;
+  }
+
+  static double _normalizedSimilarity(String a, String b) {
+    if (a.isEmpty || b.isEmpty) return 0;
+    if (a == b) return 1;
+    final distance = _levenshtein(a, b);
+    final base = a.length > b.length ? a.length : b.length;
+    if (base == 0) return 0;
+    final sim = 1 - (distance / base);
+    return sim < 0 ? 0 : sim;
+  }
+
+  static int _levenshtein(String a, String b) {
+    if (a == b) return 0;
+    if (a.isEmpty) return b.length;
+    if (b.isEmpty) return a.length;
+
+    var prev = List.generate(b.length + 1, (i) => i);
+    var curr = List.filled(b.length + 1, 0);
+
+    for (var i = 1; i <= a.length; i++) {
+      curr[0] = i;
+      for (var j = 1; j <= b.length; j++) {
+        final cost = a.codeUnitAt(i - 1) == b.codeUnitAt(j - 1) ? 0 : 1;
+        final deletion = prev[j] + 1;
+        final insertion = curr[j - 1] + 1;
+        final substitution = prev[j - 1] + cost;
+        var value = deletion < insertion ? deletion : insertion;
+        if (substitution < value) value = substitution;
+        curr[j] = value;
+      }
+      final tmp = prev;
+      prev = curr;
+      curr = tmp;
+    }
+    return prev[b.length];
+  }
+
+  /// [entry] 在引用表与归一化中的目标词。
+  static String targetTextFor(DictionaryEntry entry) {
+    if (entry.type != DictionaryEntryType.correction) {
+      return entry.original;
+    }
+    final corrected = entry.corrected?.trim() ?? '';
+    if (corrected.isEmpty) return entry.original;
+    if (TermReplacementEngine.isChineseToLatinAlias(entry)) {
+      return entry.original;
+    }
+    return corrected;
+  }
+}
+
+/// 带候选分的命中。
+class ScoredHit {
+  final PinyinMatchHit hit;
+  final double score;
+
+  const ScoredHit({required this.hit, required this.score});
+}
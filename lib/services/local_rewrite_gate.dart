@@ -0,0 +1,226 @@
+import '../models/dictionary_entry.dart';
+import '../models/memory_item.dart';
+import 'local_correction_plan.dart';
+import 'pinyin_matcher.dart';
+import 'session_glossary.dart';
+
+/// [LocalRewriteGate.decide] 的判定结果。
+class LocalRewriteDecision {
+  /// 所有命中都能在本地确定地处理，无需调用 LLM。
+  final bool confident;
+
+  /// 本地改写后的文本；[confident] 为 false 时为本地归一化结果。
+  final String text;
+
+  /// 参与本地判定（改写或确认已是标准写法）的词典命中。
+  final List<PinyinMatchHit> appliedHits;
+
+  /// 参与本地改写的记忆条目 id。
+  final List<String> memoryItemIds;
+
+  /// 实际执行的替换规则数。
+  final int rewriteCount;
+
+  /// 需要升级到 LLM 的原因，仅用于日志。
+  final String reason;
+
+  const LocalRewriteDecision._({
+    required this.confident,
+    required this.text,
+    this.appliedHits = const [],
+    this.memoryItemIds = const [],
+    this.rewriteCount = 0,
+    this.reason = '',
+  });
+}
+
+/// 纠错的本地快速路径闸门：判断一段文本能否只靠确定性替换完成纠错。
+///
+/// 每个命中按类型给出置信度：字面命中为 1，拼音精确命中取
+/// [ReferenceHitSelector] 的候选分，拼音模糊命中再乘 [fuzzyPenalty]。
+/// 与 SessionGlossary 强锚定映射一致的命中视为确定，相矛盾的视为不确定；
+/// 记忆引用只有 active 且自身 confidence 达标时才在本地改写。
+///
+/// 全部命中达到 [minConfidence]、目标互不冲突且没有实体提示时，在
+/// [LocalCorrectionPlan.normalizedText] 上替换后直接输出，否则交给 LLM。
+class LocalRewriteGate {
+  final double minConfidence;
+  final double fuzzyPenalty;
+
+  /// 每 [shadowEvery] 次本地直出抽检一次 LLM 结果，0 表示不抽检。
+  final int shadowEvery;
+
+  const LocalRewriteGate({
+    this.minConfidence = 0.85,
+    this.fuzzyPenalty = 0.5,
+    this.shadowEvery = 20,
+  });
+
+  /// 命中 [hit] 的置信度；[score] 为其候选分。
+  double confidenceOf(
+    PinyinMatchHit hit,
+    double score, {
+    Map<String, TermPin> strongPins = const {},
+  }) {
+    final pin = strongPins[hit.observedText.trim().toLowerCase()];
+    if (pin != null) {
+      return pin.corrected == ReferenceHitSelector.targetTextFor(hit.entry)
+          ? 1
+          : 0;
+    }
+    return switch (hit.matchType) {
+      PinyinMatchType.literal => 1,
+      PinyinMatchType.pinyinExact => score,
+      PinyinMatchType.pinyinFuzzy => score * fuzzyPenalty,
+    };
+  }
+
+  /// 对 [plan] 及引用到的 [memoryItems] 做本地判定。
+  LocalRewriteDecision decide({
+    required LocalCorrectionPlan plan,
+    List<MemoryItem> memoryItems = const [],
+    Map<String, TermPin> strongPins = const {},
+    bool hasEntityHints = false,
+  }) {
+    final base = plan.normalizedText;
+    LocalRewriteDecision escalate(String reason) =>
+        LocalRewriteDecision._(confident: false, text: base, reason: reason);
+
+    if (hasEntityHints) return escalate('entity hints need context');
+
+    // 长命中优先，同长按候选分；被更长命中包含的片段不再单独判定。
+    int lengthAt(int i) => plan.selectedHits[i].observedText.trim().length;
+    final order = List.generate(plan.selectedHits.length, (i) => i)
+      ..sort((a, b) {
+        final byLength = lengthAt(b).compareTo(lengthAt(a));
+        return byLength != 0 ? byLength : a.compareTo(b);
+      });
+    final rewrites = <_Rewrite>[];
+    final targets = <String, String>{};
+    final applied = <PinyinMatchHit>[];
+    for (final i in order) {
+      final hit = plan.selectedHits[i];
+      final observed = hit.observedText.trim();
+      if (observed.isEmpty) continue;
+      final target = ReferenceHitSelector.targetTextFor(hit.entry);
+      final previous = targets[observed];
+      if (previous != null) {
+        if (previous != target) return escalate('"$observed" has two targets');
+        continue;
+      }
+      if (targets.keys.any((other) => other.contains(observed))) continue;
+
+      if (hit.entry.type != DictionaryEntryType.correction) {
+        // 保留词：字面命中已是标准写法，拼音命中要结合上下文判断。
+        if (hit.matchType != PinyinMatchType.literal) {
+          return escalate('preserve term "$observed" needs context');
+        }
+      } else {
+        final score = i < plan.selectedScores.length
+            ? plan.selectedScores[i]
+            : 0.0;
+        if (confidenceOf(hit, score, strongPins: strongPins) < minConfidence) {
+          return escalate('"$observed" below confidence');
+        }
+        if (observed != target) {
+          if (target.contains(observed)) {
+            return escalate('"$target" contains "$observed"');
+          }
+          final rewrite = _Rewrite(observed, target);
+          if (rewrite.pattern.hasMatch(base)) {
+            rewrites.add(rewrite);
+          } else if (!base.contains(target)) {
+            // 命中跨越空白等，原文中找不到可替换的片段。
+            return escalate('"$observed" not found in text');
+          }
+        }
+      }
+      targets[observed] = target;
+      applied.add(hit);
+    }
+
+    final memoryItemIds = <String>[];
+    for (final item in memoryItems) {
+      final canonical = item.canonical.trim();
+      final sources = <String>{
+        item.original.trim(),
+        for (final alias in item.aliases) alias.trim(),
+      }..removeWhere((s) => s.isEmpty || s == canonical);
+      final present = [
+        for (final source in sources)
+          _Rewrite(source, canonical, caseSensitive: false),
+      ].where((rewrite) => rewrite.changes(base)).toList();
+      // 只因标准词出现而被引用，无需改写。
+      if (present.isEmpty) continue;
+      if (item.status != MemoryItemStatus.active ||
+          item.confidence < minConfidence) {
+        return escalate('memory "$canonical" below confidence');
+      }
+      final lowerCanonical = canonical.toLowerCase();
+      for (final rewrite in present) {
+        final lowerSource = rewrite.source.toLowerCase();
+        if (lowerCanonical != lowerSource &&
+            lowerCanonical.contains(lowerSource)) {
+          return escalate('"$canonical" contains "${rewrite.source}"');
+        }
+        final previous = targets[rewrite.source];
+        if (previous != null) {
+          if (previous == canonical) continue;
+          return escalate('"${rewrite.source}" has two targets');
+        }
+        targets[rewrite.source] = canonical;
+        rewrites.add(rewrite);
+      }
+      memoryItemIds.add(item.id);
+    }
+
+    // 某条规则的源出现在另一条的目标中时，替换顺序会影响结果。
+    for (final rewrite in rewrites) {
+      if (rewrites.any(
+        (other) => other != rewrite && other.target.contains(rewrite.source),
+      )) {
+        return escalate('"${rewrite.source}" chains with another rewrite');
+      }
+    }
+
+    rewrites.sort((a, b) => b.source.length.compareTo(a.source.length));
+    var text = base;
+    for (final rewrite in rewrites) {
+      text = text.replaceAll(rewrite.pattern, rewrite.target);
+    }
+    return LocalRewriteDecision._(
+      confident: true,
+      text: text,
+      appliedHits: applied,
+      memoryItemIds: memoryItemIds,
+      rewriteCount: rewrites.length,
+    );
+  }
+}
+
+/// 一条本地替换规则；拉丁字母开头或结尾的源要求词边界。
+class _Rewrite {
+  final String source;
+  final String target;
+  final RegExp pattern;
+
+  _Rewrite(this.source, this.target, {bool caseSensitive = true})
+    : pattern = RegExp(_boundedPattern(source), caseSensitive: caseSensitive);
+
+  /// [text] 中是否有会被本规则改动的片段。
+  bool changes(String text) =>
+      pattern.allMatches(text).any((match) => match[0] != target);
+
+  static String _boundedPattern(String source) {
+    final head = _isWordUnit(source.codeUnitAt(0)) ? r'(?<![A-Za-z0-9])' : '';
+    final tail = _isWordUnit(source.codeUnitAt(source.length - 1))
+        ? r'(?![A-Za-z0-9])'
+        : '';
+    return '$head${RegExp.escape(source)}$tail';
+  }
+
+  static bool _isWordUnit(int unit) =>
+      (unit >= 0x30 && unit <= 0x39) ||
+      (unit >= 0x41 && unit <= 0x5a) ||
+      (unit >= 0x61 && unit <= 0x7a);
+}
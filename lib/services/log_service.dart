@@ -1,8 +1,36 @@
+import 'dart:async';
+import 'dart:convert';
 import 'dart:io';
 import 'package:path/path.dart' as path;
 import 'package:path_provider/path_provider.dart';
 
+enum LogLevel { debug, info, warn, error }
+
+/// 应用日志。
+///
+/// [log] 同步地把格式化后的行放入内存缓冲区后立即返回；缓冲区按大小或
+/// 时间间隔在后台写入一直打开的 [IOSink]，调用方不再为每行日志等待
+/// 路径解析、文件检查与 flush。日志文件超过 [maxFileBytes] 时轮转为
+/// `voicetype.log.1` … `voicetype.log.N`，保留 [retainedFiles] 个旧文件。
 class LogService {
+  /// 低于该级别的日志直接丢弃。
+  static LogLevel minLevel = LogLevel.info;
+
+  static const int maxFileBytes = 5 * 1024 * 1024;
+  static const int retainedFiles = 3;
+  static const int _flushThresholdChars = 32 * 1024;
+  static const Duration _flushInterval = Duration(milliseconds: 500);
+
+  static final Future<void> _done = Future<void>.value();
+
+  static final List<String> _buffer = [];
+  static int _bufferedChars = 0;
+  static Timer? _flushTimer;
+  static Future<void>? _flushing;
+  static IOSink? _sink;
+  static String? _openPath;
+  static int _fileSize = 0;
+
   static String _twoDigits(int value) => value.toString().padLeft(2, '0');
   static String _threeDigits(int value) => value.toString().padLeft(3, '0');
 
@@ -62,35 +90,133 @@ class LogService {
     return '${(bytes / (1024 * 1024)).toStringAsFixed(1)} MB';
   }
 
+  /// 记录一行日志，不等待写盘。
+  static void log(LogLevel level, String tag, String message) {
+    if (level.index < minLevel.index) return;
+    final ts = _formatLocalTimestamp24h(DateTime.now());
+    final line = '[$ts][${level.name.toUpperCase()}][$tag] $message\n';
+    _buffer.add(line);
+    _bufferedChars += line.length;
+    if (_bufferedChars >= _flushThresholdChars) {
+      unawaited(flush());
+    } else {
+      _flushTimer ??= Timer(_flushInterval, () {
+        _flushTimer = null;
+        unawaited(flush());
+      });
+    }
+  }
+
   static Future<void> appendLog(
     String message, {
     String level = 'INFO',
     String tag = 'APP',
-  }) async {
+  }) {
+    final parsed = LogLevel.values.firstWhere(
+      (value) => value.name == level.toLowerCase(),
+      orElse: () => LogLevel.info,
+    );
+    log(parsed, tag, message);
+    return _done;
+  }
+
+  static Future<void> debug(String tag, String message) {
+    log(LogLevel.debug, tag, message);
+    return _done;
+  }
+
+  static Future<void> info(String tag, String message) {
+    log(LogLevel.info, tag, message);
+    return _done;
+  }
+
+  static Future<void> warn(String tag, String message) {
+    log(LogLevel.warn, tag, message);
+    return _done;
+  }
+
+  static Future<void> error(String tag, String message) {
+    log(LogLevel.error, tag, message);
+    return _done;
+  }
+
+  /// 将缓冲区写入日志文件；同一时刻只有一轮写入。
+  static Future<void> flush() async {
+    _flushTimer?.cancel();
+    _flushTimer = null;
+    while (_flushing != null) {
+      await _flushing;
+    }
+    if (_buffer.isEmpty) return;
+
+    final chunk = _buffer.join();
+    _buffer.clear();
+    _bufferedChars = 0;
+    final completer = Completer<void>();
+    _flushing = completer.future;
     try {
-      final logPath = await logFilePath;
-      final file = File(logPath);
-      if (!await file.exists()) {
-        await file.create(recursive: true);
+      final sink = await _openSink();
+      sink.write(chunk);
+      await sink.flush();
+      _fileSize += utf8.encode(chunk).length;
+      if (_fileSize >= maxFileBytes) {
+        await _rotate();
       }
-
-      final ts = _formatLocalTimestamp24h(DateTime.now());
-      final line = '[$ts][$level][$tag] $message\n';
-      await file.writeAsString(line, mode: FileMode.append, flush: true);
     } catch (_) {
       // ignore logging failures
+    } finally {
+      _flushing = null;
+      completer.complete();
     }
   }
 
-  static Future<void> info(String tag, String message) async {
-    await appendLog(message, level: 'INFO', tag: tag);
+  /// 写出剩余日志并关闭文件，用于退出前。
+  static Future<void> close() async {
+    await flush();
+    final sink = _sink;
+    _sink = null;
+    _openPath = null;
+    try {
+      await sink?.close();
+    } catch (_) {}
   }
 
-  static Future<void> warn(String tag, String message) async {
-    await appendLog(message, level: 'WARN', tag: tag);
+  static Future<IOSink> _openSink() async {
+    final existing = _sink;
+    if (existing != null) return existing;
+    final logPath = await logFilePath;
+    final file = File(logPath);
+    if (!await file.exists()) {
+      await file.create(recursive: true);
+    }
+    _fileSize = await file.length();
+    _openPath = logPath;
+    return _sink = file.openWrite(mode: FileMode.append);
   }
 
-  static Future<void> error(String tag, String message) async {
-    await appendLog(message, level: 'ERROR', tag: tag);
+  /// voicetype.log → voicetype.log.1 → … → voicetype.log.N，超出保留数的删除。
+  static Future<void> _rotate() async {
+    final logPath = _openPath;
+    final sink = _sink;
+    _sink = null;
+    _openPath = null;
+    _fileSize = 0;
+    if (logPath == null) return;
+    await sink?.close();
+
+    final oldest = File('$logPath.$retainedFiles');
+    if (await oldest.exists()) {
+      await oldest.delete();
+    }
+    for (var i = retainedFiles - 1; i >= 1; i--) {
+      final file = File('$logPath.$i');
+      if (await file.exists()) {
+        await file.rename('$logPath.${i + 1}');
+      }
+    }
+    final current = File(logPath);
+    if (await current.exists()) {
+      await current.rename('$logPath.1');
+    }
   }
 }
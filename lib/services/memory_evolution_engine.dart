@@ -1,5 +1,6 @@
 import '../models/memory_event.dart';
 import '../models/memory_item.dart';
+import 'memory_item_index.dart';
 
 class MemoryEvolutionResult {
   final List<MemoryItem> items;
@@ -48,10 +49,8 @@ class MemoryEvolutionEngine {
       original: original,
       canonical: canonical,
     );
-    final existingIndex = currentItems.indexWhere((item) {
-      return item.normalizedKey == key &&
-          item.status != MemoryItemStatus.archived;
-    });
+    final index = MemoryItemIndex.of(currentItems);
+    final existingIndex = index.indexOf(currentItems, key);
 
     final now = event.createdAt;
     if (existingIndex >= 0) {
@@ -72,8 +71,10 @@ class MemoryEvolutionEngine {
         updatedAt: now,
         stats: nextStats,
       );
-      final items = List<MemoryItem>.from(currentItems);
-      items[existingIndex] = updated;
+      final items = List<MemoryItem>.unmodifiable(
+        List<MemoryItem>.of(currentItems)..[existingIndex] = updated,
+      );
+      index.transferTo(currentItems, items);
       return MemoryEvolutionResult(
         items: items,
         item: updated,
@@ -94,8 +95,10 @@ class MemoryEvolutionEngine {
       now: now,
       stats: stats,
     );
+    final items = List<MemoryItem>.unmodifiable([created, ...currentItems]);
+    index.transferPrepended(currentItems, items, created);
     return MemoryEvolutionResult(
-      items: [created, ...currentItems],
+      items: items,
       item: created,
       event: event.copyWith(memoryId: created.id),
     );
@@ -0,0 +1,70 @@
+import '../models/memory_item.dart';
+
+/// 记忆条目按 [MemoryItem.normalizedKey] 建立的哈希索引。
+///
+/// 记录每个键第一个未归档条目的位置。位置按「距列表末尾的偏移」存储，
+/// 因此在列表头部插入新条目或原位替换条目后，已有位置全部保持有效，
+/// 索引可以直接转移给新快照而无需重建。
+///
+/// 索引只缓存在经 [register] 登记或 [transferTo] / [transferPrepended]
+/// 转移得到的快照上，这些快照须为不可修改列表，按列表实例即可判断索引
+/// 是否有效；其他列表可能被原地修改，每次查询都重新构建。
+/// 每个索引同一时刻只归属一个快照。
+class MemoryItemIndex {
+  final Map<String, int> _offsetFromEnd;
+
+  MemoryItemIndex._(this._offsetFromEnd);
+
+  static final Expando<MemoryItemIndex> _indexByItems = Expando(
+    'MemoryItemIndex',
+  );
+  static final Expando<bool> _registered = Expando('MemoryItemSnapshot');
+
+  /// 登记不可修改的快照 [items]：其索引在首次查询时构建并缓存。
+  static void register(List<MemoryItem> items) {
+    _registered[items] = true;
+  }
+
+  /// 获取 [items] 的索引；尚未缓存时 O(n) 构建，已登记的快照只构建一次。
+  static MemoryItemIndex of(List<MemoryItem> items) {
+    final cached = _indexByItems[items];
+    if (cached != null) return cached;
+    final offsets = <String, int>{};
+    final last = items.length - 1;
+    for (var i = 0; i < items.length; i++) {
+      final item = items[i];
+      if (item.status == MemoryItemStatus.archived) continue;
+      offsets.putIfAbsent(item.normalizedKey, () => last - i);
+    }
+    final index = MemoryItemIndex._(offsets);
+    if (_registered[items] == true) _indexByItems[items] = index;
+    return index;
+  }
+
+  /// [key] 对应的第一个未归档条目在 [items] 中的位置，不存在时返回 -1。
+  int indexOf(List<MemoryItem> items, String key) {
+    final offset = _offsetFromEnd[key];
+    if (offset == null) return -1;
+    return items.length - 1 - offset;
+  }
+
+  /// 将索引转移给原位替换了一个条目（键与归档状态不变）后的不可修改
+  /// 快照 [to]。
+  void transferTo(List<MemoryItem> from, List<MemoryItem> to) {
+    _indexByItems[from] = null;
+    _indexByItems[to] = this;
+  }
+
+  /// 将索引转移给在头部插入 [created] 后的不可修改快照 [to]。
+  void transferPrepended(
+    List<MemoryItem> from,
+    List<MemoryItem> to,
+    MemoryItem created,
+  ) {
+    _indexByItems[from] = null;
+    if (created.status != MemoryItemStatus.archived) {
+      _offsetFromEnd[created.normalizedKey] = to.length - 1;
+    }
+    _indexByItems[to] = this;
+  }
+}
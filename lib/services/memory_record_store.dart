@@ -0,0 +1,401 @@
+import 'dart:convert';
+import 'dart:isolate';
+
+import '../database/app_database.dart';
+import '../database/memory_record_entity.dart';
+import '../models/dictation_term_pending_candidate.dart';
+import '../models/dictionary_entry.dart';
+import '../models/entity_alias.dart';
+import '../models/entity_evidence.dart';
+import '../models/entity_memory.dart';
+import '../models/entity_relation.dart';
+import '../models/memory_event.dart';
+import '../models/memory_item.dart';
+import '../models/term_context_entry.dart';
+
+/// 一类按行存储的数据：集合名、旧版 settings 键与模型的序列化方式。
+class MemoryRecordCollection<T extends Object> {
+  final String name;
+
+  /// 旧版整体 JSON 存储所用的 settings 键，首次加载时迁移后删除。
+  final String legacySettingKey;
+  final String Function(T item) idOf;
+  final Map<String, dynamic> Function(T item) toJson;
+  final T Function(Map<String, dynamic> json) fromJson;
+  final String Function(T item)? keyOf;
+  final bool Function(T item)? enabledOf;
+  final DateTime Function(T item)? updatedAtOf;
+
+  const MemoryRecordCollection({
+    required this.name,
+    required this.legacySettingKey,
+    required this.idOf,
+    required this.toJson,
+    required this.fromJson,
+    this.keyOf,
+    this.enabledOf,
+    this.updatedAtOf,
+  });
+
+  /// 记录数达到该值时在后台 isolate 中解码，避免在 UI isolate 上
+  /// 同步解析大量 JSON；更少的记录不值得付出启动 isolate 的开销。
+  static const int backgroundDecodeThreshold = 200;
+
+  /// 只读地解码集合中的全部记录，不做迁移也不跟踪状态。
+  Future<List<T>> readAll(AppDatabase db) async {
+    final records = await db.getMemoryRecords(name);
+    return [
+      for (final item in await decodeAll(records))
+        if (item != null) item,
+    ];
+  }
+
+  /// 按顺序解码 [records]，无法解码的位置为 null。
+  Future<List<T?>> decodeAll(List<MemoryRecordEntity> records) {
+    if (records.length < backgroundDecodeThreshold) {
+      return Future.value(_decodeAll(records));
+    }
+    return Isolate.run(() => _decodeAll(records));
+  }
+
+  List<T?> _decodeAll(List<MemoryRecordEntity> records) => [
+    for (final record in records) decode(record),
+  ];
+
+  T? decode(MemoryRecordEntity record) {
+    try {
+      final decoded = json.decode(record.payload);
+      if (decoded is! Map<String, dynamic>) return null;
+      return fromJson(decoded);
+    } catch (_) {
+      return null;
+    }
+  }
+
+  MemoryRecordEntity toRecord(T item, int seq) {
+    return MemoryRecordEntity(
+      collection: name,
+      id: idOf(item),
+      normalizedKey: keyOf?.call(item) ?? '',
+      enabled: enabledOf?.call(item) ?? true,
+      updatedAt: updatedAtOf?.call(item).millisecondsSinceEpoch ?? 0,
+      seq: seq,
+      payload: json.encode(toJson(item)),
+    );
+  }
+}
+
+/// 词典、记忆与实体数据的集合定义。
+class MemoryRecordCollections {
+  MemoryRecordCollections._();
+
+  static final dictionaryEntries = MemoryRecordCollection<DictionaryEntry>(
+    name: 'dictionary_entry',
+    legacySettingKey: 'dictionary_entries',
+    idOf: (item) => item.id,
+    toJson: (item) => item.toJson(),
+    fromJson: DictionaryEntry.fromJson,
+    keyOf: (item) => item.original.trim().toLowerCase(),
+    enabledOf: (item) => item.enabled,
+    updatedAtOf: (item) => item.createdAt,
+  );
+
+  static final pendingCandidates =
+      MemoryRecordCollection<DictationTermPendingCandidate>(
+        name: 'dictation_term_pending_candidate',
+        legacySettingKey: 'dictation_term_pending_candidates_v1',
+        idOf: (item) => item.id,
+        toJson: (item) => item.toJson(),
+        fromJson: DictationTermPendingCandidate.fromJson,
+        keyOf: (item) =>
+            '${item.original.trim().toLowerCase()}|'
+            '${item.corrected.trim().toLowerCase()}',
+        updatedAtOf: (item) => item.createdAt,
+      );
+
+  static final termContextEntries = MemoryRecordCollection<TermContextEntry>(
+    name: 'term_context_entry',
+    legacySettingKey: 'term_context_entries_v1',
+    idOf: (item) => item.id,
+    toJson: (item) => item.toJson(),
+    fromJson: TermContextEntry.fromJson,
+    keyOf: (item) => item.promptTerm.trim().toLowerCase(),
+    enabledOf: (item) => item.enabled,
+    updatedAtOf: (item) => item.createdAt,
+  );
+
+  static final entityMemories = MemoryRecordCollection<EntityMemory>(
+    name: 'entity_memory',
+    legacySettingKey: 'entity_memories_v1',
+    idOf: (item) => item.id,
+    toJson: (item) => item.toJson(),
+    fromJson: EntityMemory.fromJson,
+    keyOf: (item) => item.canonicalName.trim().toLowerCase(),
+    enabledOf: (item) => item.enabled,
+    updatedAtOf: (item) => item.updatedAt,
+  );
+
+  static final entityAliases = MemoryRecordCollection<EntityAlias>(
+    name: 'entity_alias',
+    legacySettingKey: 'entity_aliases_v1',
+    idOf: (item) => item.id,
+    toJson: (item) => item.toJson(),
+    fromJson: EntityAlias.fromJson,
+    keyOf: (item) => item.aliasText.trim().toLowerCase(),
+    updatedAtOf: (item) => item.createdAt,
+  );
+
+  static final entityRelations = MemoryRecordCollection<EntityRelation>(
+    name: 'entity_relation',
+    legacySettingKey: 'entity_relations_v1',
+    idOf: (item) => item.id,
+    toJson: (item) => item.toJson(),
+    fromJson: EntityRelation.fromJson,
+    keyOf: (item) =>
+        '${item.sourceEntityId}|${item.relationType}|${item.targetEntityId}',
+  );
+
+  static final entityEvidences = MemoryRecordCollection<EntityEvidence>(
+    name: 'entity_evidence',
+    legacySettingKey: 'entity_evidences_v1',
+    idOf: (item) => item.id,
+    toJson: (item) => item.toJson(),
+    fromJson: EntityEvidence.fromJson,
+    keyOf: (item) => item.entityId,
+    updatedAtOf: (item) => item.createdAt,
+  );
+
+  static final memoryItems = MemoryRecordCollection<MemoryItem>(
+    name: 'memory_item',
+    legacySettingKey: 'adaptive_memory_items_v1',
+    idOf: (item) => item.id,
+    toJson: (item) => item.toJson(),
+    fromJson: MemoryItem.fromJson,
+    keyOf: (item) => item.normalizedKey,
+    enabledOf: (item) => item.status != MemoryItemStatus.archived,
+    updatedAtOf: (item) => item.updatedAt,
+  );
+
+  static final memoryEvents = MemoryRecordCollection<MemoryEvent>(
+    name: 'memory_event',
+    legacySettingKey: 'memory_events_v1',
+    idOf: (item) => item.id,
+    toJson: (item) => item.toJson(),
+    fromJson: MemoryEvent.fromJson,
+    keyOf: (item) => item.memoryId ?? '',
+    updatedAtOf: (item) => item.createdAt,
+  );
+}
+
+/// 按行持久化一类模型列表。
+///
+/// 记住上次加载/保存时每个 id 对应的模型实例；模型均为不可变对象，
+/// 因此保存时只需按实例比较即可得到新增、修改与删除的行，
+/// 写入代价与变更数量成正比，而不是重写整个列表。
+///
+/// 列表顺序通过 `seq` 列保存，序号间隔 [seqStride]。旧序号沿列表顺序
+/// 最长的递增子序列保持不动，新条目与移动过的条目取前后相邻条目序号
+/// 之间的空位（首尾之外直接延伸），因此调整顺序只重写移动的行；
+/// 空位用尽时才按列表位置重排全部序号。
+class MemoryRecordStore<T extends Object> {
+  final MemoryRecordCollection<T> collection;
+
+  MemoryRecordStore(this.collection);
+
+  /// 相邻条目的序号间隔，为中间插入的新条目预留空位。
+  static const int seqStride = 1 << 10;
+
+  Map<String, _PersistedRecord<T>> _persisted = {};
+
+  /// 读取集合；没有任何行且存在旧版 JSON 时先迁移。
+  ///
+  /// 既无行也无旧版数据时返回 null，便于调用方执行更早版本的兼容逻辑。
+  /// 调用方已批量读出全部配置时可传入 [settings]，省去逐键查询旧版数据。
+  Future<List<T>?> load(AppDatabase db, {Map<String, String>? settings}) async {
+    final legacyJson = settings != null
+        ? settings[collection.legacySettingKey]
+        : await db.getSetting(collection.legacySettingKey);
+    var records = await db.getMemoryRecords(collection.name);
+    if (records.isEmpty) {
+      if (legacyJson == null) {
+        _persisted = {};
+        return null;
+      }
+      await _migrateLegacy(db, legacyJson);
+      records = await db.getMemoryRecords(collection.name);
+    } else if (legacyJson != null) {
+      // 上次迁移已写入行但未来得及删除旧键。
+      await db.removeSetting(collection.legacySettingKey);
+    }
+
+    final decoded = await collection.decodeAll(records);
+    final items = <T>[];
+    final loaded = <String, _PersistedRecord<T>>{};
+    for (var i = 0; i < records.length; i++) {
+      final item = decoded[i];
+      if (item == null) continue;
+      items.add(item);
+      loaded[collection.idOf(item)] = _PersistedRecord(item, records[i].seq);
+    }
+    _persisted = loaded;
+    return items;
+  }
+
+  /// 将 [items] 与上次持久化的状态比对，只写入变化的行。
+  ///
+  /// 写入成功后才更新比对基准，失败的变更会在下次保存时重新写入。
+  Future<void> save(AppDatabase db, List<T> items) async {
+    final previous = _persisted;
+    final unique = <T>[];
+    final ids = <String>[];
+    final seen = <String>{};
+    for (final item in items) {
+      final id = collection.idOf(item);
+      if (id.isEmpty || !seen.add(id)) continue;
+      unique.add(item);
+      ids.add(id);
+    }
+
+    final seqs =
+        _placeSeqs(ids, previous) ??
+        [for (var i = 0; i < ids.length; i++) i * seqStride];
+    final next = <String, _PersistedRecord<T>>{};
+    final upserts = <MemoryRecordEntity>[];
+    for (var i = 0; i < unique.length; i++) {
+      final item = unique[i];
+      final old = previous[ids[i]];
+      if (old != null && identical(old.item, item) && old.seq == seqs[i]) {
+        next[ids[i]] = old;
+        continue;
+      }
+      upserts.add(collection.toRecord(item, seqs[i]));
+      next[ids[i]] = _PersistedRecord(item, seqs[i]);
+    }
+
+    final deletedIds = [
+      for (final id in previous.keys)
+        if (!next.containsKey(id)) id,
+    ];
+    await db.applyMemoryRecordChanges(
+      collection.name,
+      upserts: upserts,
+      deletedIds: deletedIds,
+    );
+    _persisted = next;
+  }
+
+  /// 保持旧序号最长递增子序列上的条目不变，为其余条目分配空位的序号；
+  /// 空位不足时返回 null，由调用方整体重排。
+  static List<int>? _placeSeqs<T>(
+    List<String> ids,
+    Map<String, _PersistedRecord<T>> previous,
+  ) {
+    final seqs = List<int?>.filled(ids.length, null);
+    for (final i in _longestIncreasingRun(ids, previous)) {
+      seqs[i] = previous[ids[i]]!.seq;
+    }
+
+    var i = 0;
+    while (i < ids.length) {
+      if (seqs[i] != null) {
+        i++;
+        continue;
+      }
+      var j = i;
+      while (j < ids.length && seqs[j] == null) {
+        j++;
+      }
+      final count = j - i;
+      final lower = i == 0 ? null : seqs[i - 1];
+      final upper = j == ids.length ? null : seqs[j];
+      var step = seqStride;
+      final int first;
+      if (lower == null) {
+        first = upper == null ? 0 : upper - count * step;
+      } else if (upper == null) {
+        first = lower + step;
+      } else {
+        step = (upper - lower) ~/ (count + 1);
+        if (step < 1) return null;
+        first = lower + step;
+      }
+      for (var k = 0; k < count; k++) {
+        seqs[i + k] = first + k * step;
+      }
+      i = j;
+    }
+    return [for (final seq in seqs) seq!];
+  }
+
+  /// 按列表顺序求旧序号严格递增的最长子序列，返回其列表位置（升序）。
+  static List<int> _longestIncreasingRun<T>(
+    List<String> ids,
+    Map<String, _PersistedRecord<T>> previous,
+  ) {
+    final positions = <int>[];
+    final oldSeqs = <int>[];
+    for (var i = 0; i < ids.length; i++) {
+      final old = previous[ids[i]];
+      if (old == null) continue;
+      positions.add(i);
+      oldSeqs.add(old.seq);
+    }
+
+    // tails[k]：长度为 k + 1 的递增子序列中末尾序号最小者的下标。
+    final tails = <int>[];
+    final parents = List<int>.filled(oldSeqs.length, -1);
+    for (var n = 0; n < oldSeqs.length; n++) {
+      var lo = 0;
+      var hi = tails.length;
+      while (lo < hi) {
+        final mid = (lo + hi) >> 1;
+        if (oldSeqs[tails[mid]] < oldSeqs[n]) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      if (lo > 0) parents[n] = tails[lo - 1];
+      if (lo == tails.length) {
+        tails.add(n);
+      } else {
+        tails[lo] = n;
+      }
+    }
+
+    final run = List<int>.filled(tails.length, 0);
+    var n = tails.isEmpty ? -1 : tails.last;
+    for (var k = tails.length - 1; k >= 0; k--) {
+      run[k] = positions[n];
+      n = parents[n];
+    }
+    return run;
+  }
+
+  Future<void> _migrateLegacy(AppDatabase db, String legacyJson) async {
+    final records = <MemoryRecordEntity>[];
+    final seen = <String>{};
+    try {
+      final list = json.decode(legacyJson) as List<dynamic>;
+      for (final raw in list.whereType<Map<String, dynamic>>()) {
+        try {
+          final item = collection.fromJson(raw);
+          final id = collection.idOf(item);
+          if (id.isEmpty || !seen.add(id)) continue;
+          records.add(
+            collection.toRecord(item, records.length * seqStride),
+          );
+        } catch (_) {}
+      }
+    } catch (_) {}
+    await db.replaceMemoryRecords(collection.name, records);
+    await db.removeSetting(collection.legacySettingKey);
+  }
+}
+
+class _PersistedRecord<T> {
+  final T item;
+  final int seq;
+
+  const _PersistedRecord(this.item, this.seq);
+}
@@ -1,20 +1,165 @@
+import 'dart:async';
 import 'dart:io';
 import 'package:http/http.dart' as http;
 import 'package:http/io_client.dart';
 import '../models/network_settings.dart';
 
+/// 进程级 HTTP 连接池。
+///
+/// 每个（代理模式，源站）共用一个 [HttpClient]，请求结束后连接保持
+/// keep-alive，后续分段 STT、纠错与增强请求复用已完成的 DNS / TCP / TLS
+/// 握手。空闲超过 [connectionIdleTimeout] 的连接由 [HttpClient] 关闭；
+/// 超过 [clientIdleEviction] 未使用的源站整体回收。
+///
+/// [createClient] 返回的客户端 `close()` 不会断开池中的连接，调用方
+/// 可以照旧在 finally 中关闭。dart:io 的 [HttpClient] 只支持 HTTP/1.1。
 class NetworkClientService {
   static NetworkProxyMode _proxyMode = NetworkProxyMode.none;
 
+  /// 略短于常见服务端的 keep-alive 超时，避免复用已被对端关闭的连接。
+  static const Duration connectionIdleTimeout = Duration(seconds: 45);
+  static const Duration clientIdleEviction = Duration(minutes: 10);
+  static const Duration connectTimeout = Duration(seconds: 10);
+  static const Duration _preconnectTimeout = Duration(seconds: 5);
+
+  static final Map<String, _OriginPool> _pools = {};
+  static const Symbol _abortTriggerKey = #networkAbortTrigger;
+
   static void setProxyMode(NetworkProxyMode mode) {
+    if (mode == _proxyMode) return;
     _proxyMode = mode;
+    closeAll();
+  }
+
+  /// 基于连接池的 [http.Client]。
+  static http.Client createClient() => _PooledClient();
+
+  /// [uri] 所在源站的共享 [HttpClient]，用于需要直接读取响应流的场景。
+  /// 调用方不要关闭它。
+  static HttpClient httpClientFor(Uri uri) =>
+      (_poolFor(uri)..touch()).client;
+
+  /// 预先与 [baseUrls] 的源站建立连接（完成 TCP 与 TLS 握手），
+  /// 让录音结束后的首个请求不再承担握手耗时。
+  ///
+  /// 最近仍有请求、连接大概率还在池中的源站会跳过；失败静默忽略。
+  static Future<void> preconnect(Iterable<String> baseUrls) async {
+    final origins = <String, Uri>{};
+    for (final baseUrl in baseUrls) {
+      final uri = Uri.tryParse(baseUrl.trim());
+      if (uri == null || uri.host.isEmpty) continue;
+      if (uri.scheme != 'http' && uri.scheme != 'https') continue;
+      final origin = Uri(scheme: uri.scheme, host: uri.host, port: uri.port);
+      origins[origin.toString()] = origin;
+    }
+    await Future.wait(origins.values.map(_warm));
+  }
+
+  /// 执行 [body]；其间经由 [createClient] 发出的请求在 [abortTrigger]
+  /// 完成时中止，并抛出 [http.RequestAbortedException]。
+  static R runAbortable<R>(Future<void> abortTrigger, R Function() body) {
+    return runZoned(body, zoneValues: {_abortTriggerKey: abortTrigger});
+  }
+
+  /// 关闭全部连接池；进行中的请求会正常完成。
+  static void closeAll() {
+    for (final pool in _pools.values) {
+      pool.client.close();
+    }
+    _pools.clear();
+  }
+
+  static Future<void> _warm(Uri origin) async {
+    final pool = _poolFor(origin);
+    final last = pool.lastRequestAt;
+    if (last != null &&
+        DateTime.now().difference(last) < connectionIdleTimeout) {
+      return;
+    }
+    pool.touch();
+    try {
+      final request = await pool.client
+          .openUrl('HEAD', origin.replace(path: '/'))
+          .timeout(_preconnectTimeout);
+      final response = await request.close().timeout(_preconnectTimeout);
+      await response.drain<void>();
+    } catch (_) {
+      pool.lastRequestAt = null;
+    }
+  }
+
+  static _OriginPool _poolFor(Uri uri) {
+    final now = DateTime.now();
+    _pools.removeWhere((_, pool) {
+      final idle = now.difference(pool.lastUsedAt) > clientIdleEviction;
+      if (idle) pool.client.close();
+      return idle;
+    });
+    final key = '${_proxyMode.name}|${uri.scheme}://${uri.host}:${uri.port}';
+    final pool = _pools.putIfAbsent(key, () => _OriginPool(_newHttpClient()));
+    pool.lastUsedAt = now;
+    return pool;
   }
 
-  static http.Client createClient() {
-    final ioHttpClient = HttpClient();
+  static HttpClient _newHttpClient() {
+    final client = HttpClient()
+      ..idleTimeout = connectionIdleTimeout
+      ..connectionTimeout = connectTimeout;
     if (_proxyMode == NetworkProxyMode.none) {
-      ioHttpClient.findProxy = (_) => 'DIRECT';
+      client.findProxy = (_) => 'DIRECT';
     }
-    return IOClient(ioHttpClient);
+    return client;
   }
 }
+
+class _OriginPool {
+  final HttpClient client;
+  final IOClient ioClient;
+  DateTime lastUsedAt = DateTime.now();
+
+  /// 最近一次经由该池发出请求的时间。
+  DateTime? lastRequestAt;
+
+  _OriginPool(this.client) : ioClient = IOClient(client);
+
+  void touch() => lastRequestAt = DateTime.now();
+}
+
+class _PooledClient extends http.BaseClient {
+  @override
+  Future<http.StreamedResponse> send(http.BaseRequest request) {
+    final pool = NetworkClientService._poolFor(request.url)..touch();
+    final abortTrigger =
+        Zone.current[NetworkClientService._abortTriggerKey] as Future<void>?;
+    if (abortTrigger == null || request is http.Abortable) {
+      return pool.ioClient.send(request);
+    }
+    return pool.ioClient.send(_abortable(request, abortTrigger));
+  }
+
+  /// 把 [request] 转成可中止的流式请求，请求体原样转发。
+  static http.BaseRequest _abortable(
+    http.BaseRequest request,
+    Future<void> abortTrigger,
+  ) {
+    // finalize 会补齐 multipart boundary 等头部，需先于复制头部调用。
+    final body = request.finalize();
+    final copy = http.AbortableStreamedRequest(
+      request.method,
+      request.url,
+      abortTrigger: abortTrigger,
+    );
+    copy.headers.addAll(request.headers);
+    copy
+      ..contentLength = request.contentLength
+      ..followRedirects = request.followRedirects
+      ..maxRedirects = request.maxRedirects
+      ..persistentConnection = request.persistentConnection;
+    body.pipe(copy.sink).ignore();
+    return copy;
+  }
+
+  /// 连接归连接池所有，这里不关闭。
+  @override
+  void close() {}
+}
@@ -2,6 +2,7 @@ import 'dart:io';
 
 import 'package:flutter/services.dart';
 import 'log_service.dart';
+import 'pipeline_tracer.dart';
 
 /// 与原生 overlay 窗口通信的服务（支持 macOS 和 Windows）
 class OverlayService {
@@ -21,10 +22,23 @@ class OverlayService {
   )?
   onGlobalKeyEvent;
 
+  /// 最近一次全局快捷键事件在原生侧产生的时间，已换算到
+  /// [PipelineTracer.nowUs] 的时基；原生侧未提供时为 null。在调用
+  /// [onGlobalKeyEvent] 之前更新。
+  static int? lastGlobalKeyEventUs;
+
+  /// 原生侧绕过 Flutter 退出请求直接关闭应用（Windows 托盘「退出」）前
+  /// 调用，完成后原生侧才销毁窗口。
+  static Future<void> Function()? onPrepareExit;
+
   static void init() {
     LogService.info('OVERLAY', 'init: setting method call handler');
     _channel.setMethodCallHandler((call) async {
       LogService.info('OVERLAY', 'received native call: ${call.method}');
+      if (call.method == 'prepareExit') {
+        await onPrepareExit?.call();
+        return;
+      }
       if (call.method == 'onGlobalKeyEvent') {
         final args = call.arguments as Map;
         final keyCode = args['keyCode'] as int;
@@ -32,6 +46,10 @@ class OverlayService {
         final isRepeat = args['isRepeat'] as bool;
         final hasModifiers = args['hasModifiers'] as bool? ?? false;
         final modifiers = args['modifiers'] as int? ?? 0;
+        final timestampUs = args['timestampUs'] as int?;
+        lastGlobalKeyEventUs = timestampUs == null
+            ? null
+            : PipelineTracer.fromEpochUs(timestampUs);
         final hasCallback = onGlobalKeyEvent != null;
         LogService.info(
           'OVERLAY',
@@ -36,6 +36,15 @@ class PinyinMatcher {
   /// 原始词字面索引：用于快速精确匹配
   final Map<String, List<DictionaryEntry>> _literalIndex = {};
 
+  List<DictionaryEntry> _indexedEntries = const [];
+  int _indexVersion = 0;
+
+  /// 索引版本号，每次 [buildIndex] 后递增，供下游缓存判断词典是否变更。
+  int get indexVersion => _indexVersion;
+
+  /// 当前索引中的已启用条目。
+  List<DictionaryEntry> get indexedEntries => _indexedEntries;
+
   /// 构建 / 重建拼音索引。
   ///
   /// 仅索引已启用的条目。应在词典变更后调用。
@@ -44,9 +53,11 @@ class PinyinMatcher {
     _literalIndex.clear();
     _fuzzyBucketIndex.clear();
     _allPinyinKeys.clear();
+    final indexed = <DictionaryEntry>[];
 
     for (final entry in entries) {
       if (!entry.enabled) continue;
+      indexed.add(entry);
 
       // 1. 精确字面索引（original 原文）
       final lowerOriginal = entry.original.trim().toLowerCase();
@@ -74,6 +85,9 @@ class PinyinMatcher {
         }
       }
     }
+
+    _indexedEntries = List.unmodifiable(indexed);
+    _indexVersion++;
   }
 
   /// 在输入文本中查找所有与词典匹配的条目。
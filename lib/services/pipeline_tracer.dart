@@ -0,0 +1,280 @@
+import 'dart:async';
+import 'dart:collection';
+import 'dart:convert';
+
+import '../database/app_database.dart';
+import '../database/latency_bucket_entity.dart';
+import 'latency_histogram.dart';
+
+/// 听写流水线的阶段名，同时用作直方图的 `stage` 列。
+class PipelineStage {
+  PipelineStage._();
+
+  /// 原生快捷键事件到 Dart 侧开始停止录音。
+  static const String hotkey = 'hotkey';
+
+  /// 停止录音器并拿到最后一段音频文件。
+  static const String recorderStop = 'recorder_stop';
+
+  /// 最后一段入队到全部分段转写、纠错完成。
+  static const String segmentWait = 'segment_wait';
+
+  /// 单个分段的 STT 请求。
+  static const String stt = 'stt';
+
+  /// 单个分段的纠错：只做了本地匹配 / 调用了 LLM。
+  static const String correctionLocal = 'correction_local';
+  static const String correctionLlm = 'correction_llm';
+
+  /// 终态段落级回溯纠错。
+  static const String retroCorrection = 'retro_correction';
+
+  /// AI 增强：首个流式片段 / 完整结果。
+  static const String enhanceFirstToken = 'enhance_first_token';
+  static const String enhance = 'enhance';
+
+  /// 将最终文本写入前台应用。
+  static const String insertText = 'insert_text';
+
+  /// 松开快捷键（或触发停止）到文本写入完成。
+  static const String endToEnd = 'end_to_end';
+
+  /// 启动里程碑，均自进入 main() 起计时：首帧渲染、核心设置就绪、
+  /// 已加载的快捷键注册成功、全部设置与记忆数据加载完成。
+  static const String startupFirstFrame = 'startup_first_frame';
+  static const String startupSettings = 'startup_settings';
+  static const String startupHotkeyReady = 'startup_hotkey_ready';
+  static const String startupSettingsLoaded = 'startup_settings_loaded';
+
+  /// 仪表盘展示顺序。
+  static const List<String> all = [
+    hotkey,
+    recorderStop,
+    segmentWait,
+    stt,
+    correctionLocal,
+    correctionLlm,
+    retroCorrection,
+    enhanceFirstToken,
+    enhance,
+    insertText,
+    endToEnd,
+    startupFirstFrame,
+    startupSettings,
+    startupHotkeyReady,
+    startupSettingsLoaded,
+  ];
+}
+
+/// 一次听写会话的追踪，收集各阶段的时间区间。
+class PipelineTrace {
+  final int id;
+  final String label;
+  final PipelineTracer _tracer;
+  final List<_SpanRecord> _spans = [];
+
+  PipelineTrace._(this.id, this.label, this._tracer);
+
+  /// 记录阶段 [stage] 从 [startUs] 到 [endUs]（默认当前时间）的区间，
+  /// 时间为 [PipelineTracer.nowUs] 的时基；同时计入当天的直方图。
+  void record(
+    String stage,
+    int startUs, {
+    int? endUs,
+    Map<String, Object?>? args,
+  }) {
+    final end = endUs ?? PipelineTracer.nowUs();
+    final duration = end > startUs ? end - startUs : 0;
+    _spans.add(_SpanRecord(stage, startUs, duration, args));
+    _tracer._recordSample(stage, duration);
+  }
+}
+
+/// 听写流水线的轻量追踪与分阶段耗时统计。
+///
+/// 每个阶段结束时把耗时计入内存中的 [LatencyHistogram]，按天汇总后
+/// 在 [flushDelay] 后或显式 [flush] 时以桶增量写入 `latency_buckets` 表。
+/// 最近 [retainedTraces] 次会话的完整区间保留在内存中，可导出为
+/// Chrome trace JSON（chrome://tracing 或 Perfetto 打开）做离线分析。
+class PipelineTracer {
+  PipelineTracer._();
+  static final instance = PipelineTracer._();
+
+  static const Duration flushDelay = Duration(seconds: 5);
+  static const int retainedTraces = 50;
+
+  /// 直方图保留天数，更早的桶在每次启动后的首次落盘时清理。
+  static const int retentionDays = 90;
+
+  // 时基以启动时的 Unix 纪元微秒为起点、由单调时钟推进，不受运行中的
+  // 系统时间调整影响；因此休眠或对时后会与系统时间产生偏差，原生侧的
+  // 墙钟时间戳须经 [fromEpochUs] 换算后才能与之比较。
+  static final int _epochAnchorUs = DateTime.now().microsecondsSinceEpoch;
+  static final Stopwatch _clock = Stopwatch()..start();
+
+  /// 当前时间（追踪时基，微秒）。
+  static int nowUs() => _epochAnchorUs + _clock.elapsedMicroseconds;
+
+  /// 把墙钟时间戳 [epochUs]（Unix 纪元微秒，如原生快捷键事件）换算到
+  /// [nowUs] 的时基：按它距当前墙钟的间隔向前推算。应在收到时间戳后
+  /// 立即换算，间隔越短越不受期间系统时间调整的影响。
+  static int fromEpochUs(int epochUs) =>
+      nowUs() - (DateTime.now().microsecondsSinceEpoch - epochUs);
+
+  final ListQueue<PipelineTrace> _recent = ListQueue();
+  int _nextTraceId = 1;
+
+  final Map<String, Map<String, LatencyHistogram>> _pending = {};
+  Timer? _flushTimer;
+  Future<void>? _flushing;
+  bool _pruned = false;
+
+  PipelineTrace? _startupTrace;
+  int _startupOriginUs = 0;
+  final Set<String> _startupMarked = {};
+
+  /// 开始一次会话追踪。
+  PipelineTrace begin({String label = 'dictation'}) {
+    final trace = PipelineTrace._(_nextTraceId++, label, this);
+    _recent.addLast(trace);
+    while (_recent.length > retainedTraces) {
+      _recent.removeFirst();
+    }
+    return trace;
+  }
+
+  /// 在 main() 入口调用，作为各启动里程碑的计时起点。
+  void beginStartup() {
+    _startupOriginUs = nowUs();
+    _startupTrace = begin(label: 'startup');
+  }
+
+  /// 记录启动里程碑 [stage]；每个里程碑只记录第一次。
+  void markStartup(String stage) {
+    final trace = _startupTrace;
+    if (trace == null || !_startupMarked.add(stage)) return;
+    trace.record(stage, _startupOriginUs);
+  }
+
+  void _recordSample(String stage, int micros) {
+    final byStage = _pending.putIfAbsent(dayKey(DateTime.now()), () => {});
+    byStage.putIfAbsent(stage, LatencyHistogram.new).record(micros);
+    _flushTimer ??= Timer(flushDelay, () {
+      _flushTimer = null;
+      unawaited(flush());
+    });
+  }
+
+  /// 将待写入的直方图增量写入数据库；写入失败时增量保留到下一轮。
+  Future<void> flush() async {
+    _flushTimer?.cancel();
+    _flushTimer = null;
+    while (_flushing != null) {
+      await _flushing;
+    }
+    if (_pending.isEmpty) return;
+
+    final pending = Map.of(_pending);
+    _pending.clear();
+    final deltas = <LatencyBucketEntity>[];
+    pending.forEach((day, byStage) {
+      byStage.forEach((stage, histogram) {
+        histogram.buckets.forEach((bucket, count) {
+          deltas.add(
+            LatencyBucketEntity(
+              day: day,
+              stage: stage,
+              bucket: bucket,
+              count: count,
+            ),
+          );
+        });
+      });
+    });
+
+    final completer = Completer<void>();
+    _flushing = completer.future;
+    try {
+      final db = await AppDatabase.getInstance();
+      await db.addLatencyBuckets(deltas);
+      if (!_pruned) {
+        _pruned = true;
+        await db.pruneLatencyBuckets(
+          dayKey(
+            DateTime.now().subtract(const Duration(days: retentionDays)),
+          ),
+        );
+      }
+    } catch (_) {
+      pending.forEach((day, byStage) {
+        final target = _pending.putIfAbsent(day, () => {});
+        byStage.forEach((stage, histogram) {
+          target.putIfAbsent(stage, LatencyHistogram.new).merge(histogram);
+        });
+      });
+    } finally {
+      _flushing = null;
+      completer.complete();
+    }
+  }
+
+  /// 读取 [since]（含）以来各阶段合并后的直方图（先落盘待写增量）。
+  Future<Map<String, LatencyHistogram>> readHistograms(DateTime since) async {
+    await flush();
+    final db = await AppDatabase.getInstance();
+    final result = <String, LatencyHistogram>{};
+    for (final row in await db.getLatencyBucketsSince(dayKey(since))) {
+      result
+          .putIfAbsent(row.stage, LatencyHistogram.new)
+          .addToBucket(row.bucket, row.count);
+    }
+    return result;
+  }
+
+  /// 最近会话中是否有可导出的区间。
+  bool get hasTraces => _recent.any((trace) => trace._spans.isNotEmpty);
+
+  /// 将最近的会话导出为 Chrome trace JSON，每次会话占一条轨道。
+  String exportChromeTrace() {
+    final events = <Map<String, Object?>>[];
+    for (final trace in _recent) {
+      if (trace._spans.isEmpty) continue;
+      events.add({
+        'name': 'thread_name',
+        'ph': 'M',
+        'pid': 1,
+        'tid': trace.id,
+        'args': {'name': '${trace.label} #${trace.id}'},
+      });
+      for (final span in trace._spans) {
+        events.add({
+          'name': span.stage,
+          'cat': 'pipeline',
+          'ph': 'X',
+          'ts': span.startUs,
+          'dur': span.durationUs,
+          'pid': 1,
+          'tid': trace.id,
+          if (span.args != null) 'args': span.args,
+        });
+      }
+    }
+    return json.encode({'traceEvents': events, 'displayTimeUnit': 'ms'});
+  }
+
+  /// 本地日期 `yyyy-MM-dd`，与历史汇总表的日期格式一致。
+  static String dayKey(DateTime time) {
+    final m = time.month.toString().padLeft(2, '0');
+    final d = time.day.toString().padLeft(2, '0');
+    return '${time.year}-$m-$d';
+  }
+}
+
+class _SpanRecord {
+  final String stage;
+  final int startUs;
+  final int durationUs;
+  final Map<String, Object?>? args;
+
+  const _SpanRecord(this.stage, this.startUs, this.durationUs, this.args);
+}
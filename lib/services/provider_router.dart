@@ -0,0 +1,264 @@
+import 'dart:async';
+
+import '../models/ai_enhance_config.dart';
+import '../models/provider_config.dart';
+import 'log_service.dart';
+
+/// 路由候选：[key] 标识服务（见 `RequestHedger.keyFor`），[isLocal] 表示
+/// 本地模型，只在云端候选全部熔断时才会被选中。
+class RouteCandidate<C> {
+  final String key;
+  final C config;
+  final bool isLocal;
+
+  const RouteCandidate(this.key, this.config, {this.isLocal = false});
+}
+
+enum CircuitState { closed, open, halfOpen }
+
+/// 单个服务的健康状况。
+class ProviderHealth {
+  /// 成功请求耗时的指数滑动平均（毫秒），尚无样本时为 null。
+  double? ewmaLatencyMs;
+
+  /// 失败率的指数滑动平均（0~1）。
+  double errorRate = 0;
+
+  /// 流式请求首字延迟的指数滑动平均（毫秒），尚无样本时为 null。
+  double? ewmaFirstTokenMs;
+
+  /// 流式请求输出速度的指数滑动平均（token/秒），尚无样本时为 null。
+  double? ewmaTokensPerSecond;
+
+  int consecutiveFailures = 0;
+  int timeouts = 0;
+  int openCount = 0;
+  DateTime? openUntil;
+  bool probing = false;
+
+  CircuitState stateAt(DateTime now) {
+    final until = openUntil;
+    if (until == null) return CircuitState.closed;
+    return now.isBefore(until) ? CircuitState.open : CircuitState.halfOpen;
+  }
+}
+
+/// 按服务健康度在用户偏好的候选间路由请求。
+///
+/// 每个服务记录耗时与失败率的 EWMA；连续失败 [failureThreshold] 次后
+/// 熔断 [openDuration]，之后放行一个探测请求：成功即恢复，失败则熔断
+/// 时长翻倍（至多 [maxOpenDuration]）。
+///
+/// 排序时云端候选按 `EWMA 耗时 ×（1 + 失败率）` 打分（流式请求取首字
+/// 延迟的 EWMA），偏好列表中每靠后一位加 [preferencePenalty] 的惩罚，
+/// 尚无耗时数据的候选只在首选位上参与竞争；本地模型排在所有可用云端
+/// 候选之后，熔断中的候选放在最后兜底。请求失败时依次换下一个可用
+/// 候选，至多尝试 [maxAttempts] 个；只要还有云端候选未熔断，就不换到
+/// 本地模型。
+class ProviderRouter {
+  static final instance = ProviderRouter();
+
+  static const double _latencyAlpha = 0.3;
+  static const double _errorAlpha = 0.2;
+
+  final int failureThreshold;
+  final Duration openDuration;
+  final Duration maxOpenDuration;
+  final double preferencePenalty;
+  final int maxAttempts;
+  final DateTime Function() _now;
+
+  /// 是否在多个候选间路由；关闭时只用当前服务，但仍记录健康度。
+  bool enabled = false;
+
+  /// 当前语音识别服务之外、按用户顺序排列的备选服务。
+  List<SttProviderConfig> sttFallbacks = const [];
+
+  /// 当前文本模型之外的备选端点；只取其 baseUrl / apiKey / model。
+  List<AiEnhanceConfig> aiFallbacks = const [];
+
+  final Map<String, ProviderHealth> _health = {};
+
+  ProviderRouter({
+    this.failureThreshold = 3,
+    this.openDuration = const Duration(seconds: 30),
+    this.maxOpenDuration = const Duration(minutes: 5),
+    this.preferencePenalty = 0.15,
+    this.maxAttempts = 3,
+    DateTime Function()? now,
+  }) : _now = now ?? DateTime.now;
+
+  ProviderHealth healthOf(String key) =>
+      _health.putIfAbsent(key, ProviderHealth.new);
+
+  /// 按当前健康度排序的候选；[preference] 的第一个为用户首选。
+  ///
+  /// [byFirstToken] 为 true 时（流式请求）以首字延迟代替完整耗时打分。
+  List<RouteCandidate<C>> rank<C>(
+    List<RouteCandidate<C>> preference, {
+    bool byFirstToken = false,
+  }) {
+    final now = _now();
+    final cloud = <(double, int)>[];
+    final local = <int>[];
+    final unavailable = <int>[];
+    for (var i = 0; i < preference.length; i++) {
+      final candidate = preference[i];
+      final health = healthOf(candidate.key);
+      if (!_isAvailable(health, now)) {
+        unavailable.add(i);
+      } else if (candidate.isLocal) {
+        local.add(i);
+      } else {
+        cloud.add((_scoreOf(health, i, byFirstToken: byFirstToken), i));
+      }
+    }
+    cloud.sort((a, b) {
+      final byScore = a.$1.compareTo(b.$1);
+      return byScore != 0 ? byScore : a.$2.compareTo(b.$2);
+    });
+    return [
+      for (final (_, i) in cloud) preference[i],
+      for (final i in local) preference[i],
+      for (final i in unavailable) preference[i],
+    ];
+  }
+
+  /// 依健康度选择候选执行 [attempt]，失败时换下一个可用候选。
+  ///
+  /// 所有候选都失败时抛出第一个错误。
+  Future<T> run<C, T>(
+    List<RouteCandidate<C>> preference,
+    Future<T> Function(C config) attempt,
+  ) async {
+    assert(preference.isNotEmpty);
+    final ranked = rank(preference);
+    Object? firstError;
+    StackTrace? firstStack;
+    var attempts = 0;
+    for (final candidate in ranked) {
+      final health = healthOf(candidate.key);
+      final now = _now();
+      // 熔断中的候选只在没有其他可尝试的服务时兜底。
+      if (attempts > 0 && !_isAvailable(health, now)) break;
+      // 云端偶发失败不换到本地模型，云端全部熔断时才由本地接替。
+      if (attempts > 0 &&
+          candidate.isLocal &&
+          preference.any(
+            (c) => !c.isLocal && _isAvailable(healthOf(c.key), now),
+          )) {
+        continue;
+      }
+      if (health.stateAt(now) == CircuitState.halfOpen) health.probing = true;
+      attempts++;
+      final clock = Stopwatch()..start();
+      try {
+        final result = await attempt(candidate.config);
+        recordSuccess(candidate.key, clock.elapsed);
+        return result;
+      } catch (e, st) {
+        recordFailure(candidate.key, timeout: e is TimeoutException);
+        firstError ??= e;
+        firstStack ??= st;
+        if (attempts >= maxAttempts) break;
+        if (attempts < ranked.length) {
+          LogService.warn(
+            'ROUTER',
+            'request failed on ${candidate.key}, failing over: $e',
+          );
+        }
+      }
+    }
+    Error.throwWithStackTrace(firstError!, firstStack!);
+  }
+
+  void recordSuccess(String key, Duration elapsed) {
+    final health = healthOf(key);
+    health
+      ..ewmaLatencyMs = _smooth(
+        health.ewmaLatencyMs,
+        elapsed.inMicroseconds / 1000,
+      )
+      ..errorRate = health.errorRate * (1 - _errorAlpha)
+      ..consecutiveFailures = 0
+      ..openCount = 0
+      ..openUntil = null
+      ..probing = false;
+  }
+
+  /// 记录一次完整结束的流式请求：[total] 计入耗时与成功率，首字延迟
+  /// [firstToken] 与输出速度 [tokensPerSecond]（为 0 时不计）另行平滑。
+  void recordStream(
+    String key, {
+    required Duration firstToken,
+    required Duration total,
+    double tokensPerSecond = 0,
+  }) {
+    recordSuccess(key, total);
+    final health = healthOf(key);
+    health.ewmaFirstTokenMs = _smooth(
+      health.ewmaFirstTokenMs,
+      firstToken.inMicroseconds / 1000,
+    );
+    if (tokensPerSecond > 0) {
+      health.ewmaTokensPerSecond = _smooth(
+        health.ewmaTokensPerSecond,
+        tokensPerSecond,
+      );
+    }
+  }
+
+  static double _smooth(double? previous, double sample) {
+    if (previous == null) return sample;
+    return previous + _latencyAlpha * (sample - previous);
+  }
+
+  void recordFailure(String key, {bool timeout = false}) {
+    final health = healthOf(key);
+    health
+      ..errorRate = health.errorRate + _errorAlpha * (1 - health.errorRate)
+      ..consecutiveFailures += 1;
+    if (timeout) health.timeouts++;
+    final reopen = health.probing;
+    health.probing = false;
+    if (!reopen && health.consecutiveFailures < failureThreshold) return;
+    // 并发请求在熔断期间陆续失败时不重复延长熔断。
+    if (!reopen && health.stateAt(_now()) == CircuitState.open) return;
+
+    final factor = 1 << health.openCount.clamp(0, 10);
+    var duration = openDuration * factor;
+    if (duration > maxOpenDuration) duration = maxOpenDuration;
+    health
+      ..openCount += 1
+      ..openUntil = _now().add(duration);
+    LogService.warn(
+      'ROUTER',
+      'circuit open for $key ${duration.inSeconds}s '
+          'failures=${health.consecutiveFailures} timeouts=${health.timeouts}',
+    );
+  }
+
+  bool _isAvailable(ProviderHealth health, DateTime now) {
+    return switch (health.stateAt(now)) {
+      CircuitState.closed => true,
+      CircuitState.halfOpen => !health.probing,
+      CircuitState.open => false,
+    };
+  }
+
+  double _scoreOf(
+    ProviderHealth health,
+    int preferenceIndex, {
+    bool byFirstToken = false,
+  }) {
+    final latency = byFirstToken
+        ? health.ewmaFirstTokenMs
+        : health.ewmaLatencyMs;
+    if (latency == null) {
+      return preferenceIndex == 0 ? 0 : double.infinity;
+    }
+    return latency *
+        (1 + health.errorRate) *
+        (1 + preferencePenalty * preferenceIndex);
+  }
+}
@@ -0,0 +1,532 @@
+import 'dart:async';
+import 'dart:io';
+import 'dart:isolate';
+import 'dart:typed_data';
+
+import 'package:path/path.dart' as path;
+import 'package:path_provider/path_provider.dart';
+
+import 'flac_encoder.dart';
+import 'log_service.dart';
+
+/// 归档文件中的一个录音分段，按样本位置索引。
+class ArchivedSegment {
+  /// VORBIS_COMMENT 中的索引键，值为 `起始样本,样本数,原文件名`。
+  static const String commentKey = 'VOICETYPE_SEGMENT';
+
+  final String name;
+  final int startSample;
+  final int sampleCount;
+
+  const ArchivedSegment({
+    required this.name,
+    required this.startSample,
+    required this.sampleCount,
+  });
+
+  String toComment() => '$commentKey=$startSample,$sampleCount,$name';
+
+  static ArchivedSegment? parse(String comment) {
+    const prefix = '$commentKey=';
+    if (!comment.startsWith(prefix)) return null;
+    final parts = comment.substring(prefix.length).split(',');
+    if (parts.length < 3) return null;
+    final start = int.tryParse(parts[0]);
+    final count = int.tryParse(parts[1]);
+    if (start == null || count == null) return null;
+    return ArchivedSegment(
+      name: parts.sublist(2).join(','),
+      startSample: start,
+      sampleCount: count,
+    );
+  }
+
+  /// 读取归档文件中的分段索引；不是归档文件时返回空列表。
+  static List<ArchivedSegment> readIndex(Uint8List bytes) {
+    final comments = FlacEncoder.readComments(bytes) ?? const [];
+    return [
+      for (final comment in comments)
+        if (parse(comment) case final segment?) segment,
+    ];
+  }
+}
+
+/// 一次归档的结果。
+class RecordingArchiveResult {
+  /// 已写入归档、可以删除的源文件。
+  final List<String> archived;
+
+  /// 生成的归档文件。
+  final List<String> outputs;
+
+  final int inputBytes;
+  final int outputBytes;
+
+  const RecordingArchiveResult({
+    this.archived = const [],
+    this.outputs = const [],
+    this.inputBytes = 0,
+    this.outputBytes = 0,
+  });
+}
+
+/// `recordings/` 目录的后台归档与保留策略。
+///
+/// 录音器把每个分段写成 16 kHz PCM WAV。会话结束后，本服务把该会话的
+/// 分段无损转码为 FLAC 并合并为一个文件，分段索引写在 VORBIS_COMMENT
+/// 中（见 [ArchivedSegment]），然后删除源 WAV；未能随会话提交的遗留 WAV
+/// 按修改时间聚成会话后一并归档。之后按 [maxAge] 与 [maxTotalBytes]
+/// 从最旧的归档开始清理。
+///
+/// 转码在独立 isolate 中逐段进行，段间让出 I/O；任一会话进行中都不启动
+/// 归档，新会话开始时会中止正在进行的归档（未完成的 `.part` 文件下一轮
+/// 清除）。
+class RecordingArchiver {
+  RecordingArchiver({
+    Future<Directory> Function()? directory,
+    this.maxAge = const Duration(days: 30),
+    this.maxTotalBytes = 512 * 1024 * 1024,
+    this.idleDelay = const Duration(seconds: 20),
+  }) : _directory = directory ?? _defaultDirectory;
+
+  static final instance = RecordingArchiver();
+
+  static const String archiveExtension = '.flac';
+  static const String _partialSuffix = '.part';
+
+  /// 遗留 WAV 在最后修改后至少经过这么久才会被归档。
+  static const Duration orphanGrace = Duration(minutes: 10);
+
+  /// 遗留 WAV 修改时间相距超过该值即视为不同会话。
+  static const Duration orphanSessionGap = Duration(seconds: 30);
+
+  static const Duration _ioPause = Duration(milliseconds: 5);
+
+  final Future<Directory> Function() _directory;
+  final Duration maxAge;
+  final int maxTotalBytes;
+  final Duration idleDelay;
+
+  final List<List<String>> _queue = [];
+  final Set<int> _activeSessions = {};
+  int _lastSession = 0;
+  Timer? _timer;
+  Future<void>? _running;
+  Isolate? _worker;
+
+  /// 上一会话的转写可能与下一会话的录音重叠，全部会话结束前不归档。
+  bool get _sessionActive => _activeSessions.isNotEmpty;
+
+  /// 录音会话开始：推迟归档并中止进行中的转码，返回本会话的令牌。
+  int beginSession() {
+    final session = ++_lastSession;
+    _activeSessions.add(session);
+    _timer?.cancel();
+    _timer = null;
+    _worker?.kill(priority: Isolate.immediate);
+    return session;
+  }
+
+  /// 令牌为 [session] 的会话结束；[segmentPaths] 为该会话已转写完毕、
+  /// 可以归档的分段。已结束的令牌再次结束时忽略。
+  void endSession(int session, [List<String> segmentPaths = const []]) {
+    if (!_activeSessions.remove(session)) return;
+    if (segmentPaths.isNotEmpty) {
+      _queue.add(List.of(segmentPaths));
+    }
+    schedule();
+  }
+
+  /// 在 [delay]（默认 [idleDelay]）后执行一轮归档。
+  void schedule([Duration? delay]) {
+    if (_sessionActive) return;
+    _timer?.cancel();
+    _timer = Timer(delay ?? idleDelay, () {
+      _timer = null;
+      unawaited(run());
+    });
+  }
+
+  /// 执行一轮归档与清理；会话进行中时不做任何事。
+  Future<void> run() async {
+    while (_running != null) {
+      await _running;
+    }
+    if (_sessionActive) return;
+    final completer = Completer<void>();
+    _running = completer.future;
+    try {
+      await _runOnce();
+    } catch (e) {
+      await LogService.warn('ARCHIVE', 'archive run failed: $e');
+    } finally {
+      _running = null;
+      completer.complete();
+    }
+  }
+
+  Future<void> _runOnce() async {
+    final dir = await _directory();
+    if (!await dir.exists()) return;
+    await _deletePartials(dir);
+
+    final jobs = List.of(_queue);
+    _queue.clear();
+    jobs.addAll(await _orphanSessions(dir, queued: jobs));
+
+    for (var i = 0; i < jobs.length; i++) {
+      if (_sessionActive) {
+        _queue.insertAll(0, jobs.sublist(i));
+        return;
+      }
+      final sources = [
+        for (final source in jobs[i])
+          if (await File(source).exists()) source,
+      ];
+      if (sources.isEmpty) continue;
+
+      final result = await _archiveInWorker(sources, dir.path);
+      if (result == null) {
+        if (_sessionActive) {
+          _queue.insertAll(0, jobs.sublist(i));
+          await _deletePartials(dir);
+          return;
+        }
+        continue;
+      }
+      for (final source in result.archived) {
+        try {
+          await File(source).delete();
+        } catch (_) {}
+      }
+      if (result.outputs.isNotEmpty) {
+        await LogService.info(
+          'ARCHIVE',
+          'archived ${result.archived.length} segments into '
+              '${result.outputs.length} file(s): '
+              '${result.inputBytes} -> ${result.outputBytes} bytes',
+        );
+      }
+    }
+
+    if (!_sessionActive) await _applyRetention(dir);
+  }
+
+  Future<RecordingArchiveResult?> _archiveInWorker(
+    List<String> sources,
+    String outputDir,
+  ) async {
+    final port = ReceivePort();
+    try {
+      _worker = await Isolate.spawn(
+        _archiveEntry,
+        _ArchiveRequest(sources, outputDir, port.sendPort),
+        onExit: port.sendPort,
+        onError: port.sendPort,
+        debugName: 'recording-archiver',
+      );
+      if (_sessionActive) _worker?.kill(priority: Isolate.immediate);
+      final message = await port.first;
+      if (message is RecordingArchiveResult) return message;
+      if (message is List) {
+        await LogService.warn('ARCHIVE', 'archive worker failed: $message');
+      }
+      return null;
+    } finally {
+      _worker = null;
+      port.close();
+    }
+  }
+
+  /// 未随会话提交、且已超过 [orphanGrace] 未修改的 WAV，按修改时间聚合。
+  Future<List<List<String>>> _orphanSessions(
+    Directory dir, {
+    required List<List<String>> queued,
+  }) async {
+    final skip = {for (final job in queued) ...job};
+    final cutoff = DateTime.now().subtract(orphanGrace);
+    final files = <(String, DateTime)>[];
+    await for (final entity in dir.list()) {
+      if (entity is! File || skip.contains(entity.path)) continue;
+      if (path.extension(entity.path).toLowerCase() != '.wav') continue;
+      final modified = (await entity.stat()).modified;
+      if (modified.isBefore(cutoff)) files.add((entity.path, modified));
+    }
+    files.sort((a, b) => a.$2.compareTo(b.$2));
+
+    final sessions = <List<String>>[];
+    DateTime? previous;
+    for (final (filePath, modified) in files) {
+      if (previous == null ||
+          modified.difference(previous) > orphanSessionGap) {
+        sessions.add([]);
+      }
+      sessions.last.add(filePath);
+      previous = modified;
+    }
+    return sessions;
+  }
+
+  /// 删除超过 [maxAge] 的归档与 WAV，再从最旧的归档开始删除，
+  /// 直到归档总大小不超过 [maxTotalBytes]。
+  Future<void> _applyRetention(Directory dir) async {
+    final cutoff = DateTime.now().subtract(maxAge);
+    final archives = <(File, FileStat)>[];
+    await for (final entity in dir.list()) {
+      if (entity is! File) continue;
+      final ext = path.extension(entity.path).toLowerCase();
+      if (ext != archiveExtension && ext != '.wav') continue;
+      final stat = await entity.stat();
+      if (stat.modified.isBefore(cutoff)) {
+        await _deleteQuietly(entity);
+        continue;
+      }
+      if (ext == archiveExtension) archives.add((entity, stat));
+    }
+
+    archives.sort((a, b) => a.$2.modified.compareTo(b.$2.modified));
+    var total = archives.fold<int>(0, (sum, a) => sum + a.$2.size);
+    for (final (file, stat) in archives) {
+      if (total <= maxTotalBytes) break;
+      await _deleteQuietly(file);
+      total -= stat.size;
+    }
+  }
+
+  Future<void> _deletePartials(Directory dir) async {
+    await for (final entity in dir.list()) {
+      if (entity is File && entity.path.endsWith(_partialSuffix)) {
+        await _deleteQuietly(entity);
+      }
+    }
+  }
+
+  static Future<void> _deleteQuietly(File file) async {
+    try {
+      await file.delete();
+    } catch (_) {}
+  }
+
+  static Future<Directory> _defaultDirectory() async {
+    final dir = await getApplicationSupportDirectory();
+    return Directory(path.join(dir.path, 'recordings'));
+  }
+
+  /// 将 [sources] 依次合并转码到 [outputDir]（同步执行，供 worker 调用）。
+  ///
+  /// 相邻且格式一致的分段写入同一个归档；无法解析的文件不计入
+  /// [RecordingArchiveResult.archived]，保留原样。
+  static RecordingArchiveResult archiveSegments(
+    List<String> sources,
+    String outputDir,
+  ) {
+    final groups = <List<_WavClip>>[];
+    for (final source in sources) {
+      final clip = _WavClip.read(source);
+      if (clip == null) continue;
+      if (groups.isEmpty || !groups.last.first.sameFormat(clip)) {
+        groups.add([]);
+      }
+      groups.last.add(clip);
+    }
+
+    final archived = <String>[];
+    final outputs = <String>[];
+    var inputBytes = 0;
+    var outputBytes = 0;
+    for (final group in groups) {
+      final output = _writeArchive(group, outputDir);
+      outputs.add(output.path);
+      outputBytes += output.lengthSync();
+      for (final clip in group) {
+        archived.add(clip.path);
+        inputBytes += clip.fileSize;
+      }
+    }
+    return RecordingArchiveResult(
+      archived: archived,
+      outputs: outputs,
+      inputBytes: inputBytes,
+      outputBytes: outputBytes,
+    );
+  }
+
+  static File _writeArchive(List<_WavClip> clips, String outputDir) {
+    final first = clips.first;
+    final base = path.basenameWithoutExtension(first.path);
+    final name = clips.length == 1 ? base : '$base-${clips.length}段';
+    var target = path.join(outputDir, '$name$archiveExtension');
+    for (var n = 2; File(target).existsSync(); n++) {
+      target = path.join(outputDir, '$name-$n$archiveExtension');
+    }
+
+    final comments = <String>['TITLE=$name'];
+    var offset = 0;
+    for (final clip in clips) {
+      comments.add(
+        ArchivedSegment(
+          name: path.basename(clip.path),
+          startSample: offset,
+          sampleCount: clip.frameCount,
+        ).toComment(),
+      );
+      offset += clip.frameCount;
+    }
+
+    final partial = File('$target$_partialSuffix');
+    final raf = partial.openSync(mode: FileMode.write);
+    try {
+      var info = FlacStreamInfo(
+        sampleRate: first.sampleRate,
+        channels: first.channels,
+        bitsPerSample: first.bitsPerSample,
+      );
+      // 头部长度与流参数无关：先占位，编码结束后原位回填。
+      raf.writeFromSync(FlacEncoder.buildHeader(info, comments: comments));
+      final encoder = FlacEncoder(
+        sampleRate: info.sampleRate,
+        channels: info.channels,
+        bitsPerSample: info.bitsPerSample,
+        onFrame: raf.writeFromSync,
+      );
+      for (final clip in clips) {
+        encoder.add(clip.samples());
+        sleep(_ioPause);
+      }
+      info = encoder.close();
+      raf
+        ..setPositionSync(0)
+        ..writeFromSync(FlacEncoder.buildHeader(info, comments: comments));
+    } finally {
+      raf.closeSync();
+    }
+    final output = partial.renameSync(target);
+    // 归档的修改时间沿用录音时间，保留策略按录音先后清理。
+    output.setLastModifiedSync(first.modified);
+    return output;
+  }
+}
+
+void _archiveEntry(_ArchiveRequest request) {
+  Isolate.exit(
+    request.reply,
+    RecordingArchiver.archiveSegments(request.sources, request.outputDir),
+  );
+}
+
+class _ArchiveRequest {
+  final List<String> sources;
+  final String outputDir;
+  final SendPort reply;
+
+  const _ArchiveRequest(this.sources, this.outputDir, this.reply);
+}
+
+/// 整型 PCM WAV 的 data 区。
+class _WavClip {
+  final String path;
+  final int fileSize;
+  final DateTime modified;
+  final int sampleRate;
+  final int channels;
+  final int bitsPerSample;
+  final Uint8List _data;
+
+  _WavClip._(
+    this.path,
+    this.fileSize,
+    this.modified,
+    this.sampleRate,
+    this.channels,
+    this.bitsPerSample,
+    this._data,
+  );
+
+  int get _blockAlign => channels * ((bitsPerSample + 7) ~/ 8);
+  int get frameCount => _data.length ~/ _blockAlign;
+
+  bool sameFormat(_WavClip other) =>
+      sampleRate == other.sampleRate &&
+      channels == other.channels &&
+      bitsPerSample == other.bitsPerSample;
+
+  /// 解析 WAV；不是 8/16/24 位整型 PCM 时返回 null。
+  ///
+  /// 录音中断时 data 区长度可能未回写（为 0 或超出文件），按实际字节截取。
+  static _WavClip? read(String filePath) {
+    try {
+      final file = File(filePath);
+      final bytes = file.readAsBytesSync();
+      if (bytes.length < 12) return null;
+      final data = ByteData.sublistView(bytes);
+      if (String.fromCharCodes(bytes, 0, 4) != 'RIFF' ||
+          String.fromCharCodes(bytes, 8, 12) != 'WAVE') {
+        return null;
+      }
+
+      int? format;
+      int? channels;
+      int? sampleRate;
+      int? bits;
+      var offset = 12;
+      while (offset + 8 <= bytes.length) {
+        final id = String.fromCharCodes(bytes, offset, offset + 4);
+        var size = data.getUint32(offset + 4, Endian.little);
+        final body = offset + 8;
+        if (id == 'fmt ' && body + 16 <= bytes.length) {
+          format = data.getUint16(body, Endian.little);
+          channels = data.getUint16(body + 2, Endian.little);
+          sampleRate = data.getUint32(body + 4, Endian.little);
+          bits = data.getUint16(body + 14, Endian.little);
+        } else if (id == 'data') {
+          if (size == 0 || body + size > bytes.length) {
+            size = bytes.length - body;
+          }
+          if (format != 1 && format != 0xFFFE) return null;
+          if (sampleRate == null || channels == null || bits == null) {
+            return null;
+          }
+          if (channels < 1 || channels > 8) return null;
+          if (bits != 8 && bits != 16 && bits != 24) return null;
+          return _WavClip._(
+            filePath,
+            bytes.length,
+            file.lastModifiedSync(),
+            sampleRate,
+            channels,
+            bits,
+            Uint8List.sublistView(bytes, body, body + size),
+          );
+        }
+        offset = body + size + (size & 1);
+      }
+      return null;
+    } catch (_) {
+      return null;
+    }
+  }
+
+  /// 交错排列的有符号样本。
+  Int32List samples() {
+    final count = frameCount * channels;
+    final out = Int32List(count);
+    final data = ByteData.sublistView(_data);
+    switch (bitsPerSample) {
+      case 8:
+        for (var i = 0; i < count; i++) {
+          out[i] = _data[i] - 128;
+        }
+      case 16:
+        for (var i = 0; i < count; i++) {
+          out[i] = data.getInt16(i * 2, Endian.little);
+        }
+      default:
+        for (var i = 0; i < count; i++) {
+          final b = i * 3;
+          final value = _data[b] | (_data[b + 1] << 8) | (_data[b + 2] << 16);
+          out[i] = value >= 0x800000 ? value - 0x1000000 : value;
+        }
+    }
+    return out;
+  }
+}
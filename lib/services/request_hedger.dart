@@ -0,0 +1,195 @@
+import 'dart:async';
+import 'dart:math' as math;
+
+import '../models/ai_enhance_config.dart';
+import '../models/provider_config.dart';
+import 'latency_histogram.dart';
+import 'log_service.dart';
+import 'network_client_service.dart';
+
+/// 一次请求尝试；[cancelled] 完成表示另一路已胜出，应尽快放弃。
+///
+/// 尝试内部经由 [NetworkClientService.createClient] 发出的请求会在
+/// [cancelled] 完成时自动中止。
+typedef HedgedAttempt<T> = Future<T> Function(Future<void> cancelled);
+
+/// 云端 STT 与 LLM 调用的请求对冲。
+///
+/// 请求超过该服务近期耗时的 p90 仍未返回时，再发出一路副本（同一服务或
+/// 配置的备用服务），先成功的结果胜出，另一路随即中止。副本数受额度
+/// 限制：每次请求积累 [maxExtraRatio] 个额度，最多存 [burst] 个，发出
+/// 副本消耗 1 个，因此额外请求长期不超过 [maxExtraRatio]。
+///
+/// 耗时按服务分别记入 [LatencyHistogram]，新旧两代各保留至多
+/// [windowSize] 个样本，阈值随近期网络状况变化。
+class RequestHedger {
+  static final instance = RequestHedger();
+
+  static const Duration sttColdStartDelay = Duration(seconds: 8);
+  static const Duration llmColdStartDelay = Duration(seconds: 6);
+
+  final double maxExtraRatio;
+  final double burst;
+  final int minSamples;
+  final int windowSize;
+  final Duration minDelay;
+
+  /// 是否允许发出副本；关闭时仍记录耗时，开启后阈值立即可用。
+  bool enabled = false;
+
+  /// 语音识别的备用服务，为空时副本发往同一服务。
+  SttProviderConfig? sttBackup;
+
+  /// 文本模型的备用端点；只取其 baseUrl / apiKey / model，提示词沿用原请求。
+  AiEnhanceConfig? aiBackup;
+
+  final Map<String, _LatencyWindow> _latency = {};
+  double _credits = 1;
+  int _hedgesFired = 0;
+  int _hedgesWon = 0;
+
+  RequestHedger({
+    this.maxExtraRatio = 0.1,
+    this.burst = 2,
+    this.minSamples = 10,
+    this.windowSize = 64,
+    this.minDelay = const Duration(milliseconds: 500),
+  });
+
+  /// 已发出的副本数。
+  int get hedgesFired => _hedgesFired;
+
+  /// 副本先于原请求成功的次数。
+  int get hedgesWon => _hedgesWon;
+
+  static String keyFor(String kind, String baseUrl, String model) =>
+      '$kind|${baseUrl.trim()}|${model.trim()}';
+
+  /// [key] 的对冲阈值：样本不足时为 [coldStart]，否则为 p90。
+  Duration thresholdFor(String key, Duration coldStart) {
+    final window = _latency[key];
+    if (window == null || window.count < minSamples) return coldStart;
+    final p90 = Duration(microseconds: window.percentile(0.9));
+    return p90 < minDelay ? minDelay : p90;
+  }
+
+  /// [key] 近期耗时的第 [quantile] 分位；样本不足 [minSamples] 时为 null。
+  Duration? predict(String key, {double quantile = 0.9}) {
+    final window = _latency[key];
+    if (window == null || window.count < minSamples) return null;
+    return Duration(microseconds: window.percentile(quantile));
+  }
+
+  void recordLatency(String key, Duration elapsed) {
+    _latency
+        .putIfAbsent(key, _LatencyWindow.new)
+        .record(elapsed.inMicroseconds, windowSize);
+  }
+
+  /// 执行 [primary]，必要时以 [hedge]（默认再次执行 [primary]）对冲。
+  ///
+  /// 原请求在阈值前失败时直接抛出，不发副本；两路都失败时抛出原请求的
+  /// 错误。[hedgeKey] 为副本所属服务，用于记录其耗时。
+  Future<T> run<T>({
+    required String key,
+    required HedgedAttempt<T> primary,
+    HedgedAttempt<T>? hedge,
+    String? hedgeKey,
+    Duration coldStart = llmColdStartDelay,
+  }) {
+    _credits = math.min(burst, _credits + maxExtraRatio);
+    final result = Completer<T>();
+    final cancels = <Completer<void>>[];
+    final primaryClock = Stopwatch()..start();
+    Object? primaryError;
+    StackTrace? primaryStack;
+    Timer? hedgeTimer;
+    var pending = 0;
+
+    void launch(String attemptKey, HedgedAttempt<T> attempt, bool isHedge) {
+      final cancel = Completer<void>();
+      cancels.add(cancel);
+      pending++;
+      final clock = Stopwatch()..start();
+      NetworkClientService.runAbortable(
+        cancel.future,
+        () => Future.sync(() => attempt(cancel.future)),
+      ).then(
+        (value) {
+          pending--;
+          if (result.isCompleted) return;
+          hedgeTimer?.cancel();
+          recordLatency(attemptKey, clock.elapsed);
+          if (isHedge) {
+            _hedgesWon++;
+            // 原请求耗时至少已达到这里，记入下界以免阈值只被快请求拉低。
+            recordLatency(key, primaryClock.elapsed);
+          }
+          for (final other in cancels) {
+            if (!other.isCompleted) other.complete();
+          }
+          result.complete(value);
+        },
+        onError: (Object error, StackTrace stack) {
+          pending--;
+          if (result.isCompleted) return;
+          if (!isHedge) {
+            primaryError = error;
+            primaryStack = stack;
+          }
+          if (pending > 0) return;
+          hedgeTimer?.cancel();
+          if (primaryError != null) {
+            result.completeError(primaryError!, primaryStack);
+          } else {
+            result.completeError(error, stack);
+          }
+        },
+      );
+    }
+
+    launch(key, primary, false);
+    if (enabled && !result.isCompleted) {
+      final delay = thresholdFor(key, coldStart);
+      hedgeTimer = Timer(delay, () {
+        if (result.isCompleted || pending == 0) return;
+        if (_credits < 1) {
+          LogService.info('HEDGE', 'budget exhausted, skip hedge key=$key');
+          return;
+        }
+        _credits -= 1;
+        _hedgesFired++;
+        final target = hedgeKey ?? key;
+        LogService.info(
+          'HEDGE',
+          'fire hedge after ${delay.inMilliseconds}ms key=$key target=$target',
+        );
+        launch(target, hedge ?? primary, true);
+      });
+    }
+    return result.future;
+  }
+}
+
+/// 新旧两代直方图组成的滑动窗口。
+class _LatencyWindow {
+  LatencyHistogram _current = LatencyHistogram();
+  LatencyHistogram _previous = LatencyHistogram();
+
+  int get count => _current.totalCount + _previous.totalCount;
+
+  void record(int micros, int windowSize) {
+    _current.record(micros);
+    if (_current.totalCount >= windowSize) {
+      _previous = _current;
+      _current = LatencyHistogram();
+    }
+  }
+
+  int percentile(double quantile) {
+    final merged = LatencyHistogram()
+      ..merge(_previous)
+      ..merge(_current);
+    return merged.percentile(quantile);
+  }
+}
@@ -0,0 +1,274 @@
+import 'dart:async';
+
+/// 流水线中的一个阶段。
+///
+/// 阶段之间是有界队列：下游队列已有 [capacity] 个任务时，上游完成的
+/// 任务留在原阶段占用并发槽，直到下游腾出位置，从而把背压传回上游。
+/// 第一个阶段的输入不设上限（分段音频已落盘，采集不能被阻塞）。
+class PipelineStep<J> {
+  final String name;
+  final Future<void> Function(J job) run;
+  final int concurrency;
+  final int capacity;
+
+  /// 任务按提交顺序进入该阶段，适用于依赖前序结果的阶段（如带上下文
+  /// 窗口的 LLM 纠错）。
+  final bool ordered;
+
+  /// 批处理入口：阶段空出运行槽时若已有多个任务就绪，至多 [maxBatch] 个
+  /// 一起交给它（有序阶段只取序号连续的任务），只有一个时仍走 [run]。
+  /// 队列不积压时不会等待凑批，批大小随积压程度自适应。
+  final Future<void> Function(List<J> jobs)? runBatch;
+  final int maxBatch;
+
+  const PipelineStep(
+    this.name,
+    this.run, {
+    this.concurrency = 1,
+    this.capacity = 4,
+    this.ordered = false,
+    this.runBatch,
+    this.maxBatch = 1,
+  });
+}
+
+/// 阶段占用情况：[utilization] 为忙碌槽时间占全部槽时间的比例，
+/// [avgQueued] / [maxQueued] 为等待进入该阶段的任务数。
+/// 利用率最高、排队最长的阶段即为瓶颈。
+class StageOccupancy {
+  final String name;
+  final int processed;
+  final double utilization;
+  final double avgQueued;
+  final int maxQueued;
+
+  const StageOccupancy({
+    required this.name,
+    required this.processed,
+    required this.utilization,
+    required this.avgQueued,
+    required this.maxQueued,
+  });
+
+  @override
+  String toString() =>
+      '$name busy=${(utilization * 100).round()}% '
+      'queue=${avgQueued.toStringAsFixed(1)}/$maxQueued n=$processed';
+}
+
+/// 分阶段并发处理任务、按提交顺序输出的流水线。
+///
+/// 每个阶段独立并发，后一个分段的 STT 可以与前一个分段的纠错同时进行。
+/// 某阶段抛出异常的任务跳过后续阶段且不输出，但仍占据其顺序位置，
+/// 后面的任务不会因此乱序或卡住。
+class StagedPipeline<J> {
+  final List<PipelineStep<J>> steps;
+
+  /// 按提交顺序收到每个成功完成全部阶段的任务。
+  final void Function(J job) onOutput;
+
+  final void Function(J job, String step, Object error, StackTrace stack)?
+  onError;
+
+  final Stopwatch _clock = Stopwatch()..start();
+  late final List<_StageState<J>> _stages = [
+    for (final step in steps) _StageState(step),
+  ];
+  final Map<int, _Envelope<J>> _finished = {};
+  int _nextSeq = 0;
+  int _nextOutput = 0;
+  Completer<void>? _idle;
+
+  StagedPipeline(this.steps, {required this.onOutput, this.onError})
+    : assert(steps.isNotEmpty);
+
+  /// 尚未输出的任务数。
+  int get pending => _nextSeq - _nextOutput;
+
+  /// 提交一个任务。
+  void add(J job) {
+    final envelope = _Envelope(_nextSeq++, job);
+    _stages.first.enqueue(envelope, _clock.elapsedMicroseconds);
+    _pump();
+  }
+
+  /// 当前已提交的任务全部输出后完成。
+  Future<void> get drained {
+    if (pending == 0) return Future.value();
+    return (_idle ??= Completer<void>()).future;
+  }
+
+  /// 各阶段自流水线创建以来的占用情况。
+  List<StageOccupancy> get occupancy {
+    final now = _clock.elapsedMicroseconds;
+    return [for (final stage in _stages) stage.snapshot(now)];
+  }
+
+  void _pump() {
+    var progressed = true;
+    while (progressed) {
+      progressed = false;
+      for (var i = _stages.length - 1; i >= 0; i--) {
+        final stage = _stages[i];
+        final next = i + 1 < _stages.length ? _stages[i + 1] : null;
+        final now = _clock.elapsedMicroseconds;
+
+        // 交出已完成的任务；被阻塞的任务不挡住排在它后面的可交出任务。
+        for (final envelope in List.of(stage.outbox)) {
+          if (next != null && !next.admits(envelope, _nextOutput)) continue;
+          stage.outbox.remove(envelope);
+          if (next == null) {
+            _finish(envelope);
+          } else {
+            next.enqueue(envelope, now);
+          }
+          progressed = true;
+        }
+
+        while (true) {
+          final envelope = stage.takeNext(now, _nextOutput);
+          if (envelope == null) break;
+          progressed = true;
+          if (envelope.failed) {
+            stage.outbox.add(envelope);
+          } else {
+            final batch = [envelope, ...stage.takeFollowers(envelope, now)];
+            unawaited(_execute(stage, batch));
+          }
+        }
+      }
+    }
+  }
+
+  Future<void> _execute(
+    _StageState<J> stage,
+    List<_Envelope<J>> batch,
+  ) async {
+    stage.setActive(stage.active + 1, _clock.elapsedMicroseconds);
+    try {
+      if (batch.length == 1) {
+        await stage.step.run(batch.single.job);
+      } else {
+        await stage.step.runBatch!([for (final e in batch) e.job]);
+      }
+    } catch (e, st) {
+      for (final envelope in batch) {
+        envelope.failed = true;
+        onError?.call(envelope.job, stage.step.name, e, st);
+      }
+    }
+    stage
+      ..setActive(stage.active - 1, _clock.elapsedMicroseconds)
+      ..processed += batch.length
+      ..outbox.addAll(batch);
+    _pump();
+  }
+
+  void _finish(_Envelope<J> envelope) {
+    _finished[envelope.seq] = envelope;
+    while (true) {
+      final ready = _finished.remove(_nextOutput);
+      if (ready == null) break;
+      _nextOutput++;
+      if (!ready.failed) onOutput(ready.job);
+    }
+    if (pending == 0 && _idle != null) {
+      _idle!.complete();
+      _idle = null;
+    }
+  }
+}
+
+class _Envelope<J> {
+  final int seq;
+  final J job;
+  bool failed = false;
+
+  _Envelope(this.seq, this.job);
+}
+
+class _StageState<J> {
+  final PipelineStep<J> step;
+  final List<_Envelope<J>> queue = [];
+  final List<_Envelope<J>> outbox = [];
+  int active = 0;
+  int processed = 0;
+  int nextSeq = 0;
+
+  int _maxQueued = 0;
+  int _busyArea = 0;
+  int _queueArea = 0;
+  int _lastActiveChange = 0;
+  int _lastQueueChange = 0;
+
+  _StageState(this.step);
+
+  // 最早的未输出任务 [head] 总能进入队列并在有运行槽时启动，不受
+  // 容量与被阻塞任务的限制：非有序阶段允许后面的任务超车，否则超车
+  // 任务可能占满各级队列而让 [head] 永远进不来。
+  bool admits(_Envelope<J> envelope, int head) =>
+      queue.length < step.capacity ||
+      envelope.seq == head ||
+      (step.ordered && envelope.seq == nextSeq);
+
+  void enqueue(_Envelope<J> envelope, int now) {
+    _accrueQueue(now);
+    queue.add(envelope);
+    if (queue.length > _maxQueued) _maxQueued = queue.length;
+  }
+
+  _Envelope<J>? takeNext(int now, int head) {
+    if (queue.isEmpty || active >= step.concurrency) return null;
+    var index = queue.indexWhere((e) => e.seq == head);
+    if (index < 0) {
+      if (active + outbox.length >= step.concurrency) return null;
+      index = step.ordered ? queue.indexWhere((e) => e.seq == nextSeq) : 0;
+      if (index < 0) return null;
+    }
+    _accrueQueue(now);
+    final envelope = queue.removeAt(index);
+    if (step.ordered) nextSeq = envelope.seq + 1;
+    return envelope;
+  }
+
+  /// 与 [first] 同批执行的后续任务；有序阶段只取序号紧接的任务，遇到
+  /// 失败任务即停止（它需原样交给下游）。
+  List<_Envelope<J>> takeFollowers(_Envelope<J> first, int now) {
+    final followers = <_Envelope<J>>[];
+    if (step.runBatch == null || step.maxBatch <= 1) return followers;
+    while (followers.length + 1 < step.maxBatch && queue.isNotEmpty) {
+      final index = step.ordered
+          ? queue.indexWhere((e) => e.seq == nextSeq)
+          : queue.indexWhere((e) => !e.failed);
+      if (index < 0 || queue[index].failed) break;
+      _accrueQueue(now);
+      final envelope = queue.removeAt(index);
+      if (step.ordered) nextSeq = envelope.seq + 1;
+      followers.add(envelope);
+    }
+    return followers;
+  }
+
+  void setActive(int value, int now) {
+    _busyArea += active * (now - _lastActiveChange);
+    _lastActiveChange = now;
+    active = value;
+  }
+
+  void _accrueQueue(int now) {
+    _queueArea += queue.length * (now - _lastQueueChange);
+    _lastQueueChange = now;
+  }
+
+  StageOccupancy snapshot(int now) {
+    final busy = _busyArea + active * (now - _lastActiveChange);
+    final queued = _queueArea + queue.length * (now - _lastQueueChange);
+    return StageOccupancy(
+      name: step.name,
+      processed: processed,
+      utilization: now == 0 ? 0 : busy / (now * step.concurrency),
+      avgQueued: now == 0 ? 0 : queued / now,
+      maxQueued: _maxQueued,
+    );
+  }
+}
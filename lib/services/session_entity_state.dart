@@ -33,6 +33,11 @@ class SessionEntityActivation {
 class SessionEntityState {
   final Map<String, SessionEntityActivation> _activations = {};
 
+  /// 激活状态变更代数，供下游缓存判断是否失效。
+  int _generation = 0;
+
+  int get generation => _generation;
+
   Map<String, SessionEntityActivation> get activations =>
       Map.unmodifiable(_activations);
 
@@ -47,6 +52,7 @@ class SessionEntityState {
     final normalizedAlias = alias.trim();
     if (entityId.trim().isEmpty || canonicalName.trim().isEmpty) return;
     final now = DateTime.now();
+    _generation++;
     final current = _activations[entityId];
     final nextAliases = <String>{
       ...?current?.recentAliases,
@@ -81,9 +87,11 @@ class SessionEntityState {
     _activations
       ..clear()
       ..addAll(next);
+    _generation++;
   }
 
   void reset() {
     _activations.clear();
+    _generation++;
   }
 }
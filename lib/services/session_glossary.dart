@@ -17,6 +17,11 @@ class SessionGlossary {
   int _overridesCount = 0;
   int _injectionsCount = 0;
 
+  /// 条目变更代数，每次锚定表内容变化时递增，供下游缓存判断是否失效。
+  int _generation = 0;
+
+  int get generation => _generation;
+
   int get pinsCount => _pinsCount;
   int get strongPromotionsCount => _strongPromotionsCount;
   int get overridesCount => _overridesCount;
@@ -48,6 +53,7 @@ class SessionGlossary {
     // 不锚定相同内容
     if (key == corrected.trim().toLowerCase()) return;
 
+    _generation++;
     if (_entries.containsKey(key)) {
       final oldHit = _entries[key]!.hitCount;
       _entries[key] = _entries[key]!.copyWithHit();
@@ -71,6 +77,7 @@ class SessionGlossary {
     final key = original.trim().toLowerCase();
     if (key.isEmpty) return;
     _overridesCount++;
+    _generation++;
     if (corrected.trim().isEmpty) {
       _entries.remove(key);
       return;
@@ -132,6 +139,7 @@ class SessionGlossary {
   /// 重置（新录音会话开始时调用）。
   void reset() {
     _entries.clear();
+    _generation++;
     _pinsCount = 0;
     _strongPromotionsCount = 0;
     _overridesCount = 0;
@@ -0,0 +1,61 @@
+import 'dart:async';
+
+import '../database/app_database.dart';
+
+/// 持久化统计计数器的内存累加与批量落盘。
+///
+/// [add] 只在内存中累加增量，不触碰数据库；增量在 [flushDelay] 后或
+/// 显式调用 [flush]（如退出时）在一个事务内写入，写入在 SQL 中完成累加，
+/// 因此并发的分段处理不会因读-改-写而丢失更新。
+class StatCounters {
+  StatCounters._();
+  static final instance = StatCounters._();
+
+  static const Duration flushDelay = Duration(seconds: 5);
+
+  final Map<String, int> _pending = {};
+  Timer? _flushTimer;
+  Future<void>? _flushing;
+
+  /// 累加计数器 [key]。
+  void add(String key, int delta) {
+    if (delta == 0) return;
+    _pending[key] = (_pending[key] ?? 0) + delta;
+    _flushTimer ??= Timer(flushDelay, () {
+      _flushTimer = null;
+      unawaited(flush());
+    });
+  }
+
+  /// 将待写入的增量写入数据库；写入失败时增量保留到下一轮。
+  Future<void> flush() async {
+    _flushTimer?.cancel();
+    _flushTimer = null;
+    // 同一时刻只有一轮写入，读取方等待它完成后即可看到一致的值。
+    while (_flushing != null) {
+      await _flushing;
+    }
+    if (_pending.isEmpty) return;
+
+    final deltas = Map<String, int>.of(_pending);
+    _pending.clear();
+    final completer = Completer<void>();
+    _flushing = completer.future;
+    try {
+      final db = await AppDatabase.getInstance();
+      await db.incrementCounters(deltas);
+    } catch (_) {
+      deltas.forEach(add);
+    } finally {
+      _flushing = null;
+      completer.complete();
+    }
+  }
+
+  /// 读取一组计数器的当前值（先落盘待写增量）。
+  Future<Map<String, int>> read(List<String> keys) async {
+    await flush();
+    final db = await AppDatabase.getInstance();
+    return db.getCounters(keys);
+  }
+}
@@ -1,5 +1,7 @@
 import '../models/provider_config.dart';
 import '../models/stt_request_context.dart';
+import 'provider_router.dart';
+import 'request_hedger.dart';
 import 'stt_providers/stt_provider.dart';
 import 'stt_providers/openai_stt_provider.dart';
 import 'stt_providers/zai_stt_provider.dart';
@@ -52,9 +54,66 @@ class SttService {
     return OpenAiSttProvider(config);
   }
 
+  /// [config] 在健康度统计、对冲与路由中的标识。
+  static String routeKeyOf(SttProviderConfig config) =>
+      RequestHedger.keyFor('stt', config.baseUrl, config.model);
+
   /// 将音频文件转写为文本。
+  ///
+  /// 经 [ProviderRouter] 调用：开启路由时在当前服务与
+  /// [ProviderRouter.sttFallbacks] 中选择最快的健康服务，云端全部熔断时
+  /// 退到本地模型。
   Future<String> transcribe(String audioPath, {SttRequestContext? context}) {
-    return _resolveProvider().transcribe(audioPath, context: context);
+    final router = ProviderRouter.instance;
+    final key = routeKeyOf(config);
+    final candidates = [
+      _routeCandidate(config),
+      if (router.enabled)
+        for (final fallback in router.sttFallbacks)
+          if (routeKeyOf(fallback) != key) _routeCandidate(fallback),
+    ];
+    return router.run(
+      candidates,
+      (SttProviderConfig target) =>
+          SttService(target)._transcribeHedged(audioPath, context),
+    );
+  }
+
+  static RouteCandidate<SttProviderConfig> _routeCandidate(
+    SttProviderConfig config,
+  ) {
+    return RouteCandidate(
+      routeKeyOf(config),
+      config,
+      isLocal: config.type == SttProviderType.senseVoice,
+    );
+  }
+
+  /// 云端服务经 [RequestHedger] 调用：迟迟未返回时对冲到同一服务或
+  /// [RequestHedger.sttBackup]。本地模型不对冲。
+  Future<String> _transcribeHedged(
+    String audioPath,
+    SttRequestContext? context,
+  ) {
+    final provider = _resolveProvider();
+    if (config.type == SttProviderType.senseVoice) {
+      return provider.transcribe(audioPath, context: context);
+    }
+    final hedger = RequestHedger.instance;
+    final backup = hedger.sttBackup;
+    final hedgeProvider = backup == null ? null : SttService(backup);
+    return hedger.run(
+      key: routeKeyOf(config),
+      coldStart: RequestHedger.sttColdStartDelay,
+      primary: (_) => provider.transcribe(audioPath, context: context),
+      hedge: hedgeProvider == null
+          ? null
+          : (_) => hedgeProvider._resolveProvider().transcribe(
+              audioPath,
+              context: context,
+            ),
+      hedgeKey: backup == null ? null : routeKeyOf(backup),
+    );
   }
 
   /// 检查服务是否可用（简单版本）。
@@ -7,6 +7,7 @@ import '../models/memory_item.dart';
 import '../models/term_context_entry.dart';
 import '../models/term_prompt_bundle.dart';
 import '../models/transcription.dart';
+import 'entity_recall_index.dart';
 import 'entity_recall_service.dart';
 import 'session_glossary.dart';
 import 'session_entity_state.dart';
@@ -35,7 +36,12 @@ class TermPromptBuilder {
     List<MemoryItem> memoryItems = const [],
     int maxTerms = TermRecallService.defaultMaxTerms,
   }) {
-    final contextDocuments = _selectContextDocuments(termContextEntries);
+    final staticParts = buildStaticParts(
+      dictionaryEntries: dictionaryEntries,
+      sessionGlossary: sessionGlossary,
+      termContextEntries: termContextEntries,
+      memoryItems: memoryItems,
+    );
     final preferredTerms = recallService.recallPreferredTerms(
       currentText: currentText,
       history: history,
@@ -44,36 +50,93 @@ class TermPromptBuilder {
       termContextEntries: termContextEntries,
       maxTerms: maxTerms,
     );
-    final promptMemoryItems = _promptEligibleMemoryItems(memoryItems);
-    final activeMemoryTerms = _activeMemoryPreferredTerms(promptMemoryItems);
-    final activeMemoryReferences = _activeMemoryReferences(promptMemoryItems);
-    final includedMemoryItemIds = promptMemoryItems
-        .map((item) => item.id)
-        .toList(growable: false);
-    final includedWeakMemoryItemIds = memoryItems
-        .where(
-          (item) =>
-              item.status == MemoryItemStatus.weakActive &&
-              item.kind == MemoryItemKind.correction &&
-              item.isCorrectionEligible &&
-              item.original.trim().isNotEmpty &&
-              item.canonical.trim().isNotEmpty &&
-              item.original.trim() != item.canonical.trim(),
-        )
-        .map((item) => item.id)
-        .toList(growable: false);
-
-    final entityBundle = entityRecallService.buildForStt(
+    final entityBundle = buildEntityBundle(
       currentText: currentText,
-      historyTexts: history.take(5).map((e) => e.text).toList(growable: false),
+      history: history,
+      staticParts: staticParts,
+      sessionEntityState: sessionEntityState,
+      entityMemories: entityMemories,
+      entityAliases: entityAliases,
+      entityRelations: entityRelations,
+    );
+    return assemble(
+      scene: scene,
+      staticParts: staticParts,
+      preferredTerms: preferredTerms,
+      entityBundle: entityBundle,
+    );
+  }
+
+  /// 仅依赖词典、上下文术语、记忆与会话术语表的提示片段，与当前文本无关。
+  TermPromptStaticParts buildStaticParts({
+    required List<DictionaryEntry> dictionaryEntries,
+    required SessionGlossary sessionGlossary,
+    List<TermContextEntry> termContextEntries = const [],
+    List<MemoryItem> memoryItems = const [],
+  }) {
+    final contextDocuments = _selectContextDocuments(termContextEntries);
+    final promptMemoryItems = _promptEligibleMemoryItems(memoryItems);
+    return TermPromptStaticParts(
+      contextDocuments: contextDocuments,
       contextTexts: contextDocuments
           .map((e) => _truncateContext(e.content ?? ''))
           .toList(growable: false),
+      activeMemoryTerms: _activeMemoryPreferredTerms(promptMemoryItems),
+      activeMemoryReferences: _activeMemoryReferences(promptMemoryItems),
+      includedMemoryItemIds: promptMemoryItems
+          .map((item) => item.id)
+          .toList(growable: false),
+      includedWeakMemoryItemIds: memoryItems
+          .where(
+            (item) =>
+                item.status == MemoryItemStatus.weakActive &&
+                item.kind == MemoryItemKind.correction &&
+                item.isCorrectionEligible &&
+                item.original.trim().isNotEmpty &&
+                item.canonical.trim().isNotEmpty &&
+                item.original.trim() != item.canonical.trim(),
+          )
+          .map((item) => item.id)
+          .toList(growable: false),
+      correctionReferences: _buildCorrectionReferences(
+        dictionaryEntries,
+        sessionGlossary,
+        memoryItems,
+      ),
+    );
+  }
+
+  EntityPromptBundle buildEntityBundle({
+    required String currentText,
+    required List<Transcription> history,
+    required TermPromptStaticParts staticParts,
+    SessionEntityState? sessionEntityState,
+    List<EntityMemory> entityMemories = const [],
+    List<EntityAlias> entityAliases = const [],
+    List<EntityRelation> entityRelations = const [],
+    EntityMentions? currentMentions,
+  }) {
+    return entityRecallService.buildForStt(
+      currentText: currentText,
+      historyTexts: history.take(5).map((e) => e.text).toList(growable: false),
+      contextTexts: staticParts.contextTexts,
       memories: entityMemories,
       aliases: entityAliases,
       relations: entityRelations,
       sessionState: sessionEntityState ?? SessionEntityState(),
+      currentMentions: currentMentions,
     );
+  }
+
+  TermPromptBundle assemble({
+    required String scene,
+    required TermPromptStaticParts staticParts,
+    required List<String> preferredTerms,
+    required EntityPromptBundle entityBundle,
+  }) {
+    final contextDocuments = staticParts.contextDocuments;
+    final activeMemoryTerms = staticParts.activeMemoryTerms;
+    final activeMemoryReferences = staticParts.activeMemoryReferences;
 
     if (preferredTerms.isEmpty &&
         activeMemoryTerms.isEmpty &&
@@ -89,11 +152,7 @@ class TermPromptBuilder {
       ...entityBundle.entities.map((e) => e.memory.canonicalName),
     }.toList(growable: false);
     final preserveTerms = mergedPreferredTerms.toList(growable: false);
-    final correctionReferences = _buildCorrectionReferences(
-      dictionaryEntries,
-      sessionGlossary,
-      memoryItems,
-    );
+    final correctionReferences = staticParts.correctionReferences;
 
     final prompt = StringBuffer()
       ..writeln('请将这段音频准确转写为纯文本，仅返回转写结果。')
@@ -107,9 +166,9 @@ class TermPromptBuilder {
     }
     if (contextDocuments.isNotEmpty) {
       prompt.writeln('参考以下上下文：');
-      for (final entry in contextDocuments) {
-        prompt.writeln('[${entry.displayTitle}]');
-        prompt.writeln(_truncateContext(entry.content ?? ''));
+      for (var i = 0; i < contextDocuments.length; i++) {
+        prompt.writeln('[${contextDocuments[i].displayTitle}]');
+        prompt.writeln(staticParts.contextTexts[i]);
       }
     }
     if (activeMemoryReferences.isNotEmpty) {
@@ -137,8 +196,8 @@ class TermPromptBuilder {
       preferredTerms: mergedPreferredTerms,
       preserveTerms: preserveTerms,
       correctionReferences: correctionReferences,
-      includedMemoryItemIds: includedMemoryItemIds,
-      includedWeakMemoryItemIds: includedWeakMemoryItemIds,
+      includedMemoryItemIds: staticParts.includedMemoryItemIds,
+      includedWeakMemoryItemIds: staticParts.includedWeakMemoryItemIds,
       entityCorrectionSection: entityBundle.correctionEntitySection,
       entityRelationSection: entityBundle.correctionRelationSection,
     );
@@ -313,3 +372,26 @@ class TermPromptBuilder {
     return terms.toList(growable: false);
   }
 }
+
+/// [TermPromptBuilder.buildStaticParts] 的结果，可在输入不变时跨分段复用。
+class TermPromptStaticParts {
+  final List<TermContextEntry> contextDocuments;
+
+  /// 与 [contextDocuments] 一一对应的截断后正文。
+  final List<String> contextTexts;
+  final List<String> activeMemoryTerms;
+  final List<MemoryItem> activeMemoryReferences;
+  final List<String> includedMemoryItemIds;
+  final List<String> includedWeakMemoryItemIds;
+  final List<String> correctionReferences;
+
+  const TermPromptStaticParts({
+    this.contextDocuments = const [],
+    this.contextTexts = const [],
+    this.activeMemoryTerms = const [],
+    this.activeMemoryReferences = const [],
+    this.includedMemoryItemIds = const [],
+    this.includedWeakMemoryItemIds = const [],
+    this.correctionReferences = const [],
+  });
+}
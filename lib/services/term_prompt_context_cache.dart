@@ -0,0 +1,412 @@
+import '../models/dictionary_entry.dart';
+import '../models/entity_alias.dart';
+import '../models/entity_memory.dart';
+import '../models/entity_prompt_bundle.dart';
+import '../models/entity_relation.dart';
+import '../models/memory_item.dart';
+import '../models/term_context_entry.dart';
+import '../models/term_prompt_bundle.dart';
+import '../models/transcription.dart';
+import 'entity_recall_index.dart';
+import 'session_entity_state.dart';
+import 'session_glossary.dart';
+import 'term_prompt_builder.dart';
+import 'term_recall_service.dart';
+
+/// 单个缓存片段的命中统计。
+class PromptCacheStats {
+  int hits = 0;
+  int misses = 0;
+
+  int get lookups => hits + misses;
+
+  double get hitRate => lookups == 0 ? 0 : hits / lookups;
+
+  void _record(bool hit) {
+    if (hit) {
+      hits++;
+    } else {
+      misses++;
+    }
+  }
+
+  @override
+  String toString() => '$hits/$lookups';
+}
+
+/// 会话级 STT 提示上下文缓存。
+///
+/// 将 [TermPromptBuilder.build] 拆成若干片段分别记忆化，每个片段只在其输入的
+/// 版本变化时重建：
+/// - 静态片段：词典/上下文术语/记忆列表实例 + 会话术语表代数
+/// - 查询关键词：最近 5 条历史 + 当前文本；当前文本只追加时仅提取增量
+/// - 偏好术语：词典/上下文术语列表实例 + 会话术语表代数 + 关键词版本
+/// - 实体片段：实体索引 + 会话实体状态代数 + 历史 + 当前文本中的实体提及；
+///   当前文本只追加时仅扫描增量，提及不变即可复用
+///
+/// 列表实例即版本：设置层以写时复制方式替换列表，录音层按会话复制一份，
+/// 因此列表不变即表示内容未变。结果与直接调用 [TermPromptBuilder.build] 一致。
+class TermPromptContextCache {
+  static const int _historyWindow = 5;
+
+  final TermPromptBuilder builder;
+
+  TermPromptContextCache({this.builder = const TermPromptBuilder()});
+
+  final PromptCacheStats staticStats = PromptCacheStats();
+  final PromptCacheStats keywordStats = PromptCacheStats();
+  final PromptCacheStats termStats = PromptCacheStats();
+  final PromptCacheStats entityStats = PromptCacheStats();
+  final PromptCacheStats bundleStats = PromptCacheStats();
+
+  // 静态片段
+  TermPromptStaticParts? _staticParts;
+  List<DictionaryEntry>? _staticDictionary;
+  List<TermContextEntry>? _staticTermContext;
+  List<MemoryItem>? _staticMemory;
+  SessionGlossary? _staticGlossary;
+  int _staticGlossaryGeneration = -1;
+
+  // 查询关键词
+  final Set<String> _queryKeywords = {};
+  int _keywordsVersion = 0;
+  List<Transcription> _keywordHistory = const [];
+  String? _keywordText;
+
+  // 偏好术语
+  List<String>? _preferredTerms;
+  List<DictionaryEntry>? _termDictionary;
+  List<TermContextEntry>? _termContext;
+  SessionGlossary? _termGlossary;
+  int _termGlossaryGeneration = -1;
+  int _termKeywordsVersion = -1;
+  int _termMaxTerms = -1;
+
+  // 当前文本的实体提及
+  EntityRecallIndex? _mentionIndex;
+  String? _mentionText;
+  EntityMentions _mentions = EntityMentions.empty;
+
+  // 实体片段
+  EntityPromptBundle? _entityBundle;
+  EntityRecallIndex? _entityIndex;
+  SessionEntityState? _entityState;
+  int _entityStateGeneration = -1;
+  TermPromptStaticParts? _entityStaticParts;
+  List<Transcription> _entityHistory = const [];
+  EntityMentions _entityMentions = EntityMentions.empty;
+
+  // 完整结果
+  TermPromptBundle? _bundle;
+  String? _bundleScene;
+  TermPromptStaticParts? _bundleStaticParts;
+  List<String>? _bundlePreferredTerms;
+  EntityPromptBundle? _bundleEntityBundle;
+
+  Map<String, PromptCacheStats> get stats => {
+    'static': staticStats,
+    'keywords': keywordStats,
+    'terms': termStats,
+    'entities': entityStats,
+    'bundle': bundleStats,
+  };
+
+  /// 形如 `static=3/4 keywords=2/4 ...` 的统计摘要，用于日志。
+  String describeStats() => stats.entries
+      .map((e) => '${e.key}=${e.value}')
+      .join(' ');
+
+  TermPromptBundle build({
+    required String scene,
+    required String currentText,
+    required List<Transcription> history,
+    required List<DictionaryEntry> dictionaryEntries,
+    required SessionGlossary sessionGlossary,
+    required SessionEntityState sessionEntityState,
+    List<TermContextEntry> termContextEntries = const [],
+    List<EntityMemory> entityMemories = const [],
+    List<EntityAlias> entityAliases = const [],
+    List<EntityRelation> entityRelations = const [],
+    List<MemoryItem> memoryItems = const [],
+    int maxTerms = TermRecallService.defaultMaxTerms,
+  }) {
+    final historyHead = history.length <= _historyWindow
+        ? history
+        : history.sublist(0, _historyWindow);
+    final staticParts = _resolveStaticParts(
+      dictionaryEntries: dictionaryEntries,
+      sessionGlossary: sessionGlossary,
+      termContextEntries: termContextEntries,
+      memoryItems: memoryItems,
+    );
+    _resolveQueryKeywords(currentText, historyHead);
+    final preferredTerms = _resolvePreferredTerms(
+      currentText: currentText,
+      historyHead: historyHead,
+      dictionaryEntries: dictionaryEntries,
+      sessionGlossary: sessionGlossary,
+      termContextEntries: termContextEntries,
+      maxTerms: maxTerms,
+    );
+    final entityBundle = _resolveEntityBundle(
+      currentText: currentText,
+      historyHead: historyHead,
+      staticParts: staticParts,
+      sessionEntityState: sessionEntityState,
+      entityMemories: entityMemories,
+      entityAliases: entityAliases,
+      entityRelations: entityRelations,
+    );
+
+    final cached = _bundle;
+    if (cached != null &&
+        _bundleScene == scene &&
+        identical(_bundleStaticParts, staticParts) &&
+        identical(_bundlePreferredTerms, preferredTerms) &&
+        identical(_bundleEntityBundle, entityBundle)) {
+      bundleStats._record(true);
+      return cached;
+    }
+    bundleStats._record(false);
+
+    final bundle = builder.assemble(
+      scene: scene,
+      staticParts: staticParts,
+      preferredTerms: preferredTerms,
+      entityBundle: entityBundle,
+    );
+    _bundle = bundle;
+    _bundleScene = scene;
+    _bundleStaticParts = staticParts;
+    _bundlePreferredTerms = preferredTerms;
+    _bundleEntityBundle = entityBundle;
+    return bundle;
+  }
+
+  /// 清空缓存与统计，在新会话开始时调用。
+  void reset() {
+    _staticParts = null;
+    _staticDictionary = null;
+    _staticTermContext = null;
+    _staticMemory = null;
+    _staticGlossary = null;
+    _queryKeywords.clear();
+    _keywordsVersion++;
+    _keywordHistory = const [];
+    _keywordText = null;
+    _preferredTerms = null;
+    _mentionIndex = null;
+    _mentionText = null;
+    _mentions = EntityMentions.empty;
+    _entityBundle = null;
+    _entityIndex = null;
+    _entityStaticParts = null;
+    _entityHistory = const [];
+    _entityMentions = EntityMentions.empty;
+    _bundle = null;
+    _bundleScene = null;
+    _bundleStaticParts = null;
+    _bundlePreferredTerms = null;
+    _bundleEntityBundle = null;
+    for (final item in stats.values) {
+      item
+        ..hits = 0
+        ..misses = 0;
+    }
+  }
+
+  TermPromptStaticParts _resolveStaticParts({
+    required List<DictionaryEntry> dictionaryEntries,
+    required SessionGlossary sessionGlossary,
+    required List<TermContextEntry> termContextEntries,
+    required List<MemoryItem> memoryItems,
+  }) {
+    final cached = _staticParts;
+    if (cached != null &&
+        identical(_staticDictionary, dictionaryEntries) &&
+        identical(_staticTermContext, termContextEntries) &&
+        identical(_staticMemory, memoryItems) &&
+        identical(_staticGlossary, sessionGlossary) &&
+        _staticGlossaryGeneration == sessionGlossary.generation) {
+      staticStats._record(true);
+      return cached;
+    }
+    staticStats._record(false);
+
+    final parts = builder.buildStaticParts(
+      dictionaryEntries: dictionaryEntries,
+      sessionGlossary: sessionGlossary,
+      termContextEntries: termContextEntries,
+      memoryItems: memoryItems,
+    );
+    _staticParts = parts;
+    _staticDictionary = dictionaryEntries;
+    _staticTermContext = termContextEntries;
+    _staticMemory = memoryItems;
+    _staticGlossary = sessionGlossary;
+    _staticGlossaryGeneration = sessionGlossary.generation;
+    return parts;
+  }
+
+  /// 维护 [_queryKeywords]，内容变化时递增 [_keywordsVersion]。
+  void _resolveQueryKeywords(String currentText, List<Transcription> history) {
+    final recall = builder.recallService;
+    final previous = _keywordText;
+    if (previous != null && _sameItems(_keywordHistory, history)) {
+      if (previous == currentText) {
+        keywordStats._record(true);
+        return;
+      }
+      // 关键词不跨越空白：以空白开头的追加文本只需提取增量部分。
+      if (previous.isNotEmpty &&
+          currentText.length > previous.length &&
+          currentText.startsWith(previous) &&
+          _isWhitespace(currentText.codeUnitAt(previous.length))) {
+        keywordStats._record(true);
+        _keywordText = currentText;
+        if (recall.addKeywordsOf(
+          currentText.substring(previous.length),
+          _queryKeywords,
+        )) {
+          _keywordsVersion++;
+        }
+        return;
+      }
+    }
+
+    keywordStats._record(false);
+    final keywords = recall.buildQueryKeywords(currentText, history);
+    _keywordText = currentText;
+    _keywordHistory = List<Transcription>.of(history, growable: false);
+    if (keywords.length == _queryKeywords.length &&
+        _queryKeywords.containsAll(keywords)) {
+      return;
+    }
+    _queryKeywords
+      ..clear()
+      ..addAll(keywords);
+    _keywordsVersion++;
+  }
+
+  List<String> _resolvePreferredTerms({
+    required String currentText,
+    required List<Transcription> historyHead,
+    required List<DictionaryEntry> dictionaryEntries,
+    required SessionGlossary sessionGlossary,
+    required List<TermContextEntry> termContextEntries,
+    required int maxTerms,
+  }) {
+    final cached = _preferredTerms;
+    if (cached != null &&
+        identical(_termDictionary, dictionaryEntries) &&
+        identical(_termContext, termContextEntries) &&
+        identical(_termGlossary, sessionGlossary) &&
+        _termGlossaryGeneration == sessionGlossary.generation &&
+        _termKeywordsVersion == _keywordsVersion &&
+        _termMaxTerms == maxTerms) {
+      termStats._record(true);
+      return cached;
+    }
+    termStats._record(false);
+
+    final terms = builder.recallService.recallPreferredTerms(
+      currentText: currentText,
+      history: historyHead,
+      dictionaryEntries: dictionaryEntries,
+      sessionGlossary: sessionGlossary,
+      termContextEntries: termContextEntries,
+      maxTerms: maxTerms,
+      queryKeywords: _queryKeywords,
+    );
+    _preferredTerms = terms;
+    _termDictionary = dictionaryEntries;
+    _termContext = termContextEntries;
+    _termGlossary = sessionGlossary;
+    _termGlossaryGeneration = sessionGlossary.generation;
+    _termKeywordsVersion = _keywordsVersion;
+    _termMaxTerms = maxTerms;
+    return terms;
+  }
+
+  EntityPromptBundle _resolveEntityBundle({
+    required String currentText,
+    required List<Transcription> historyHead,
+    required TermPromptStaticParts staticParts,
+    required SessionEntityState sessionEntityState,
+    required List<EntityMemory> entityMemories,
+    required List<EntityAlias> entityAliases,
+    required List<EntityRelation> entityRelations,
+  }) {
+    final index = EntityRecallIndex.of(
+      memories: entityMemories,
+      aliases: entityAliases,
+      relations: entityRelations,
+    );
+    final mentions = _resolveMentions(index, currentText.trim());
+    final cached = _entityBundle;
+    if (cached != null &&
+        identical(_entityIndex, index) &&
+        identical(_entityState, sessionEntityState) &&
+        _entityStateGeneration == sessionEntityState.generation &&
+        identical(_entityStaticParts, staticParts) &&
+        _entityMentions.sameAs(mentions) &&
+        _sameItems(_entityHistory, historyHead)) {
+      entityStats._record(true);
+      return cached;
+    }
+    entityStats._record(false);
+
+    final bundle = builder.buildEntityBundle(
+      currentText: currentText,
+      history: historyHead,
+      staticParts: staticParts,
+      sessionEntityState: sessionEntityState,
+      entityMemories: entityMemories,
+      entityAliases: entityAliases,
+      entityRelations: entityRelations,
+      currentMentions: mentions,
+    );
+    _entityBundle = bundle;
+    _entityIndex = index;
+    _entityState = sessionEntityState;
+    _entityStateGeneration = sessionEntityState.generation;
+    _entityStaticParts = staticParts;
+    _entityMentions = mentions;
+    _entityHistory = List<Transcription>.of(historyHead, growable: false);
+    return bundle;
+  }
+
+  /// 当前文本 [text]（已去除首尾空白）中的实体提及；文本只追加时仅扫描
+  /// 新增部分。
+  EntityMentions _resolveMentions(EntityRecallIndex index, String text) {
+    final previous = _mentionText;
+    if (previous != null &&
+        identical(_mentionIndex, index) &&
+        text.startsWith(previous)) {
+      if (text.length > previous.length) {
+        _mentions = index.scanAppended(_mentions, text, previous.length);
+        _mentionText = text;
+      }
+      return _mentions;
+    }
+    _mentions = index.scan(text);
+    _mentionIndex = index;
+    _mentionText = text;
+    return _mentions;
+  }
+
+  static bool _sameItems(List<Transcription> a, List<Transcription> b) {
+    if (a.length != b.length) return false;
+    for (var i = 0; i < a.length; i++) {
+      if (!identical(a[i], b[i])) return false;
+    }
+    return true;
+  }
+
+  static bool _isWhitespace(int unit) {
+    return unit == 0x20 ||
+        (unit >= 0x09 && unit <= 0x0D) ||
+        unit == 0xA0 ||
+        unit == 0x3000;
+  }
+}
@@ -0,0 +1,246 @@
+import '../models/dictionary_entry.dart';
+import '../models/term_context_entry.dart';
+
+/// 召回候选术语及其预计算特征。
+class IndexedTerm {
+  final String term;
+
+  /// 小写形式，用于关键词匹配与去重。
+  final String key;
+
+  /// 来源加分：词典条目按来源，上下文术语按类型。
+  final double sourceBonus;
+
+  /// 上下文术语的置信度（词典条目为 null）。
+  final double? confidence;
+  final int sourcePriority;
+  final bool hasUpperCase;
+  final bool hasChinese;
+
+  const IndexedTerm({
+    required this.term,
+    required this.key,
+    required this.sourceBonus,
+    required this.sourcePriority,
+    required this.hasUpperCase,
+    required this.hasChinese,
+    this.confidence,
+  });
+
+  /// 与原逐条打分完全一致的合成顺序：匹配分 → 字形特征 → 来源加分。
+  double scoreWith(double matchScore, {required bool hasKeywords}) {
+    var score = matchScore;
+    if (!hasKeywords) {
+      score = term.length <= 8 ? 1.0 : 0.5;
+    } else {
+      if (hasUpperCase) score += 1.5;
+      if (hasChinese) score += 1;
+    }
+    score += sourceBonus;
+    final value = confidence;
+    if (value != null) score += value;
+    return score;
+  }
+}
+
+/// 术语召回索引。
+///
+/// 对词典与上下文术语的标准写法建立：
+/// - 小写全词哈希表：用于「关键词包含术语」与完全相等
+/// - 二元组倒排表：用于「术语包含关键词」
+/// - 两种无匹配时的静态排序（有关键词 / 无关键词），供 Top-K 补位
+///
+/// 召回代价只与命中术语数和 K 相关，不随词典规模线性增长。
+/// 索引按词典/上下文列表实例缓存，列表替换后才重建。
+class TermRecallIndex {
+  static final RegExp _upperCasePattern = RegExp(r'[A-Z]');
+  static final RegExp _chinesePattern = RegExp(r'[\u4e00-\u9fff]');
+
+  final List<DictionaryEntry> dictionaryEntries;
+  final List<TermContextEntry> termContextEntries;
+
+  final List<IndexedTerm> _terms = [];
+  final Map<String, int> _termByKey = {};
+  final Map<String, List<int>> _bigramPostings = {};
+  int _maxKeyLength = 0;
+  late final List<int> _rankedWithKeywords = _rankStatic(hasKeywords: true);
+  late final List<int> _rankedWithoutKeywords = _rankStatic(
+    hasKeywords: false,
+  );
+
+  TermRecallIndex._(this.dictionaryEntries, this.termContextEntries) {
+    _build();
+  }
+
+  static final Expando<TermRecallIndex> _indexByEntries = Expando(
+    'TermRecallIndex',
+  );
+
+  static TermRecallIndex of({
+    required List<DictionaryEntry> dictionaryEntries,
+    required List<TermContextEntry> termContextEntries,
+  }) {
+    final cached = _indexByEntries[dictionaryEntries];
+    if (cached != null &&
+        identical(cached.termContextEntries, termContextEntries)) {
+      return cached;
+    }
+    final index = TermRecallIndex._(dictionaryEntries, termContextEntries);
+    _indexByEntries[dictionaryEntries] = index;
+    return index;
+  }
+
+  int get length => _terms.length;
+
+  /// 词典条目用于提示的标准写法。
+  static String canonicalTermOf(DictionaryEntry entry) {
+    final corrected = (entry.corrected ?? '').trim();
+    final original = entry.original.trim();
+    if (entry.type == DictionaryEntryType.correction && corrected.isNotEmpty) {
+      final originalHasChinese = _chinesePattern.hasMatch(original);
+      final correctedHasChinese = _chinesePattern.hasMatch(corrected);
+      if (originalHasChinese && !correctedHasChinese) {
+        return original;
+      }
+      return corrected;
+    }
+    return original;
+  }
+
+  void _build() {
+    for (final entry in dictionaryEntries.where((e) => e.enabled)) {
+      final canonical = canonicalTermOf(entry);
+      if (canonical.isEmpty) continue;
+      final historyEdit = entry.source == DictionaryEntrySource.historyEdit;
+      _add(
+        canonical,
+        sourceBonus: historyEdit ? 8.0 : 4.0,
+        sourcePriority: historyEdit ? 1 : 2,
+      );
+    }
+
+    for (final entry in termContextEntries.where((e) => e.enabled)) {
+      if (entry.isDocumentContext) continue;
+      final value = entry.promptTerm.trim();
+      if (value.isEmpty) continue;
+      final sourceBonus = switch (entry.entryType) {
+        TermContextEntryType.correctionHint => 3.5,
+        TermContextEntryType.preserveHint => 3.0,
+        TermContextEntryType.reference => 1.5,
+      };
+      _add(
+        value,
+        sourceBonus: sourceBonus,
+        confidence: entry.confidence,
+        sourcePriority: 3,
+      );
+    }
+  }
+
+  void _add(
+    String term, {
+    required double sourceBonus,
+    required int sourcePriority,
+    double? confidence,
+  }) {
+    final key = term.toLowerCase();
+    if (_termByKey.containsKey(key)) return;
+    final position = _terms.length;
+    _terms.add(
+      IndexedTerm(
+        term: term,
+        key: key,
+        sourceBonus: sourceBonus,
+        confidence: confidence,
+        sourcePriority: sourcePriority,
+        hasUpperCase: _upperCasePattern.hasMatch(term),
+        hasChinese: _chinesePattern.hasMatch(term),
+      ),
+    );
+    _termByKey[key] = position;
+    if (key.length > _maxKeyLength) _maxKeyLength = key.length;
+    final bigrams = <String>{};
+    for (var i = 0; i + 2 <= key.length; i++) {
+      bigrams.add(key.substring(i, i + 2));
+    }
+    for (final bigram in bigrams) {
+      _bigramPostings.putIfAbsent(bigram, () => []).add(position);
+    }
+  }
+
+  /// 计算与关键词有交集的术语的匹配分（未出现的术语匹配分为 0）。
+  ///
+  /// 与原逐条打分一致：每个关键词完全相等计 20，互相包含计 8。
+  Map<int, double> matchScores(Set<String> queryKeywords) {
+    final scores = <int, double>{};
+    for (final keyword in queryKeywords) {
+      final matched = <int>{};
+
+      // 关键词包含术语（含完全相等）：枚举关键词子串查全词表。
+      final maxLength = keyword.length < _maxKeyLength
+          ? keyword.length
+          : _maxKeyLength;
+      for (var start = 0; start < keyword.length; start++) {
+        var last = start + maxLength;
+        if (last > keyword.length) last = keyword.length;
+        for (var end = start + 1; end <= last; end++) {
+          final position = _termByKey[keyword.substring(start, end)];
+          if (position != null) matched.add(position);
+        }
+      }
+
+      // 术语包含关键词：取关键词中最稀有的二元组倒排表后逐一校验。
+      List<int>? postings;
+      for (var i = 0; i + 2 <= keyword.length; i++) {
+        final list = _bigramPostings[keyword.substring(i, i + 2)];
+        if (list == null) {
+          postings = null;
+          break;
+        }
+        if (postings == null || list.length < postings.length) {
+          postings = list;
+        }
+      }
+      if (postings != null) {
+        for (final position in postings) {
+          if (_terms[position].key.contains(keyword)) matched.add(position);
+        }
+      }
+
+      for (final position in matched) {
+        final gain = _terms[position].key == keyword ? 20.0 : 8.0;
+        scores.update(
+          position,
+          (value) => value + gain,
+          ifAbsent: () => gain,
+        );
+      }
+    }
+    return scores;
+  }
+
+  /// 无匹配时的静态排序（按最终排序规则），用于 Top-K 补位。
+  List<int> rankedPositions({required bool hasKeywords}) =>
+      hasKeywords ? _rankedWithKeywords : _rankedWithoutKeywords;
+
+  IndexedTerm termAt(int position) => _terms[position];
+
+  List<int> _rankStatic({required bool hasKeywords}) {
+    final scores = [
+      for (final term in _terms) term.scoreWith(0, hasKeywords: hasKeywords),
+    ];
+    final positions = List<int>.generate(_terms.length, (i) => i)
+      ..sort((a, b) {
+        final byScore = scores[b].compareTo(scores[a]);
+        if (byScore != 0) return byScore;
+        final termA = _terms[a];
+        final termB = _terms[b];
+        final bySource = termA.sourcePriority.compareTo(termB.sourcePriority);
+        if (bySource != 0) return bySource;
+        final byLength = termB.term.length.compareTo(termA.term.length);
+        if (byLength != 0) return byLength;
+        return termA.term.compareTo(termB.term);
+      });
+    return List.unmodifiable(positions);
+  }
+}
@@ -2,6 +2,7 @@ import '../models/dictionary_entry.dart';
 import '../models/term_context_entry.dart';
 import '../models/transcription.dart';
 import 'session_glossary.dart';
+import 'term_recall_index.dart';
 
 class TermRecallService {
   static const int defaultMaxTerms = 18;
@@ -15,9 +16,17 @@ class TermRecallService {
     required SessionGlossary sessionGlossary,
     List<TermContextEntry> termContextEntries = const [],
     int maxTerms = defaultMaxTerms,
+    Set<String>? queryKeywords,
   }) {
-    final queryKeywords = _buildQueryKeywords(currentText, history);
-    final scored = <_ScoredTerm>[];
+    if (maxTerms <= 0) return const [];
+    final index = TermRecallIndex.of(
+      dictionaryEntries: dictionaryEntries,
+      termContextEntries: termContextEntries,
+    );
+    final keywords =
+        queryKeywords ?? buildQueryKeywords(currentText, history);
+    final hasKeywords = keywords.isNotEmpty;
+    final topK = _TopKTerms(maxTerms);
     final seen = <String>{};
 
     for (final pin in sessionGlossary.strongEntries.values) {
@@ -25,7 +34,7 @@ class TermRecallService {
       if (canonical.isEmpty) continue;
       final key = canonical.toLowerCase();
       if (!seen.add(key)) continue;
-      scored.add(
+      topK.offer(
         _ScoredTerm(
           term: canonical,
           score: 100 + pin.hitCount.toDouble(),
@@ -34,127 +43,71 @@ class TermRecallService {
       );
     }
 
-    for (final entry in dictionaryEntries.where((e) => e.enabled)) {
-      final canonical = _canonicalTerm(entry);
-      if (canonical.isEmpty) continue;
-      final key = canonical.toLowerCase();
-      if (!seen.add(key)) continue;
-      final score = _scoreTerm(canonical, queryKeywords) +
-          (entry.source == DictionaryEntrySource.historyEdit ? 8 : 4);
-      scored.add(
+    // 命中关键词的术语：代价只与命中数相关。
+    final matchScores = hasKeywords
+        ? index.matchScores(keywords)
+        : const <int, double>{};
+    for (final entry in matchScores.entries) {
+      final term = index.termAt(entry.key);
+      if (seen.contains(term.key)) continue;
+      topK.offer(
         _ScoredTerm(
-          term: canonical,
-          score: score,
-          sourcePriority: entry.source == DictionaryEntrySource.historyEdit
-              ? 1
-              : 2,
+          term: term.term,
+          score: term.scoreWith(entry.value, hasKeywords: true),
+          sourcePriority: term.sourcePriority,
         ),
       );
     }
 
-    for (final entry in termContextEntries.where((e) => e.enabled)) {
-      if (entry.isDocumentContext) continue;
-      final value = entry.promptTerm.trim();
-      if (value.isEmpty) continue;
-      final key = value.toLowerCase();
-      if (!seen.add(key)) continue;
-      final sourceBonus = switch (entry.entryType) {
-        TermContextEntryType.correctionHint => 3.5,
-        TermContextEntryType.preserveHint => 3.0,
-        TermContextEntryType.reference => 1.5,
-      };
-      scored.add(
+    // 未命中的术语得分只由预计算特征决定，按静态顺序补足前 K 个即可。
+    var filled = 0;
+    for (final position in index.rankedPositions(hasKeywords: hasKeywords)) {
+      if (filled >= maxTerms) break;
+      if (matchScores.containsKey(position)) continue;
+      final term = index.termAt(position);
+      if (seen.contains(term.key)) continue;
+      topK.offer(
         _ScoredTerm(
-          term: value,
-          score: _scoreTerm(value, queryKeywords) + sourceBonus + entry.confidence,
-          sourcePriority: 3,
+          term: term.term,
+          score: term.scoreWith(0, hasKeywords: hasKeywords),
+          sourcePriority: term.sourcePriority,
         ),
       );
+      filled++;
     }
 
-    scored.sort((a, b) {
-      final byScore = b.score.compareTo(a.score);
-      if (byScore != 0) return byScore;
-      final bySource = a.sourcePriority.compareTo(b.sourcePriority);
-      if (bySource != 0) return bySource;
-      final byLength = b.term.length.compareTo(a.term.length);
-      if (byLength != 0) return byLength;
-      return a.term.compareTo(b.term);
-    });
-
-    final terms = scored
-        .map((e) => e.term)
-        .take(maxTerms)
-        .toList(growable: false);
-    if (terms.isNotEmpty) return terms;
-
-    return dictionaryEntries
-        .where((e) => e.enabled)
-        .map(_canonicalTerm)
-        .where((e) => e.isNotEmpty)
-        .take(maxTerms)
-        .toList(growable: false);
+    return topK.sorted().map((e) => e.term).toList(growable: false);
   }
 
-  Set<String> _buildQueryKeywords(
+  static final RegExp _keywordPattern = RegExp(
+    r'[A-Za-z][A-Za-z0-9\-_]{1,}|[0-9]+(?:\.[0-9]+)?|[\u4e00-\u9fff]{2,}',
+  );
+
+  /// 由当前文本与最近 5 条历史构建查询关键词。
+  Set<String> buildQueryKeywords(
     String currentText,
     List<Transcription> history,
   ) {
-    final candidates = <String>[
-      currentText,
-      ...history.take(5).map((e) => e.text),
-    ];
     final keywords = <String>{};
-    final regex = RegExp(
-      r'[A-Za-z][A-Za-z0-9\-_]{1,}|[0-9]+(?:\.[0-9]+)?|[\u4e00-\u9fff]{2,}',
-    );
-    for (final text in candidates) {
-      for (final match in regex.allMatches(text)) {
-        final value = match.group(0)!.trim().toLowerCase();
-        if (value.length >= 2) {
-          keywords.add(value);
-        }
-      }
+    addKeywordsOf(currentText, keywords);
+    for (final item in history.take(5)) {
+      addKeywordsOf(item.text, keywords);
     }
     return keywords;
   }
 
-  double _scoreTerm(String term, Set<String> queryKeywords) {
-    if (queryKeywords.isEmpty) {
-      return term.length <= 8 ? 1 : 0.5;
-    }
-    final normalized = term.toLowerCase();
-    var score = 0.0;
-    for (final keyword in queryKeywords) {
-      if (normalized == keyword) {
-        score += 20;
-        continue;
-      }
-      if (normalized.contains(keyword) || keyword.contains(normalized)) {
-        score += 8;
+  /// 将 [text] 中的关键词并入 [keywords]，返回是否新增了关键词。
+  ///
+  /// 关键词不会跨越空白，因此以空白开头的追加文本可单独提取后并入。
+  bool addKeywordsOf(String text, Set<String> keywords) {
+    var added = false;
+    for (final match in _keywordPattern.allMatches(text)) {
+      final value = match.group(0)!.trim().toLowerCase();
+      if (value.length >= 2 && keywords.add(value)) {
+        added = true;
       }
     }
-    if (RegExp(r'[A-Z]').hasMatch(term)) {
-      score += 1.5;
-    }
-    if (RegExp(r'[\u4e00-\u9fff]').hasMatch(term)) {
-      score += 1;
-    }
-    return score;
-  }
-
-  String _canonicalTerm(DictionaryEntry entry) {
-    final corrected = (entry.corrected ?? '').trim();
-    final original = entry.original.trim();
-    if (entry.type == DictionaryEntryType.correction && corrected.isNotEmpty) {
-      final originalHasChinese = RegExp(r'[\u4e00-\u9fff]').hasMatch(original);
-      final correctedHasChinese = RegExp(r'[\u4e00-\u9fff]').hasMatch(corrected);
-      if (originalHasChinese && !correctedHasChinese) {
-        return original;
-      }
-      return corrected;
-    }
-    return original;
+    return added;
   }
 }
 
@@ -169,3 +122,68 @@ class _ScoredTerm {
     required this.sourcePriority,
   });
 }
+
+int _compareScoredTerms(_ScoredTerm a, _ScoredTerm b) {
+  final byScore = b.score.compareTo(a.score);
+  if (byScore != 0) return byScore;
+  final bySource = a.sourcePriority.compareTo(b.sourcePriority);
+  if (bySource != 0) return bySource;
+  final byLength = b.term.length.compareTo(a.term.length);
+  if (byLength != 0) return byLength;
+  return a.term.compareTo(b.term);
+}
+
+/// 容量为 K 的小顶堆：堆顶为当前入选中最差的一项。
+class _TopKTerms {
+  final int capacity;
+  final List<_ScoredTerm> _heap = [];
+
+  _TopKTerms(this.capacity);
+
+  void offer(_ScoredTerm item) {
+    if (_heap.length < capacity) {
+      _heap.add(item);
+      _siftUp(_heap.length - 1);
+      return;
+    }
+    if (_compareScoredTerms(item, _heap.first) >= 0) return;
+    _heap[0] = item;
+    _siftDown(0);
+  }
+
+  List<_ScoredTerm> sorted() =>
+      _heap.toList(growable: false)..sort(_compareScoredTerms);
+
+  /// 排序更靠后（更差）的项在堆中更靠上。
+  bool _worse(int i, int j) => _compareScoredTerms(_heap[i], _heap[j]) > 0;
+
+  void _siftUp(int index) {
+    var child = index;
+    while (child > 0) {
+      final parent = (child - 1) >> 1;
+      if (!_worse(child, parent)) break;
+      _swap(child, parent);
+      child = parent;
+    }
+  }
+
+  void _siftDown(int index) {
+    var parent = index;
+    while (true) {
+      final left = parent * 2 + 1;
+      if (left >= _heap.length) break;
+      final right = left + 1;
+      var worst = left;
+      if (right < _heap.length && _worse(right, left)) worst = right;
+      if (!_worse(worst, parent)) break;
+      _swap(worst, parent);
+      parent = worst;
+    }
+  }
+
+  void _swap(int i, int j) {
+    final tmp = _heap[i];
+    _heap[i] = _heap[j];
+    _heap[j] = tmp;
+  }
+}
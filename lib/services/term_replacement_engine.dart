@@ -0,0 +1,342 @@
+import '../models/dictionary_entry.dart';
+import 'pinyin_matcher.dart';
+
+final RegExp _chinesePattern = RegExp(r'[\u4e00-\u9fff]');
+
+/// 术语归一化替换引擎。
+///
+/// 将词典中所有「模式 → 标准词」规则编译进一棵字典树：
+/// - 中文标准词的拉丁别名（大小写不敏感）
+/// - 中文标准词的拼音音节序列（音节间允许空白/下划线/连字符，两端需词边界）
+/// - 中文别名条目的拉丁原词（大小写不敏感）
+///
+/// 每次调用只对文本做一次从左到右的扫描，按「最左最长」原则替换，
+/// 取代原先逐条构建 RegExp 并多次全文替换的做法。
+/// 命中片段（observedText）随输入变化，作为单次调用的小型叠加树参与同一遍扫描。
+///
+/// 引擎按 [PinyinMatcher.indexVersion] 缓存，仅在词典重建索引后重新编译。
+class TermReplacementEngine {
+  /// 编译时对应的词典索引版本。
+  final int version;
+
+  final _TrieNode _root = _TrieNode();
+  int _patternCount = 0;
+
+  TermReplacementEngine.build(
+    List<DictionaryEntry> entries, {
+    this.version = 0,
+  }) {
+    for (final entry in entries) {
+      _compileEntry(entry);
+    }
+  }
+
+  static final Expando<TermReplacementEngine> _engineByMatcher = Expando(
+    'TermReplacementEngine',
+  );
+
+  /// 获取与 [matcher] 当前索引版本对应的引擎，版本未变时复用缓存。
+  static TermReplacementEngine forMatcher(PinyinMatcher matcher) {
+    final cached = _engineByMatcher[matcher];
+    if (cached != null && cached.version == matcher.indexVersion) {
+      return cached;
+    }
+    final engine = TermReplacementEngine.build(
+      matcher.indexedEntries,
+      version: matcher.indexVersion,
+    );
+    _engineByMatcher[matcher] = engine;
+    return engine;
+  }
+
+  /// 已编译的词典级模式数量。
+  int get patternCount => _patternCount;
+
+  static bool containsChinese(String text) => _chinesePattern.hasMatch(text);
+
+  /// 中文标准词 + 拉丁别名（如 好数连 / hao shu lian），归一化目标为中文原词。
+  static bool isChineseToLatinAlias(DictionaryEntry entry) {
+    final original = entry.original.trim();
+    final corrected = entry.corrected?.trim() ?? '';
+    return entry.type == DictionaryEntryType.correction &&
+        corrected.isNotEmpty &&
+        containsChinese(original) &&
+        !containsChinese(corrected);
+  }
+
+  /// 对 [text] 应用 [hits] 所选条目的归一化规则，单遍扫描完成所有替换。
+  String apply(String text, List<PinyinMatchHit> hits) {
+    if (text.isEmpty || hits.isEmpty) return text;
+
+    final activeEntryIds = <String>{};
+    _TrieNode? overlay;
+    var order = _patternCount;
+    for (final hit in hits) {
+      final entry = hit.entry;
+      final alias = entry.corrected?.trim() ?? '';
+      final original = entry.original.trim();
+      final observed = hit.observedText.trim();
+
+      if (isChineseToLatinAlias(entry)) {
+        if (alias.isEmpty || original.isEmpty) continue;
+        activeEntryIds.add(entry.id);
+        if (observed.isNotEmpty &&
+            observed != original &&
+            containsChinese(observed)) {
+          overlay ??= _TrieNode();
+          _insert(
+            overlay,
+            _TermPattern(
+              source: observed,
+              replacement: original,
+              caseSensitive: true,
+              order: order++,
+            ),
+          );
+        }
+        continue;
+      }
+
+      // 拉丁命中片段回收为中文别名：仅当命中片段本身证明应当合并时生效。
+      if (entry.type == DictionaryEntryType.correction &&
+          alias.isNotEmpty &&
+          containsChinese(alias) &&
+          observed.isNotEmpty &&
+          !containsChinese(observed)) {
+        activeEntryIds.add(entry.id);
+        overlay ??= _TrieNode();
+        _insert(
+          overlay,
+          _TermPattern(source: observed, replacement: alias, order: order++),
+        );
+      }
+    }
+
+    if (activeEntryIds.isEmpty && overlay == null) return text;
+    final roots = overlay == null ? [_root] : [_root, overlay];
+    return _scan(text, roots, activeEntryIds);
+  }
+
+  void _compileEntry(DictionaryEntry entry) {
+    if (!entry.enabled) return;
+    final alias = entry.corrected?.trim() ?? '';
+    final original = entry.original.trim();
+
+    if (isChineseToLatinAlias(entry)) {
+      if (alias.isEmpty || original.isEmpty) return;
+      _insert(
+        _root,
+        _TermPattern(
+          entryId: entry.id,
+          source: alias,
+          replacement: original,
+          order: _patternCount++,
+        ),
+      );
+
+      final pinyin = PinyinMatcher.computePinyin(original);
+      final syllables = pinyin
+          .split(' ')
+          .where((s) => s.isNotEmpty)
+          .toList(growable: false);
+      if (syllables.isNotEmpty) {
+        _insert(
+          _root,
+          _TermPattern(
+            entryId: entry.id,
+            source: syllables.join(' '),
+            replacement: original,
+            wordBoundary: true,
+            order: _patternCount++,
+          ),
+          syllables: syllables,
+        );
+      }
+      return;
+    }
+
+    if (entry.type == DictionaryEntryType.correction &&
+        containsChinese(alias) &&
+        original.isNotEmpty &&
+        !containsChinese(original)) {
+      _insert(
+        _root,
+        _TermPattern(
+          entryId: entry.id,
+          source: original,
+          replacement: alias,
+          order: _patternCount++,
+        ),
+      );
+    }
+  }
+
+  /// 插入模式。传入 [syllables] 时逐音节插入，音节衔接处允许分隔符。
+  void _insert(
+    _TrieNode root,
+    _TermPattern pattern, {
+    List<String>? syllables,
+  }) {
+    final parts = syllables ?? [pattern.source];
+    var node = root;
+    for (var p = 0; p < parts.length; p++) {
+      final part = parts[p];
+      for (var i = 0; i < part.length; i++) {
+        final key = _foldAscii(part.codeUnitAt(i));
+        node = node.children.putIfAbsent(key, _TrieNode.new);
+      }
+      if (p < parts.length - 1) node.separatorJoint = true;
+    }
+    (node.terminals ??= <_TermPattern>[]).add(pattern);
+  }
+
+  String _scan(
+    String text,
+    List<_TrieNode> roots,
+    Set<String> activeEntryIds,
+  ) {
+    final out = StringBuffer();
+    var copyFrom = 0;
+    var i = 0;
+    while (i < text.length) {
+      final match = _longestMatchAt(text, i, roots, activeEntryIds);
+      if (match == null) {
+        i++;
+        continue;
+      }
+      out
+        ..write(text.substring(copyFrom, i))
+        ..write(match.pattern.replacement);
+      i = match.end;
+      copyFrom = i;
+    }
+    if (copyFrom == 0) return text;
+    out.write(text.substring(copyFrom));
+    return out.toString();
+  }
+
+  _TermMatch? _longestMatchAt(
+    String text,
+    int start,
+    List<_TrieNode> roots,
+    Set<String> activeEntryIds,
+  ) {
+    var states = roots;
+    _TermPattern? best;
+    var bestEnd = -1;
+    for (var j = start; j < text.length && states.isNotEmpty; j++) {
+      final unit = text.codeUnitAt(j);
+      final key = _foldAscii(unit);
+      final next = <_TrieNode>[];
+      for (final state in states) {
+        final child = state.children[key];
+        if (child != null) {
+          next.add(child);
+          final accepted = _acceptedPattern(
+            child,
+            text,
+            start,
+            j + 1,
+            activeEntryIds,
+          );
+          if (accepted != null &&
+              (best == null ||
+                  j + 1 > bestEnd ||
+                  accepted.order < best.order)) {
+            best = accepted;
+            bestEnd = j + 1;
+          }
+        }
+        if (state.separatorJoint && _isSeparator(unit)) {
+          next.add(state);
+        }
+      }
+      states = next;
+    }
+    if (best == null) return null;
+    return _TermMatch(pattern: best, end: bestEnd);
+  }
+
+  _TermPattern? _acceptedPattern(
+    _TrieNode node,
+    String text,
+    int start,
+    int end,
+    Set<String> activeEntryIds,
+  ) {
+    final terminals = node.terminals;
+    if (terminals == null) return null;
+    for (final pattern in terminals) {
+      final entryId = pattern.entryId;
+      if (entryId != null && !activeEntryIds.contains(entryId)) continue;
+      if (pattern.caseSensitive &&
+          text.substring(start, end) != pattern.source) {
+        continue;
+      }
+      if (pattern.wordBoundary &&
+          ((start > 0 && _isWordUnit(text.codeUnitAt(start - 1))) ||
+              (end < text.length && _isWordUnit(text.codeUnitAt(end))))) {
+        continue;
+      }
+      return pattern;
+    }
+    return null;
+  }
+
+  static int _foldAscii(int unit) {
+    if (unit >= 0x41 && unit <= 0x5A) return unit + 0x20;
+    return unit;
+  }
+
+  /// 与 RegExp `\b` 一致的 ASCII 词字符：[A-Za-z0-9_]。
+  static bool _isWordUnit(int unit) {
+    return (unit >= 0x30 && unit <= 0x39) ||
+        (unit >= 0x41 && unit <= 0x5A) ||
+        (unit >= 0x61 && unit <= 0x7A) ||
+        unit == 0x5F;
+  }
+
+  static bool _isSeparator(int unit) {
+    return unit == 0x20 ||
+        (unit >= 0x09 && unit <= 0x0D) ||
+        unit == 0xA0 ||
+        unit == 0x3000 ||
+        unit == 0x5F ||
+        unit == 0x2D;
+  }
+}
+
+class _TrieNode {
+  final Map<int, _TrieNode> children = {};
+
+  /// 拼音音节衔接点：此处可跳过任意个分隔符。
+  bool separatorJoint = false;
+
+  List<_TermPattern>? terminals;
+}
+
+class _TermPattern {
+  /// 所属词典条目；为 null 表示单次调用的命中片段模式，始终生效。
+  final String? entryId;
+  final String source;
+  final String replacement;
+  final bool caseSensitive;
+  final bool wordBoundary;
+  final int order;
+
+  const _TermPattern({
+    this.entryId,
+    required this.source,
+    required this.replacement,
+    this.caseSensitive = false,
+    this.wordBoundary = false,
+    required this.order,
+  });
+}
+
+class _TermMatch {
+  final _TermPattern pattern;
+  final int end;
+
+  const _TermMatch({required this.pattern, required this.end});
+}
@@ -0,0 +1,278 @@
+import 'dart:async';
+import 'dart:isolate';
+
+import '../models/dictionary_entry.dart';
+import 'local_correction_plan.dart';
+import 'pinyin_matcher.dart';
+
+/// 文本流水线的后台计算 isolate 池。
+///
+/// 拼音匹配、候选打分与术语归一化在长段落、大词典下耗时明显，
+/// 放在 UI isolate 上会让悬浮窗和界面卡顿。池内常驻 [workerCount] 个
+/// worker isolate，各自持有词典索引的只读快照。快照以 [PinyinMatcher]
+/// 实例和 [PinyinMatcher.indexVersion] 标识，每个版本只向每个 worker
+/// 发送一次，之后的请求只传输入文本。
+///
+/// worker 启动失败或意外退出时，请求以异常结束，调用方应退回当前
+/// isolate 计算；之后的请求会重新拉起 worker（启动失败后冷却
+/// [respawnCooldown]）。
+class TextComputePool {
+  TextComputePool({this.workerCount = 2});
+  static final instance = TextComputePool();
+
+  static const Duration respawnCooldown = Duration(seconds: 30);
+
+  final int workerCount;
+  final List<_Worker> _workers = [];
+  Future<void>? _starting;
+  DateTime? _spawnFailedAt;
+  int _spawned = 0;
+
+  static final Expando<int> _matcherIds = Expando('TextComputePool');
+  static int _nextMatcherId = 1;
+
+  /// 提前拉起 worker 并下发 [matcher] 当前版本的快照，
+  /// 让首个分段不必承担启动与索引构建的耗时。
+  Future<void> prepare(PinyinMatcher matcher) async {
+    if (matcher.indexedEntries.isEmpty) return;
+    await _ensureStarted();
+    for (final worker in _workers) {
+      _syncSnapshot(worker, matcher);
+    }
+  }
+
+  /// 在后台 isolate 中计算 [text] 的 [LocalCorrectionPlan]。
+  ///
+  /// 词典为空时无需匹配，直接在当前 isolate 返回。
+  Future<LocalCorrectionPlan> planCorrection(
+    PinyinMatcher matcher,
+    String text,
+    ReferenceHitSelector selector,
+  ) async {
+    if (matcher.indexedEntries.isEmpty) {
+      return LocalCorrectionPlan.compute(matcher, text, selector);
+    }
+    await _ensureStarted();
+    final worker = _pick(_snapshotKey(matcher));
+    _syncSnapshot(worker, matcher);
+    final reply = await worker.request(
+      (id) => _PlanRequest(
+        id,
+        text,
+        selector.maxReferenceEntries,
+        selector.minCandidateScore,
+      ),
+    );
+    return reply as LocalCorrectionPlan;
+  }
+
+  /// 关闭全部 worker。未完成的请求以异常结束。
+  Future<void> dispose() async {
+    final workers = List.of(_workers);
+    _workers.clear();
+    for (final worker in workers) {
+      worker.kill();
+    }
+  }
+
+  Future<void> _ensureStarted() async {
+    _workers.removeWhere((worker) => !worker.alive);
+    if (_workers.length >= workerCount) return;
+    await (_starting ??= _fill().whenComplete(() => _starting = null));
+    if (_workers.isEmpty) {
+      throw StateError('text compute pool unavailable');
+    }
+  }
+
+  Future<void> _fill() async {
+    final failedAt = _spawnFailedAt;
+    if (failedAt != null &&
+        DateTime.now().difference(failedAt) < respawnCooldown) {
+      return;
+    }
+    while (_workers.length < workerCount) {
+      try {
+        _workers.add(await _Worker.spawn('text-compute-${_spawned++}'));
+        _spawnFailedAt = null;
+      } catch (_) {
+        _spawnFailedAt = DateTime.now();
+        return;
+      }
+    }
+  }
+
+  /// 优先选择待处理请求最少的 worker，其次选择已持有同版本快照的。
+  _Worker _pick(String snapshotKey) {
+    var best = _workers.first;
+    for (final worker in _workers.skip(1)) {
+      if (worker.pending < best.pending ||
+          (worker.pending == best.pending &&
+              worker.snapshotKey == snapshotKey &&
+              best.snapshotKey != snapshotKey)) {
+        best = worker;
+      }
+    }
+    return best;
+  }
+
+  /// 快照与之后的请求经同一端口按序到达，worker 收到请求时快照已就绪。
+  void _syncSnapshot(_Worker worker, PinyinMatcher matcher) {
+    final key = _snapshotKey(matcher);
+    if (worker.snapshotKey == key) return;
+    worker.send(
+      _IndexSnapshot(matcher.indexedEntries, matcher.enableSingleCharFuzzy),
+    );
+    worker.snapshotKey = key;
+  }
+
+  static String _snapshotKey(PinyinMatcher matcher) {
+    final id = _matcherIds[matcher] ??= _nextMatcherId++;
+    return '$id:${matcher.indexVersion}';
+  }
+}
+
+class _Worker {
+  final Isolate _isolate;
+  final ReceivePort _replies;
+  final SendPort _commands;
+  final Map<int, Completer<Object?>> _inflight = {};
+  int _nextRequestId = 1;
+  bool _alive = true;
+
+  /// 该 worker 当前持有的快照标识。
+  String? snapshotKey;
+
+  _Worker._(this._isolate, this._replies, this._commands);
+
+  bool get alive => _alive;
+  int get pending => _inflight.length;
+
+  static Future<_Worker> spawn(String name) async {
+    final replies = ReceivePort(name);
+    final ready = Completer<SendPort>();
+    _Worker? worker;
+    replies.listen((message) {
+      if (message is SendPort) {
+        ready.complete(message);
+      } else if (message is _Reply) {
+        worker?._complete(message);
+      } else if (message == null) {
+        // onExit：isolate 已退出。
+        if (!ready.isCompleted) {
+          ready.completeError(StateError('$name exited during startup'));
+        }
+        worker?._shutdown();
+        replies.close();
+      }
+    });
+    try {
+      final isolate = await Isolate.spawn(
+        _workerMain,
+        replies.sendPort,
+        onExit: replies.sendPort,
+        debugName: name,
+      );
+      worker = _Worker._(isolate, replies, await ready.future);
+      return worker;
+    } catch (_) {
+      replies.close();
+      rethrow;
+    }
+  }
+
+  void send(Object message) => _commands.send(message);
+
+  Future<Object?> request(Object Function(int id) build) {
+    if (!_alive) {
+      return Future.error(StateError('text compute worker has exited'));
+    }
+    final id = _nextRequestId++;
+    final completer = Completer<Object?>();
+    _inflight[id] = completer;
+    _commands.send(build(id));
+    return completer.future;
+  }
+
+  void kill() {
+    _isolate.kill(priority: Isolate.immediate);
+    _shutdown();
+    _replies.close();
+  }
+
+  void _complete(_Reply reply) {
+    final completer = _inflight.remove(reply.id);
+    if (completer == null) return;
+    final error = reply.error;
+    if (error != null) {
+      completer.completeError(StateError(error));
+    } else {
+      completer.complete(reply.value);
+    }
+  }
+
+  void _shutdown() {
+    _alive = false;
+    final inflight = List.of(_inflight.values);
+    _inflight.clear();
+    for (final completer in inflight) {
+      completer.completeError(StateError('text compute worker has exited'));
+    }
+  }
+}
+
+void _workerMain(SendPort replies) {
+  final commands = ReceivePort();
+  replies.send(commands.sendPort);
+  var matcher = PinyinMatcher();
+  commands.listen((message) {
+    switch (message) {
+      case _IndexSnapshot snapshot:
+        matcher = PinyinMatcher(
+          enableSingleCharFuzzy: snapshot.enableSingleCharFuzzy,
+        )..buildIndex(snapshot.entries);
+      case _PlanRequest request:
+        try {
+          final plan = LocalCorrectionPlan.compute(
+            matcher,
+            request.text,
+            ReferenceHitSelector(
+              maxReferenceEntries: request.maxReferenceEntries,
+              minCandidateScore: request.minCandidateScore,
+            ),
+          );
+          replies.send(_Reply(request.id, value: plan));
+        } catch (e) {
+          replies.send(_Reply(request.id, error: '$e'));
+        }
+    }
+  });
+}
+
+class _IndexSnapshot {
+  final List<DictionaryEntry> entries;
+  final bool enableSingleCharFuzzy;
+
+  const _IndexSnapshot(this.entries, this.enableSingleCharFuzzy);
+}
+
+class _PlanRequest {
+  final int id;
+  final String text;
+  final int maxReferenceEntries;
+  final double minCandidateScore;
+
+  const _PlanRequest(
+    this.id,
+    this.text,
+    this.maxReferenceEntries,
+    this.minCandidateScore,
+  );
+}
+
+class _Reply {
+  final int id;
+  final Object? value;
+  final String? error;
+
+  const _Reply(this.id, {this.value, this.error});
+}
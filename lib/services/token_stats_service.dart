@@ -1,4 +1,4 @@
-import '../database/app_database.dart';
+import 'stat_counters.dart';
 
 /// 持久化累计 AI 增强 token 用量。
 class TokenStatsService {
@@ -7,30 +7,95 @@ class TokenStatsService {
 
   static const _keyPromptTokens = 'ai_enhance_prompt_tokens';
   static const _keyCompletionTokens = 'ai_enhance_completion_tokens';
+  static const _keyCachedPromptTokens = 'ai_enhance_cached_prompt_tokens';
+  static const _keyCacheHits = 'llm_cache_hits';
+  static const _keyCacheMisses = 'llm_cache_misses';
+  static const _keyCacheSavedPromptTokens = 'llm_cache_saved_prompt_tokens';
+  static const _keyCacheSavedCompletionTokens =
+      'llm_cache_saved_completion_tokens';
 
-  final _db = AppDatabase.instance;
+  final _counters = StatCounters.instance;
 
   /// 累加本次增强消耗的 token 数（语音输入）。
+  ///
+  /// 只在内存中累加，由 [StatCounters] 批量落盘。[cachedPromptTokens]
+  /// 是 [promptTokens] 中命中服务端前缀缓存的部分。
   Future<void> addTokens({
     required int promptTokens,
     required int completionTokens,
+    int cachedPromptTokens = 0,
   }) async {
-    final current = await getTokens();
-    await _db.setSetting(
+    _counters.add(_keyPromptTokens, promptTokens);
+    _counters.add(_keyCompletionTokens, completionTokens);
+    if (cachedPromptTokens > 0) {
+      _counters.add(_keyCachedPromptTokens, cachedPromptTokens);
+    }
+  }
+
+  /// 读取累计 token 数（语音输入）。
+  Future<({int promptTokens, int completionTokens, int cachedPromptTokens})>
+  getTokens() async {
+    final values = await _counters.read(const [
       _keyPromptTokens,
-      (current.promptTokens + promptTokens).toString(),
-    );
-    await _db.setSetting(
       _keyCompletionTokens,
-      (current.completionTokens + completionTokens).toString(),
+      _keyCachedPromptTokens,
+    ]);
+    return (
+      promptTokens: values[_keyPromptTokens] ?? 0,
+      completionTokens: values[_keyCompletionTokens] ?? 0,
+      cachedPromptTokens: values[_keyCachedPromptTokens] ?? 0,
     );
   }
 
-  /// 读取累计 token 数（语音输入）。
-  Future<({int promptTokens, int completionTokens})> getTokens() async {
-    final p = int.tryParse(await _db.getSetting(_keyPromptTokens) ?? '') ?? 0;
-    final c =
-        int.tryParse(await _db.getSetting(_keyCompletionTokens) ?? '') ?? 0;
-    return (promptTokens: p, completionTokens: c);
+  /// 记录一次 LLM 结果缓存查询；命中时累加原请求的 token 作为节省量。
+  Future<void> recordCacheLookup({
+    required bool hit,
+    int savedPromptTokens = 0,
+    int savedCompletionTokens = 0,
+  }) async {
+    if (!hit) {
+      _counters.add(_keyCacheMisses, 1);
+      return;
+    }
+    _counters.add(_keyCacheHits, 1);
+    _counters.add(_keyCacheSavedPromptTokens, savedPromptTokens);
+    _counters.add(_keyCacheSavedCompletionTokens, savedCompletionTokens);
   }
+
+  /// 读取 LLM 结果缓存的累计命中情况。
+  Future<LlmCacheStats> getCacheStats() async {
+    final values = await _counters.read(const [
+      _keyCacheHits,
+      _keyCacheMisses,
+      _keyCacheSavedPromptTokens,
+      _keyCacheSavedCompletionTokens,
+    ]);
+    return LlmCacheStats(
+      hits: values[_keyCacheHits] ?? 0,
+      misses: values[_keyCacheMisses] ?? 0,
+      savedPromptTokens: values[_keyCacheSavedPromptTokens] ?? 0,
+      savedCompletionTokens: values[_keyCacheSavedCompletionTokens] ?? 0,
+    );
+  }
+}
+
+/// LLM 结果缓存的累计命中统计。
+class LlmCacheStats {
+  final int hits;
+  final int misses;
+  final int savedPromptTokens;
+  final int savedCompletionTokens;
+
+  const LlmCacheStats({
+    this.hits = 0,
+    this.misses = 0,
+    this.savedPromptTokens = 0,
+    this.savedCompletionTokens = 0,
+  });
+
+  int get lookups => hits + misses;
+
+  double get hitRatio => lookups == 0 ? 0 : hits / lookups;
+
+  int get savedTokens => savedPromptTokens + savedCompletionTokens;
 }
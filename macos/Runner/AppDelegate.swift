@@ -342,12 +342,16 @@ class AppDelegate: FlutterAppDelegate, NSWindowDelegate {
     let hasModifiersFromFlags = !flags.intersection([.command, .control, .option, .shift]).isEmpty
     let hasModifiers = hasModifiersOverride ?? hasModifiersFromFlags
 
+    // 与 Dart 侧 DateTime.microsecondsSinceEpoch 同一时基，用于流水线追踪
+    let timestampUs = Int64(Date().timeIntervalSince1970 * 1_000_000)
+
     let payload: [String: Any] = [
       "keyCode": Int(keyCode),
       "type": type,
       "isRepeat": isRepeat,
       "hasModifiers": hasModifiers,
       "modifiers": Int(modifiers),
+      "timestampUs": timestampUs,
     ]
 
     log("[hotkey] emit keyCode=\(keyCode) type=\(type) isRepeat=\(isRepeat) source=\(source)")
@@ -3,6 +3,7 @@ import 'package:voicetype/models/dictation_term_pending_candidate.dart';
 import 'package:voicetype/models/dictionary_entry.dart';
 import 'package:voicetype/models/memory_item.dart';
 import 'package:voicetype/services/adaptive_memory_repository.dart';
+import 'package:voicetype/services/memory_item_index.dart';
 
 void main() {
   group('AdaptiveMemoryRepository', () {
@@ -64,6 +65,52 @@ void main() {
       },
     );
 
+    test('reuses projections and ordering across merges', () {
+      final dictionary = [
+        DictionaryEntry.create(original: 'MCP'),
+        DictionaryEntry.create(
+          original: '反软',
+          corrected: '帆软',
+          source: DictionaryEntrySource.historyEdit,
+        ),
+      ];
+      List<MemoryItem> merge() => repository.mergeWithLegacy(
+        memoryItems: const [],
+        dictionaryEntries: dictionary,
+        pendingCandidates: const [],
+        termContextEntries: const [],
+        entityMemories: const [],
+        entityAliases: const [],
+      );
+
+      final first = merge();
+      expect(merge(), same(first));
+
+      dictionary.add(DictionaryEntry.create(original: 'DeepSeek'));
+      final second = merge();
+      expect(second, hasLength(3));
+      final firstIds = first.map((item) => item.id).toSet();
+      expect(second.where((item) => firstIds.contains(item.id)), hasLength(2));
+      expect(second.first.original, '反软');
+    });
+
+    test('caches the key index on merged snapshots', () {
+      final merged = repository.mergeWithLegacy(
+        memoryItems: const [],
+        dictionaryEntries: [DictionaryEntry.create(original: 'MCP')],
+        pendingCandidates: const [],
+        termContextEntries: const [],
+        entityMemories: const [],
+        entityAliases: const [],
+      );
+      final index = MemoryItemIndex.of(merged);
+      expect(MemoryItemIndex.of(merged), same(index));
+      expect(index.indexOf(merged, merged.single.normalizedKey), 0);
+
+      final copy = List<MemoryItem>.of(merged);
+      expect(MemoryItemIndex.of(copy), isNot(same(MemoryItemIndex.of(copy))));
+    });
+
     test('recall excludes suppressed memories and can include weak active', () {
       final active = MemoryItem.create(
         kind: MemoryItemKind.correction,
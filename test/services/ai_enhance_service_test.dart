@@ -26,6 +26,33 @@ void main() {
         expect(input, contains('<source>\n今天的会议记录\n</source>'));
       });
 
+      test('places volatile context after the fixed instructions', () {
+        const config = AiEnhanceConfig(
+          baseUrl: 'https://example.com/v1',
+          apiKey: 'test-key',
+          model: 'test-model',
+          prompt: '优化文本',
+          agentName: 'Offhand',
+        );
+        final service = AiEnhanceService(config);
+
+        final plain = service.buildInputForTokenEstimate('正文');
+        final withContext = service.buildInputForTokenEstimate(
+          '正文',
+          context: '【最近输入上下文】\n- 最近主题：周报',
+        );
+
+        final sourceAt = plain.indexOf('<source>');
+        expect(
+          withContext.substring(0, sourceAt),
+          plain.substring(0, sourceAt),
+        );
+        expect(
+          withContext.indexOf('【最近输入上下文】'),
+          lessThan(withContext.indexOf('<source>')),
+        );
+      });
+
       test('counts output from final returned text only', () {
         final outputTokens = AiEnhanceService.estimateTokenCount('abcd中文!');
 
@@ -67,6 +94,57 @@ void main() {
         expect(result.text, 'Enhanced text here');
       });
 
+      test('parses cached prompt tokens from usage', () async {
+        final usages = [
+          {
+            'prompt_tokens': 120,
+            'completion_tokens': 10,
+            'prompt_tokens_details': {'cached_tokens': 96},
+          },
+          {
+            'prompt_tokens': 120,
+            'completion_tokens': 10,
+            'prompt_cache_hit_tokens': 64,
+            'prompt_cache_miss_tokens': 56,
+          },
+          {'prompt_tokens': 120, 'completion_tokens': 10},
+        ];
+        var index = 0;
+        final server = await HttpServer.bind(InternetAddress.loopbackIPv4, 0);
+        addTearDown(() => server.close(force: true));
+        server.listen((req) async {
+          req.response.statusCode = 200;
+          req.response.headers.contentType = ContentType.json;
+          req.response.write(
+            json.encode({
+              'choices': [
+                {
+                  'message': {'content': 'result'},
+                },
+              ],
+              'usage': usages[index++],
+            }),
+          );
+          await req.response.close();
+        });
+
+        final service = AiEnhanceService(
+          AiEnhanceConfig(
+            baseUrl: 'http://127.0.0.1:${server.port}/v1',
+            apiKey: 'test-key',
+            model: 'test-model',
+            prompt: 'Fix',
+            agentName: 'Agent',
+          ),
+        );
+        final cached = [
+          for (var i = 0; i < usages.length; i++)
+            (await service.enhance('text $i')).cachedPromptTokens,
+        ];
+
+        expect(cached, [96, 64, 0]);
+      });
+
       test('returns original text when input is empty', () async {
         const config = AiEnhanceConfig(
           baseUrl: 'https://example.com/v1',
@@ -1,6 +1,7 @@
 import 'package:flutter_test/flutter_test.dart';
 import 'package:sqflite_common_ffi/sqflite_ffi.dart';
 import 'package:voicetype/database/app_database.dart';
+import 'package:voicetype/models/transcription.dart';
 
 void main() {
   setUpAll(() async {
@@ -52,4 +53,57 @@ void main() {
       expect(all['all_b'], '2');
     });
   });
+
+  group('AppDatabase history rollups', () {
+    Transcription item(
+      String id,
+      DateTime createdAt, {
+      String text = 'hello',
+      String model = 'm1',
+      int? inputTokens,
+    }) => Transcription(
+      id: id,
+      text: text,
+      createdAt: createdAt,
+      duration: const Duration(seconds: 2),
+      llmInputTokens: inputTokens,
+      provider: 'P',
+      model: model,
+      providerConfigJson: '{}',
+    );
+
+    test('insert, replace and delete keep daily and model totals', () async {
+      final db = AppDatabase.instance;
+      await db.clearHistory();
+
+      await db.insertHistory(item('r1', DateTime(2026, 3, 1, 9)));
+      await db.insertHistory(
+        item('r2', DateTime(2026, 3, 1, 18), text: '你好', inputTokens: 7),
+      );
+      await db.insertHistory(item('r3', DateTime(2026, 3, 2, 8), model: 'm2'));
+
+      var daily = await db.getDailyHistoryStats();
+      expect(daily.map((d) => d.day), ['2026-03-01', '2026-03-02']);
+      expect(daily.first.count, 2);
+      expect(daily.first.durationMs, 4000);
+      expect(daily.first.charCount, 7);
+      expect(daily.first.llmInputTokens, 7);
+
+      // 同 id 重新写入（编辑文本）按替换处理，不重复计数。
+      await db.insertHistory(item('r1', DateTime(2026, 3, 1, 9), text: 'hi'));
+      daily = await db.getDailyHistoryStats();
+      expect(daily.first.count, 2);
+      expect(daily.first.charCount, 4);
+
+      await db.deleteHistoryById('r3');
+      daily = await db.getDailyHistoryStats();
+      expect(daily.map((d) => d.day), ['2026-03-01']);
+      final usage = await db.getHistoryModelUsage();
+      expect(usage.map((u) => '${u.model}:${u.count}'), ['m1:2']);
+
+      await db.clearHistory();
+      expect(await db.getDailyHistoryStats(), isEmpty);
+      expect(await db.getHistoryModelUsage(), isEmpty);
+    });
+  });
 }
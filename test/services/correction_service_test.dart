@@ -9,7 +9,10 @@ import 'package:voicetype/models/entity_relation.dart';
 import 'package:voicetype/models/memory_item.dart';
 import 'package:voicetype/services/correction_context.dart';
 import 'package:voicetype/services/correction_service.dart';
+import 'package:voicetype/services/latency_budget.dart';
+import 'package:voicetype/services/local_rewrite_gate.dart';
 import 'package:voicetype/services/pinyin_matcher.dart';
+import 'package:voicetype/services/pipeline_tracer.dart';
 import 'package:voicetype/services/session_entity_state.dart';
 import 'package:voicetype/services/session_glossary.dart';
 
@@ -422,6 +425,175 @@ void main() {
       expect(result.llmInvoked, isFalse);
     });
 
+    test('keeps the local result when the latency budget runs out', () async {
+      matcher.buildIndex([
+        DictionaryEntry.create(original: '墨提斯', corrected: 'Metis'),
+      ]);
+      var requests = 0;
+      server.listen((request) async {
+        requests++;
+        await Future<void>.delayed(const Duration(milliseconds: 400));
+        request.response
+          ..statusCode = 200
+          ..headers.contentType = ContentType.json
+          ..write(
+            json.encode({
+              'choices': [
+                {
+                  'message': {'content': 'Metis数据'},
+                },
+              ],
+            }),
+          );
+        await request.response.close();
+      });
+
+      final service = CorrectionService(
+        matcher: matcher,
+        context: context,
+        aiConfig: AiEnhanceConfig(
+          agentName: 'test',
+          baseUrl: baseUrl,
+          apiKey: 'test-key',
+          model: 'test-model',
+          prompt: '',
+        ),
+        correctionPrompt: '纠错 prompt',
+      );
+      final local = (await service.planLocal('墨提斯数据')).normalizedText;
+
+      // 没有耗时样本：照常请求，到期后不再等待。
+      final waiting = LatencyBudget(
+        const Duration(milliseconds: 60),
+        reserve: Duration.zero,
+        predict: (_) => null,
+      )..arm(PipelineTracer.nowUs());
+      addTearDown(waiting.dispose);
+      final abandoned = await service.correct('墨提斯数据', budget: waiting);
+      expect(abandoned.text, local);
+      expect(abandoned.llmInvoked, isFalse);
+      expect(requests, 1);
+      expect(context.getContextString(), local);
+
+      // 预计来不及：不发请求。
+      final tight = LatencyBudget(
+        const Duration(seconds: 1),
+        predict: (_) => const Duration(seconds: 3),
+      )..arm(PipelineTracer.nowUs());
+      addTearDown(tight.dispose);
+      final skipped = await service.correct('墨提斯数据', budget: tight);
+      expect(skipped.text, local);
+      expect(requests, 1);
+      expect(tight.degradedStages, {'correction'});
+    });
+
+    test('rewrites confident hits locally without calling the LLM', () async {
+      matcher.buildIndex([
+        DictionaryEntry.create(original: '反软', corrected: '帆软'),
+        DictionaryEntry.create(original: '墨提斯'),
+      ]);
+      var requests = 0;
+      server.listen((request) async {
+        requests++;
+        request.response
+          ..statusCode = 200
+          ..headers.contentType = ContentType.json
+          ..write(
+            json.encode({
+              'choices': [
+                {
+                  'message': {'content': '墨提斯数据很好'},
+                },
+              ],
+            }),
+          );
+        await request.response.close();
+      });
+
+      final service = CorrectionService(
+        matcher: matcher,
+        context: context,
+        aiConfig: AiEnhanceConfig(
+          agentName: 'test',
+          baseUrl: baseUrl,
+          apiKey: 'test-key',
+          model: 'test-model',
+          prompt: '',
+        ),
+        correctionPrompt: '纠错 prompt',
+        localRewriteGate: const LocalRewriteGate(shadowEvery: 0),
+      );
+
+      final local = await service.correct('今天用反软做报表');
+      expect(local.text, '今天用帆软做报表');
+      expect(local.llmInvoked, isFalse);
+      expect(requests, 0);
+      expect(context.getContextString(), '今天用帆软做报表');
+
+      // 保留词的拼音命中需要结合上下文，交给 LLM。
+      final escalated = await service.correct('莫提斯数据很好');
+      expect(escalated.text, '墨提斯数据很好');
+      expect(escalated.llmInvoked, isTrue);
+      expect(requests, 1);
+    });
+
+    test('shadow-checks every Nth local rewrite in the background', () async {
+      matcher.buildIndex([
+        DictionaryEntry.create(original: '反软', corrected: '帆软'),
+      ]);
+      final userMessages = <String>[];
+      server.listen((request) async {
+        final body = await utf8.decoder.bind(request).join();
+        final payload = json.decode(body) as Map<String, dynamic>;
+        final messages = payload['messages'] as List<dynamic>;
+        userMessages.add(
+          (messages.last as Map<String, dynamic>)['content'] as String,
+        );
+        request.response
+          ..statusCode = 200
+          ..headers.contentType = ContentType.json
+          ..write(
+            json.encode({
+              'choices': [
+                {
+                  'message': {'content': '帆软的报表'},
+                },
+              ],
+            }),
+          );
+        await request.response.close();
+      });
+
+      final service = CorrectionService(
+        matcher: matcher,
+        context: context,
+        aiConfig: AiEnhanceConfig(
+          agentName: 'test',
+          baseUrl: baseUrl,
+          apiKey: 'test-key',
+          model: 'test-model',
+          prompt: '',
+        ),
+        correctionPrompt: '纠错 prompt',
+        localRewriteGate: const LocalRewriteGate(shadowEvery: 2),
+      );
+
+      final results = [
+        for (final text in ['反软报表一', '反软报表二', '反软报表三'])
+          await service.correct(text),
+      ];
+      for (var i = 0; i < 20 && userMessages.length < 2; i++) {
+        await Future<void>.delayed(const Duration(milliseconds: 20));
+      }
+
+      expect(results.map((r) => r.text), ['帆软报表一', '帆软报表二', '帆软报表三']);
+      expect(results.every((r) => !r.llmInvoked), isTrue);
+      expect(userMessages, hasLength(2));
+      expect(userMessages.first, contains('#I: 反软报表一'));
+      expect(userMessages.last, contains('#I: 反软报表三'));
+      expect(context.segmentCount, 3);
+    });
+
     test(
       'uses local normalization fallback on LLM failure for homophones',
       () async {
@@ -520,6 +692,78 @@ void main() {
       expect(refs.length, 1);
     });
 
+    test('moves repeated references into the #G system prompt', () async {
+      matcher.buildIndex([
+        DictionaryEntry.create(original: '兴阔', corrected: '星阔'),
+        DictionaryEntry.create(original: '蓝乔', corrected: '蓝桥'),
+      ]);
+
+      final systems = <String>[];
+      final references = <String>[];
+      server.listen((request) async {
+        final body = await utf8.decoder.bind(request).join();
+        final payload = json.decode(body) as Map<String, dynamic>;
+        final messages = payload['messages'] as List<dynamic>;
+        systems.add(
+          (messages.first as Map<String, dynamic>)['content'] as String,
+        );
+        final userMessage =
+            (messages.last as Map<String, dynamic>)['content'] as String;
+        references.add(
+          userMessage
+              .split('\n')
+              .firstWhere((line) => line.startsWith('#R: '))
+              .substring(4)
+              .trim(),
+        );
+        request.response
+          ..statusCode = 200
+          ..headers.contentType = ContentType.json
+          ..write(
+            json.encode({
+              'choices': [
+                {
+                  'message': {'content': '好的'},
+                },
+              ],
+              'usage': {'prompt_tokens': 40, 'completion_tokens': 4},
+            }),
+          );
+        await request.response.close();
+      });
+
+      final service = CorrectionService(
+        matcher: matcher,
+        context: context,
+        aiConfig: AiEnhanceConfig(
+          agentName: 'test',
+          baseUrl: baseUrl,
+          apiKey: 'test-key',
+          model: 'test-model',
+          prompt: '',
+        ),
+        correctionPrompt: '纠错 prompt',
+        minCandidateScore: 0,
+      );
+
+      await service.correct('兴阔开会');
+      await service.correct('兴阔和蓝乔开会');
+      await service.correct('蓝乔开会');
+
+      expect(systems[0], '纠错 prompt');
+      expect(systems[1], '纠错 prompt\n\n#G: 兴阔->星阔');
+      expect(systems[2], '纠错 prompt\n\n#G: 兴阔->星阔|蓝乔->蓝桥');
+      // 前一次的 system prompt 是后一次的前缀。
+      expect(systems[2].startsWith(systems[1]), isTrue);
+      expect(references[0], '兴阔->星阔');
+      expect(references[1], '蓝乔->蓝桥');
+      expect(references[2], isEmpty);
+
+      context.reset();
+      await service.correct('蓝乔开会');
+      expect(systems.last, '纠错 prompt');
+    });
+
     test('regression samples: 12 boundary cases', () async {
       final dictionaries = <DictionaryEntry>[
         DictionaryEntry.create(original: '兴阔', corrected: '星阔'),
@@ -889,7 +1133,7 @@ void main() {
       await server.close(force: true);
     });
 
-    test('injects strong glossary entries into #R', () async {
+    test('injects strong glossary entries into the #G prefix', () async {
       matcher.buildIndex([
         DictionaryEntry.create(original: '墨提斯', corrected: 'Metis'),
       ]);
@@ -897,11 +1141,14 @@ void main() {
       // Pre-populate glossary with a strong entry
       glossary.override('反软', '帆软');
 
+      String capturedSystem = '';
       String capturedReference = '';
       server.listen((request) async {
         final body = await utf8.decoder.bind(request).join();
         final payload = json.decode(body) as Map<String, dynamic>;
         final messages = payload['messages'] as List<dynamic>? ?? [];
+        capturedSystem =
+            (messages.first as Map<String, dynamic>)['content'] as String;
         final userMessage = messages.isNotEmpty
             ? (messages.last as Map<String, dynamic>)['content'] as String? ??
                   ''
@@ -943,9 +1190,68 @@ void main() {
       );
 
       await service.correct('墨提斯和反软都是好产品');
-      // Glossary strong entry should be injected
+      // Glossary strong entry should be in the stable system prompt suffix
+      expect(capturedSystem, endsWith('\n\n#G: 反软->帆软'));
+      expect(capturedReference, isNot(contains('反软->帆软')));
+      // Dictionary entry first seen in this segment stays in #R
+      expect(capturedReference, contains('墨提斯'));
+    });
+
+    test('sends strong entries that overflow #G in #R', () async {
+      matcher.buildIndex([
+        DictionaryEntry.create(original: '墨提斯', corrected: 'Metis'),
+      ]);
+      context = CorrectionContext(maxSessionReferences: 1)
+        ..addSessionReferences('兴阔->星阔');
+      glossary.override('反软', '帆软');
+
+      String capturedSystem = '';
+      String capturedReference = '';
+      server.listen((request) async {
+        final body = await utf8.decoder.bind(request).join();
+        final payload = json.decode(body) as Map<String, dynamic>;
+        final messages = payload['messages'] as List<dynamic>;
+        capturedSystem =
+            (messages.first as Map<String, dynamic>)['content'] as String;
+        final userMessage =
+            (messages.last as Map<String, dynamic>)['content'] as String;
+        capturedReference = userMessage
+            .split('\n')
+            .firstWhere((line) => line.startsWith('#R: '))
+            .substring(4);
+
+        request.response
+          ..statusCode = 200
+          ..headers.contentType = ContentType.json
+          ..write(
+            json.encode({
+              'choices': [
+                {
+                  'message': {'content': 'Metis和帆软都是好产品'},
+                },
+              ],
+            }),
+          );
+        await request.response.close();
+      });
+
+      final service = CorrectionService(
+        matcher: matcher,
+        context: context,
+        aiConfig: AiEnhanceConfig(
+          agentName: 'test',
+          baseUrl: baseUrl,
+          apiKey: 'test-key',
+          model: 'test-model',
+          prompt: '',
+        ),
+        correctionPrompt: '纠错 prompt',
+        sessionGlossary: glossary,
+      );
+
+      await service.correct('墨提斯和反软都是好产品');
+      expect(capturedSystem, endsWith('\n\n#G: 兴阔->星阔'));
       expect(capturedReference, contains('反软->帆软'));
-      // Dictionary entry should also be present
       expect(capturedReference, contains('墨提斯'));
     });
 
@@ -1006,5 +1312,124 @@ void main() {
       // Should NOT contain 反软->帆软 since it's weak
       expect(capturedReference, isNot(contains('反软->帆软')));
     });
+
+    group('correctBatch', () {
+      final userMessages = <String>[];
+
+      void setupBatchServer(String Function(String userMessage) reply) {
+        server.listen((request) async {
+          final body = await utf8.decoder.bind(request).join();
+          final payload = json.decode(body) as Map<String, dynamic>;
+          final messages = payload['messages'] as List<dynamic>;
+          final userMessage =
+              (messages.last as Map<String, dynamic>)['content'] as String;
+          userMessages.add(userMessage);
+          request.response
+            ..statusCode = 200
+            ..headers.contentType = ContentType.json
+            ..write(
+              json.encode({
+                'choices': [
+                  {
+                    'message': {'content': reply(userMessage)},
+                  },
+                ],
+                'usage': {'prompt_tokens': 50, 'completion_tokens': 20},
+              }),
+            );
+          await request.response.close();
+        });
+      }
+
+      CorrectionService newService({LocalRewriteGate? gate}) {
+        matcher.buildIndex([
+          DictionaryEntry.create(original: '墨提斯', corrected: 'Metis'),
+          DictionaryEntry.create(original: '反软', corrected: '帆软'),
+        ]);
+        return CorrectionService(
+          matcher: matcher,
+          context: context,
+          aiConfig: AiEnhanceConfig(
+            agentName: 'test',
+            baseUrl: baseUrl,
+            apiKey: 'test-key',
+            model: 'test-model',
+            prompt: '',
+          ),
+          correctionPrompt: '纠错 prompt',
+          localRewriteGate: gate,
+        );
+      }
+
+      setUp(userMessages.clear);
+
+      test('merges segments into one request and splits the reply', () async {
+        setupBatchServer(
+          (_) => '<s1>墨提斯数据很好。</s1>\n<s2>墨提斯报表完成。</s2>',
+        );
+        final service = newService();
+
+        final results = await service.correctBatch([
+          '墨提斯数据很好',
+          '今天天气不错',
+          '墨提斯报表完成',
+        ]);
+
+        expect(userMessages, hasLength(1));
+        final input = userMessages.single;
+        expect(input, contains('<s1>墨提斯数据很好</s1>'));
+        expect(input, contains('<s2>墨提斯报表完成</s2>'));
+        expect(input, isNot(contains('今天天气不错')));
+        expect('#R: '.allMatches(input), hasLength(1));
+        expect(results.map((r) => r.text), [
+          '墨提斯数据很好。',
+          '今天天气不错',
+          '墨提斯报表完成。',
+        ]);
+        expect(results.map((r) => r.llmInvoked), [true, false, true]);
+        expect(results.fold<int>(0, (n, r) => n + r.totalTokens), 70);
+        expect(context.segmentCount, 3);
+      });
+
+      test('falls back to per-segment calls on a malformed reply', () async {
+        setupBatchServer(
+          (message) => message.contains('<s1>') ? '墨提斯数据' : '墨提斯。',
+        );
+        final service = newService();
+
+        final results = await service.correctBatch(['墨提斯数据', '墨提斯报表']);
+
+        expect(userMessages, hasLength(3));
+        expect(results.map((r) => r.text), ['墨提斯。', '墨提斯。']);
+        expect(results.every((r) => r.llmInvoked), isTrue);
+        expect(context.segmentCount, 2);
+      });
+
+      test('keeps locally confident segments out of the request', () async {
+        setupBatchServer(
+          (_) => '<s1>墨提斯数据很好。</s1>\n<s2>墨提斯报表完成。</s2>',
+        );
+        final service = newService(
+          gate: const LocalRewriteGate(shadowEvery: 0),
+        );
+
+        // 魔体思与墨提斯只有拼音相同，置信度不足，需要 LLM。
+        final results = await service.correctBatch([
+          '魔体思数据很好',
+          '反软报表完成',
+          '魔体思报表完成',
+        ]);
+
+        expect(userMessages, hasLength(1));
+        expect(userMessages.single, isNot(contains('反软')));
+        expect(results.map((r) => r.text), [
+          '墨提斯数据很好。',
+          '帆软报表完成',
+          '墨提斯报表完成。',
+        ]);
+        expect(results.map((r) => r.llmInvoked), [true, false, true]);
+        expect(context.segmentCount, 3);
+      });
+    });
   });
 }
@@ -2,6 +2,7 @@ import 'package:flutter_test/flutter_test.dart';
 import 'package:voicetype/models/entity_alias.dart';
 import 'package:voicetype/models/entity_memory.dart';
 import 'package:voicetype/models/entity_relation.dart';
+import 'package:voicetype/services/entity_recall_index.dart';
 import 'package:voicetype/services/entity_recall_service.dart';
 import 'package:voicetype/services/session_entity_state.dart';
 
@@ -114,5 +115,68 @@ void main() {
         expect(recalledZhang.aliases.length, lessThanOrEqualTo(3));
       },
     );
+
+    test('index scan reports canonical and overlapping alias mentions', () {
+      final index = EntityRecallIndex.of(
+        memories: [zhang, li],
+        aliases: aliases,
+        relations: relations,
+      );
+
+      final mentions = index.scan('张三丰说接龙和金雨希都到了');
+      expect(mentions.hasCanonical(zhang.id), isTrue);
+      expect(mentions.hasCanonical(li.id), isFalse);
+      expect(mentions.aliases.map((a) => a.aliasText).toSet(), {
+        '三丰',
+        '接龙',
+        '金雨希',
+      });
+      expect(index.relationsOf(li.id), hasLength(1));
+    });
+
+    test('index is reused until entity lists change', () {
+      final memories = [zhang, li];
+      final first = EntityRecallIndex.of(
+        memories: memories,
+        aliases: aliases,
+        relations: relations,
+      );
+      expect(
+        EntityRecallIndex.of(
+          memories: memories,
+          aliases: aliases,
+          relations: relations,
+        ),
+        same(first),
+      );
+      expect(
+        EntityRecallIndex.of(
+          memories: memories,
+          aliases: [...aliases],
+          relations: relations,
+        ),
+        isNot(same(first)),
+      );
+    });
+
+    test('unmentioned entities without activation are not recalled', () {
+      final wang = EntityMemory.create(
+        canonicalName: '王五',
+        type: EntityType.person,
+      );
+
+      final bundle = service.buildForCorrection(
+        currentText: '接龙今天来了',
+        contextText: '',
+        memories: [zhang, li, wang],
+        aliases: aliases,
+        relations: relations,
+        sessionState: SessionEntityState(),
+      );
+
+      final names = bundle.entities.map((e) => e.memory.canonicalName);
+      expect(names, contains('张三丰'));
+      expect(names, isNot(contains('王五')));
+    });
   });
 }
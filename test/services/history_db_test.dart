@@ -1,5 +1,7 @@
 import 'package:flutter_test/flutter_test.dart';
 import 'package:sqflite_common_ffi/sqflite_ffi.dart';
+import 'package:voicetype/models/history_cursor.dart';
+import 'package:voicetype/models/history_search_hit.dart';
 import 'package:voicetype/models/transcription.dart';
 import 'package:voicetype/database/app_database.dart';
 import 'package:voicetype/services/history_db.dart';
@@ -165,5 +167,126 @@ void main() {
       expect(result[1].id, 'order-2');
       expect(result[2].id, 'order-1'); // oldest last
     });
+
+    test('getPage walks history by (created_at, id) keyset', () async {
+      final db = HistoryDb.instance;
+      await db.clear();
+
+      final base = DateTime(2026, 3, 1, 9);
+      // 两条记录共享同一时间戳，验证 id 作为次级排序键。
+      final createdAts = [
+        base,
+        base.add(const Duration(minutes: 1)),
+        base.add(const Duration(minutes: 1)),
+        base.add(const Duration(minutes: 2)),
+        base.add(const Duration(minutes: 3)),
+      ];
+      for (var i = 0; i < createdAts.length; i++) {
+        await db.insert(
+          Transcription(
+            id: 'page-$i',
+            text: 'Item $i',
+            createdAt: createdAts[i],
+            duration: const Duration(seconds: 1),
+            provider: 'P',
+            model: 'm',
+            providerConfigJson: '{}',
+          ),
+        );
+      }
+
+      final ids = <String>[];
+      HistoryCursor? cursor;
+      while (true) {
+        final page = await db.getPage(limit: 2, before: cursor);
+        ids.addAll(page.map((t) => t.id));
+        if (page.length < 2) break;
+        cursor = HistoryCursor.after(page.last);
+      }
+
+      expect(ids, ['page-4', 'page-3', 'page-2', 'page-1', 'page-0']);
+      expect(await db.count(), 5);
+      expect(await db.filterExistingIds(['page-1', 'missing']), {'page-1'});
+    });
+
+    test('pages by the stored created_at string', () async {
+      final db = HistoryDb.instance;
+      await db.clear();
+      final database = (await AppDatabase.getInstance()).database;
+      // 旧数据的时间格式与 toIso8601String() 不同，游标须沿用存储值。
+      for (final id in ['raw-a', 'raw-b', 'raw-c']) {
+        final item = Transcription(
+          id: id,
+          text: id,
+          createdAt: DateTime(2026, 3, 3, 9),
+          duration: const Duration(seconds: 1),
+          provider: 'P',
+          model: 'm',
+          providerConfigJson: '{}',
+        );
+        await database.insert('transcriptions', {
+          ...item.toDb(),
+          'created_at': '2026-03-03 09:00:00',
+        });
+      }
+
+      final first = await db.getPage(limit: 2);
+      expect(first.map((t) => t.id), ['raw-c', 'raw-b']);
+      final next = await db.getPage(
+        limit: 2,
+        before: HistoryCursor.after(first.last),
+      );
+      expect(next.map((t) => t.id), ['raw-a']);
+    });
+
+    test('search finds CJK text and follows replace and delete', () async {
+      final db = HistoryDb.instance;
+      await db.clear();
+
+      Transcription item(String id, String text, int minute) => Transcription(
+        id: id,
+        text: text,
+        createdAt: DateTime(2026, 3, 2, 9, minute),
+        duration: const Duration(seconds: 1),
+        provider: 'P',
+        model: 'm',
+        providerConfigJson: '{}',
+      );
+      await db.insert(item('s-1', '今天评审帆软报表的权限方案', 1));
+      await db.insert(item('s-2', '下午同步 MCP 接入进度', 2));
+      await db.insert(item('s-3', '帆软报表导出还有问题', 3));
+
+      final hits = await db.search('帆软报表');
+      expect(hits.map((h) => h.item.id), ['s-3', 's-1']);
+      expect(
+        hits.first.snippet,
+        contains(
+          '${HistorySearchHit.highlightStart}帆软报表'
+          '${HistorySearchHit.highlightEnd}',
+        ),
+      );
+
+      // 短于 3 个字符的词走 LIKE 过滤。
+      expect((await db.search('报表 权限')).map((h) => h.item.id), ['s-1']);
+      expect(
+        (await db.search('权限方案 mcp', matchAny: true)).map(
+          (h) => h.item.id,
+        ),
+        ['s-2', 's-1'],
+      );
+
+      final page = await db.search('帆软报表', limit: 1);
+      final next = await db.search(
+        '帆软报表',
+        limit: 1,
+        before: HistoryCursor.after(page.single.item),
+      );
+      expect(next.single.item.id, 's-1');
+
+      await db.insert(item('s-3', '导出问题已修复', 3));
+      expect((await db.search('帆软报表')).map((h) => h.item.id), ['s-1']);
+      await db.deleteById('s-1');
+      expect(await db.search('帆软报表'), isEmpty);
+    });
   });
 }
@@ -0,0 +1,86 @@
+import 'dart:async';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voicetype/services/latency_budget.dart';
+import 'package:voicetype/services/pipeline_tracer.dart';
+
+void main() {
+  Future<String> delayed(String value, int ms) =>
+      Future.delayed(Duration(milliseconds: ms), () => value);
+
+  test('unarmed budget allows requests and waits for them', () async {
+    final budget = LatencyBudget(
+      const Duration(milliseconds: 10),
+      reserve: Duration.zero,
+      predict: (_) => const Duration(seconds: 5),
+    );
+
+    expect(budget.remaining, isNull);
+    expect(budget.allows('llm|a', stage: 'correction'), isTrue);
+    expect(await budget.guard(delayed('ok', 30), stage: 'correction'), 'ok');
+    expect(budget.degraded, isFalse);
+  });
+
+  test('skips requests predicted to overrun the remaining budget', () {
+    var nowUs = 0;
+    final predictions = {
+      'llm|slow': const Duration(milliseconds: 900),
+      'llm|fast': const Duration(milliseconds: 300),
+    };
+    final budget = LatencyBudget(
+      const Duration(milliseconds: 1500),
+      reserve: const Duration(milliseconds: 100),
+      predict: (key) => predictions[key],
+      nowUs: () => nowUs,
+    )..arm(0);
+    addTearDown(budget.dispose);
+
+    nowUs = 600 * 1000;
+    expect(budget.remaining, const Duration(milliseconds: 800));
+    expect(budget.allows('llm|fast', stage: 'enhance'), isTrue);
+    // 没有耗时样本时先尝试，由 guard 兜底。
+    expect(budget.allows('llm|new', stage: 'enhance'), isTrue);
+    expect(budget.allows('llm|slow', stage: 'correction'), isFalse);
+    expect(budget.degradedStages, {'correction'});
+
+    nowUs = 2000 * 1000;
+    expect(budget.remaining, Duration.zero);
+    expect(budget.allows('llm|new', stage: 'enhance'), isFalse);
+  });
+
+  test('guard stops waiting at the deadline', () async {
+    final budget = LatencyBudget(
+      const Duration(milliseconds: 40),
+      reserve: Duration.zero,
+      predict: (_) => null,
+    )..arm(PipelineTracer.nowUs());
+    addTearDown(budget.dispose);
+
+    final fast = await budget.guard(delayed('fast', 5), stage: 'correction');
+    expect(fast, 'fast');
+    expect(budget.degraded, isFalse);
+
+    final clock = Stopwatch()..start();
+    final slow = await budget.guard(delayed('slow', 500), stage: 'enhance');
+    expect(slow, isNull);
+    expect(clock.elapsedMilliseconds, lessThan(300));
+    expect(budget.isExpired, isTrue);
+    expect(budget.degradedStages, {'enhance'});
+  });
+
+  test('guard propagates errors raised before the deadline', () async {
+    final budget = LatencyBudget(
+      const Duration(seconds: 5),
+      predict: (_) => null,
+    )..arm(PipelineTracer.nowUs());
+    addTearDown(budget.dispose);
+
+    await expectLater(
+      budget.guard(
+        Future<String>.error(TimeoutException('down')),
+        stage: 'correction',
+      ),
+      throwsA(isA<TimeoutException>()),
+    );
+  });
+}
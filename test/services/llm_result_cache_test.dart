@@ -0,0 +1,213 @@
+import 'dart:convert';
+import 'dart:io';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:sqflite_common_ffi/sqflite_ffi.dart';
+import 'package:voicetype/database/app_database.dart';
+import 'package:voicetype/models/ai_enhance_config.dart';
+import 'package:voicetype/services/ai_enhance_service.dart';
+import 'package:voicetype/services/llm_result_cache.dart';
+import 'package:voicetype/services/provider_router.dart';
+import 'package:voicetype/services/token_stats_service.dart';
+
+void main() {
+  setUpAll(() async {
+    sqfliteFfiInit();
+    databaseFactory = databaseFactoryFfi;
+  });
+
+  setUp(() async {
+    await AppDatabase.resetForTest();
+  });
+
+  String keyOf(String message) => LlmResultCache.keyFor(
+    baseUrl: 'https://a.example/v1',
+    model: 'm',
+    prompt: 'p',
+    message: message,
+  );
+
+  test('key covers endpoint, model, prompt and message', () {
+    final key = keyOf('#R: a->b\n#I: a');
+    expect(key, keyOf('#R: a->b\n#I: a'));
+    expect(key, isNot(keyOf('#R: a->c\n#I: a')));
+    expect(
+      key,
+      isNot(
+        LlmResultCache.keyFor(
+          baseUrl: 'https://a.example/v1',
+          model: 'm2',
+          prompt: 'p',
+          message: '#I: a',
+        ),
+      ),
+    );
+    expect(
+      key,
+      isNot(
+        LlmResultCache.keyFor(
+          baseUrl: 'https://b.example/v1',
+          model: 'm',
+          prompt: 'p',
+          message: '#R: a->b\n#I: a',
+        ),
+      ),
+    );
+  });
+
+  test('hits return cached text and count saved tokens', () async {
+    final cache = LlmResultCache();
+    final key = keyOf('今天用了墨提斯');
+    expect(await cache.lookup(key, unchangedText: '今天用了墨提斯'), isNull);
+
+    await cache.store(
+      key,
+      const AiEnhanceResult(
+        text: '今天用了 Metis',
+        promptTokens: 40,
+        completionTokens: 8,
+      ),
+      unchangedText: '今天用了墨提斯',
+    );
+    final hit = await cache.lookup(key, unchangedText: '今天用了墨提斯');
+
+    expect(hit?.text, '今天用了 Metis');
+    expect(hit?.cached, isTrue);
+    expect(hit?.totalTokens, 0);
+    final stats = await TokenStatsService.instance.getCacheStats();
+    expect(stats.hits, 1);
+    expect(stats.misses, 1);
+    expect(stats.hitRatio, 0.5);
+    expect(stats.savedTokens, 48);
+  });
+
+  test('unchanged results are stored as negative entries', () async {
+    final cache = LlmResultCache();
+    final key = keyOf('好的');
+    await cache.store(
+      key,
+      const AiEnhanceResult(text: '好的\n'),
+      unchangedText: '好的',
+    );
+
+    final entry = await AppDatabase.instance.llmCacheDao.findByKey(key);
+    expect(entry?.unchanged, isTrue);
+    expect(entry?.text, '');
+    final hit = await cache.lookup(key, unchangedText: '好的');
+    expect(hit?.text, '好的');
+  });
+
+  test('prune evicts least recently used entries', () async {
+    final cache = LlmResultCache(maxEntries: 2, pruneInterval: 1000);
+    for (final name in ['a', 'b', 'c']) {
+      await cache.store(
+        keyOf(name),
+        AiEnhanceResult(text: '$name!'),
+        unchangedText: name,
+      );
+      await Future<void>.delayed(const Duration(milliseconds: 2));
+    }
+    // 命中 a 后，b 成为最久未用的条目。
+    await cache.lookup(keyOf('a'), unchangedText: 'a');
+    await cache.prune();
+
+    expect(await cache.lookup(keyOf('a'), unchangedText: 'a'), isNotNull);
+    expect(await cache.lookup(keyOf('b'), unchangedText: 'b'), isNull);
+    expect(await cache.lookup(keyOf('c'), unchangedText: 'c'), isNotNull);
+  });
+
+  test('enhance serves repeated requests from the cache', () async {
+    var requests = 0;
+    final server = await HttpServer.bind(InternetAddress.loopbackIPv4, 0);
+    addTearDown(() => server.close(force: true));
+    server.listen((request) async {
+      requests++;
+      request.response
+        ..statusCode = 200
+        ..headers.contentType = ContentType.json
+        ..write(
+          json.encode({
+            'choices': [
+              {
+                'message': {'content': '整理后的文本'},
+              },
+            ],
+            'usage': {'prompt_tokens': 30, 'completion_tokens': 6},
+          }),
+        );
+      await request.response.close();
+    });
+
+    final service = AiEnhanceService(
+      AiEnhanceConfig(
+        baseUrl: 'http://127.0.0.1:${server.port}/v1',
+        apiKey: 'test-key',
+        model: 'test-model',
+        prompt: '整理文本',
+        agentName: 'Agent',
+      ),
+    );
+    final first = await service.enhance('原始文本');
+    // 写入是异步的，等它落盘。
+    await Future<void>.delayed(const Duration(milliseconds: 50));
+    final second = await service.enhance('原始文本');
+    final uncached = await service.enhance('原始文本', useCache: false);
+
+    expect(first.cached, isFalse);
+    expect(second.text, '整理后的文本');
+    expect(second.cached, isTrue);
+    expect(uncached.cached, isFalse);
+    expect(requests, 2);
+  });
+  test('results are cached under the endpoint that produced them', () async {
+    Future<HttpServer> serve(int status) async {
+      final server = await HttpServer.bind(InternetAddress.loopbackIPv4, 0);
+      addTearDown(() => server.close(force: true));
+      server.listen((request) async {
+        request.response
+          ..statusCode = status
+          ..headers.contentType = ContentType.json
+          ..write(
+            json.encode({
+              'choices': [
+                {
+                  'message': {'content': '备用模型的结果'},
+                },
+              ],
+            }),
+          );
+        await request.response.close();
+      });
+      return server;
+    }
+
+    AiEnhanceConfig configOf(HttpServer server, String model) =>
+        AiEnhanceConfig(
+          baseUrl: 'http://127.0.0.1:${server.port}/v1',
+          apiKey: 'test-key',
+          model: model,
+          prompt: '整理文本',
+          agentName: 'Agent',
+        );
+
+    final primary = configOf(await serve(500), 'primary-model');
+    final fallback = configOf(await serve(200), 'fallback-model');
+    final router = ProviderRouter.instance
+      ..enabled = true
+      ..aiFallbacks = [fallback];
+    addTearDown(() {
+      router
+        ..enabled = false
+        ..aiFallbacks = const [];
+    });
+
+    final first = await AiEnhanceService(primary).enhance('原始文本');
+    await Future<void>.delayed(const Duration(milliseconds: 50));
+
+    expect(first.text, '备用模型的结果');
+    final again = await AiEnhanceService(primary).enhance('原始文本');
+    expect(again.cached, isFalse);
+    final direct = await AiEnhanceService(fallback).enhance('原始文本');
+    expect(direct.cached, isTrue);
+  });
+}
@@ -0,0 +1,129 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voicetype/models/dictionary_entry.dart';
+import 'package:voicetype/models/memory_item.dart';
+import 'package:voicetype/services/local_correction_plan.dart';
+import 'package:voicetype/services/local_rewrite_gate.dart';
+import 'package:voicetype/services/pinyin_matcher.dart';
+import 'package:voicetype/services/session_glossary.dart';
+
+void main() {
+  const gate = LocalRewriteGate();
+
+  LocalCorrectionPlan planFor(List<DictionaryEntry> entries, String text) {
+    final matcher = PinyinMatcher()..buildIndex(entries);
+    return LocalCorrectionPlan.compute(
+      matcher,
+      text,
+      const ReferenceHitSelector(),
+    );
+  }
+
+  MemoryItem memory(
+    String original,
+    String canonical, {
+    MemoryItemStatus status = MemoryItemStatus.active,
+    double confidence = 0.9,
+  }) => MemoryItem.create(
+    kind: MemoryItemKind.correction,
+    status: status,
+    scope: MemoryItemScope.user,
+    original: original,
+    canonical: canonical,
+    confidence: confidence,
+    strength: 4,
+  );
+
+  test('rewrites literal correction hits locally', () {
+    final plan = planFor([
+      DictionaryEntry.create(original: '反软', corrected: '帆软'),
+    ], '今天用反软做报表');
+
+    final decision = gate.decide(plan: plan);
+
+    expect(decision.confident, isTrue);
+    expect(decision.text, '今天用帆软做报表');
+    expect(decision.rewriteCount, 1);
+  });
+
+  test('passes terms already in canonical form without rewriting', () {
+    final plan = planFor([
+      DictionaryEntry.create(original: '墨提斯', corrected: 'Metis'),
+    ], '今天用了墨提斯做报表');
+
+    final decision = gate.decide(plan: plan);
+
+    expect(decision.confident, isTrue);
+    expect(decision.text, '今天用了墨提斯做报表');
+    expect(decision.rewriteCount, 0);
+  });
+
+  test('escalates pinyin hits on preserve terms and entity hints', () {
+    final preserve = planFor([
+      DictionaryEntry.create(original: '墨提斯'),
+    ], '莫提斯数据很好');
+    expect(gate.decide(plan: preserve).confident, isFalse);
+
+    final literal = planFor([
+      DictionaryEntry.create(original: '反软', corrected: '帆软'),
+    ], '反软数据很好');
+    expect(gate.decide(plan: literal, hasEntityHints: true).confident, isFalse);
+  });
+
+  test('scores hits by match type and session glossary strength', () {
+    final entry = DictionaryEntry.create(original: '反软', corrected: '帆软');
+    PinyinMatchHit hit(PinyinMatchType type) =>
+        PinyinMatchHit(entry: entry, observedText: '翻软', matchType: type);
+    TermPin pin(String corrected) => TermPin(
+      original: '翻软',
+      corrected: corrected,
+      hitCount: 2,
+      firstSeenSegment: 0,
+    );
+
+    expect(gate.confidenceOf(hit(PinyinMatchType.literal), 0.5), 1);
+    expect(gate.confidenceOf(hit(PinyinMatchType.pinyinExact), 0.9), 0.9);
+    expect(gate.confidenceOf(hit(PinyinMatchType.pinyinFuzzy), 0.9), 0.45);
+    expect(
+      gate.confidenceOf(
+        hit(PinyinMatchType.pinyinFuzzy),
+        0.5,
+        strongPins: {'翻软': pin('帆软')},
+      ),
+      1,
+    );
+    expect(
+      gate.confidenceOf(
+        hit(PinyinMatchType.literal),
+        1,
+        strongPins: {'翻软': pin('反软')},
+      ),
+      0,
+    );
+  });
+
+  test('applies confident memory items and escalates weak ones', () {
+    final plan = planFor(const [], '打开 configmap 和 figma');
+
+    final confident = gate.decide(
+      plan: plan,
+      memoryItems: [memory('figma', 'Figma')],
+    );
+    expect(confident.confident, isTrue);
+    expect(confident.text, '打开 configmap 和 Figma');
+    expect(confident.memoryItemIds, hasLength(1));
+
+    final weak = gate.decide(
+      plan: plan,
+      memoryItems: [
+        memory('figma', 'Figma', status: MemoryItemStatus.weakActive),
+      ],
+    );
+    expect(weak.confident, isFalse);
+
+    final growing = gate.decide(
+      plan: plan,
+      memoryItems: [memory('figma', 'figma plugin')],
+    );
+    expect(growing.confident, isFalse);
+  });
+}
@@ -53,6 +53,76 @@ void main() {
       expect(next.item.stats.rejectedCount, 1);
     });
 
+    test('finds existing memories across chained observations', () {
+      var items = <MemoryItem>[
+        MemoryItem.create(
+          kind: MemoryItemKind.correction,
+          status: MemoryItemStatus.archived,
+          scope: MemoryItemScope.user,
+          original: '反软',
+          canonical: '帆软',
+        ),
+      ];
+      final pairs = [
+        ('反软', '帆软'),
+        ('低铺戏客', 'DeepSeek'),
+        ('反软', '帆软'),
+        ('墨题斯', '墨提斯'),
+        ('低铺戏客', 'DeepSeek'),
+      ];
+      final ids = <String, String>{};
+      for (final (original, canonical) in pairs) {
+        final result = engine.observeCorrection(
+          currentItems: items,
+          original: original,
+          canonical: canonical,
+          sourceType: 'history_edit',
+        );
+        final previousId = ids.putIfAbsent(original, () => result.item.id);
+        expect(result.item.id, previousId);
+        items = result.items;
+      }
+
+      expect(items, hasLength(4));
+      expect(items.last.status, MemoryItemStatus.archived);
+      final fanruan = items.firstWhere((item) => item.id == ids['反软']);
+      expect(fanruan.stats.evidenceCount, 2);
+    });
+
+    test('does not reuse the index for lists edited in place', () {
+      final first = engine.observeCorrection(
+        currentItems: const [],
+        original: '反软',
+        canonical: '帆软',
+        sourceType: 'history_edit',
+      );
+      expect(() => first.items.add(first.item), throwsUnsupportedError);
+
+      final items = List<MemoryItem>.of(first.items);
+      engine.observeCorrection(
+        currentItems: items,
+        original: '反软',
+        canonical: '帆软',
+        sourceType: 'history_edit',
+      );
+      items[0] = MemoryItem.create(
+        kind: MemoryItemKind.correction,
+        status: MemoryItemStatus.pending,
+        scope: MemoryItemScope.user,
+        original: '墨题斯',
+        canonical: '墨提斯',
+      );
+
+      final next = engine.observeCorrection(
+        currentItems: items,
+        original: '墨题斯',
+        canonical: '墨提斯',
+        sourceType: 'history_edit',
+      );
+      expect(next.item.id, items[0].id);
+      expect(next.items, hasLength(1));
+    });
+
     test('records prompt injections and correction hits', () {
       final item = MemoryItem.create(
         kind: MemoryItemKind.correction,
@@ -0,0 +1,151 @@
+import 'dart:convert';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:sqflite_common_ffi/sqflite_ffi.dart';
+import 'package:voicetype/database/app_database.dart';
+import 'package:voicetype/models/dictionary_entry.dart';
+import 'package:voicetype/models/memory_item.dart';
+import 'package:voicetype/services/memory_record_store.dart';
+
+void main() {
+  setUpAll(() async {
+    sqfliteFfiInit();
+    databaseFactory = databaseFactoryFfi;
+  });
+
+  setUp(() async {
+    await AppDatabase.resetForTest();
+  });
+
+  group('MemoryRecordStore', () {
+    test('migrates legacy JSON blob into rows once', () async {
+      final db = AppDatabase.instance;
+      final entries = [
+        DictionaryEntry.create(original: 'MCP'),
+        DictionaryEntry.create(original: '反软', corrected: '帆软'),
+      ];
+      await db.setSetting(
+        'dictionary_entries',
+        json.encode(entries.map((e) => e.toJson()).toList()),
+      );
+
+      final store = MemoryRecordStore(
+        MemoryRecordCollections.dictionaryEntries,
+      );
+      final loaded = await store.load(db);
+
+      expect(loaded!.map((e) => e.id), entries.map((e) => e.id));
+      expect(await db.getSetting('dictionary_entries'), isNull);
+      final records = await db.getMemoryRecords('dictionary_entry');
+      expect(records.map((r) => r.normalizedKey), ['mcp', '反软']);
+    });
+
+    test('writes only changed rows and preserves list order', () async {
+      final db = AppDatabase.instance;
+      final store = MemoryRecordStore(MemoryRecordCollections.memoryItems);
+      expect(await store.load(db), isNull);
+
+      MemoryItem create(String original) => MemoryItem.create(
+        kind: MemoryItemKind.correction,
+        status: MemoryItemStatus.pending,
+        scope: MemoryItemScope.user,
+        original: original,
+        canonical: '$original!',
+      );
+      final a = create('a');
+      final b = create('b');
+      await store.save(db, [a, b]);
+
+      final before = {
+        for (final r in await db.getMemoryRecords('memory_item')) r.id: r,
+      };
+      final c = create('c');
+      final updatedB = b.copyWith(status: MemoryItemStatus.archived);
+      await store.save(db, [c, a, updatedB]);
+
+      final after = await db.getMemoryRecords('memory_item');
+      expect(after.map((r) => r.id), [c.id, a.id, b.id]);
+      final byId = {for (final r in after) r.id: r};
+      expect(byId[a.id]!.payload, before[a.id]!.payload);
+      expect(byId[b.id]!.enabled, isFalse);
+
+      await store.save(db, [c, updatedB]);
+      final reloaded = await MemoryRecordStore(
+        MemoryRecordCollections.memoryItems,
+      ).load(db);
+      expect(reloaded!.map((item) => item.id), [c.id, b.id]);
+      expect(reloaded.last.status, MemoryItemStatus.archived);
+    });
+
+    test('persists middle inserts and reorders', () async {
+      final db = AppDatabase.instance;
+      final collection = MemoryRecordCollections.dictionaryEntries;
+      final store = MemoryRecordStore(collection);
+      expect(await store.load(db), isNull);
+      final a = DictionaryEntry.create(original: 'a');
+      final b = DictionaryEntry.create(original: 'b');
+      final c = DictionaryEntry.create(original: 'c');
+      await store.save(db, [a, c]);
+
+      Future<List<String>> reloadedIds() async => (await MemoryRecordStore(
+        collection,
+      ).load(db))!.map((e) => e.id).toList();
+
+      await store.save(db, [a, b, c]);
+      expect(await reloadedIds(), [a.id, b.id, c.id]);
+
+      // 反复插在同一位置直到空位用尽、整体重排，顺序仍然保持。
+      var items = [a, b, c];
+      for (var i = 0; i < 12; i++) {
+        items = [a, DictionaryEntry.create(original: 'x$i'), ...items.skip(1)];
+        await store.save(db, items);
+      }
+      expect(await reloadedIds(), items.map((e) => e.id));
+
+      await store.save(db, [c, b, a]);
+      expect(await reloadedIds(), [c.id, b.id, a.id]);
+    });
+
+    test('rewrites only the rows that moved', () async {
+      final db = AppDatabase.instance;
+      final collection = MemoryRecordCollections.dictionaryEntries;
+      final store = MemoryRecordStore(collection);
+      expect(await store.load(db), isNull);
+      final entries = [
+        for (var i = 0; i < 6; i++) DictionaryEntry.create(original: 't$i'),
+      ];
+      await store.save(db, entries);
+      Future<Map<String, int>> seqsById() async => {
+        for (final r in await db.getMemoryRecords(collection.name)) r.id: r.seq,
+      };
+      final before = await seqsById();
+
+      // 末尾条目移到最前，其余条目的序号保持不变。
+      final moved = [entries.last, ...entries.take(5)];
+      await store.save(db, moved);
+      final after = await seqsById();
+      for (final entry in entries.take(5)) {
+        expect(after[entry.id], before[entry.id]);
+      }
+      expect(after[entries.last.id], lessThan(before[entries.first.id]!));
+      final reloaded = await MemoryRecordStore(collection).load(db);
+      expect(reloaded!.map((e) => e.id), moved.map((e) => e.id));
+    });
+
+    test('decodes large collections off the UI isolate in order', () async {
+      final db = AppDatabase.instance;
+      final collection = MemoryRecordCollections.dictionaryEntries;
+      const count = MemoryRecordCollection.backgroundDecodeThreshold + 10;
+      final entries = [
+        for (var i = 0; i < count; i++)
+          DictionaryEntry.create(original: 'term$i'),
+      ];
+      await MemoryRecordStore(collection).save(db, entries);
+
+      final loaded = await MemoryRecordStore(
+        collection,
+      ).load(db, settings: await db.getAllSettings());
+      expect(loaded!.map((e) => e.id), entries.map((e) => e.id));
+    });
+  });
+}
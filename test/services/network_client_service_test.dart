@@ -0,0 +1,63 @@
+import 'dart:io';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voicetype/models/network_settings.dart';
+import 'package:voicetype/services/network_client_service.dart';
+
+void main() {
+  late HttpServer server;
+  late Set<int> connections;
+  late String baseUrl;
+
+  setUp(() async {
+    connections = {};
+    server = await HttpServer.bind(InternetAddress.loopbackIPv4, 0);
+    server.listen((request) {
+      // 每个 TCP 连接（即每次 TLS 握手）对应一个客户端端口。
+      connections.add(request.connectionInfo!.remotePort);
+      request.response
+        ..statusCode = HttpStatus.ok
+        ..write('ok')
+        ..close();
+    });
+    baseUrl = 'http://127.0.0.1:${server.port}/v1';
+  });
+
+  tearDown(() async {
+    NetworkClientService.closeAll();
+    await server.close(force: true);
+  });
+
+  test('requests from separate clients share one connection', () async {
+    for (var i = 0; i < 3; i++) {
+      final client = NetworkClientService.createClient();
+      try {
+        final response = await client.get(Uri.parse('$baseUrl/models'));
+        expect(response.body, 'ok');
+      } finally {
+        client.close();
+      }
+    }
+    expect(connections, hasLength(1));
+  });
+
+  test('preconnect warms the connection used by later requests', () async {
+    await NetworkClientService.preconnect([baseUrl, '$baseUrl/other']);
+    expect(connections, hasLength(1));
+
+    // 刚有过请求的源站不会重复预热。
+    await NetworkClientService.preconnect([baseUrl]);
+    final client = NetworkClientService.createClient();
+    await client.post(Uri.parse('$baseUrl/chat/completions'), body: '{}');
+    expect(connections, hasLength(1));
+  });
+
+  test('changing proxy mode drops pooled connections', () async {
+    final client = NetworkClientService.createClient();
+    await client.get(Uri.parse(baseUrl));
+    NetworkClientService.setProxyMode(NetworkProxyMode.system);
+    NetworkClientService.setProxyMode(NetworkProxyMode.none);
+    await client.get(Uri.parse(baseUrl));
+    expect(connections, hasLength(2));
+  });
+}
@@ -0,0 +1,103 @@
+import 'dart:convert';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:sqflite_common_ffi/sqflite_ffi.dart';
+import 'package:voicetype/database/app_database.dart';
+import 'package:voicetype/services/latency_histogram.dart';
+import 'package:voicetype/services/pipeline_tracer.dart';
+
+void main() {
+  setUpAll(() async {
+    sqfliteFfiInit();
+    databaseFactory = databaseFactoryFfi;
+  });
+
+  setUp(() async {
+    await AppDatabase.resetForTest();
+  });
+
+  group('LatencyHistogram', () {
+    test('buckets are contiguous and bounded in relative width', () {
+      var previousUpper = 0;
+      for (var bucket = 0; bucket < 400; bucket++) {
+        final lower = LatencyHistogram.lowerBoundOf(bucket);
+        final upper = LatencyHistogram.upperBoundOf(bucket);
+        expect(lower, previousUpper);
+        expect(LatencyHistogram.bucketOf(lower), bucket);
+        expect(LatencyHistogram.bucketOf(upper - 1), bucket);
+        if (lower >= LatencyHistogram.subBucketCount) {
+          expect(
+            (upper - lower) / lower,
+            lessThanOrEqualTo(1 / LatencyHistogram.subBucketCount),
+          );
+        }
+        previousUpper = upper;
+      }
+    });
+
+    test('percentiles stay within bucket error', () {
+      final histogram = LatencyHistogram();
+      for (var ms = 1; ms <= 1000; ms++) {
+        histogram.record(ms * 1000);
+      }
+      expect(histogram.totalCount, 1000);
+      expect(histogram.percentile(0.5), closeTo(500000, 500000 * 0.04));
+      expect(histogram.percentile(0.99), closeTo(990000, 990000 * 0.04));
+
+      final merged = LatencyHistogram.fromBuckets(histogram.buckets)
+        ..merge(histogram);
+      expect(merged.totalCount, 2000);
+      expect(merged.percentile(0.5), histogram.percentile(0.5));
+    });
+  });
+
+  group('PipelineTracer', () {
+    test('persists per-day buckets additively and exports trace', () async {
+      final tracer = PipelineTracer.instance;
+      final trace = tracer.begin();
+      final start = PipelineTracer.nowUs();
+      trace
+        ..record(PipelineStage.stt, start, endUs: start + 120000)
+        ..record(
+          PipelineStage.insertText,
+          start + 120000,
+          endUs: start + 125000,
+          args: {'chars': 12},
+        );
+      await tracer.flush();
+
+      tracer.begin().record(PipelineStage.stt, start, endUs: start + 120000);
+      final histograms = await tracer.readHistograms(DateTime.now());
+      expect(histograms[PipelineStage.stt]!.totalCount, 2);
+      expect(histograms[PipelineStage.insertText]!.totalCount, 1);
+      expect(
+        histograms[PipelineStage.stt]!.percentile(0.5),
+        closeTo(120000, 120000 * 0.04),
+      );
+
+      final exported =
+          json.decode(tracer.exportChromeTrace()) as Map<String, dynamic>;
+      final spans = (exported['traceEvents'] as List)
+          .cast<Map<String, dynamic>>()
+          .where((e) => e['ph'] == 'X' && e['tid'] == trace.id)
+          .toList();
+      expect(spans.map((e) => e['name']), [
+        PipelineStage.stt,
+        PipelineStage.insertText,
+      ]);
+      expect(spans.first['ts'], start);
+      expect(spans.first['dur'], 120000);
+      expect(spans.last['args'], {'chars': 12});
+    });
+
+    test('maps wall-clock stamps onto the tracer clock', () {
+      final before = PipelineTracer.nowUs();
+      final epochUs = DateTime.now().microsecondsSinceEpoch - 250000;
+      final mapped = PipelineTracer.fromEpochUs(epochUs);
+      final after = PipelineTracer.nowUs();
+
+      expect(mapped, lessThanOrEqualTo(after - 250000));
+      expect(mapped, greaterThanOrEqualTo(before - 250000 - 50000));
+    });
+  });
+}
@@ -0,0 +1,141 @@
+import 'dart:async';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voicetype/services/provider_router.dart';
+
+void main() {
+  late DateTime now;
+  late ProviderRouter router;
+
+  const a = RouteCandidate('stt|a', 'a');
+  const b = RouteCandidate('stt|b', 'b');
+  const c = RouteCandidate('stt|c', 'c');
+  const local = RouteCandidate('stt|local', 'local', isLocal: true);
+
+  setUp(() {
+    now = DateTime(2026, 1, 1);
+    router = ProviderRouter(
+      failureThreshold: 2,
+      openDuration: const Duration(seconds: 30),
+      now: () => now,
+    )..enabled = true;
+  });
+
+  List<String> ranked(List<RouteCandidate<String>> preference) =>
+      router.rank(preference).map((e) => e.config).toList();
+
+  test('prefers the first candidate until others prove faster', () {
+    expect(ranked([a, b, c]), ['a', 'b', 'c']);
+
+    router.recordSuccess(a.key, const Duration(milliseconds: 900));
+    router.recordSuccess(b.key, const Duration(milliseconds: 300));
+    expect(ranked([a, b, c]), ['b', 'a', 'c']);
+
+    // 差距小于偏好惩罚时仍按用户顺序。
+    router.recordSuccess(c.key, const Duration(milliseconds: 320));
+    expect(ranked([c, b]), ['c', 'b']);
+  });
+
+  test('ranks streaming requests by time to first token', () {
+    // a 首字快但总耗时长，b 反之。
+    router.recordStream(
+      a.key,
+      firstToken: const Duration(milliseconds: 200),
+      total: const Duration(milliseconds: 2000),
+      tokensPerSecond: 40,
+    );
+    router.recordStream(
+      b.key,
+      firstToken: const Duration(milliseconds: 600),
+      total: const Duration(milliseconds: 900),
+    );
+
+    expect(ranked([a, b]), ['b', 'a']);
+    expect(
+      router.rank([a, b], byFirstToken: true).map((e) => e.config),
+      ['a', 'b'],
+    );
+    expect(router.healthOf(a.key).ewmaTokensPerSecond, 40);
+    expect(router.healthOf(b.key).ewmaTokensPerSecond, isNull);
+  });
+
+  test('opens the circuit after repeated failures and probes later', () {
+    router.recordFailure(a.key);
+    expect(router.healthOf(a.key).stateAt(now), CircuitState.closed);
+    router.recordFailure(a.key, timeout: true);
+    expect(router.healthOf(a.key).stateAt(now), CircuitState.open);
+    expect(router.healthOf(a.key).timeouts, 1);
+    expect(ranked([a, b]), ['b', 'a']);
+
+    now = now.add(const Duration(seconds: 31));
+    expect(router.healthOf(a.key).stateAt(now), CircuitState.halfOpen);
+    expect(ranked([a, b]).first, 'a');
+
+    // 探测失败后熔断时长翻倍。
+    router.healthOf(a.key).probing = true;
+    router.recordFailure(a.key);
+    now = now.add(const Duration(seconds: 45));
+    expect(router.healthOf(a.key).stateAt(now), CircuitState.open);
+    now = now.add(const Duration(seconds: 20));
+    expect(router.healthOf(a.key).stateAt(now), CircuitState.halfOpen);
+
+    router.recordSuccess(a.key, const Duration(milliseconds: 200));
+    expect(router.healthOf(a.key).stateAt(now), CircuitState.closed);
+  });
+
+  test('falls back to local only when every cloud candidate is open', () {
+    expect(ranked([local, a, b]), ['a', 'b', 'local']);
+    for (final key in [a.key, b.key]) {
+      router
+        ..recordFailure(key)
+        ..recordFailure(key);
+    }
+    expect(ranked([local, a, b]), ['local', 'a', 'b']);
+  });
+
+  test('run fails over to the next healthy candidate', () async {
+    final tried = <String>[];
+    final result = await router.run([a, b, c], (config) async {
+      tried.add(config);
+      if (config == 'a') throw TimeoutException('slow');
+      return 'ok from $config';
+    });
+
+    expect(result, 'ok from b');
+    expect(tried, ['a', 'b']);
+    expect(router.healthOf(a.key).errorRate, greaterThan(0));
+    expect(router.healthOf(b.key).ewmaLatencyMs, isNotNull);
+  });
+
+  test('run fails over to local only when cloud circuits are open', () async {
+    final tried = <String>[];
+    Future<String> attempt(String config) async {
+      tried.add(config);
+      if (config == 'a') throw StateError(config);
+      return 'ok from $config';
+    }
+
+    await expectLater(
+      router.run([a, local], attempt),
+      throwsA(isA<StateError>()),
+    );
+    expect(tried, ['a']);
+
+    // 第二次失败使 a 熔断，此时才换到本地模型。
+    tried.clear();
+    expect(await router.run([a, local], attempt), 'ok from local');
+    expect(tried, ['a', 'local']);
+  });
+
+  test('run rethrows the first error when all candidates fail', () async {
+    final tried = <String>[];
+    await expectLater(
+      router.run([a, b], (config) async {
+        tried.add(config);
+        throw StateError(config);
+      }),
+      throwsA(isA<StateError>().having((e) => e.message, 'message', 'a')),
+    );
+    expect(tried, ['a', 'b']);
+  });
+}
@@ -0,0 +1,192 @@
+import 'dart:io';
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:path/path.dart' as p;
+import 'package:voicetype/services/recording_archiver.dart';
+
+void main() {
+  late Directory dir;
+
+  setUp(() async {
+    dir = await Directory.systemTemp.createTemp('recording_archiver_test');
+  });
+
+  tearDown(() async {
+    await dir.delete(recursive: true);
+  });
+
+  String writeWav(String name, List<int> samples, {DateTime? modified}) {
+    final data = ByteData(44 + samples.length * 2);
+    void tag(int offset, String value) {
+      for (var i = 0; i < 4; i++) {
+        data.setUint8(offset + i, value.codeUnitAt(i));
+      }
+    }
+
+    tag(0, 'RIFF');
+    data.setUint32(4, 36 + samples.length * 2, Endian.little);
+    tag(8, 'WAVE');
+    tag(12, 'fmt ');
+    data
+      ..setUint32(16, 16, Endian.little)
+      ..setUint16(20, 1, Endian.little)
+      ..setUint16(22, 1, Endian.little)
+      ..setUint32(24, 16000, Endian.little)
+      ..setUint32(28, 32000, Endian.little)
+      ..setUint16(32, 2, Endian.little)
+      ..setUint16(34, 16, Endian.little);
+    tag(36, 'data');
+    data.setUint32(40, samples.length * 2, Endian.little);
+    for (var i = 0; i < samples.length; i++) {
+      data.setInt16(44 + i * 2, samples[i], Endian.little);
+    }
+    final file = File(p.join(dir.path, name))
+      ..writeAsBytesSync(data.buffer.asUint8List());
+    if (modified != null) file.setLastModifiedSync(modified);
+    return file.path;
+  }
+
+  List<int> tone(int count, {double amplitude = 6000}) {
+    final random = math.Random(7);
+    return [
+      for (var i = 0; i < count; i++)
+        (amplitude * math.sin(2 * math.pi * 220 * i / 16000) +
+                random.nextInt(64) - 32)
+            .round(),
+    ];
+  }
+
+  int totalSamplesOf(Uint8List flac) {
+    // fLaC(4) + 块头(4) 之后是 STREAMINFO，样本总数位于其第 108 位起的 36 位。
+    const base = 8;
+    return ((flac[base + 13] & 0x0F) << 32) |
+        (flac[base + 14] << 24) |
+        (flac[base + 15] << 16) |
+        (flac[base + 16] << 8) |
+        flac[base + 17];
+  }
+
+  test('bundles a session into one indexed FLAC', () {
+    final sources = [
+      writeWav('a.wav', List.filled(16000, 0)),
+      writeWav('b.wav', tone(16000)),
+      writeWav('c.wav', tone(5000)),
+    ];
+    final inputBytes = sources.fold<int>(
+      0,
+      (sum, path) => sum + File(path).lengthSync(),
+    );
+
+    final result = RecordingArchiver.archiveSegments(sources, dir.path);
+
+    expect(result.archived, sources);
+    expect(result.outputs, hasLength(1));
+    expect(p.basename(result.outputs.single), 'a-3段.flac');
+    final bytes = File(result.outputs.single).readAsBytesSync();
+    expect(String.fromCharCodes(bytes, 0, 4), 'fLaC');
+    expect(totalSamplesOf(bytes), 37000);
+    expect(bytes.length, lessThan(inputBytes ~/ 2));
+    expect(result.outputBytes, bytes.length);
+
+    final index = ArchivedSegment.readIndex(bytes);
+    expect(index.map((s) => s.name), ['a.wav', 'b.wav', 'c.wav']);
+    expect(index.map((s) => s.startSample), [0, 16000, 32000]);
+    expect(index.map((s) => s.sampleCount), [16000, 16000, 5000]);
+  });
+
+  test('skips files that are not PCM WAV', () {
+    final broken = File(p.join(dir.path, 'broken.wav'))
+      ..writeAsStringSync('not a wav');
+    final good = writeWav('good.wav', tone(3000));
+
+    final result = RecordingArchiver.archiveSegments([
+      broken.path,
+      good,
+    ], dir.path);
+
+    expect(result.archived, [good]);
+    expect(broken.existsSync(), isTrue);
+  });
+
+  test('archives sessions and leftovers, applies retention', () async {
+    final archiver = RecordingArchiver(
+      directory: () async => dir,
+      maxTotalBytes: 1 << 30,
+    );
+    final stale = DateTime.now().subtract(const Duration(minutes: 30));
+    writeWav('old-1.wav', tone(4000), modified: stale);
+    writeWav(
+      'old-2.wav',
+      tone(4000),
+      modified: stale.add(const Duration(seconds: 10)),
+    );
+    final expired = File(p.join(dir.path, 'expired.flac'))
+      ..writeAsBytesSync([0])
+      ..setLastModifiedSync(
+        DateTime.now().subtract(const Duration(days: 40)),
+      );
+
+    final token = archiver.beginSession();
+    final session = [
+      writeWav('s-1.wav', tone(8000)),
+      writeWav('s-2.wav', tone(8000)),
+    ];
+    await archiver.run();
+    expect(File(session.first).existsSync(), isTrue);
+
+    archiver.endSession(token, session);
+    await archiver.run();
+
+    final names = dir.listSync().map((e) => p.basename(e.path)).toSet();
+    expect(names, {'old-1-2段.flac', 's-1-2段.flac'});
+    expect(expired.existsSync(), isFalse);
+  });
+
+  test('keeps archiving paused while an overlapping session records', () async {
+    final archiver = RecordingArchiver(
+      directory: () async => dir,
+      maxTotalBytes: 1 << 30,
+    );
+
+    final first = archiver.beginSession();
+    final firstSegments = [writeWav('first-1.wav', tone(4000))];
+    // 上一会话仍在转写时，下一会话已经开始录音。
+    final second = archiver.beginSession();
+    final secondSegments = [writeWav('second-1.wav', tone(4000))];
+
+    archiver.endSession(first, firstSegments);
+    await archiver.run();
+    expect(File(firstSegments.single).existsSync(), isTrue);
+    expect(File(secondSegments.single).existsSync(), isTrue);
+
+    // 已结束的令牌再次结束时不影响仍在进行的会话。
+    archiver.endSession(first);
+    await archiver.run();
+    expect(File(secondSegments.single).existsSync(), isTrue);
+
+    archiver.endSession(second, secondSegments);
+    await archiver.run();
+    final names = dir.listSync().map((e) => p.basename(e.path)).toSet();
+    expect(names, {'first-1.flac', 'second-1.flac'});
+  });
+
+  test('drops the oldest archives beyond the size budget', () async {
+    final archiver = RecordingArchiver(
+      directory: () async => dir,
+      maxTotalBytes: 2500,
+    );
+    final now = DateTime.now();
+    for (var i = 0; i < 3; i++) {
+      File(p.join(dir.path, 'day-$i.flac'))
+        ..writeAsBytesSync(List.filled(1000, 0))
+        ..setLastModifiedSync(now.subtract(Duration(days: 3 - i)));
+    }
+
+    await archiver.run();
+
+    final names = dir.listSync().map((e) => p.basename(e.path)).toSet();
+    expect(names, {'day-1.flac', 'day-2.flac'});
+  });
+}
@@ -0,0 +1,148 @@
+import 'dart:async';
+import 'dart:io';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:http/http.dart' as http;
+import 'package:voicetype/services/network_client_service.dart';
+import 'package:voicetype/services/request_hedger.dart';
+
+void main() {
+  const coldStart = Duration(milliseconds: 30);
+
+  RequestHedger newHedger({double maxExtraRatio = 0.1, double burst = 2}) {
+    return RequestHedger(
+      maxExtraRatio: maxExtraRatio,
+      burst: burst,
+      minSamples: 5,
+      minDelay: Duration.zero,
+    )..enabled = true;
+  }
+
+  Future<String> delayed(String value, int ms, [Future<void>? cancelled]) {
+    final completer = Completer<String>();
+    final timer = Timer(Duration(milliseconds: ms), () {
+      if (!completer.isCompleted) completer.complete(value);
+    });
+    cancelled?.then((_) {
+      timer.cancel();
+      if (!completer.isCompleted) completer.completeError('cancelled');
+    });
+    return completer.future;
+  }
+
+  test('slow primary is hedged and the loser is cancelled', () async {
+    final hedger = newHedger();
+    var primaryCancelled = false;
+
+    final result = await hedger.run(
+      key: 'stt|a',
+      coldStart: coldStart,
+      primary: (cancelled) {
+        cancelled.then((_) => primaryCancelled = true);
+        return delayed('primary', 2000, cancelled);
+      },
+      hedge: (cancelled) => delayed('backup', 10, cancelled),
+      hedgeKey: 'stt|b',
+    );
+
+    expect(result, 'backup');
+    expect(primaryCancelled, isTrue);
+    expect(hedger.hedgesFired, 1);
+    expect(hedger.hedgesWon, 1);
+  });
+
+  test('fast primary and disabled hedger send a single request', () async {
+    final hedger = newHedger();
+    var calls = 0;
+    Future<String> call(Future<void> cancelled) {
+      calls++;
+      return delayed('ok', 5, cancelled);
+    }
+
+    expect(
+      await hedger.run(key: 'k', coldStart: coldStart, primary: call),
+      'ok',
+    );
+    hedger.enabled = false;
+    expect(
+      await hedger.run(
+        key: 'k',
+        coldStart: Duration.zero,
+        primary: (c) => delayed('slow', 80, c),
+      ),
+      'slow',
+    );
+    expect(calls, 1);
+    expect(hedger.hedgesFired, 0);
+  });
+
+  test('budget caps the number of extra requests', () async {
+    final hedger = newHedger(maxExtraRatio: 0, burst: 1);
+    for (var i = 0; i < 3; i++) {
+      await hedger.run(
+        key: 'k',
+        coldStart: coldStart,
+        primary: (c) => delayed('primary', 120, c),
+        hedge: (c) => delayed('backup', 5, c),
+      );
+    }
+    expect(hedger.hedgesFired, 1);
+  });
+
+  test('threshold follows the recorded p90', () {
+    final hedger = newHedger();
+    expect(hedger.thresholdFor('k', coldStart), coldStart);
+    for (var i = 1; i <= 10; i++) {
+      hedger.recordLatency('k', Duration(milliseconds: i * 100));
+    }
+    final threshold = hedger.thresholdFor('k', coldStart);
+    expect(threshold.inMilliseconds, closeTo(900, 50));
+  });
+
+  test('primary failure before the threshold is not retried', () async {
+    final hedger = newHedger();
+    var hedgeCalls = 0;
+
+    await expectLater(
+      hedger.run<String>(
+        key: 'k',
+        coldStart: coldStart,
+        primary: (_) async => throw StateError('boom'),
+        hedge: (c) {
+          hedgeCalls++;
+          return delayed('backup', 5, c);
+        },
+      ),
+      throwsStateError,
+    );
+    await Future<void>.delayed(const Duration(milliseconds: 60));
+    expect(hedgeCalls, 0);
+  });
+
+  test('cancelling aborts pooled HTTP requests', () async {
+    final server = await HttpServer.bind(InternetAddress.loopbackIPv4, 0);
+    server.listen((request) async {
+      await Future<void>.delayed(const Duration(seconds: 5));
+      await request.response.close().catchError((_) {});
+    });
+    addTearDown(() async {
+      NetworkClientService.closeAll();
+      await server.close(force: true);
+    });
+
+    final abort = Completer<void>();
+    final pending = NetworkClientService.runAbortable(
+      abort.future,
+      () => NetworkClientService.createClient().post(
+        Uri.parse('http://127.0.0.1:${server.port}/audio/transcriptions'),
+        body: 'payload',
+      ),
+    );
+    Timer(const Duration(milliseconds: 50), abort.complete);
+
+    await expectLater(
+      pending,
+      throwsA(isA<http.RequestAbortedException>()),
+    );
+  });
+}
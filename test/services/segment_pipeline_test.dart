@@ -0,0 +1,144 @@
+import 'dart:async';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voicetype/services/segment_pipeline.dart';
+
+class _Job {
+  final int id;
+  final List<String> log = [];
+
+  _Job(this.id);
+}
+
+Future<void> _sleep(int ms) => Future.delayed(Duration(milliseconds: ms));
+
+void main() {
+  test('overlaps stages and outputs in submission order', () async {
+    final events = <String>[];
+    final output = <int>[];
+    final pipeline = StagedPipeline<_Job>(
+      [
+        PipelineStep('stt', (job) async {
+          events.add('stt+${job.id}');
+          // 第一个分段最慢，后面的分段会超车。
+          await _sleep(job.id == 0 ? 60 : 10);
+          events.add('stt-${job.id}');
+        }, concurrency: 2),
+        PipelineStep('llm', (job) async {
+          events.add('llm+${job.id}');
+          await _sleep(30);
+          events.add('llm-${job.id}');
+        }, ordered: true),
+      ],
+      onOutput: (job) => output.add(job.id),
+    );
+
+    for (var i = 0; i < 4; i++) {
+      pipeline.add(_Job(i));
+    }
+    await pipeline.drained;
+
+    expect(output, [0, 1, 2, 3]);
+    final llmStarts = events.where((e) => e.startsWith('llm+')).toList();
+    expect(llmStarts, ['llm+0', 'llm+1', 'llm+2', 'llm+3']);
+    // 第 1 段的 LLM 纠错进行时，后续分段的 STT 已经完成。
+    expect(events.indexOf('stt-3'), lessThan(events.indexOf('llm-1')));
+  });
+
+  test('failed jobs are skipped without blocking later ones', () async {
+    final output = <int>[];
+    final errors = <String>[];
+    final pipeline = StagedPipeline<_Job>(
+      [
+        PipelineStep('stt', (job) async {
+          await _sleep(5);
+          if (job.id == 1) throw StateError('stt down');
+        }, concurrency: 2),
+        PipelineStep('llm', (job) async => job.log.add('llm'), ordered: true),
+      ],
+      onOutput: (job) => output.add(job.id),
+      onError: (job, step, error, _) => errors.add('$step:${job.id}'),
+    );
+
+    for (var i = 0; i < 3; i++) {
+      pipeline.add(_Job(i));
+    }
+    await pipeline.drained;
+
+    expect(output, [0, 2]);
+    expect(errors, ['stt:1']);
+    expect(pipeline.pending, 0);
+  });
+
+  test('bounded queues apply backpressure without deadlocking', () async {
+    var running = 0;
+    var maxRunning = 0;
+    final output = <int>[];
+    final pipeline = StagedPipeline<_Job>(
+      [
+        PipelineStep('stt', (job) async {
+          await _sleep(job.id == 0 ? 80 : 2);
+        }, concurrency: 2),
+        PipelineStep('match', (job) async => _sleep(1), capacity: 1),
+        PipelineStep('llm', (job) async {
+          running++;
+          if (running > maxRunning) maxRunning = running;
+          await _sleep(3);
+          running--;
+        }, capacity: 1, ordered: true),
+      ],
+      onOutput: (job) => output.add(job.id),
+    );
+
+    for (var i = 0; i < 12; i++) {
+      pipeline.add(_Job(i));
+    }
+    await pipeline.drained.timeout(const Duration(seconds: 5));
+
+    expect(output, List.generate(12, (i) => i));
+    expect(maxRunning, 1);
+    final occupancy = {for (final s in pipeline.occupancy) s.name: s};
+    // 队列上限为 1，另加一个为最早分段预留的位置。
+    expect(occupancy['match']!.maxQueued, lessThanOrEqualTo(2));
+    expect(occupancy['llm']!.maxQueued, lessThanOrEqualTo(2));
+    expect(occupancy['stt']!.processed, 12);
+    expect(occupancy['stt']!.utilization, greaterThan(0));
+  });
+
+  test('backed-up ordered stage runs consecutive jobs as one batch', () async {
+    final batches = <List<int>>[];
+    final output = <int>[];
+    final pipeline = StagedPipeline<_Job>(
+      [
+        PipelineStep('stt', (job) async => _sleep(job.id == 0 ? 5 : 1)),
+        PipelineStep(
+          'llm',
+          (job) async {
+            batches.add([job.id]);
+            await _sleep(40);
+          },
+          ordered: true,
+          runBatch: (jobs) async {
+            batches.add([for (final job in jobs) job.id]);
+            await _sleep(40);
+          },
+          maxBatch: 3,
+          capacity: 8,
+        ),
+      ],
+      onOutput: (job) => output.add(job.id),
+    );
+
+    for (var i = 0; i < 6; i++) {
+      pipeline.add(_Job(i));
+    }
+    await pipeline.drained;
+
+    expect(output, List.generate(6, (i) => i));
+    // 第 0 段单独处理，其余分段在它纠错期间积压，按顺序成批处理。
+    expect(batches.first, [0]);
+    expect(batches.expand((b) => b), List.generate(6, (i) => i));
+    expect(batches.skip(1).every((b) => b.length > 1), isTrue);
+    expect(batches.every((b) => b.length <= 3), isTrue);
+  });
+}
@@ -0,0 +1,87 @@
+import 'dart:convert';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voicetype/services/ai_providers/sse_delta_parser.dart';
+
+void main() {
+  String event(Map<String, dynamic> data) => 'data: ${json.encode(data)}\n\n';
+
+  Map<String, dynamic> chunk(Object? content) => {
+    'id': 'chatcmpl-1',
+    'object': 'chat.completion.chunk',
+    'choices': [
+      {
+        'index': 0,
+        'delta': {'role': 'assistant', 'content': content},
+        'finish_reason': null,
+      },
+    ],
+    'usage': null,
+  };
+
+  Future<List<SseDelta>> parse(List<List<int>> chunks) =>
+      Stream.fromIterable(chunks).transform(const SseDeltaParser()).toList();
+
+  test('extracts delta content without full decoding', () {
+    const payload =
+        '{"choices":[{"index":0,"delta":{"role":"assistant",'
+        '"tool_calls":[{"x":"}"}],"content":"第\\"一\\"句\\n\\u4e8c"}}]}';
+    expect(SseDeltaParser.extractContent(payload), '第"一"句\n二');
+    expect(
+      SseDeltaParser.extractContent('{"choices":[{"delta":{"content":null}}]}'),
+      '',
+    );
+    expect(SseDeltaParser.extractContent('{"choices":[]}'), '');
+    // 数组形式的 content 交给完整解析。
+    expect(
+      SseDeltaParser.extractContent(
+        '{"choices":[{"delta":{"content":[{"text":"a"}]}}]}',
+      ),
+      isNull,
+    );
+  });
+
+  test('reassembles lines and characters split across chunks', () async {
+    final bytes = utf8.encode(
+      '${event(chunk('你好'))}: keep-alive\r\n'
+      '${event(chunk('，世界'))}data: [DONE]\n\n',
+    );
+    // 逐字节切分，覆盖行与 UTF-8 字符被截断的所有位置。
+    final deltas = await parse([
+      for (final byte in bytes) [byte],
+    ]);
+
+    expect(deltas.map((d) => d.content), ['你好', '，世界']);
+  });
+
+  test('reads list content and the trailing usage event', () async {
+    final deltas = await parse([
+      utf8.encode(
+        event(
+          chunk([
+            {'type': 'text', 'text': '甲'},
+            {'type': 'text', 'text': '乙'},
+          ]),
+        ),
+      ),
+      utf8.encode(
+        'data: {"choices":[],"usage":{"prompt_tokens":12,'
+        '"completion_tokens":3}}',
+      ),
+    ]);
+
+    expect(deltas, hasLength(2));
+    expect(deltas.first.content, '甲乙');
+    expect(deltas.last.content, isEmpty);
+    expect(deltas.last.usage?['completion_tokens'], 3);
+  });
+
+  test('skips malformed events', () async {
+    final deltas = await parse([
+      utf8.encode('data: {"choices":[{"delta":{"content":"a\n'),
+      utf8.encode(event(chunk('b'))),
+    ]);
+
+    expect(deltas.map((d) => d.content), ['b']);
+  });
+}
@@ -0,0 +1,61 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:sqflite_common_ffi/sqflite_ffi.dart';
+import 'package:voicetype/database/app_database.dart';
+import 'package:voicetype/services/correction_stats_service.dart';
+import 'package:voicetype/services/stat_counters.dart';
+
+void main() {
+  setUpAll(() async {
+    sqfliteFfiInit();
+    databaseFactory = databaseFactoryFfi;
+  });
+
+  setUp(() async {
+    await AppDatabase.resetForTest();
+  });
+
+  group('StatCounters', () {
+    test('accumulates in memory and flushes increments in SQL', () async {
+      final db = AppDatabase.instance;
+      await db.setSetting('counter_a', '40');
+
+      final counters = StatCounters.instance;
+      counters
+        ..add('counter_a', 1)
+        ..add('counter_a', 1)
+        ..add('counter_b', 5);
+      // 尚未落盘。
+      expect(await db.getSetting('counter_a'), '40');
+
+      await counters.flush();
+      expect(await db.getSetting('counter_a'), '42');
+      expect(await db.getSetting('counter_b'), '5');
+
+      counters.add('counter_b', 3);
+      expect(await counters.read(['counter_a', 'counter_b', 'missing']), {
+        'counter_a': 42,
+        'counter_b': 8,
+        'missing': 0,
+      });
+    });
+
+    test('concurrent recordCall updates are not lost', () async {
+      final stats = CorrectionStatsService.instance;
+      await Future.wait([
+        for (var i = 0; i < 20; i++)
+          stats.recordCall(
+            matchesCount: 2,
+            selectedCount: 1,
+            referenceChars: 10,
+            llmInvoked: i.isEven,
+          ),
+      ]);
+
+      final snapshot = await stats.getSnapshot();
+      expect(snapshot.calls, 20);
+      expect(snapshot.llmCalls, 10);
+      expect(snapshot.matches, 40);
+      expect(snapshot.referenceChars, 200);
+    });
+  });
+}
@@ -0,0 +1,138 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voicetype/models/dictionary_entry.dart';
+import 'package:voicetype/models/entity_memory.dart';
+import 'package:voicetype/models/transcription.dart';
+import 'package:voicetype/services/session_entity_state.dart';
+import 'package:voicetype/services/session_glossary.dart';
+import 'package:voicetype/services/term_prompt_builder.dart';
+import 'package:voicetype/services/term_prompt_context_cache.dart';
+
+void main() {
+  group('TermPromptContextCache', () {
+    const builder = TermPromptBuilder();
+    late TermPromptContextCache cache;
+    late SessionGlossary glossary;
+    late SessionEntityState entityState;
+    late List<DictionaryEntry> dictionary;
+    late List<EntityMemory> entities;
+    late List<Transcription> history;
+
+    setUp(() {
+      cache = TermPromptContextCache();
+      glossary = SessionGlossary();
+      entityState = SessionEntityState();
+      dictionary = [
+        DictionaryEntry.create(original: 'MCP'),
+        DictionaryEntry.create(original: '帆软报表'),
+        DictionaryEntry.create(original: '反软', corrected: '帆软'),
+      ];
+      entities = [
+        EntityMemory.create(canonicalName: '张三丰', type: EntityType.person),
+      ];
+      history = [
+        Transcription(
+          id: '1',
+          text: '昨天看了 MCP 文档',
+          createdAt: DateTime(2026, 3, 28),
+          duration: const Duration(seconds: 5),
+          provider: 'test',
+          model: 'test',
+          providerConfigJson: '{}',
+        ),
+      ];
+    });
+
+    String cached(String currentText) => cache
+        .build(
+          scene: 'dictation',
+          currentText: currentText,
+          history: history,
+          dictionaryEntries: dictionary,
+          sessionGlossary: glossary,
+          sessionEntityState: entityState,
+          entityMemories: entities,
+        )
+        .sttPrompt;
+
+    String direct(String currentText) => builder
+        .build(
+          scene: 'dictation',
+          currentText: currentText,
+          history: history,
+          dictionaryEntries: dictionary,
+          sessionGlossary: glossary,
+          sessionEntityState: entityState,
+          entityMemories: entities,
+        )
+        .sttPrompt;
+
+    test('matches the builder while text grows segment by segment', () {
+      const segments = ['今天讨论帆软报表', '张三丰负责 MCP 接入', '其他事项'];
+      var text = '';
+      for (final segment in segments) {
+        text = text.isEmpty ? segment : '$text\n$segment';
+        expect(cached(text), direct(text));
+      }
+
+      expect(cache.staticStats.hits, 2);
+      expect(cache.staticStats.misses, 1);
+      // 后续分段只追加文本，关键词增量提取。
+      expect(cache.keywordStats.hits, 2);
+    });
+
+    test('reuses preferred terms when appended text adds no keyword', () {
+      cached('帆软报表');
+      final first = cache.termStats.misses;
+      cached('帆软报表\n的');
+
+      expect(cache.termStats.misses, first);
+      expect(cache.termStats.hits, 1);
+    });
+
+    test('reuses entities while appended text adds no mention', () {
+      const segments = ['张三丰负责', '接入文档', '张三丰确认', '其他事项'];
+      var text = '';
+      for (final segment in segments) {
+        text = text.isEmpty ? segment : '$text\n$segment';
+        expect(cached(text), direct(text));
+      }
+
+      expect(cache.entityStats.misses, 1);
+      expect(cache.entityStats.hits, 3);
+    });
+
+    test('finds mentions that span the appended boundary', () {
+      expect(cached('今天张三'), direct('今天张三'));
+      expect(cached('今天张三丰'), direct('今天张三丰'));
+
+      expect(cached('今天张三丰'), contains('张三丰'));
+      expect(cache.entityStats.misses, 2);
+    });
+
+    test('invalidates on glossary and entity state changes', () {
+      cached('讨论反软');
+      glossary.override('反软', '帆软');
+      expect(cached('讨论反软'), direct('讨论反软'));
+      expect(cache.staticStats.misses, 2);
+
+      entityState.activate(
+        entityId: entities.first.id,
+        canonicalName: '张三丰',
+        alias: '张三丰',
+      );
+      expect(cached('讨论反软'), direct('讨论反软'));
+      expect(cache.entityStats.misses, 3);
+    });
+
+    test('reset clears entries and statistics', () {
+      cached('帆软报表');
+      cached('帆软报表');
+      expect(cache.bundleStats.hits, 1);
+
+      cache.reset();
+      expect(cache.bundleStats.lookups, 0);
+      expect(cached('帆软报表'), direct('帆软报表'));
+      expect(cache.bundleStats.misses, 1);
+    });
+  });
+}
@@ -0,0 +1,88 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voicetype/models/dictionary_entry.dart';
+import 'package:voicetype/models/term_context_entry.dart';
+import 'package:voicetype/services/session_glossary.dart';
+import 'package:voicetype/services/term_recall_index.dart';
+import 'package:voicetype/services/term_recall_service.dart';
+
+void main() {
+  group('TermRecallService', () {
+    const service = TermRecallService();
+
+    test('ranks keyword matches ahead of unrelated dictionary terms', () {
+      final entries = [
+        for (var i = 0; i < 50; i++)
+          DictionaryEntry.create(original: 'Filler$i'),
+        DictionaryEntry.create(original: '帆软报表'),
+        DictionaryEntry.create(original: 'MCP'),
+      ];
+
+      final terms = service.recallPreferredTerms(
+        currentText: '今天讨论帆软报表和 mcp 接入',
+        history: const [],
+        dictionaryEntries: entries,
+        sessionGlossary: SessionGlossary(),
+        maxTerms: 5,
+      );
+
+      expect(terms, hasLength(5));
+      expect(terms.take(2), containsAll(['帆软报表', 'MCP']));
+    });
+
+    test('session glossary shadows dictionary term with same key', () {
+      final glossary = SessionGlossary()..override('低铺戏客', 'DeepSeek');
+
+      final terms = service.recallPreferredTerms(
+        currentText: 'deepseek 接入',
+        history: const [],
+        dictionaryEntries: [DictionaryEntry.create(original: 'deepseek')],
+        sessionGlossary: glossary,
+      );
+
+      expect(terms, ['DeepSeek']);
+    });
+
+    test('includes non-document term context entries', () {
+      final terms = service.recallPreferredTerms(
+        currentText: '数据治理平台',
+        history: const [],
+        dictionaryEntries: const [],
+        sessionGlossary: SessionGlossary(),
+        termContextEntries: [
+          TermContextEntry.create(
+            term: '数据治理',
+            sourceName: 'glossary.md',
+            entryType: TermContextEntryType.preserveHint,
+          ),
+        ],
+      );
+
+      expect(terms, ['数据治理']);
+    });
+  });
+
+  group('TermRecallIndex', () {
+    test('matches terms contained in keywords and keywords in terms', () {
+      final entries = [
+        DictionaryEntry.create(original: '报表'),
+        DictionaryEntry.create(original: '帆软报表平台'),
+        DictionaryEntry.create(original: '无关词'),
+      ];
+      final index = TermRecallIndex.of(
+        dictionaryEntries: entries,
+        termContextEntries: const [],
+      );
+
+      final scores = index.matchScores({'帆软报表'});
+      final matched = scores.keys.map((p) => index.termAt(p).term).toSet();
+      expect(matched, {'报表', '帆软报表平台'});
+      expect(
+        TermRecallIndex.of(
+          dictionaryEntries: entries,
+          termContextEntries: const [],
+        ),
+        same(index),
+      );
+    });
+  });
+}
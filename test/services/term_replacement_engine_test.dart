@@ -0,0 +1,85 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voicetype/models/dictionary_entry.dart';
+import 'package:voicetype/services/pinyin_matcher.dart';
+import 'package:voicetype/services/term_replacement_engine.dart';
+
+void main() {
+  group('TermReplacementEngine', () {
+    late PinyinMatcher matcher;
+
+    setUp(() {
+      matcher = PinyinMatcher();
+    });
+
+    test('collapses observed variants, alias and pinyin in one pass', () {
+      matcher.buildIndex([
+        DictionaryEntry.create(original: '好数连', corrected: 'hao shu lian'),
+      ]);
+      const input = '好数联、Hao Shu Lian、haoshulian 和 hao-shu_lian';
+      final hits = matcher.findMatchHits(input);
+      final engine = TermReplacementEngine.forMatcher(matcher);
+
+      expect(engine.apply(input, hits), '好数连、好数连、好数连 和 好数连');
+    });
+
+    test('pinyin pattern respects word boundaries', () {
+      matcher.buildIndex([
+        DictionaryEntry.create(original: '好数连', corrected: 'HSL'),
+      ]);
+      final hits = matcher.findMatchHits('好数联');
+      final engine = TermReplacementEngine.forMatcher(matcher);
+
+      expect(
+        engine.apply('xhaoshulian 与 hao shu lian', hits),
+        'xhaoshulian 与 好数连',
+      );
+    });
+
+    test('only applies rules of selected hits', () {
+      matcher.buildIndex([
+        DictionaryEntry.create(original: '墨提斯', corrected: 'Metis'),
+        DictionaryEntry.create(original: '星阔', corrected: 'XingKuo'),
+      ]);
+      final hits = matcher.findMatchHits('莫提斯');
+      final engine = TermReplacementEngine.forMatcher(matcher);
+
+      expect(engine.apply('metis and xingkuo', hits), '墨提斯 and xingkuo');
+    });
+
+    test('prefers the longest match at the leftmost position', () {
+      matcher.buildIndex([
+        DictionaryEntry.create(original: '数据', corrected: 'Data'),
+        DictionaryEntry.create(original: '数据湖', corrected: 'DataLake'),
+      ]);
+      final hits = matcher.findMatchHits('数据湖和数据');
+      final engine = TermReplacementEngine.forMatcher(matcher);
+
+      expect(engine.apply('DataLake and Data', hits), '数据湖 and 数据');
+    });
+
+    test('normalizes latin variants back to Chinese alias', () {
+      matcher.buildIndex([
+        DictionaryEntry.create(original: 'Metis', corrected: '墨提斯'),
+      ]);
+      final hits = matcher.findMatchHits('metis 报表');
+      final engine = TermReplacementEngine.forMatcher(matcher);
+
+      expect(engine.apply('METIS 报表', hits), '墨提斯 报表');
+    });
+
+    test('engine is cached per dictionary version', () {
+      matcher.buildIndex([
+        DictionaryEntry.create(original: '墨提斯', corrected: 'Metis'),
+      ]);
+      final first = TermReplacementEngine.forMatcher(matcher);
+      expect(TermReplacementEngine.forMatcher(matcher), same(first));
+
+      matcher.buildIndex([
+        DictionaryEntry.create(original: '星阔', corrected: 'XingKuo'),
+      ]);
+      final rebuilt = TermReplacementEngine.forMatcher(matcher);
+      expect(rebuilt, isNot(same(first)));
+      expect(rebuilt.version, matcher.indexVersion);
+    });
+  });
+}
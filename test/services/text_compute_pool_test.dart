@@ -0,0 +1,80 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voicetype/models/dictionary_entry.dart';
+import 'package:voicetype/services/local_correction_plan.dart';
+import 'package:voicetype/services/pinyin_matcher.dart';
+import 'package:voicetype/services/text_compute_pool.dart';
+
+void main() {
+  group('TextComputePool', () {
+    late TextComputePool pool;
+
+    setUp(() {
+      pool = TextComputePool(workerCount: 2);
+    });
+
+    tearDown(() async {
+      await pool.dispose();
+    });
+
+    test('matches the inline plan', () async {
+      final matcher = PinyinMatcher()
+        ..buildIndex([
+          DictionaryEntry.create(original: '墨提斯', corrected: 'Metis'),
+          DictionaryEntry.create(original: '好数连', corrected: 'Hermes'),
+          DictionaryEntry.create(original: 'Kubernetes'),
+        ]);
+      const selector = ReferenceHitSelector();
+      const text = '今天用魔提斯和 kubernetes 部署了好书连';
+
+      final inline = LocalCorrectionPlan.compute(matcher, text, selector);
+      final pooled = await pool.planCorrection(matcher, text, selector);
+
+      expect(inline.matchHits, isNotEmpty);
+      expect(pooled.normalizedText, inline.normalizedText);
+      expect(
+        pooled.selectedHits.map((h) => '${h.entry.id}|${h.observedText}'),
+        inline.selectedHits.map((h) => '${h.entry.id}|${h.observedText}'),
+      );
+      expect(pooled.matchHits.length, inline.matchHits.length);
+    });
+
+    test('picks up a rebuilt index on the next request', () async {
+      final matcher = PinyinMatcher()
+        ..buildIndex([
+          DictionaryEntry.create(original: '墨提斯', corrected: 'Metis'),
+        ]);
+      const selector = ReferenceHitSelector();
+      await pool.prepare(matcher);
+
+      final before = await pool.planCorrection(matcher, '好数连上线', selector);
+      expect(before.matchHits, isEmpty);
+
+      matcher.buildIndex([
+        DictionaryEntry.create(original: '好数连', corrected: 'Hermes'),
+      ]);
+      final after = await Future.wait([
+        for (var i = 0; i < 4; i++)
+          pool.planCorrection(matcher, '好数连上线', selector),
+      ]);
+      for (final plan in after) {
+        expect(plan.matchHits.map((h) => h.entry.original), ['好数连']);
+      }
+    });
+
+    test('respawns workers after dispose', () async {
+      final matcher = PinyinMatcher()
+        ..buildIndex([
+          DictionaryEntry.create(original: '墨提斯', corrected: 'Metis'),
+        ]);
+      await pool.prepare(matcher);
+      await pool.dispose();
+
+      final plan = await pool.planCorrection(
+        matcher,
+        '墨提斯',
+        const ReferenceHitSelector(),
+      );
+      expect(plan.selectedHits.single.entry.original, '墨提斯');
+    });
+  });
+}
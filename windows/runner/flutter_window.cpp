@@ -1,9 +1,11 @@
 #include "flutter_window.h"
 
+#include <flutter/method_result_functions.h>
 #include <flutter/standard_method_codec.h>
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <optional>
 #include <shellapi.h>
@@ -30,6 +32,20 @@ std::wstring Utf8ToWide(const std::string& value) {
   return result;
 }
 
+// Current wall-clock time in microseconds since the Unix epoch, matching
+// Dart's DateTime.microsecondsSinceEpoch so the key event can be placed on
+// the same timeline as the Dart-side pipeline trace.
+int64_t UnixEpochMicros() {
+  FILETIME file_time;
+  GetSystemTimePreciseAsFileTime(&file_time);
+  ULARGE_INTEGER ticks;
+  ticks.LowPart = file_time.dwLowDateTime;
+  ticks.HighPart = file_time.dwHighDateTime;
+  // FILETIME counts 100ns intervals since 1601-01-01.
+  constexpr uint64_t kEpochDifference100ns = 116444736000000000ULL;
+  return static_cast<int64_t>((ticks.QuadPart - kEpochDifference100ns) / 10);
+}
+
 std::string OverlayStatusText(const std::string& state) {
   if (state == "starting") {
     return "Mic starting";
@@ -444,6 +460,8 @@ void FlutterWindow::EmitGlobalKeyEvent(int key_code, const std::string& type,
       flutter::EncodableValue(has_modifiers);
   payload[flutter::EncodableValue("modifiers")] =
       flutter::EncodableValue(static_cast<int32_t>(modifiers));
+  payload[flutter::EncodableValue("timestampUs")] =
+      flutter::EncodableValue(UnixEpochMicros());
   method_channel_->InvokeMethod("onGlobalKeyEvent",
                                 std::make_unique<flutter::EncodableValue>(
                                     std::move(payload)));
@@ -769,8 +787,35 @@ void FlutterWindow::ShowTrayMenu() {
 }
 
 void FlutterWindow::ExitFromTray() {
+  if (exiting_from_tray_) {
+    return;
+  }
   exiting_from_tray_ = true;
   RemoveTrayIcon();
+  if (!method_channel_) {
+    Destroy();
+    return;
+  }
+
+  // Destroying the window skips Flutter's exit request, so ask Dart to
+  // flush buffered stats and logs first. The timer bounds the wait in case
+  // Dart never answers.
+  SetTimer(GetHandle(), kExitFlushTimerId, kExitFlushTimeoutMs, nullptr);
+  method_channel_->InvokeMethod(
+      "prepareExit", nullptr,
+      std::make_unique<flutter::MethodResultFunctions<flutter::EncodableValue>>(
+          [this](const flutter::EncodableValue*) { FinishExitFromTray(); },
+          [this](const std::string&, const std::string&,
+                 const flutter::EncodableValue*) { FinishExitFromTray(); },
+          [this]() { FinishExitFromTray(); }));
+}
+
+void FlutterWindow::FinishExitFromTray() {
+  HWND hwnd = GetHandle();
+  if (hwnd == nullptr) {
+    return;
+  }
+  KillTimer(hwnd, kExitFlushTimerId);
   Destroy();
 }
 
@@ -807,6 +852,12 @@ FlutterWindow::MessageHandler(HWND hwnd, UINT const message,
       }
       break;
     }
+    case WM_TIMER:
+      if (wparam == kExitFlushTimerId) {
+        FinishExitFromTray();
+        return 0;
+      }
+      break;
     case kTrayCallbackMessage:
       if (LOWORD(lparam) == WM_LBUTTONDBLCLK) {
         ShowMainWindowNative();
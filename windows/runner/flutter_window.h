@@ -32,6 +32,9 @@ class FlutterWindow : public Win32Window {
      static constexpr UINT kTrayIconId = 1;
      static constexpr UINT kTrayMenuOpenId = 40001;
      static constexpr UINT kTrayMenuExitId = 40002;
+    static constexpr UINT_PTR kExitFlushTimerId = 1;
+    // Upper bound on how long tray Quit waits for Dart to flush buffers.
+    static constexpr UINT kExitFlushTimeoutMs = 3000;
 
     static FlutterWindow* instance_;
 
@@ -67,6 +70,7 @@ class FlutterWindow : public Win32Window {
     void RemoveTrayIcon();
     void ShowTrayMenu();
     void ExitFromTray();
+    void FinishExitFromTray();
 
   // The project to run.
   flutter::DartProject project_;